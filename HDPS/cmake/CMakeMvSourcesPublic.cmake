@@ -378,12 +378,14 @@ set(PUBLIC_WIDGET_FILES
 set(PUBLIC_RENDERERS_HEADERS
     src/renderers/Renderer.h
     src/renderers/PointRenderer.h
+    src/renderers/PointSpatialIndex.h
     src/renderers/DensityRenderer.h
     src/renderers/ImageRenderer.h
 )
 
 set(PUBLIC_RENDERERS_SOURCES
     src/renderers/PointRenderer.cpp
+    src/renderers/PointSpatialIndex.cpp
     src/renderers/DensityRenderer.cpp
     src/renderers/ImageRenderer.cpp
 )
@@ -453,6 +455,11 @@ set(PUBLIC_UTIL_HEADERS
     src/util/Version.h
     src/util/DockWidgetPermission.h
     src/util/NumericalRange.h
+    src/util/SelectionBitmap.h
+    src/util/RawDataCodec.h
+    src/util/ScalarStatistics.h
+    src/util/ListenerSlotMap.h
+    src/util/Parallel.h
 )
 
 if(APPLE)
@@ -494,6 +501,10 @@ set(PUBLIC_UTIL_SOURCES
     src/util/Version.cpp
     src/util/DockWidgetPermission.cpp
     src/util/NumericalRange.cpp
+    src/util/SelectionBitmap.cpp
+    src/util/RawDataCodec.cpp
+    src/util/ScalarStatistics.cpp
+    src/util/Parallel.cpp
 )
 
 if(APPLE)
@@ -562,6 +573,7 @@ set(PUBLIC_DATASET_HEADERS
     src/LinkedData.h
     src/Dataset.h
     src/DatasetPrivate.h
+    src/DatasetReference.h
     src/DatasetsMimeData.h
 )
 
@@ -570,6 +582,7 @@ set(PUBLIC_DATASET_SOURCES
     src/LinkedData.cpp
     src/Dataset.cpp
     src/DatasetPrivate.cpp
+    src/DatasetReference.cpp
     src/DatasetsMimeData.cpp
 )
 
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#version 330 core
+
+uniform sampler2D densityTexture;   /** Density map (or the result of the previous reduction pass) */
+uniform ivec2 sourceSize;           /** Size of the valid region of the density texture */
+
+out float value;
+
+// Takes the maximum of the 2x2 source texels that correspond to this fragment
+void main() {
+    ivec2 texel = ivec2(gl_FragCoord.xy) * 2;
+    ivec2 last  = sourceSize - 1;
+
+    value = texelFetch(densityTexture, min(texel, last), 0).r;
+    value = max(value, texelFetch(densityTexture, min(texel + ivec2(1, 0), last), 0).r);
+    value = max(value, texelFetch(densityTexture, min(texel + ivec2(0, 1), last), 0).r);
+    value = max(value, texelFetch(densityTexture, min(texel + ivec2(1, 1), last), 0).r);
+}
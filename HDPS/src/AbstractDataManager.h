@@ -100,6 +100,50 @@ public:
 
     /** Get all sets from the data manager */
     virtual const QVector<Dataset<DatasetImpl>>& allSets() const = 0;
+
+public: // Dataset graph
+
+    /**
+     * Updates the dataset graph index for \p dataset (and the datasets that are derived from it), to be called when
+     * the source dataset or the proxy members of a dataset that was already added to the data manager changed
+     * @param dataset Smart pointer to the dataset of which the relations changed
+     */
+    virtual void updateDatasetRelations(const Dataset<DatasetImpl>& dataset) = 0;
+
+    /**
+     * Get datasets that reference the raw data with \p rawDataName
+     * @param rawDataName Name of the raw data
+     * @return Datasets (full datasets and subsets) of the raw data
+     */
+    virtual Datasets getDatasetsByRawDataName(const QString& rawDataName) const = 0;
+
+    /**
+     * Get derived datasets of which the (ultimate) source dataset references the raw data with \p sourceRawDataName
+     * @param sourceRawDataName Name of the raw data of the source dataset
+     * @return Derived datasets
+     */
+    virtual Datasets getDerivedDatasets(const QString& sourceRawDataName) const = 0;
+
+    /**
+     * Get datasets that are directly derived from \p sourceDataset
+     * @param sourceDataset Smart pointer to the source dataset
+     * @return Derived datasets
+     */
+    virtual Datasets getDerivedDatasets(const Dataset<DatasetImpl>& sourceDataset) const = 0;
+
+    /**
+     * Get proxy datasets that contain \p memberDataset
+     * @param memberDataset Smart pointer to the proxy member dataset
+     * @return Proxy datasets
+     */
+    virtual Datasets getProxyDatasets(const Dataset<DatasetImpl>& memberDataset) const = 0;
+
+    /**
+     * Get the revision of the dataset graph, which increases whenever a dataset is added, removed or changes
+     * relations, so that information derived from the graph (like global indices) can be cached
+     * @return Dataset graph revision
+     */
+    virtual std::uint64_t getDatasetGraphRevision() const = 0;
 };
 
 }
\ No newline at end of file
@@ -72,6 +72,22 @@ public:
      */
     virtual void notifyDatasetDataSelectionChanged(const Dataset<DatasetImpl>& dataset, Datasets* ignoreDatasets = nullptr) = 0;
 
+    /**
+     * Set the maximum rate at which dataset data selection changes are propagated to the listeners. Selection changes
+     * that occur in between two propagations are coalesced, so that each affected dataset gets one event per propagation.
+     * @param selectionPropagationRate Maximum number of propagations per second (zero propagates each selection change immediately)
+     */
+    virtual void setSelectionPropagationRate(std::uint32_t selectionPropagationRate) = 0;
+
+    /**
+     * Get the maximum rate at which dataset data selection changes are propagated to the listeners
+     * @return Maximum number of propagations per second (zero when each selection change is propagated immediately)
+     */
+    virtual std::uint32_t getSelectionPropagationRate() const = 0;
+
+    /** Propagates the pending (coalesced) dataset data selection changes immediately */
+    virtual void flushSelectionChanges() = 0;
+
     /**
      * Notify all listeners that a dataset is locked
      * @param dataset Smart pointer to the dataset
@@ -96,6 +112,13 @@ public:
      */
     virtual void unregisterEventListener(EventListener* eventListener) = 0;
 
+    /**
+     * Updates the registration of an event listener of which the supported event types changed
+     * @param eventListener Pointer to event listener to update
+     * @param previousEventTypes Event types the listener supported before the change
+     */
+    virtual void updateEventListener(EventListener* eventListener, const QSet<std::uint32_t>& previousEventTypes) = 0;
+
 protected:
 
     /**
@@ -109,6 +132,17 @@ protected:
 
         eventListener->onDataEvent(dataEvent);
     }
+
+    /**
+     * Get the handle of \p eventListener in the registry of the event manager
+     * @param eventListener Pointer to event listener
+     * @return Reference to the handle
+     */
+    static util::ListenerSlotMap<EventListener>::Handle& getEventListenerHandle(EventListener* eventListener) {
+        Q_ASSERT(eventListener != nullptr);
+
+        return eventListener->_eventManagerHandle;
+    }
 };
 
 }
@@ -34,6 +34,7 @@ Application::Application(int& argc, char** argv) :
     _settings(),
     _serializationTemporaryDirectory(),
     _serializationAborted(false),
+    _serializationRawDataCodec(util::RawDataCodec::None),
     _logger(),
     _startupProjectFilePath(),
     _startupProjectMetaAction(nullptr),
@@ -187,6 +188,16 @@ void Application::setSerializationAborted(bool serializationAborted)
     current()->_serializationAborted = serializationAborted;
 }
 
+util::RawDataCodec Application::getSerializationRawDataCodec()
+{
+    return current()->_serializationRawDataCodec;
+}
+
+void Application::setSerializationRawDataCodec(util::RawDataCodec serializationRawDataCodec)
+{
+    current()->_serializationRawDataCodec = serializationRawDataCodec;
+}
+
 void Application::initialize()
 {
     _logger.initialize();
@@ -7,6 +7,7 @@
 #include "util/IconFonts.h"
 #include "util/Logger.h"
 #include "util/Version.h"
+#include "util/RawDataCodec.h"
 
 #include "actions/TriggerAction.h"
 
@@ -166,6 +167,45 @@ public: // Serialization
      */
     static void setSerializationAborted(bool serializationAborted);
 
+    /**
+     * Get the codec with which raw data blocks are saved to disk
+     * @return Raw data codec
+     */
+    static util::RawDataCodec getSerializationRawDataCodec();
+
+    /**
+     * Set the codec with which raw data blocks are saved to disk to \p serializationRawDataCodec
+     * @param serializationRawDataCodec Raw data codec
+     */
+    static void setSerializationRawDataCodec(util::RawDataCodec serializationRawDataCodec);
+
+    /** Sets the codec with which raw data blocks are saved for the duration of a scope (e.g. saving a project) */
+    class ScopedSerializationRawDataCodec {
+    public:
+
+        /**
+         * Construct with the codec for the scope
+         * @param serializationRawDataCodec Raw data codec at scope begin (reverts to the previous codec when the object gets out of scope)
+         */
+        explicit ScopedSerializationRawDataCodec(util::RawDataCodec serializationRawDataCodec) :
+            _previousSerializationRawDataCodec(getSerializationRawDataCodec())
+        {
+            setSerializationRawDataCodec(serializationRawDataCodec);
+        }
+
+        /** Revert to the previous codec when object goes out of scope */
+        ~ScopedSerializationRawDataCodec()
+        {
+            setSerializationRawDataCodec(_previousSerializationRawDataCodec);
+        }
+
+        ScopedSerializationRawDataCodec(const ScopedSerializationRawDataCodec&) = delete;
+        ScopedSerializationRawDataCodec& operator=(const ScopedSerializationRawDataCodec&) = delete;
+
+    private:
+        util::RawDataCodec  _previousSerializationRawDataCodec;     /** Codec before the scope */
+    };
+
 public: // Statics
 
     static QMainWindow* getMainWindow();
@@ -206,6 +246,7 @@ protected:
     QSettings               _settings;                          /** Settings */
     QString                 _serializationTemporaryDirectory;   /** Temporary directory for serialization */
     bool                    _serializationAborted;              /** Whether serialization was aborted */
+    util::RawDataCodec      _serializationRawDataCodec;         /** Codec with which raw data blocks are saved */
     util::Logger            _logger;                            /** Logger instance */
     gui::TriggerAction*     _exitAction;                        /** Action for exiting the application */
     QString                 _startupProjectFilePath;            /** File path of the project to automatically open upon startup (if set) */
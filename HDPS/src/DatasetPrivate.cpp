@@ -10,6 +10,9 @@
 
 #include <QMetaMethod>
 
+#include <utility>
+#include <vector>
+
 #ifdef _DEBUG
     #define DATASET_PRIVATE_VERBOSE
 #endif
@@ -19,21 +22,48 @@ namespace mv
 
 using namespace util;
 
+namespace
+{
+    /**
+     * Get the type of event that is rebroadcast by \p signal
+     * @param signal Signal of the dataset smart pointer
+     * @param eventType Type of event (output)
+     * @return Whether \p signal rebroadcasts an event
+     */
+    bool getSignalEventType(const QMetaMethod& signal, std::uint32_t& eventType)
+    {
+        static const std::vector<std::pair<QMetaMethod, EventType>> signalEventTypes{
+            { QMetaMethod::fromSignal(&DatasetPrivate::aboutToBeRemoved), EventType::DatasetAboutToBeRemoved },
+            { QMetaMethod::fromSignal(&DatasetPrivate::removed), EventType::DatasetRemoved },
+            { QMetaMethod::fromSignal(&DatasetPrivate::dataChanged), EventType::DatasetDataChanged },
+            { QMetaMethod::fromSignal(&DatasetPrivate::dataDimensionsChanged), EventType::DatasetDataDimensionsChanged },
+            { QMetaMethod::fromSignal(&DatasetPrivate::dataSelectionChanged), EventType::DatasetDataSelectionChanged },
+            { QMetaMethod::fromSignal(&DatasetPrivate::childAdded), EventType::DatasetChildAdded },
+            { QMetaMethod::fromSignal(&DatasetPrivate::childRemoved), EventType::DatasetChildRemoved }
+        };
+
+        for (const auto& signalEventType : signalEventTypes) {
+            if (signal == signalEventType.first) {
+                eventType = static_cast<std::uint32_t>(signalEventType.second);
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
 DatasetPrivate::DatasetPrivate() :
     QObject(),
     _datasetId(),
-    _dataset(nullptr),
-    _eventListener()
+    _dataset(nullptr)
 {
-    registerDatasetEvents();
 }
 
 DatasetPrivate::DatasetPrivate(const DatasetPrivate& other) :
     _datasetId(),
-    _dataset(nullptr),
-    _eventListener()
+    _dataset(nullptr)
 {
-    registerDatasetEvents();
 }
 
 QString DatasetPrivate::getDatasetId() const
@@ -52,8 +82,12 @@ void DatasetPrivate::setDatasetId(const QString& datasetId)
         reset();
     }
     else {
+        _dataset = nullptr;
         _dataset = getDataset();
 
+        updateEventSubscription();
+        updateGuiNameConnection();
+
         emit changed(_dataset);
     }
 }
@@ -77,17 +111,14 @@ void DatasetPrivate::setDataset(DatasetImpl* dataset)
         reset();
     }
     else {
-        disconnect(dataset, &gui::WidgetAction::textChanged, this, nullptr);
-
         if (dataset == _dataset)
             return;
 
         _dataset        = dataset;
-        _datasetId    = _dataset->getId();
+        _datasetId      = _dataset->getId();
 
-        connect(_dataset, &gui::WidgetAction::textChanged, this, [this]() -> void {
-            emit guiNameChanged();
-        });
+        updateEventSubscription();
+        updateGuiNameConnection();
 
         emit changed(_dataset);
     }
@@ -97,61 +128,77 @@ void DatasetPrivate::reset()
 {
     _dataset    = nullptr;
     _datasetId  = "";
+
+    updateEventSubscription();
+    updateGuiNameConnection();
 }
 
 void DatasetPrivate::connectNotify(const QMetaMethod& signal)
 {
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::aboutToBeRemoved))
-        _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetAboutToBeRemoved));
-
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::removed))
-        _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetRemoved));
-
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::dataChanged))
-        _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetDataChanged));
+    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::guiNameChanged)) {
+        updateGuiNameConnection();
+        return;
+    }
 
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::dataDimensionsChanged))
-        _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetDataDimensionsChanged));
+    std::uint32_t eventType = 0;
 
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::dataSelectionChanged))
-        _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetDataSelectionChanged));
+    if (!getSignalEventType(signal, eventType))
+        return;
 
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::childAdded))
-        _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetChildAdded));
+    registerDatasetEvents();
 
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::childRemoved))
-        _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetChildRemoved));
+    if (_eventListener)
+        _eventListener->addSupportedEventType(eventType);
 }
 
 void DatasetPrivate::disconnectNotify(const QMetaMethod& signal)
 {
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::aboutToBeRemoved))
-        _eventListener.removeSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetAboutToBeRemoved));
+    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::guiNameChanged)) {
+        updateGuiNameConnection();
+        return;
+    }
 
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::removed))
-        _eventListener.removeSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetRemoved));
+    std::uint32_t eventType = 0;
+
+    // The event listener itself is kept, as it might be dispatching the event that causes the disconnection
+    if (getSignalEventType(signal, eventType) && _eventListener && !isSignalConnected(signal))
+        _eventListener->removeSupportedEventType(eventType);
+}
 
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::dataChanged))
-        _eventListener.removeSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetDataChanged));
+void DatasetPrivate::updateEventSubscription()
+{
+    if (_eventListener)
+        _eventListener->setDatasetId(_datasetId);
+}
 
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::dataDimensionsChanged))
-        _eventListener.removeSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetDataDimensionsChanged));
+void DatasetPrivate::updateGuiNameConnection()
+{
+    const auto guiNameChangedConnected = isSignalConnected(QMetaMethod::fromSignal(&DatasetPrivate::guiNameChanged));
 
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::dataSelectionChanged))
-        _eventListener.removeSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetDataSelectionChanged));
+    if (_guiNameChangedConnection)
+        disconnect(_guiNameChangedConnection);
 
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::childAdded))
-        _eventListener.removeSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetChildAdded));
+    if (!guiNameChangedConnected || _dataset == nullptr)
+        return;
 
-    if (signal == QMetaMethod::fromSignal(&DatasetPrivate::childRemoved))
-        _eventListener.removeSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetChildRemoved));
+    _guiNameChangedConnection = connect(_dataset, &gui::WidgetAction::textChanged, this, [this]() -> void {
+        emit guiNameChanged();
+    });
 }
 
 void DatasetPrivate::registerDatasetEvents()
 {
+    if (_eventListener)
+        return;
+
     try
     {
-        _eventListener.registerDataEvent([this](DatasetEvent* dataEvent) {
+        _eventListener = std::make_unique<EventListener>();
+
+        // Only the events of the referenced dataset are delivered to this listener
+        _eventListener->setDatasetId(_datasetId);
+
+        _eventListener->registerDataEvent([this](DatasetEvent* dataEvent) {
             switch (dataEvent->getType()) {
 
                 case EventType::DatasetAboutToBeRemoved:
@@ -9,6 +9,8 @@
 
 #include <QString>
 
+#include <memory>
+
 namespace mv
 {
 
@@ -26,6 +28,11 @@ template<typename> class Dataset;
  * - Save a pointer to a dataset (if initialized properly)
  * - Intercept events related to the dataset and rebroadcast them using Qt signals
  *
+ * The event listener is only created when one of the dataset signals is connected, and it
+ * subscribes to the events of the referenced dataset only, so that (temporary) smart pointers
+ * of which no signal is used do not register with the event manager at all. See DatasetReference
+ * for an even lighter (non-QObject) reference to a dataset.
+ *
  * @author T. Kroes
  */
 class DatasetPrivate : public QObject
@@ -102,9 +109,15 @@ public: // Keep track of when someone connects/disconnects from our signal(s)
 
 protected:
 
-    /** Register for data events from the core */
+    /** Register for data events from the core (creates the event listener on first use) */
     void registerDatasetEvents();
 
+    /** Subscribes the event listener (if any) to the events of the current dataset */
+    void updateEventSubscription();
+
+    /** Connects the text changed signal of the dataset (if any and when needed) to the GUI name changed signal */
+    void updateGuiNameConnection();
+
 signals:
 
     /**
@@ -147,9 +160,10 @@ signals:
     void childRemoved(const QString& childDatasetGuid);
 
 private:
-    QString         _datasetId;         /** Globally unique identifier of the dataset */
-    DatasetImpl*    _dataset;           /** Pointer to the dataset (if any) */
-    EventListener   _eventListener;     /** Listen to HDPS events */
+    QString                         _datasetId;                 /** Globally unique identifier of the dataset */
+    DatasetImpl*                    _dataset;                   /** Pointer to the dataset (if any) */
+    std::unique_ptr<EventListener>  _eventListener;             /** Listen to HDPS events (only created when one of the signals is connected) */
+    QMetaObject::Connection         _guiNameChangedConnection;  /** Connection from the dataset text changed signal (only when the GUI name changed signal is connected) */
 };
 
 /**
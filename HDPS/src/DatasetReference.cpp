@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "DatasetReference.h"
+#include "CoreInterface.h"
+#include "Set.h"
+
+namespace mv
+{
+
+DatasetReferencePrivate::DatasetReferencePrivate(DatasetImpl* dataset) :
+    _datasetId(dataset != nullptr ? dataset->getId() : QString()),
+    _dataset(dataset),
+    _datasetGraphRevision(dataset != nullptr ? mv::data().getDatasetGraphRevision() : 0),
+    _isResolved(dataset != nullptr)
+{
+}
+
+DatasetReferencePrivate::DatasetReferencePrivate(const QString& datasetId) :
+    _datasetId(datasetId)
+{
+}
+
+void DatasetReferencePrivate::setDatasetId(const QString& datasetId)
+{
+    if (datasetId == _datasetId)
+        return;
+
+    _datasetId  = datasetId;
+    _dataset    = nullptr;
+    _isResolved = false;
+}
+
+DatasetImpl* DatasetReferencePrivate::getDataset() const
+{
+    if (_datasetId.isEmpty())
+        return nullptr;
+
+    const auto datasetGraphRevision = mv::data().getDatasetGraphRevision();
+
+    // The dataset graph revision changes whenever a dataset is added or removed
+    if (!_isResolved || datasetGraphRevision != _datasetGraphRevision) {
+        _dataset                = mv::data().getSet(_datasetId).get();
+        _datasetGraphRevision   = datasetGraphRevision;
+        _isResolved             = true;
+    }
+
+    return _dataset;
+}
+
+void DatasetReferencePrivate::reset()
+{
+    setDatasetId("");
+}
+
+}
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#pragma once
+
+#include "Dataset.h"
+
+#include <QString>
+
+#include <cstdint>
+
+namespace mv
+{
+
+class DatasetImpl;
+
+/**
+ * Dataset reference private base class
+ *
+ * Non-template part of the dataset reference: the globally unique identifier of the
+ * dataset and the cached pointer to the dataset. The pointer is resolved again (by
+ * identifier) when the dataset graph revision of the data manager changed, so that it
+ * never dangles after the dataset is removed, without listening to events.
+ */
+class DatasetReferencePrivate
+{
+protected: // Construction
+
+    /** Default constructor */
+    DatasetReferencePrivate() = default;
+
+    /**
+     * Construct from dataset pointer
+     * @param dataset Pointer to the dataset (may be nullptr)
+     */
+    explicit DatasetReferencePrivate(DatasetImpl* dataset);
+
+    /**
+     * Construct from globally unique identifier
+     * @param datasetId Globally unique identifier of the dataset
+     */
+    explicit DatasetReferencePrivate(const QString& datasetId);
+
+public: // Member access
+
+    /** Get the globally unique identifier of the dataset */
+    const QString& getDatasetId() const {
+        return _datasetId;
+    }
+
+    /**
+     * Set the globally unique identifier of the dataset
+     * @param datasetId Globally unique identifier of the dataset
+     */
+    void setDatasetId(const QString& datasetId);
+
+    /**
+     * Get pointer to the dataset
+     * @return Pointer to the dataset (nullptr if the dataset does not exist (anymore))
+     */
+    DatasetImpl* getDataset() const;
+
+    /** Resets the reference */
+    void reset();
+
+private:
+    QString                 _datasetId;                 /** Globally unique identifier of the dataset */
+    mutable DatasetImpl*    _dataset = nullptr;         /** Cached pointer to the dataset (if any) */
+    mutable std::uint64_t   _datasetGraphRevision = 0;  /** Dataset graph revision at which the pointer was resolved */
+    mutable bool            _isResolved = false;        /** Whether the cached pointer was resolved at all */
+};
+
+/**
+ * Dataset reference class
+ *
+ * Lightweight (non-QObject) counterpart of the dataset smart pointer: it only holds the
+ * globally unique identifier and a cached pointer, and does not register with the event
+ * manager. Use it to store references to datasets in bulk or in temporaries, and use
+ * Dataset<DatasetType> (which subscribes to the events of its dataset as soon as one of
+ * its signals is connected) when dataset notifications are needed.
+ */
+template<typename DatasetType>
+class DatasetReference : public DatasetReferencePrivate
+{
+public: // Construction
+
+    /**
+     * (Default) constructor
+     * @param dataset Pointer to dataset (if any)
+     */
+    DatasetReference(DatasetType* dataset = nullptr) :
+        DatasetReferencePrivate(reinterpret_cast<DatasetImpl*>(dataset))
+    {
+    }
+
+    /**
+     * Construct from dataset smart pointer
+     * @param dataset Smart pointer to the dataset
+     */
+    template<typename OtherDatasetType>
+    DatasetReference(const Dataset<OtherDatasetType>& dataset) :
+        DatasetReferencePrivate(dataset.getDatasetId())
+    {
+    }
+
+public: // Pointer access
+
+    /**
+     * Get pointer to dataset
+     * @return Pointer to dataset (if any, maybe nullptr)
+     */
+    DatasetType* get() const
+    {
+        return reinterpret_cast<DatasetType*>(getDataset());
+    }
+
+    /**
+     * Overloaded arrow operator
+     * @return Pointer to dataset (if any, maybe nullptr)
+     */
+    DatasetType* operator-> () const
+    {
+        return get();
+    }
+
+    /** Returns reference validity
+     * @return Boolean determining whether the dataset actually exists
+     */
+    bool isValid() const
+    {
+        return getDataset() != nullptr;
+    }
+
+    /**
+     * Get a smart pointer to the dataset
+     * @return Smart pointer to the dataset (refers to the identifier when the dataset does not exist yet)
+     */
+    Dataset<DatasetType> toDataset() const
+    {
+        if (isValid())
+            return Dataset<DatasetType>(get());
+
+        Dataset<DatasetType> dataset;
+
+        dataset.setDatasetId(getDatasetId());
+
+        return dataset;
+    }
+
+    /**
+     * Conversion to dataset smart pointer
+     * @return Smart pointer to the dataset
+     */
+    operator Dataset<DatasetType>() const
+    {
+        return toDataset();
+    }
+};
+
+/**
+ * Compares two dataset references for equality
+ * @param lhs Left hand side dataset reference
+ * @param rhs Right hand side dataset reference
+ * @return Whether lhs and rhs are equal
+ */
+inline bool operator == (const DatasetReferencePrivate& lhs, const DatasetReferencePrivate& rhs)
+{
+    return lhs.getDatasetId() == rhs.getDatasetId();
+}
+
+/**
+ * Compares two dataset references for inequality
+ * @param lhs Left hand side dataset reference
+ * @param rhs Right hand side dataset reference
+ * @return Whether lhs and rhs are not equal
+ */
+inline bool operator != (const DatasetReferencePrivate& lhs, const DatasetReferencePrivate& rhs)
+{
+    return lhs.getDatasetId() != rhs.getDatasetId();
+}
+
+}
@@ -5,11 +5,24 @@
 #include "LinkedData.h"
 #include "Set.h"
 
+#include "util/Parallel.h"
+#include "util/SelectionBitmap.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
 using namespace mv::util;
 
 namespace mv
 {
 
+namespace
+{
+    /** Selections are only mapped in parallel when each range gets at least this many indices */
+    constexpr std::size_t minimumNumberOfIndicesPerRange = 1 << 16;
+}
+
 SelectionMap::SelectionMap(Type type /*= Indexed*/) :
     Serializable("SelectionMapping"),
     _type(type)
@@ -29,8 +42,18 @@ void SelectionMap::populateMappingIndices(std::uint32_t pointIndex, Indices& ind
     switch (_type)
     {
         case Type::Indexed:
-            indices = _map.at(pointIndex);
+        {
+            if (!isCompressed()) {
+                indices = _map.at(pointIndex);
+                break;
+            }
+
+            if (!_sourceBitmap.contains(pointIndex))
+                throw std::out_of_range(QString("No selection mapping for point index %1").arg(pointIndex).toStdString());
+
+            indices.assign(_targetIndices.begin() + _offsets[pointIndex], _targetIndices.begin() + _offsets[pointIndex + 1]);
             break;
+        }
 
         case Type::ImagePyramid:
         {
@@ -76,17 +99,196 @@ void SelectionMap::populateMappingIndices(std::uint32_t pointIndex, Indices& ind
     }
 }
 
+SelectionMap::Indices SelectionMap::mapSelection(const Indices& selection) const
+{
+    // Maps the selection indices in [begin, end) and removes the duplicates by means of a selection bitmap
+    const auto mapRange = [this, &selection](std::size_t begin, std::size_t end) -> SelectionBitmap {
+        Indices mappedIndices;
+
+        mappedIndices.reserve(end - begin);
+
+        if (_type == Type::Indexed && isCompressed()) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const auto pointIndex = selection[i];
+
+                if (static_cast<std::size_t>(pointIndex) + 1 < _offsets.size())
+                    mappedIndices.insert(mappedIndices.end(), _targetIndices.begin() + _offsets[pointIndex], _targetIndices.begin() + _offsets[pointIndex + 1]);
+            }
+        }
+        else {
+            Indices pointMappedIndices;
+
+            for (std::size_t i = begin; i < end; ++i) {
+                if (!hasMappingForPointIndex(selection[i]))
+                    continue;
+
+                populateMappingIndices(selection[i], pointMappedIndices);
+                mappedIndices.insert(mappedIndices.end(), pointMappedIndices.begin(), pointMappedIndices.end());
+            }
+        }
+
+        return SelectionBitmap(mappedIndices);
+    };
+
+    const auto numberOfRanges = getNumberOfParallelRanges(selection.size(), minimumNumberOfIndicesPerRange);
+
+    if (numberOfRanges <= 1)
+        return mapRange(0, selection.size()).toIndices();
+
+    std::vector<SelectionBitmap> mappedSelections(numberOfRanges);
+
+    const auto getRangeBegin = [&selection, numberOfRanges](std::size_t rangeIndex) {
+        return selection.size() * rangeIndex / numberOfRanges;
+    };
+
+    parallelForEach(numberOfRanges, [&mappedSelections, &mapRange, &getRangeBegin](std::size_t rangeIndex) -> void {
+        mappedSelections[rangeIndex] = mapRange(getRangeBegin(rangeIndex), getRangeBegin(rangeIndex + 1));
+    });
+
+    for (std::size_t rangeIndex = 1; rangeIndex < numberOfRanges; ++rangeIndex)
+        mappedSelections.front() |= mappedSelections[rangeIndex];
+
+    return mappedSelections.front().toIndices();
+}
+
 SelectionMap::Map& SelectionMap::getMap()
 {
+    // Expand a compressed mapping, so that the map holds the complete mapping while it is edited
+    if (!_sourceBitmap.isEmpty()) {
+        Map map;
+
+        _sourceBitmap.forEach([this, &map](std::uint32_t pointIndex) {
+            map.emplace_hint(map.end(), pointIndex, Indices(_targetIndices.begin() + _offsets[pointIndex], _targetIndices.begin() + _offsets[pointIndex + 1]));
+        });
+
+        clearIndexedMapping();
+
+        _map = std::move(map);
+    }
+
     return _map;
 }
 
+void SelectionMap::setCompressedMapping(Indices offsets, Indices targetIndices)
+{
+    if (offsets.empty() ? !targetIndices.empty() : (offsets.front() != 0 || offsets.back() != targetIndices.size() || !std::is_sorted(offsets.begin(), offsets.end())))
+        throw std::runtime_error("Selection mapping offsets are inconsistent with the target indices");
+
+    clearIndexedMapping();
+
+    _type           = Type::Indexed;
+    _offsets        = std::move(offsets);
+    _targetIndices  = std::move(targetIndices);
+
+    // Each source point in the range of the offsets is mapped, also when it has no target indices
+    if (!_offsets.empty())
+        _sourceBitmap = SelectionBitmap::fromRange(0, static_cast<std::uint32_t>(_offsets.size() - 1));
+
+    updateTargetBitmap();
+}
+
+void SelectionMap::setOneToOneMapping(const Indices& sourceIndices, const Indices& targetIndices)
+{
+    if (sourceIndices.size() != targetIndices.size())
+        throw std::runtime_error("Unable to set one-to-one selection mapping, the number of source and target indices differ");
+
+    _type = Type::Indexed;
+
+    clearIndexedMapping();
+
+    if (sourceIndices.empty())
+        return;
+
+    _offsets.resize(static_cast<std::size_t>(*std::max_element(sourceIndices.begin(), sourceIndices.end())) + 2, 0);
+
+    // Count the target indices per source index, and accumulate the counts into offsets
+    for (const auto sourceIndex : sourceIndices)
+        _offsets[sourceIndex + 1]++;
+
+    std::partial_sum(_offsets.begin(), _offsets.end(), _offsets.begin());
+
+    _targetIndices.resize(targetIndices.size());
+
+    auto insertPositions = _offsets;
+
+    for (std::size_t i = 0; i < sourceIndices.size(); ++i)
+        _targetIndices[insertPositions[sourceIndices[i]]++] = targetIndices[i];
+
+    _sourceBitmap = SelectionBitmap(sourceIndices);
+
+    updateTargetBitmap();
+}
+
+void SelectionMap::compress()
+{
+    if (isCompressed())
+        return;
+
+    _offsets.assign(static_cast<std::size_t>(_map.rbegin()->first) + 2, 0);
+    _targetIndices.clear();
+
+    Indices sourceIndices;
+
+    sourceIndices.reserve(_map.size());
+
+    // The map is ordered by source index, so the target indices are appended row by row
+    auto nextPointIndex = 0u;
+
+    for (const auto& [pointIndex, indices] : _map) {
+        for (; nextPointIndex <= pointIndex; ++nextPointIndex)
+            _offsets[nextPointIndex] = static_cast<std::uint32_t>(_targetIndices.size());
+
+        _targetIndices.insert(_targetIndices.end(), indices.begin(), indices.end());
+
+        sourceIndices.push_back(pointIndex);
+    }
+
+    _offsets.back() = static_cast<std::uint32_t>(_targetIndices.size());
+
+    _map.clear();
+
+    // Keys with an empty vector of target indices remain mapped
+    _sourceBitmap = SelectionBitmap(sourceIndices);
+
+    updateTargetBitmap();
+}
+
+bool SelectionMap::isCompressed() const
+{
+    return _map.empty();
+}
+
+const SelectionMap::Indices& SelectionMap::getOffsets() const
+{
+    return _offsets;
+}
+
+const SelectionMap::Indices& SelectionMap::getTargetIndices() const
+{
+    return _targetIndices;
+}
+
+const SelectionBitmap& SelectionMap::getSourceBitmap() const
+{
+    return _sourceBitmap;
+}
+
+const SelectionBitmap& SelectionMap::getTargetBitmap() const
+{
+    return _targetBitmap;
+}
+
 bool SelectionMap::hasMappingForPointIndex(std::uint32_t pointIndex) const
 {
     switch (_type)
     {
         case Type::Indexed:
-            return _map.find(pointIndex) != _map.end();
+        {
+            if (!isCompressed())
+                return _map.find(pointIndex) != _map.end();
+
+            return _sourceBitmap.contains(pointIndex);
+        }
 
         case Type::ImagePyramid:
             return pointIndex < static_cast<std::uint32_t>(_sourceImageSize.width() * _sourceImageSize.height());
@@ -120,8 +322,33 @@ void SelectionMap::fromVariantMap(const QVariantMap& variantMap)
             populateDataBufferFromVariantMap(variantMap["Indices"].toMap(), (char*)indices.data());
             populateDataBufferFromVariantMap(variantMap["Ranges"].toMap(), (char*)ranges.data());
 
-            for (int i = 0; i < ranges.size(); i += 3)
-                _map[ranges[i]] = std::vector<std::uint32_t>(indices.begin() + ranges[i + 1], indices.begin() + ranges[i + 2]);
+            // The ranges are triplets of source point index, begin and end of its target indices
+            std::size_t numberOfSourcePoints = 0;
+            Indices sourceIndices;
+
+            sourceIndices.reserve(ranges.size() / 3);
+
+            for (std::size_t i = 0; i + 2 < ranges.size(); i += 3) {
+                numberOfSourcePoints = std::max(numberOfSourcePoints, static_cast<std::size_t>(ranges[i]) + 1);
+                sourceIndices.push_back(ranges[i]);
+            }
+
+            Indices offsets(numberOfSourcePoints + 1, 0);
+
+            for (std::size_t i = 0; i + 2 < ranges.size(); i += 3)
+                offsets[ranges[i] + 1] = ranges[i + 2] - ranges[i + 1];
+
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            Indices targetIndices(offsets.back());
+
+            for (std::size_t i = 0; i + 2 < ranges.size(); i += 3)
+                std::copy(indices.begin() + ranges[i + 1], indices.begin() + ranges[i + 2], targetIndices.begin() + offsets[ranges[i]]);
+
+            setCompressedMapping(std::move(offsets), std::move(targetIndices));
+
+            // Only the saved source points are mapped (the ones in between have no mapping at all)
+            _sourceBitmap = SelectionBitmap(sourceIndices);
 
             break;
         }
@@ -148,6 +375,18 @@ QVariantMap SelectionMap::toVariantMap() const
     {
         case Type::Indexed:
         {
+            if (isCompressed()) {
+                ranges.reserve(_sourceBitmap.count() * 3);
+
+                _sourceBitmap.forEach([this, &ranges](std::uint32_t pointIndex) {
+                    ranges.push_back(pointIndex);
+                    ranges.push_back(_offsets[pointIndex]);
+                    ranges.push_back(_offsets[pointIndex + 1]);
+                });
+
+                break;
+            }
+
             ranges.reserve(_map.size() * 3);
 
             for (const auto& item : _map) {
@@ -174,11 +413,14 @@ QVariantMap SelectionMap::toVariantMap() const
         { "Height", QVariant::fromValue(_targetImageSize.height()) }
     };
 
+    // A compressed mapping is saved without copying its target indices
+    const auto& savedIndices = (_type == Type::Indexed && isCompressed()) ? _targetIndices : indices;
+
     return {
         { "Type", QVariant::fromValue(static_cast<std::int32_t>(_type)) },
-        { "NumberOfIndices", QVariant::fromValue(indices.size()) },
-        { "Indices", rawDataToVariantMap((char*)indices.data(), indices.size() * sizeof(std::uint32_t), true) },
-        { "IndicesSize", QVariant::fromValue(indices.size()) },
+        { "NumberOfIndices", QVariant::fromValue(savedIndices.size()) },
+        { "Indices", rawDataToVariantMap((char*)savedIndices.data(), savedIndices.size() * sizeof(std::uint32_t), true) },
+        { "IndicesSize", QVariant::fromValue(savedIndices.size()) },
         { "Ranges", rawDataToVariantMap((char*)ranges.data(), ranges.size() * sizeof(std::uint32_t), true) },
         { "RangesSize", QVariant::fromValue(ranges.size()) },
         { "SourceImageSize", sourceImageSize },
@@ -186,6 +428,20 @@ QVariantMap SelectionMap::toVariantMap() const
     };
 }
 
+void SelectionMap::clearIndexedMapping()
+{
+    _map.clear();
+    _offsets.clear();
+    _targetIndices.clear();
+    _sourceBitmap.clear();
+    _targetBitmap.clear();
+}
+
+void SelectionMap::updateTargetBitmap()
+{
+    _targetBitmap = SelectionBitmap(_targetIndices);
+}
+
 LinkedData::LinkedData() :
     Serializable("LinkedData")
 {
@@ -213,6 +469,7 @@ const SelectionMap& LinkedData::getMapping() const
 void LinkedData::setMapping(SelectionMap& mapping)
 {
     _mapping = mapping;
+    _mapping.compress();
 }
 
 void LinkedData::fromVariantMap(const QVariantMap& variantMap)
@@ -5,8 +5,10 @@
 #pragma once
 
 #include "Dataset.h"
+#include "DatasetReference.h"
 
 #include "util/Serializable.h"
+#include "util/SelectionBitmap.h"
 
 #include <QString>
 
@@ -18,6 +20,20 @@ namespace mv
 
 class DatasetImpl;
 
+/**
+ * Selection map class
+ *
+ * Maps the indices of the points in a source dataset to indices of points in a target dataset.
+ *
+ * Indexed mappings are stored in compressed sparse row (CSR) format: the target indices of
+ * source point i are stored in the target indices array, from offsets[i] up to offsets[i + 1].
+ * Mappings may also be built up point by point by means of getMap(), in which case compress()
+ * converts them to CSR format (LinkedData::setMapping does so automatically).
+ *
+ * Like an entry in the map, a source point may have a mapping with no target indices, so the
+ * mapped source points are kept separately. The union of all target indices is computed once
+ * the mapping is compressed, for replacing the selection of the mapped target points.
+ */
 class SelectionMap : public util::Serializable
 {
 public:
@@ -55,11 +71,53 @@ public:
     void populateMappingIndices(std::uint32_t pointIndex, Indices& indices) const;
 
     /**
-     * Get map for indexed pixels
+     * Maps all point indices in \p selection at once (in parallel for large selections)
+     * @param selection Source point indices
+     * @return Sorted target point indices, without duplicates
+     */
+    Indices mapSelection(const Indices& selection) const;
+
+    /**
+     * Get map for indexed pixels, for editing the mapping point by point (converts a compressed
+     * mapping back to a map, so prefer setCompressedMapping() or setOneToOneMapping() for large mappings)
      * @return Index map
      */
     Map& getMap();
 
+    /**
+     * Sets the indexed mapping in compressed sparse row format, in which each source point in the range of the offsets has a mapping (possibly without target indices)
+     * @param offsets Offsets into \p targetIndices, one per source point plus one at the end
+     * @param targetIndices Target indices of all source points, one after the other
+     * @throws std::runtime_error when the offsets are inconsistent with the target indices
+     */
+    void setCompressedMapping(Indices offsets, Indices targetIndices);
+
+    /**
+     * Sets an indexed mapping in which each source index maps to exactly one target index
+     * @param sourceIndices Unique source indices
+     * @param targetIndices Target index for each of the source indices
+     * @throws std::runtime_error when the number of source and target indices differ
+     */
+    void setOneToOneMapping(const Indices& sourceIndices, const Indices& targetIndices);
+
+    /** Converts an indexed mapping that is built up by means of getMap() to compressed sparse row format */
+    void compress();
+
+    /** Get whether the indexed mapping is stored in compressed sparse row format (rather than as map) */
+    bool isCompressed() const;
+
+    /** Get the compressed sparse row offsets, one per source point plus one at the end (when compressed) */
+    const Indices& getOffsets() const;
+
+    /** Get the target indices of all source points, one after the other (when compressed) */
+    const Indices& getTargetIndices() const;
+
+    /** Get the source points for which a mapping exists, possibly without target indices (when compressed) */
+    const util::SelectionBitmap& getSourceBitmap() const;
+
+    /** Get the union of the target indices of all source points, which is computed when the mapping is compressed (empty otherwise) */
+    const util::SelectionBitmap& getTargetBitmap() const;
+
     /**
      * Establishes whether a mapping exists for \p pointIndex
      * @param pointIndex Point index to check for
@@ -80,10 +138,22 @@ public:
     QVariantMap toVariantMap() const override;
 
 private:
-    Type    _type;              /** The type of selection map */
-    Map     _map;               /** Map contents (when mapping type is indexed) */
-    QSize   _sourceImageSize;   /** Source image size (when mapping type is image pyramid) */
-    QSize   _targetImageSize;   /** Target image size (when mapping type is image pyramid) */
+
+    /** Clears the indexed mapping in both the map and the compressed representation */
+    void clearIndexedMapping();
+
+    /** Computes the union of the target indices of the compressed mapping */
+    void updateTargetBitmap();
+
+private:
+    Type                    _type;              /** The type of selection map */
+    Map                     _map;               /** Map contents (when mapping type is indexed and it is not compressed) */
+    Indices                 _offsets;           /** Compressed sparse row offsets (when mapping type is indexed and it is compressed) */
+    Indices                 _targetIndices;     /** Compressed sparse row target indices (when mapping type is indexed and it is compressed) */
+    util::SelectionBitmap   _sourceBitmap;      /** Source points with a mapping (when mapping type is indexed and it is compressed) */
+    util::SelectionBitmap   _targetBitmap;      /** Union of the compressed sparse row target indices (when mapping type is indexed and it is compressed) */
+    QSize                   _sourceImageSize;   /** Source image size (when mapping type is image pyramid) */
+    QSize                   _targetImageSize;   /** Target image size (when mapping type is image pyramid) */
 };
 
 class LinkedData : public util::Serializable
@@ -93,8 +163,8 @@ public:
     LinkedData(const Dataset<DatasetImpl>& sourceDataSet, const Dataset<DatasetImpl>& targetDataSet);
     //LinkedData(const LinkedData& linkedData);
 
-    const Dataset<DatasetImpl> getSourceDataSet() const { return _sourceDataSet; }
-    const Dataset<DatasetImpl> getTargetDataset() const { return _targetDataSet; }
+    const Dataset<DatasetImpl> getSourceDataSet() const { return _sourceDataSet.toDataset(); }
+    const Dataset<DatasetImpl> getTargetDataset() const { return _targetDataSet.toDataset(); }
 
     const SelectionMap& getMapping() const;
     void setMapping(SelectionMap& map);
@@ -112,9 +182,9 @@ public:
     QVariantMap toVariantMap() const override;
 
 private:
-    Dataset<DatasetImpl>    _sourceDataSet;
-    Dataset<DatasetImpl>    _targetDataSet;
-    SelectionMap            _mapping;
+    DatasetReference<DatasetImpl>   _sourceDataSet;     /** Lightweight reference to the source dataset (linked data is stored in bulk, so it does not subscribe to events) */
+    DatasetReference<DatasetImpl>   _targetDataSet;     /** Lightweight reference to the target dataset */
+    SelectionMap                    _mapping;
 };
 
 class IndexLinkedData
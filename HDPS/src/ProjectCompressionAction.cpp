@@ -4,6 +4,8 @@
 
 #include "ProjectCompressionAction.h"
 
+#include "util/RawDataCodec.h"
+
 using namespace mv::gui;
 using namespace mv::util;
 
@@ -12,13 +14,17 @@ namespace mv {
 ProjectCompressionAction::ProjectCompressionAction(QObject* parent /*= nullptr*/) :
     GroupAction(parent, "ProjectCompression"),
     _enabledAction(this, "Compression", DEFAULT_ENABLE_COMPRESSION),
-    _levelAction(this, "Compression level", 1, 9, DEFAULT_COMPRESSION_LEVEL)
+    _levelAction(this, "Compression level", 1, 9, DEFAULT_COMPRESSION_LEVEL),
+    _rawDataCodecAction(this, "Raw data codec", getRawDataCodecNames(), getRawDataCodecName(RawDataCodec::None))
 {
     addAction(&_enabledAction);
     addAction(&_levelAction);
+    addAction(&_rawDataCodecAction);
 
     _levelAction.setPrefix("Level: ");
 
+    _rawDataCodecAction.setToolTip("Codec with which raw data blocks are encoded before they are (optionally) compressed into the project archive");
+
     const auto updateCompressionLevelReadOnly = [this]() -> void {
         _levelAction.setEnabled(_enabledAction.isChecked());
     };
@@ -34,6 +40,9 @@ void ProjectCompressionAction::fromVariantMap(const QVariantMap& variantMap)
 
     _enabledAction.fromParentVariantMap(variantMap);
     _levelAction.fromParentVariantMap(variantMap);
+
+    if (variantMap.contains(_rawDataCodecAction.getSerializationName()))
+        _rawDataCodecAction.fromParentVariantMap(variantMap);
 }
 
 QVariantMap ProjectCompressionAction::toVariantMap() const
@@ -42,6 +51,7 @@ QVariantMap ProjectCompressionAction::toVariantMap() const
 
     _enabledAction.insertIntoVariantMap(variantMap);
     _levelAction.insertIntoVariantMap(variantMap);
+    _rawDataCodecAction.insertIntoVariantMap(variantMap);
 
     return variantMap;
 }
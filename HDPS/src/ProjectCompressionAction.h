@@ -7,6 +7,7 @@
 #include "actions/GroupAction.h"
 #include "actions/ToggleAction.h"
 #include "actions/IntegralAction.h"
+#include "actions/OptionAction.h"
 
 namespace mv {
 
@@ -44,10 +45,12 @@ public: // Action getters
 
     gui::ToggleAction& getEnabledAction() { return _enabledAction; }
     gui::IntegralAction& getLevelAction() { return _levelAction; }
+    gui::OptionAction& getRawDataCodecAction() { return _rawDataCodecAction; }
 
 private:
-    gui::ToggleAction       _enabledAction;     /** Action to enable/disable project file compression */
-    gui::IntegralAction     _levelAction;       /** Action to control the amount of project file compression */
+    gui::ToggleAction       _enabledAction;         /** Action to enable/disable project file compression */
+    gui::IntegralAction     _levelAction;           /** Action to control the amount of project file compression */
+    gui::OptionAction       _rawDataCodecAction;    /** Action to pick the codec with which raw data blocks are encoded */
 
 public:
     static constexpr bool           DEFAULT_ENABLE_COMPRESSION  = false;    /** No compression by default */
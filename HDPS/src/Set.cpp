@@ -144,6 +144,8 @@ void DatasetImpl::fromVariantMap(const QVariantMap& variantMap)
     if (!full)
         _fullDataset = getParent()->getFullDataset<mv::DatasetImpl>();
 
+    mv::data().updateDatasetRelations(this);
+
     setStorageType(static_cast<StorageType>(variantMap["StorageType"].toInt()));
 
     if (getStorageType() == StorageType::Proxy && variantMap.contains("ProxyMembers")) {
@@ -201,6 +203,26 @@ QVariantMap DatasetImpl::toVariantMap() const
     return variantMap;
 }
 
+std::uint64_t DatasetImpl::getSelectionGeneration() const
+{
+    return _selectionGeneration;
+}
+
+void DatasetImpl::incrementSelectionGeneration()
+{
+    ++_selectionGeneration;
+}
+
+std::uint64_t DatasetImpl::getDataGeneration() const
+{
+    return _dataGeneration;
+}
+
+void DatasetImpl::incrementDataGeneration()
+{
+    ++_dataGeneration;
+}
+
 std::int32_t DatasetImpl::getGroupIndex() const
 {
     return _groupIndex;
@@ -235,6 +257,8 @@ void DatasetImpl::setProxyMembers(const Datasets& proxyDatasets)
 
         setStorageType(StorageType::Proxy);
 
+        mv::data().updateDatasetRelations(this);
+
         events().notifyDatasetDataChanged(this);
     }
     catch (std::exception& e)
@@ -305,7 +329,9 @@ DatasetImpl::DatasetImpl(CoreInterface* core, const QString& rawDataName, const
     _linkedDataFlags(LinkedDataFlag::SendReceive),
     _locked(false),
     _smartPointer(this),
-    _task(this, "")
+    _task(this, ""),
+    _selectionGeneration(0),
+    _dataGeneration(0)
 {
     if (!id.isEmpty())
         Serializable::setId(id);
@@ -365,6 +391,8 @@ void DatasetImpl::setSourceDataSet(const Dataset<DatasetImpl>& dataset)
 {
     _sourceDataset = dataset;
     _derived = true;
+
+    mv::data().updateDatasetRelations(this);
 }
 
 mv::Dataset<mv::DatasetImpl> DatasetImpl::getSelection() const
@@ -177,6 +177,26 @@ public:
         return _core->requestSelection<DatasetType>(getSourceDataset<DatasetImpl>()->getRawDataName());
     }
 
+    /**
+     * Get the selection generation, which is incremented each time a selection change of this dataset
+     * is notified, so that data derived from the selection can be cached until the selection changes
+     * @return Selection generation
+     */
+    std::uint64_t getSelectionGeneration() const;
+
+    /** Increments the selection generation (called by the event manager when a selection change of this dataset is notified) */
+    void incrementSelectionGeneration();
+
+    /**
+     * Get the data generation, which is incremented each time a data (or dimensions) change of this dataset
+     * is notified, so that data derived from the values can be cached until the values change
+     * @return Data generation
+     */
+    std::uint64_t getDataGeneration() const;
+
+    /** Increments the data generation (called by the event manager when a data change of this dataset is notified) */
+    void incrementDataGeneration();
+
     /**
      * Get reference to smart pointer which is owned by the set
      * @return Reference to smart pointer which is owned by the set
@@ -559,6 +579,8 @@ private:
     bool                        _locked;            /** Whether the dataset is locked */
     Dataset<DatasetImpl>        _smartPointer;      /** Smart pointer to own dataset */
     DatasetTask                 _task;              /** Task for display in the data hierarchy and foreground */
+    std::uint64_t               _selectionGeneration;   /** Incremented on each notified selection change */
+    std::uint64_t               _dataGeneration;        /** Incremented on each notified data change */
 
     friend class CoreInterface;
     friend class Core;
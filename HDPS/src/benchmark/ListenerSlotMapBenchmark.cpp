@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// Compares the dispatch of one event to many listeners (of which 1% is interested in the event type) by the
+// listener slot map with the previous scheme, which copied the listener vector and checked the membership of
+// each listener by linear search.
+//
+// Usage: CoreBenchmark [numberOfListeners]
+
+#include <util/ListenerSlotMap.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using mv::util::ListenerSlotMap;
+
+
+namespace
+{
+    struct Listener
+    {
+        std::set<std::uint32_t> eventTypes;
+        std::uint32_t           numberOfCalls = 0;
+    };
+
+    constexpr std::uint32_t eventType{ 1 };
+    constexpr int numberOfEvents{ 100 };
+
+
+    void benchmarkDispatch(const std::size_t numberOfListeners)
+    {
+        std::vector<Listener> storage(numberOfListeners);
+
+        for (std::size_t listenerIndex = 0; listenerIndex < numberOfListeners; ++listenerIndex)
+            storage[listenerIndex].eventTypes = { (listenerIndex % 100 == 0) ? eventType : 0u };
+
+        const auto callListener = [](Listener* listener) {
+            if (listener->eventTypes.count(eventType) > 0)
+                ++listener->numberOfCalls;
+        };
+
+        // Before: vector registry
+        std::vector<Listener*> vectorListeners;
+
+        for (auto& listener : storage)
+            vectorListeners.push_back(&listener);
+
+        // Quadratic in the number of listeners, so a single event is timed
+        const auto vectorStart = std::chrono::steady_clock::now();
+        {
+            const auto eventListeners = vectorListeners;
+
+            for (auto listener : eventListeners)
+                if (std::find(vectorListeners.begin(), vectorListeners.end(), listener) != vectorListeners.end())
+                    callListener(listener);
+        }
+        const std::chrono::duration<double, std::micro> vectorDuration = std::chrono::steady_clock::now() - vectorStart;
+
+        // After: slot map, bucketed by event type
+        ListenerSlotMap<Listener> listeners;
+
+        for (auto& listener : storage)
+            listeners.insert(&listener, listener.eventTypes);
+
+        const auto slotMapStart = std::chrono::steady_clock::now();
+
+        for (int eventIndex = 0; eventIndex < numberOfEvents; ++eventIndex)
+            listeners.dispatch(eventType, callListener);
+
+        const std::chrono::duration<double, std::micro> slotMapDuration = (std::chrono::steady_clock::now() - slotMapStart) / numberOfEvents;
+
+        std::cout << "Dispatch to " << numberOfListeners << " listeners, vector: " << vectorDuration.count() << " us, slot map: " << slotMapDuration.count() << " us per event" << std::endl;
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    const std::size_t numberOfListeners = (argc > 1) ? std::stoull(argv[1]) : 50'000;
+
+    if (numberOfListeners == 0)
+    {
+        std::cerr << "The number of listeners should be greater than zero" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    benchmarkDispatch(numberOfListeners);
+
+    return EXIT_SUCCESS;
+}
@@ -11,11 +11,13 @@
 #include "Dataset.h"
 
 #include <unordered_map>
+#include <utility>
 
 namespace mv
 {
 
-EventListener::EventListener()
+EventListener::EventListener() :
+    _isDatasetSpecific(false)
 {
     core()->getEventManager().registerEventListener(this);
 }
@@ -32,17 +34,67 @@ bool EventListener::isEventTypeSupported(std::uint32_t eventType) const
 
 void EventListener::addSupportedEventType(std::uint32_t eventType)
 {
-    _supportEventTypes << eventType;
+    updateSupportedEventTypes([eventType](QSet<std::uint32_t>& eventTypes) -> void {
+        eventTypes << eventType;
+    });
 }
 
 void EventListener::removeSupportedEventType(std::uint32_t eventType)
 {
-    _supportEventTypes.remove(eventType);
+    updateSupportedEventTypes([eventType](QSet<std::uint32_t>& eventTypes) -> void {
+        eventTypes.remove(eventType);
+    });
 }
 
 void EventListener::setSupportedEventTypes(const QSet<std::uint32_t>& eventTypes)
 {
-    _supportEventTypes = eventTypes;
+    updateSupportedEventTypes([&eventTypes](QSet<std::uint32_t>& supportedEventTypes) -> void {
+        supportedEventTypes = eventTypes;
+    });
+}
+
+const QSet<std::uint32_t>& EventListener::getSupportedEventTypes() const
+{
+    return _supportEventTypes;
+}
+
+void EventListener::updateSupportedEventTypes(const std::function<void(QSet<std::uint32_t>&)>& function)
+{
+    auto supportedEventTypes = _supportEventTypes;
+
+    function(supportedEventTypes);
+
+    if (supportedEventTypes == _supportEventTypes)
+        return;
+
+    // The event manager buckets the listeners by event type
+    const auto previousEventTypes = std::exchange(_supportEventTypes, std::move(supportedEventTypes));
+
+    core()->getEventManager().updateEventListener(this, previousEventTypes);
+}
+
+void EventListener::setDatasetId(const QString& datasetId)
+{
+    if (_isDatasetSpecific && datasetId == _datasetId)
+        return;
+
+    // Re-register, so that the event manager files the listener under the new dataset
+    core()->getEventManager().unregisterEventListener(this);
+
+    _datasetId          = datasetId;
+    _isDatasetSpecific  = true;
+
+    core()->getEventManager().registerEventListener(this);
+}
+
+const QString& EventListener::getDatasetId() const
+{
+    return _datasetId;
+}
+
+bool EventListener::isDatasetSpecific() const
+{
+    return _isDatasetSpecific;
 }
 
 //void EventListener::registerDataEventByName(QString dataSetName, DataEventHandler callback)
@@ -6,6 +6,8 @@
 
 #include "DataType.h"
 
+#include "util/ListenerSlotMap.h"
+
 #include <QSet>
 
 #include <unordered_map>
@@ -66,6 +68,24 @@ public: // Event filtering
      */
     void setSupportedEventTypes(const QSet<std::uint32_t>& eventTypes);
 
+    /** Get the event types this listener listens to */
+    const QSet<std::uint32_t>& getSupportedEventTypes() const;
+
+public: // Dataset subscription
+
+    /**
+     * Restricts the listener to the events of a single dataset, so that the event manager only delivers
+     * the events of that dataset to it (an empty identifier means that no dataset events are delivered at all)
+     * @param datasetId Globally unique identifier of the dataset
+     */
+    void setDatasetId(const QString& datasetId);
+
+    /** Get the globally unique identifier of the dataset the listener is restricted to (empty when not restricted) */
+    const QString& getDatasetId() const;
+
+    /** Get whether the listener is restricted to the events of a single dataset */
+    bool isDatasetSpecific() const;
+
 private:
 
     /**
@@ -74,10 +94,20 @@ private:
      */
     void onDataEvent(DatasetEvent* dataEvent);
 
+    /**
+     * Changes the supported event types by \p function, and updates the registration of the listener when they changed,
+     * so that the event manager files the listener under the right event types
+     * @param function Function that modifies the supported event types
+     */
+    void updateSupportedEventTypes(const std::function<void(QSet<std::uint32_t>&)>& function);
+
     std::unordered_map<QString, DataEventHandler>   _dataEventHandlersById;         /** Data event handlers by dataset globally unique identifier */
     std::unordered_map<DataType, DataEventHandler>  _dataEventHandlersByType;       /** Data event handlers by data type */
     std::vector<DataEventHandler>                   _dataEventHandlers;             /** Non-specific Data event handlers */
     QSet<std::uint32_t>                             _supportEventTypes;             /** Event types this listener should listen to (will listen to all if left empty) */
+    QString                                         _datasetId;                     /** Globally unique identifier of the dataset the listener is restricted to */
+    bool                                            _isDatasetSpecific;             /** Whether the listener is restricted to the events of a single dataset */
+    util::ListenerSlotMap<EventListener>::Handle    _eventManagerHandle;            /** Handle of the listener in the event manager registry */
 
     friend class AbstractEventManager;
 };
@@ -31,6 +31,8 @@ void BufferObject::bind()
 void BufferObject::destroy()
 {
     glDeleteBuffers(1, &_object);
+
+    _size = 0;
 }
 
 } // namespace mv
@@ -19,15 +19,61 @@ public:
 
     void create();
     void bind();
+
+    /**
+     * Uploads all of \p data to the (bound) buffer, re-allocating the buffer storage. Since the previous
+     * storage is orphaned, this does not wait for draw calls that still use the previous contents.
+     * @param data Data to upload
+     * @param usage Usage hint, GL_DYNAMIC_DRAW for buffers that are partially updated frequently
+     */
+    template<typename T>
+    void setData(const std::vector<T>& data, GLenum usage = GL_STATIC_DRAW)
+    {
+        _size = data.size() * sizeof(T);
+
+        glBufferData(GL_ARRAY_BUFFER, _size, data.data(), usage);
+    }
+
+    /**
+     * Uploads \p count elements of \p data, starting at element \p offset, to the (bound) buffer without
+     * re-allocating the buffer storage. The range must lie within the data of the last setData(...) call.
+     * @param data Data of which a range is uploaded (same element type and size as the last setData(...) call)
+     * @param offset Index of the first element to upload
+     * @param count Number of elements to upload
+     */
+    template<typename T>
+    void setSubData(const std::vector<T>& data, std::size_t offset, std::size_t count)
+    {
+        setSubData(data.data() + offset, offset, count);
+    }
+
+    /**
+     * Uploads the \p count elements at \p data to the (bound) buffer at element \p offset without
+     * re-allocating the buffer storage. The range must lie within the data of the last setData(...) call.
+     * @param data Pointer to the first element to upload
+     * @param offset Index of the element in the buffer at which the data is stored
+     * @param count Number of elements to upload
+     */
     template<typename T>
-    void setData(const std::vector<T>& data)
+    void setSubData(const T* data, std::size_t offset, std::size_t count)
     {
-        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(T), data.data(), GL_STATIC_DRAW);
+        Q_ASSERT((offset + count) * sizeof(T) <= _size);
+
+        if (count == 0)
+            return;
+
+        glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(T), count * sizeof(T), data);
+    }
+
+    /** Get the size of the buffer storage in bytes */
+    std::size_t getSize() const {
+        return _size;
     }
 
     void destroy();
 private:
-    GLuint _object;
+    GLuint          _object;
+    std::size_t     _size = 0;      /** Size of the buffer storage in bytes */
 };
 
 } // namespace mv
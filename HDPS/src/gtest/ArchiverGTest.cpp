@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <private/Archiver.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QTemporaryDir>
+
+#include <cstdint>
+#include <random>
+
+using mv::util::Archiver;
+
+
+namespace
+{
+    // Compressible (pseudo) random content.
+    QByteArray generateContent(const qsizetype size, const std::uint32_t seed)
+    {
+        std::mt19937 randomNumberEngine(seed);
+        std::uniform_int_distribution<int> distribution('a', 'h');
+
+        QByteArray content(size, '\0');
+
+        for (auto& byte : content)
+        {
+            byte = static_cast<char>(distribution(randomNumberEngine));
+        }
+        return content;
+    }
+
+
+    // Files of the source directory, by path relative to the directory.
+    QMap<QString, QByteArray> createSourceFiles(const QString& directoryPath)
+    {
+        QMap<QString, QByteArray> files;
+
+        // An empty file, many small files, and a file that is deflated in several chunks.
+        files["empty.bin"] = QByteArray();
+
+        for (std::uint32_t fileIndex = 0; fileIndex < 20; ++fileIndex)
+        {
+            files[QString("small/%1.json").arg(fileIndex)] = generateContent(1000 + 37 * fileIndex, fileIndex);
+        }
+
+        files["large/data.bin"] = generateContent(40 * 1024 * 1024 + 3, 42);
+
+        for (auto it = files.cbegin(); it != files.cend(); ++it)
+        {
+            const auto filePath = QDir(directoryPath).absoluteFilePath(it.key());
+
+            QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+            QFile file(filePath);
+
+            if (file.open(QIODevice::WriteOnly))
+            {
+                file.write(it.value());
+            }
+        }
+        return files;
+    }
+
+
+    void expectRoundTrip(const std::uint32_t numberOfThreads, const std::int32_t compressionLevel)
+    {
+        QTemporaryDir sourceDirectory;
+        QTemporaryDir archiveDirectory;
+        QTemporaryDir destinationDirectory;
+
+        ASSERT_TRUE(sourceDirectory.isValid() && archiveDirectory.isValid() && destinationDirectory.isValid());
+
+        const auto files = createSourceFiles(sourceDirectory.path());
+        const auto archiveFilePath = archiveDirectory.filePath("archive.zip");
+
+        Archiver archiver;
+
+        archiver.setNumberOfThreads(numberOfThreads);
+        archiver.compressDirectory(sourceDirectory.path(), archiveFilePath, true, compressionLevel);
+        archiver.decompress(archiveFilePath, destinationDirectory.path());
+
+        for (auto it = files.cbegin(); it != files.cend(); ++it)
+        {
+            QFile file(QDir(destinationDirectory.path()).absoluteFilePath(it.key()));
+
+            ASSERT_TRUE(file.open(QIODevice::ReadOnly)) << it.key().toStdString();
+            EXPECT_EQ(file.readAll(), it.value()) << it.key().toStdString();
+        }
+
+        // No temporary (spool) files are left next to the archive.
+        EXPECT_EQ(QDir(archiveDirectory.path()).entryList(QDir::Files), QStringList({ "archive.zip" }));
+    }
+}
+
+
+TEST(Archiver, roundTripSequentially)
+{
+    expectRoundTrip(1, 6);
+}
+
+
+TEST(Archiver, roundTripConcurrently)
+{
+    expectRoundTrip(4, 6);
+}
+
+
+TEST(Archiver, roundTripWithoutCompression)
+{
+    expectRoundTrip(4, 0);
+}
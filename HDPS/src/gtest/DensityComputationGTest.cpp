@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <util/DensityComputation.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using mv::Bounds;
+using mv::DensityComputation;
+using mv::Vector2f;
+
+
+namespace
+{
+    // Sums the truncated Gaussian of each point at the grid cell centers, like the splats on the GPU.
+    std::vector<double> computeReferenceDensityMap(const std::vector<Vector2f>& points, const std::uint32_t resolution, const float sigma, const float kernelSupport)
+    {
+        const auto standardDeviation    = sigma / 3.0 * resolution / 2.0;
+        const auto peakValue            = 1000.0 / (2.0 * 3.1415926535 * (32.0 / 6.0) * (32.0 / 6.0));
+
+        std::vector<double> densityMap(resolution * resolution, 0.0);
+
+        for (std::uint32_t row = 0; row < resolution; ++row) {
+            for (std::uint32_t column = 0; column < resolution; ++column) {
+                for (const auto& point : points) {
+                    const auto dx = column - ((point.x + 1.0) / 2.0 * resolution - 0.5);
+                    const auto dy = row - ((point.y + 1.0) / 2.0 * resolution - 0.5);
+
+                    if (std::abs(dx) <= kernelSupport * standardDeviation && std::abs(dy) <= kernelSupport * standardDeviation)
+                        densityMap[row * resolution + column] += peakValue * std::exp(-(dx * dx + dy * dy) / (2.0 * standardDeviation * standardDeviation));
+                }
+            }
+        }
+
+        return densityMap;
+    }
+}
+
+
+TEST(DensityComputation, cpuDensityMapMatchesGaussianSum)
+{
+    std::mt19937 randomNumberEngine;
+    std::normal_distribution<float> distribution(0.0f, 0.3f);
+
+    std::vector<Vector2f> points(200);
+
+    for (auto& point : points)
+        point = Vector2f(distribution(randomNumberEngine), distribution(randomNumberEngine));
+
+    for (const std::uint32_t resolution : { 64, 128 })
+    {
+        for (const float kernelSupport : { 3.0f, 5.0f })
+        {
+            const auto densityMap           = DensityComputation::computeDensityMap(points, Bounds(-1, 1, -1, 1), resolution, 0.15f, kernelSupport);
+            const auto referenceDensityMap  = computeReferenceDensityMap(points, resolution, 0.15f, kernelSupport);
+
+            ASSERT_EQ(densityMap.size(), referenceDensityMap.size());
+
+            const auto maximumDensity = *std::max_element(referenceDensityMap.begin(), referenceDensityMap.end());
+
+            // Linear binning is accurate when the kernel is wider than a grid cell
+            for (std::size_t cellIndex = 0; cellIndex < densityMap.size(); ++cellIndex)
+                EXPECT_NEAR(densityMap[cellIndex], referenceDensityMap[cellIndex], 0.05 * maximumDensity);
+        }
+    }
+}
+
+
+TEST(DensityComputation, computeOnCpuWithoutOpenGLContext)
+{
+    const std::vector<Vector2f> points{ { 0.0f, 0.0f }, { 0.5f, 0.5f } };
+
+    DensityComputation densityComputation;
+
+    densityComputation.setData(&points);
+    densityComputation.setBounds(-1, 1, -1, 1);
+    densityComputation.setResolution(256);
+
+    // Without OpenGL context, compute() does not silently fall back to the CPU
+    densityComputation.compute();
+
+    EXPECT_TRUE(densityComputation.getDensityMap().empty());
+
+    densityComputation.computeOnCpu();
+
+    ASSERT_EQ(densityComputation.getDensityMap().size(), 256 * 256);
+    EXPECT_EQ(densityComputation.getNumPoints(), points.size());
+    EXPECT_FLOAT_EQ(densityComputation.getMaxDensity(), *std::max_element(densityComputation.getDensityMap().begin(), densityComputation.getDensityMap().end()));
+    EXPECT_GT(densityComputation.getMaxDensity(), 0.0f);
+}
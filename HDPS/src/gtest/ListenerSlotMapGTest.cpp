@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <util/ListenerSlotMap.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+using namespace mv::util;
+
+
+namespace
+{
+    struct Listener
+    {
+        std::set<std::uint32_t> eventTypes;
+        std::uint32_t           numberOfCalls = 0;
+    };
+
+    using Listeners = ListenerSlotMap<Listener>;
+}
+
+
+TEST(ListenerSlotMap, recognizesStaleHandles)
+{
+    Listeners listeners;
+    Listener first, second;
+
+    const auto firstHandle = listeners.insert(&first, std::vector<std::uint32_t>{ 1 });
+
+    EXPECT_EQ(listeners.get(firstHandle), &first);
+
+    listeners.erase(firstHandle);
+
+    // The slot is reused, with a new generation
+    const auto secondHandle = listeners.insert(&second, std::vector<std::uint32_t>{ 1 });
+
+    EXPECT_EQ(secondHandle._index, firstHandle._index);
+    EXPECT_EQ(listeners.get(firstHandle), nullptr);
+    EXPECT_EQ(listeners.get(secondHandle), &second);
+
+    listeners.erase(firstHandle);
+
+    EXPECT_EQ(listeners.size(), 1u);
+
+    listeners.dispatch(1, [](Listener* listener) { ++listener->numberOfCalls; });
+
+    EXPECT_EQ(first.numberOfCalls, 0u);
+    EXPECT_EQ(second.numberOfCalls, 1u);
+}
+
+
+TEST(ListenerSlotMap, supportsRegistrationDuringDispatch)
+{
+    Listeners listeners;
+    std::vector<Listener> storage(4);
+    std::vector<Listeners::Handle> handles;
+
+    for (auto& listener : storage)
+        handles.push_back(listeners.insert(&listener, std::vector<std::uint32_t>{ 2 }));
+
+    Listener inserted;
+
+    // The first listener removes the second one and inserts another one
+    listeners.dispatch(2, [&](Listener* listener) {
+        ++listener->numberOfCalls;
+
+        if (listener == &storage[0]) {
+            listeners.erase(handles[1]);
+            listeners.insert(&inserted, std::vector<std::uint32_t>{ 2 });
+        }
+    });
+
+    EXPECT_EQ(storage[0].numberOfCalls, 1u);
+    EXPECT_EQ(storage[1].numberOfCalls, 0u);
+    EXPECT_EQ(storage[2].numberOfCalls, 1u);
+    EXPECT_EQ(storage[3].numberOfCalls, 1u);
+    EXPECT_EQ(inserted.numberOfCalls, 0u);
+
+    // Listeners are only called for the event types they are inserted with
+    listeners.dispatch(3, [](Listener* listener) { ++listener->numberOfCalls; });
+    listeners.dispatch(2, [](Listener* listener) { ++listener->numberOfCalls; });
+
+    EXPECT_EQ(storage[1].numberOfCalls, 0u);
+    EXPECT_EQ(storage[2].numberOfCalls, 2u);
+    EXPECT_EQ(inserted.numberOfCalls, 1u);
+}
+
+
+
+TEST(ListenerSlotMap, updatesEventTypesInPlace)
+{
+    Listeners listeners;
+    Listener first, second;
+
+    const auto firstHandle  = listeners.insert(&first, std::vector<std::uint32_t>{ 2 });
+    const auto secondHandle = listeners.insert(&second, std::vector<std::uint32_t>{ 2 });
+
+    // Adding an event type during dispatch keeps the listener in the current dispatch
+    listeners.dispatch(2, [&](Listener* listener) {
+        ++listener->numberOfCalls;
+
+        if (listener == &first)
+            listeners.addEventTypes(secondHandle, std::vector<std::uint32_t>{ 3 });
+    });
+
+    EXPECT_EQ(first.numberOfCalls, 1u);
+    EXPECT_EQ(second.numberOfCalls, 1u);
+    EXPECT_EQ(listeners.get(secondHandle), &second);
+
+    // Removing an event type during dispatch skips the listener for that event type only
+    listeners.dispatch(2, [&](Listener* listener) {
+        ++listener->numberOfCalls;
+
+        if (listener == &first)
+            listeners.removeEventTypes(secondHandle, std::vector<std::uint32_t>{ 2 });
+    });
+
+    EXPECT_EQ(first.numberOfCalls, 2u);
+    EXPECT_EQ(second.numberOfCalls, 1u);
+
+    listeners.dispatch(3, [](Listener* listener) { ++listener->numberOfCalls; });
+
+    EXPECT_EQ(first.numberOfCalls, 2u);
+    EXPECT_EQ(second.numberOfCalls, 2u);
+
+    // The handles stay valid, and removal still removes all entries of the listener
+    EXPECT_EQ(listeners.get(firstHandle), &first);
+
+    listeners.erase(secondHandle);
+
+    listeners.dispatch(3, [](Listener* listener) { ++listener->numberOfCalls; });
+
+    EXPECT_EQ(second.numberOfCalls, 2u);
+    EXPECT_EQ(listeners.size(), 1u);
+}
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <util/MeanShift.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using mv::MeanShift;
+using mv::Vector2f;
+
+
+namespace
+{
+    // Merges the peaks like the original nested loop over all cluster centers.
+    std::vector<int> mergeClusterCentersByLinearSearch(const std::vector<Vector2f>& meanShiftMap, const float epsilon, std::vector<Vector2f>& clusterCenters)
+    {
+        std::vector<int> clusterIds(meanShiftMap.size(), -1);
+
+        clusterCenters.clear();
+
+        for (std::size_t pixelIndex = 0; pixelIndex < meanShiftMap.size(); ++pixelIndex) {
+            const auto& center = meanShiftMap[pixelIndex];
+
+            if (center.sqrMagnitude() < 0.0001f)
+                continue;
+
+            const auto it = std::find_if(clusterCenters.begin(), clusterCenters.end(), [&](const Vector2f& clusterCenter) {
+                return std::abs(center.x - clusterCenter.x) < epsilon && std::abs(center.y - clusterCenter.y) < epsilon;
+            });
+
+            if (it == clusterCenters.end()) {
+                clusterIds[pixelIndex] = static_cast<int>(clusterCenters.size());
+                clusterCenters.push_back(center);
+            }
+            else {
+                clusterIds[pixelIndex] = static_cast<int>(it - clusterCenters.begin());
+            }
+        }
+
+        return clusterIds;
+    }
+}
+
+
+TEST(MeanShift, spatialHashMergesLikeLinearSearch)
+{
+    std::mt19937 randomNumberEngine;
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+    std::vector<Vector2f> meanShiftMap(20'000);
+
+    for (auto& center : meanShiftMap)
+        center = distribution(randomNumberEngine) < 0.1f ? Vector2f(0.0f, 0.0f) : Vector2f(distribution(randomNumberEngine), distribution(randomNumberEngine));
+
+    for (const float epsilon : { 2.0f / 256, 0.05f })
+    {
+        std::vector<Vector2f> clusterCenters, expectedClusterCenters;
+
+        const auto clusterIds           = MeanShift::mergeClusterCenters(meanShiftMap, epsilon, clusterCenters);
+        const auto expectedClusterIds   = mergeClusterCentersByLinearSearch(meanShiftMap, epsilon, expectedClusterCenters);
+
+        EXPECT_EQ(clusterIds, expectedClusterIds);
+        EXPECT_EQ(clusterCenters.size(), expectedClusterCenters.size());
+    }
+}
+
+
+TEST(MeanShift, clustersSeparatedBlobsWithoutOpenGLContext)
+{
+    std::mt19937 randomNumberEngine;
+    std::normal_distribution<float> distribution(0.0f, 0.05f);
+
+    const std::vector<Vector2f> blobCenters{ { -0.5f, -0.5f }, { 0.5f, -0.4f }, { 0.0f, 0.5f } };
+
+    std::vector<Vector2f> points;
+
+    for (const auto& blobCenter : blobCenters)
+        for (int pointIndex = 0; pointIndex < 1000; ++pointIndex)
+            points.emplace_back(blobCenter.x + distribution(randomNumberEngine), blobCenter.y + distribution(randomNumberEngine));
+
+    MeanShift meanShift;
+
+    meanShift.setData(&points);
+
+    std::vector<std::vector<unsigned int>> clusters;
+
+    meanShift.cluster(points, clusters);
+
+    ASSERT_EQ(clusters.size(), blobCenters.size());
+
+    for (const auto& cluster : clusters) {
+        ASSERT_FALSE(cluster.empty());
+
+        // All points of a cluster come from the same blob
+        const auto blobIndex = cluster.front() / 1000;
+
+        EXPECT_TRUE(std::all_of(cluster.begin(), cluster.end(), [blobIndex](unsigned int pointIndex) { return pointIndex / 1000 == blobIndex; }));
+        EXPECT_EQ(cluster.size(), 1000);
+    }
+}
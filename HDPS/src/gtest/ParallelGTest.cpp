@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <util/Parallel.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace mv::util;
+
+
+TEST(Parallel, rangesCoverEachItemOnce)
+{
+    for (const std::size_t count : { 0, 1, 7, 1'000, 100'003 })
+    {
+        for (const std::size_t numberOfRanges : { 0, 1, 3, 64, 1'000'000 })
+        {
+            std::vector<std::uint8_t> visits(count, 0);
+            std::atomic<std::size_t> numberOfCalls{};
+
+            parallelFor(count, numberOfRanges, [&](std::size_t begin, std::size_t end) -> void {
+                EXPECT_LT(begin, end);
+
+                for (auto index = begin; index < end; ++index)
+                    ++visits[index];
+
+                ++numberOfCalls;
+            });
+
+            EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), static_cast<std::ptrdiff_t>(count));
+            EXPECT_EQ(numberOfCalls, count == 0 ? 0 : std::clamp<std::size_t>(numberOfRanges, 1, count));
+        }
+    }
+}
+
+
+TEST(Parallel, forEachVisitsEachIndexOnce)
+{
+    std::vector<std::uint8_t> visits(1'000, 0);
+
+    parallelForEach(visits.size(), [&visits](std::size_t index) -> void {
+        ++visits[index];
+    });
+
+    EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), static_cast<std::ptrdiff_t>(visits.size()));
+}
+
+
+TEST(Parallel, rethrowsOnCallingThread)
+{
+    std::atomic<std::size_t> numberOfProcessedIndices{};
+
+    EXPECT_THROW(parallelForEach(64, [&numberOfProcessedIndices](std::size_t index) -> void {
+        ++numberOfProcessedIndices;
+
+        if (index % 8 == 3)
+            throw std::runtime_error("Failure");
+    }), std::runtime_error);
+
+    // The other indices are processed nevertheless
+    EXPECT_EQ(numberOfProcessedIndices, 64u);
+}
+
+
+TEST(Parallel, usesAtMostOneThreadPerHardwareThread)
+{
+    std::set<std::thread::id> threadIds;
+    std::mutex threadIdsMutex;
+
+    const auto recordThread = [&threadIds, &threadIdsMutex]() -> void {
+        const std::lock_guard<std::mutex> lock(threadIdsMutex);
+
+        threadIds.insert(std::this_thread::get_id());
+    };
+
+    // Many more items (and ranges) than hardware threads
+    parallelForEach(10'000, [&recordThread](std::size_t) -> void { recordThread(); });
+    parallelFor(10'000, 10'000, [&recordThread](std::size_t, std::size_t) -> void { recordThread(); });
+
+    // Each of the two calls uses at most one thread per hardware thread
+    EXPECT_LE(threadIds.size(), 2 * getNumberOfHardwareThreads());
+}
+
+
+TEST(Parallel, numberOfRangesRespectsMinimumRangeSize)
+{
+    EXPECT_EQ(getNumberOfParallelRanges(0, 16), 0u);
+    EXPECT_EQ(getNumberOfParallelRanges(15, 16), 1u);
+    EXPECT_EQ(getNumberOfParallelRanges(std::size_t(1) << 40, 16), getNumberOfHardwareThreads());
+    EXPECT_GE(getNumberOfHardwareThreads(), 1u);
+}
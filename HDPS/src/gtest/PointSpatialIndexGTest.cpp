@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <renderers/PointSpatialIndex.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <vector>
+
+using mv::Bounds;
+using mv::Vector2f;
+using mv::gui::PointSpatialIndex;
+
+
+namespace
+{
+    std::vector<Vector2f> generateRandomPositions(std::mt19937& randomNumberEngine, const std::size_t numberOfPositions)
+    {
+        std::normal_distribution<float> distribution;
+
+        std::vector<Vector2f> positions(numberOfPositions);
+
+        for (auto& position : positions)
+            position = Vector2f(distribution(randomNumberEngine), 3 * distribution(randomNumberEngine));
+
+        return positions;
+    }
+
+
+    std::set<std::uint32_t> getPointIndices(const PointSpatialIndex& spatialIndex, const std::vector<PointSpatialIndex::Range>& ranges)
+    {
+        std::set<std::uint32_t> pointIndices;
+
+        for (const auto& [begin, end] : ranges)
+            for (auto position = begin; position < end; ++position)
+                pointIndices.insert(spatialIndex.getOrder()[position]);
+
+        return pointIndices;
+    }
+
+
+    std::size_t getNumberOfPoints(const std::vector<PointSpatialIndex::Range>& ranges)
+    {
+        std::size_t numberOfPoints = 0;
+
+        for (const auto& [begin, end] : ranges)
+            numberOfPoints += end - begin;
+
+        return numberOfPoints;
+    }
+}
+
+
+TEST(PointSpatialIndex, isInvalidWithoutPoints)
+{
+    PointSpatialIndex spatialIndex;
+    spatialIndex.build({});
+
+    EXPECT_FALSE(spatialIndex.isValid());
+    EXPECT_TRUE(spatialIndex.getRanges(Bounds(-1, 1, -1, 1), PointSpatialIndex::NUMBER_OF_LEVELS).empty());
+}
+
+
+TEST(PointSpatialIndex, orderIsPermutation)
+{
+    std::mt19937 randomNumberEngine;
+
+    const auto positions = generateRandomPositions(randomNumberEngine, 100'000);
+
+    PointSpatialIndex spatialIndex;
+    spatialIndex.build(positions);
+
+    ASSERT_EQ(spatialIndex.getNumberOfPoints(), positions.size());
+
+    for (std::uint32_t pointIndex = 0; pointIndex < positions.size(); ++pointIndex)
+        EXPECT_EQ(spatialIndex.getOrder()[spatialIndex.getInverseOrder()[pointIndex]], pointIndex);
+
+    EXPECT_EQ(spatialIndex.reorder(positions)[spatialIndex.getInverseOrder()[123]], positions[123]);
+}
+
+
+TEST(PointSpatialIndex, rangesContainAllPointsInsideBounds)
+{
+    std::mt19937 randomNumberEngine;
+
+    for (const std::size_t numberOfPositions : { 1, 100, 100'000 })
+    {
+        const auto positions = generateRandomPositions(randomNumberEngine, numberOfPositions);
+
+        PointSpatialIndex spatialIndex;
+        spatialIndex.build(positions);
+
+        const auto allPointIndices = getPointIndices(spatialIndex, spatialIndex.getRanges(Bounds(-1e9f, 1e9f, -1e9f, 1e9f), PointSpatialIndex::NUMBER_OF_LEVELS - 1));
+
+        EXPECT_EQ(allPointIndices.size(), numberOfPositions);
+
+        const Bounds bounds(0.2f, 1.0f, -1.0f, 2.0f);
+
+        const auto ranges       = spatialIndex.getRanges(bounds, PointSpatialIndex::NUMBER_OF_LEVELS - 1);
+        const auto pointIndices = getPointIndices(spatialIndex, ranges);
+
+        for (std::uint32_t pointIndex = 0; pointIndex < positions.size(); ++pointIndex) {
+            const auto& position = positions[pointIndex];
+
+            if (position.x >= bounds.getLeft() && position.x <= bounds.getRight() && position.y >= bounds.getBottom() && position.y <= bounds.getTop())
+                EXPECT_EQ(pointIndices.count(pointIndex), 1);
+        }
+
+        std::uint64_t numberOfPoints = 0;
+
+        for (const auto numberOfPointsInLevel : spatialIndex.getNumberOfPointsPerLevel(bounds))
+            numberOfPoints += numberOfPointsInLevel;
+
+        EXPECT_EQ(numberOfPoints, pointIndices.size());
+    }
+}
+
+
+TEST(PointSpatialIndex, coarseLevelsHoldFewerPoints)
+{
+    std::mt19937 randomNumberEngine;
+
+    const auto positions = generateRandomPositions(randomNumberEngine, 1'000'000);
+
+    PointSpatialIndex spatialIndex;
+    spatialIndex.build(positions);
+
+    const Bounds bounds(-1e9f, 1e9f, -1e9f, 1e9f);
+
+    std::size_t previousNumberOfPoints = 0;
+
+    for (std::uint32_t level = 0; level < PointSpatialIndex::NUMBER_OF_LEVELS; ++level) {
+        const auto numberOfPoints = getNumberOfPoints(spatialIndex.getRanges(bounds, level));
+
+        EXPECT_GE(numberOfPoints, previousNumberOfPoints);
+
+        previousNumberOfPoints = numberOfPoints;
+    }
+
+    EXPECT_LT(getNumberOfPoints(spatialIndex.getRanges(bounds, 2)), positions.size() / 2);
+    EXPECT_EQ(previousNumberOfPoints, positions.size());
+}
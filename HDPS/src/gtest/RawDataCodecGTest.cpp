@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <util/RawDataCodec.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using mv::util::RawDataCodec;
+
+
+namespace
+{
+    // Encodes and decodes the specified bytes, and expects the decoded bytes to be equal to the original ones.
+    void expectRoundTrip(const RawDataCodec rawDataCodec, const std::vector<char>& bytes, const std::uint32_t elementSize)
+    {
+        const auto encodedBytes = mv::util::encodeRawData(rawDataCodec, bytes.data(), bytes.size(), elementSize);
+
+        std::vector<char> decodedBytes(bytes.size());
+
+        mv::util::decodeRawData(rawDataCodec, encodedBytes.data(), encodedBytes.size(), decodedBytes.data(), decodedBytes.size(), elementSize);
+
+        EXPECT_EQ(decodedBytes, bytes);
+    }
+
+
+    std::vector<char> toBytes(const std::vector<float>& values)
+    {
+        std::vector<char> bytes(values.size() * sizeof(float));
+        std::memcpy(bytes.data(), values.data(), bytes.size());
+        return bytes;
+    }
+}
+
+
+TEST(RawDataCodec, codecNamesRoundTrip)
+{
+    for (const auto& name : mv::util::getRawDataCodecNames())
+        EXPECT_EQ(mv::util::getRawDataCodecName(mv::util::getRawDataCodec(name)), name);
+
+    EXPECT_THROW(mv::util::getRawDataCodec("Unknown"), std::runtime_error);
+}
+
+
+TEST(RawDataCodec, roundTripsRandomAndSmoothData)
+{
+    std::mt19937 randomNumberEngine;
+    std::normal_distribution<float> distribution;
+
+    for (const std::size_t numberOfValues : { 0, 1, 7, 1000, 3'000'000 })
+    {
+        std::vector<float> randomValues(numberOfValues), smoothValues(numberOfValues);
+
+        for (std::size_t valueIndex = 0; valueIndex < numberOfValues; ++valueIndex) {
+            randomValues[valueIndex] = distribution(randomNumberEngine);
+            smoothValues[valueIndex] = std::sin(valueIndex * 0.001f);
+        }
+
+        for (const auto rawDataCodec : { RawDataCodec::None, RawDataCodec::ShuffleLz4 }) {
+            for (const std::uint32_t elementSize : { 1, 2, 4 }) {
+                expectRoundTrip(rawDataCodec, toBytes(randomValues), elementSize);
+                expectRoundTrip(rawDataCodec, toBytes(smoothValues), elementSize);
+            }
+        }
+    }
+}
+
+
+TEST(RawDataCodec, compressesRedundantData)
+{
+    const std::vector<float> values(1'000'000, 1.0f);
+    const auto bytes = toBytes(values);
+
+    const auto encodedBytes = mv::util::encodeRawData(RawDataCodec::ShuffleLz4, bytes.data(), bytes.size(), sizeof(float));
+
+    EXPECT_LT(encodedBytes.size(), bytes.size() / 100);
+
+    expectRoundTrip(RawDataCodec::ShuffleLz4, bytes, sizeof(float));
+}
+
+
+TEST(RawDataCodec, throwsOnCorruptData)
+{
+    const std::vector<float> values(10'000, 1.0f);
+    const auto bytes = toBytes(values);
+
+    auto encodedBytes = mv::util::encodeRawData(RawDataCodec::ShuffleLz4, bytes.data(), bytes.size(), sizeof(float));
+    encodedBytes.resize(encodedBytes.size() / 2);
+
+    std::vector<char> decodedBytes(bytes.size());
+
+    EXPECT_THROW(mv::util::decodeRawData(RawDataCodec::ShuffleLz4, encodedBytes.data(), encodedBytes.size(), decodedBytes.data(), decodedBytes.size(), sizeof(float)), std::runtime_error);
+}
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <util/ScalarStatistics.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace mv::util;
+
+
+TEST(ScalarStatistics, isInvalidForNoValues)
+{
+    const std::vector<float> values{ std::numeric_limits<float>::quiet_NaN() };
+
+    EXPECT_FALSE(computeScalarStatistics(values.data(), 0).isValid());
+    EXPECT_FALSE(computeScalarStatistics(values.data(), values.size()).isValid());
+}
+
+
+TEST(ScalarStatistics, matchesSerialComputation)
+{
+    std::mt19937 randomNumberEngine;
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+    for (const std::size_t numberOfValues : { 3, 1'000, 1'000'000 })
+    {
+        std::vector<float> values(numberOfValues);
+
+        for (auto& value : values)
+            value = distribution(randomNumberEngine);
+
+        values.front() = std::numeric_limits<float>::infinity();
+
+        const auto statistics = computeScalarStatistics(values.data(), values.size(), 1, 10);
+
+        const auto minimum  = *std::min_element(values.cbegin() + 1, values.cend());
+        const auto maximum  = *std::max_element(values.cbegin() + 1, values.cend());
+        const auto mean     = std::accumulate(values.cbegin() + 1, values.cend(), 0.0) / (numberOfValues - 1);
+
+        EXPECT_EQ(statistics.numberOfValues, numberOfValues - 1);
+        EXPECT_EQ(statistics.minimum, minimum);
+        EXPECT_EQ(statistics.maximum, maximum);
+        EXPECT_NEAR(statistics.mean, mean, 1e-3);
+        ASSERT_EQ(statistics.histogram.size(), 10);
+        EXPECT_EQ(std::accumulate(statistics.histogram.cbegin(), statistics.histogram.cend(), std::uint64_t{}), numberOfValues - 1);
+    }
+}
+
+
+TEST(ScalarStatistics, supportsStridedIntegerValues)
+{
+    // Two points with three dimensions (row-major), the statistics are of the second dimension
+    const std::vector<std::int16_t> values{ 3, 1, 2, 5, 9, 4 };
+
+    const auto statistics = computeScalarStatistics(values.data() + 1, 2, 3, ADAPTIVE_NUMBER_OF_BINS);
+
+    EXPECT_EQ(statistics.minimum, 1.0f);
+    EXPECT_EQ(statistics.maximum, 9.0f);
+    EXPECT_EQ(statistics.mean, 5.0);
+    EXPECT_EQ(statistics.histogram.size(), getAdaptiveNumberOfBins(2));
+    EXPECT_EQ(statistics.histogram.front(), 1);
+    EXPECT_EQ(statistics.histogram.back(), 1);
+}
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <util/SelectionBitmap.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+using mv::util::SelectionBitmap;
+
+
+namespace
+{
+    // Generates unsorted indices (possibly with duplicates), either sparse or dense enough to
+    // have both the array and the bitset representation of chunks.
+    std::vector<std::uint32_t> generateRandomIndices(std::mt19937& randomNumberEngine, const std::size_t numberOfIndices)
+    {
+        std::uniform_int_distribution<std::uint32_t> distribution(0, 300'000);
+
+        std::vector<std::uint32_t> indices(numberOfIndices);
+
+        for (auto& index : indices)
+            index = distribution(randomNumberEngine);
+
+        return indices;
+    }
+
+
+    std::vector<std::uint32_t> toSortedUniqueIndices(const std::vector<std::uint32_t>& indices)
+    {
+        const std::set<std::uint32_t> indexSet(indices.cbegin(), indices.cend());
+        return { indexSet.cbegin(), indexSet.cend() };
+    }
+}
+
+
+TEST(SelectionBitmap, isEmptyByDefault)
+{
+    const SelectionBitmap selectionBitmap;
+
+    EXPECT_TRUE(selectionBitmap.isEmpty());
+    EXPECT_EQ(selectionBitmap.count(), 0);
+    EXPECT_TRUE(selectionBitmap.toIndices().empty());
+}
+
+
+TEST(SelectionBitmap, yieldsSortedUniqueIndices)
+{
+    std::mt19937 randomNumberEngine;
+
+    for (const std::size_t numberOfIndices : { 10, 10'000, 200'000 })
+    {
+        const auto indices = generateRandomIndices(randomNumberEngine, numberOfIndices);
+        const auto expectedIndices = toSortedUniqueIndices(indices);
+
+        const SelectionBitmap selectionBitmap(indices);
+
+        EXPECT_EQ(selectionBitmap.toIndices(), expectedIndices);
+        EXPECT_EQ(selectionBitmap.count(), expectedIndices.size());
+
+        SelectionBitmap addedIndices;
+
+        for (const auto index : indices)
+            addedIndices.add(index);
+
+        EXPECT_EQ(addedIndices, selectionBitmap);
+
+        for (std::uint32_t index = 0; index < 1000; ++index)
+            EXPECT_EQ(selectionBitmap.contains(index), std::binary_search(expectedIndices.cbegin(), expectedIndices.cend(), index));
+    }
+}
+
+
+TEST(SelectionBitmap, setOperationsMatchStandardAlgorithms)
+{
+    std::mt19937 randomNumberEngine;
+
+    for (const std::size_t numberOfIndices1 : { 10, 10'000, 200'000 })
+    {
+        for (const std::size_t numberOfIndices2 : { 10, 10'000, 200'000 })
+        {
+            const auto indices1 = toSortedUniqueIndices(generateRandomIndices(randomNumberEngine, numberOfIndices1));
+            const auto indices2 = toSortedUniqueIndices(generateRandomIndices(randomNumberEngine, numberOfIndices2));
+
+            const SelectionBitmap selectionBitmap1(indices1);
+            const SelectionBitmap selectionBitmap2(indices2);
+
+            const auto expectResult = [&](SelectionBitmap result, const auto setAlgorithm)
+            {
+                std::vector<std::uint32_t> expectedIndices;
+                setAlgorithm(indices1.cbegin(), indices1.cend(), indices2.cbegin(), indices2.cend(), std::back_inserter(expectedIndices));
+
+                EXPECT_EQ(result.toIndices(), expectedIndices);
+                EXPECT_EQ(result, SelectionBitmap(expectedIndices));
+            };
+
+            expectResult(SelectionBitmap(selectionBitmap1) |= selectionBitmap2, [](auto... args) { return std::set_union(args...); });
+            expectResult(SelectionBitmap(selectionBitmap1) &= selectionBitmap2, [](auto... args) { return std::set_intersection(args...); });
+            expectResult(SelectionBitmap(selectionBitmap1) -= selectionBitmap2, [](auto... args) { return std::set_difference(args...); });
+            expectResult(SelectionBitmap(selectionBitmap1) ^= selectionBitmap2, [](auto... args) { return std::set_symmetric_difference(args...); });
+        }
+    }
+}
+
+
+TEST(SelectionBitmap, invertYieldsComplementWithinRange)
+{
+    std::mt19937 randomNumberEngine;
+
+    const auto indices = toSortedUniqueIndices(generateRandomIndices(randomNumberEngine, 100'000));
+
+    constexpr std::uint32_t size{ 250'000 };
+
+    auto selectionBitmap = SelectionBitmap(indices);
+    selectionBitmap.invert(size);
+
+    std::vector<std::uint32_t> expectedIndices;
+
+    for (std::uint32_t index = 0; index < size; ++index)
+        if (!std::binary_search(indices.cbegin(), indices.cend(), index))
+            expectedIndices.push_back(index);
+
+    EXPECT_EQ(selectionBitmap.toIndices(), expectedIndices);
+
+    selectionBitmap.invert(size);
+    EXPECT_EQ(selectionBitmap, SelectionBitmap(std::vector<std::uint32_t>(indices.cbegin(), std::lower_bound(indices.cbegin(), indices.cend(), size))));
+}
+
+
+TEST(SelectionBitmap, fromRangeContainsAllIndicesInRange)
+{
+    for (const auto& [begin, end] : { std::pair<std::uint32_t, std::uint32_t>{ 0, 0 }, { 3, 4 }, { 100, 5000 }, { 65'530, 200'007 } })
+    {
+        std::vector<std::uint32_t> expectedIndices(end - begin);
+        std::iota(expectedIndices.begin(), expectedIndices.end(), begin);
+
+        const auto selectionBitmap = SelectionBitmap::fromRange(begin, end);
+
+        EXPECT_EQ(selectionBitmap.toIndices(), expectedIndices);
+        EXPECT_EQ(selectionBitmap, SelectionBitmap(expectedIndices));
+    }
+}
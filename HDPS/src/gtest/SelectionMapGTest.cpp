@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <LinkedData.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using mv::SelectionMap;
+
+
+namespace
+{
+    // Random mapping, in which some source points have no mapping and some have an empty mapping.
+    SelectionMap::Map generateRandomMap(const std::uint32_t numberOfSourcePoints, const std::uint32_t numberOfTargetPoints)
+    {
+        std::mt19937 randomNumberEngine;
+        std::uniform_int_distribution<std::uint32_t> numberOfTargetIndicesDistribution(0, 4);
+        std::uniform_int_distribution<std::uint32_t> targetIndexDistribution(0, numberOfTargetPoints - 1);
+
+        SelectionMap::Map map;
+
+        for (std::uint32_t pointIndex = 0; pointIndex < numberOfSourcePoints; ++pointIndex)
+        {
+            if (pointIndex % 5 == 3)
+            {
+                continue;
+            }
+
+            auto& targetIndices = map[pointIndex];
+
+            targetIndices.resize(numberOfTargetIndicesDistribution(randomNumberEngine));
+
+            for (auto& targetIndex : targetIndices)
+            {
+                targetIndex = targetIndexDistribution(randomNumberEngine);
+            }
+        }
+
+        return map;
+    }
+
+    // Straightforward mapping of a selection: the sorted union of the target indices of the selected source points.
+    SelectionMap::Indices mapSelection(const SelectionMap::Map& map, const SelectionMap::Indices& selection)
+    {
+        std::set<std::uint32_t> targetIndices;
+
+        for (const auto pointIndex : selection)
+        {
+            const auto it = map.find(pointIndex);
+
+            if (it != map.end())
+            {
+                targetIndices.insert(it->second.begin(), it->second.end());
+            }
+        }
+
+        return { targetIndices.begin(), targetIndices.end() };
+    }
+}
+
+
+TEST(SelectionMap, compressKeepsTheMapping)
+{
+    const auto map = generateRandomMap(1000, 300);
+
+    SelectionMap selectionMap;
+
+    selectionMap.getMap() = map;
+    selectionMap.compress();
+
+    ASSERT_TRUE(selectionMap.isCompressed());
+    ASSERT_EQ(selectionMap.getOffsets().size(), 1001u);
+
+    SelectionMap::Indices indices;
+
+    for (std::uint32_t pointIndex = 0; pointIndex < 1100; ++pointIndex)
+    {
+        const auto it = map.find(pointIndex);
+
+        // A source point with an empty vector of target indices still has a mapping
+        ASSERT_EQ(selectionMap.hasMappingForPointIndex(pointIndex), it != map.end());
+
+        if (it == map.end())
+        {
+            EXPECT_THROW(selectionMap.populateMappingIndices(pointIndex, indices), std::out_of_range);
+            continue;
+        }
+
+        selectionMap.populateMappingIndices(pointIndex, indices);
+
+        ASSERT_EQ(indices, it->second);
+    }
+
+    // Editing the mapping expands it into the same map
+    EXPECT_EQ(selectionMap.getMap(), map);
+    EXPECT_FALSE(selectionMap.isCompressed());
+}
+
+
+TEST(SelectionMap, setCompressedMappingMapsEachSourcePoint)
+{
+    SelectionMap selectionMap;
+
+    selectionMap.setCompressedMapping({ 0, 2, 2, 3 }, { 7, 5, 5 });
+
+    EXPECT_TRUE(selectionMap.hasMappingForPointIndex(0));
+    EXPECT_TRUE(selectionMap.hasMappingForPointIndex(1));
+    EXPECT_TRUE(selectionMap.hasMappingForPointIndex(2));
+    EXPECT_FALSE(selectionMap.hasMappingForPointIndex(3));
+
+    SelectionMap::Indices indices;
+
+    selectionMap.populateMappingIndices(1, indices);
+
+    EXPECT_TRUE(indices.empty());
+    EXPECT_EQ(selectionMap.mapSelection({ 2, 1, 0, 3 }), SelectionMap::Indices({ 5, 7 }));
+    EXPECT_EQ(selectionMap.getTargetBitmap().toIndices(), SelectionMap::Indices({ 5, 7 }));
+
+    EXPECT_THROW(selectionMap.setCompressedMapping({ 0, 2 }, { 1 }), std::runtime_error);
+    EXPECT_THROW(selectionMap.setCompressedMapping({ 1, 2 }, { 1, 2 }), std::runtime_error);
+    EXPECT_THROW(selectionMap.setCompressedMapping({ 0, 2, 1, 2 }, { 1, 2 }), std::runtime_error);
+}
+
+
+TEST(SelectionMap, setOneToOneMappingMapsOnlyTheSourceIndices)
+{
+    SelectionMap selectionMap;
+
+    selectionMap.setOneToOneMapping({ 4, 0, 9 }, { 40, 0, 90 });
+
+    SelectionMap::Indices indices;
+
+    for (std::uint32_t pointIndex = 0; pointIndex < 10; ++pointIndex)
+    {
+        const bool isMapped = (pointIndex == 0) || (pointIndex == 4) || (pointIndex == 9);
+
+        ASSERT_EQ(selectionMap.hasMappingForPointIndex(pointIndex), isMapped);
+
+        if (isMapped)
+        {
+            selectionMap.populateMappingIndices(pointIndex, indices);
+
+            ASSERT_EQ(indices, SelectionMap::Indices({ 10 * pointIndex }));
+        }
+    }
+
+    EXPECT_EQ(selectionMap.getTargetBitmap().toIndices(), SelectionMap::Indices({ 0, 40, 90 }));
+    EXPECT_THROW(selectionMap.setOneToOneMapping({ 1, 2 }, { 1 }), std::runtime_error);
+}
+
+
+TEST(SelectionMap, mapSelectionMatchesStraightforwardMapping)
+{
+    // Enough source points to map large selections in parallel
+    constexpr std::uint32_t numberOfSourcePoints = 300'000;
+    constexpr std::uint32_t numberOfTargetPoints = 100'000;
+
+    const auto map = generateRandomMap(numberOfSourcePoints, numberOfTargetPoints);
+
+    SelectionMap uncompressedSelectionMap;
+    SelectionMap compressedSelectionMap;
+
+    uncompressedSelectionMap.getMap() = map;
+    compressedSelectionMap.getMap() = map;
+    compressedSelectionMap.compress();
+
+    std::mt19937 randomNumberEngine;
+
+    for (const std::uint32_t numberOfSelectedPoints : { 0u, 1u, 1000u, numberOfSourcePoints })
+    {
+        SelectionMap::Indices selection(numberOfSourcePoints + 10);
+
+        std::iota(selection.begin(), selection.end(), 0u);
+        std::shuffle(selection.begin(), selection.end(), randomNumberEngine);
+
+        selection.resize(numberOfSelectedPoints);
+
+        const auto expectedTargetIndices = mapSelection(map, selection);
+
+        EXPECT_EQ(compressedSelectionMap.mapSelection(selection), expectedTargetIndices);
+
+        if (numberOfSelectedPoints <= 1000u)
+        {
+            EXPECT_EQ(uncompressedSelectionMap.mapSelection(selection), expectedTargetIndices);
+        }
+    }
+
+    SelectionMap::Indices allSourceIndices(numberOfSourcePoints);
+
+    std::iota(allSourceIndices.begin(), allSourceIndices.end(), 0u);
+
+    EXPECT_EQ(compressedSelectionMap.getTargetBitmap().toIndices(), mapSelection(map, allSourceIndices));
+}
+
+
+TEST(SelectionMap, variantMapRoundTripKeepsEmptyMappings)
+{
+    SelectionMap selectionMap;
+
+    selectionMap.getMap() = generateRandomMap(500, 100);
+    selectionMap.compress();
+
+    SelectionMap loadedSelectionMap;
+
+    loadedSelectionMap.fromVariantMap(selectionMap.toVariantMap());
+
+    EXPECT_EQ(loadedSelectionMap.getSourceBitmap(), selectionMap.getSourceBitmap());
+    EXPECT_EQ(loadedSelectionMap.getTargetBitmap(), selectionMap.getTargetBitmap());
+    EXPECT_EQ(loadedSelectionMap.getMap(), selectionMap.getMap());
+}
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <util/Serialization.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using mv::util::computeChecksum;
+
+
+TEST(Serialization, computeChecksumYieldsStandardCrc32)
+{
+    // The check value of CRC-32, as specified by the catalogue of parametrised CRC algorithms.
+    EXPECT_EQ(computeChecksum("123456789", 9), 0xCBF43926u);
+    EXPECT_EQ(computeChecksum(nullptr, 0), 0u);
+}
+
+
+TEST(Serialization, computeChecksumCanBeComputedIncrementally)
+{
+    std::mt19937 randomNumberEngine;
+
+    std::vector<char> bytes(100'003);
+
+    for (auto& byte : bytes)
+        byte = static_cast<char>(randomNumberEngine());
+
+    const auto checksum = computeChecksum(bytes.data(), bytes.size());
+
+    for (const std::size_t splitOffset : { 0, 1, 7, 8, 50'001, 100'003 })
+        EXPECT_EQ(computeChecksum(bytes.data() + splitOffset, bytes.size() - splitOffset, computeChecksum(bytes.data(), splitOffset)), checksum);
+}
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include "ClusterLabels.h"
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+namespace
+{
+    constexpr auto NO_CLUSTER = ClusterLabels::NO_CLUSTER;
+
+    // Minimal cluster, which provides getIndices() like the Cluster class of the plugin.
+    struct TestCluster
+    {
+        std::vector<std::uint32_t> indices;
+
+        const std::vector<std::uint32_t>& getIndices() const
+        {
+            return indices;
+        }
+    };
+
+
+    std::vector<std::uint32_t> getClusterIndices(const ClusterLabels& clusterLabels, const std::uint32_t clusterIndex)
+    {
+        const auto range = clusterLabels.getClusterIndices(clusterIndex);
+
+        return std::vector<std::uint32_t>(range.begin(), range.end());
+    }
+}
+
+
+TEST(ClusterLabels, fromClustersSortsIndicesAndBuildsLabels)
+{
+    const std::vector<TestCluster> clusters{ { { 5, 1, 3 } }, { {} }, { { 4, 0 } } };
+
+    const auto clusterLabels = ClusterLabels::fromClusters(clusters);
+
+    EXPECT_EQ(clusterLabels.getNumberOfClusters(), 3u);
+    EXPECT_EQ(clusterLabels.getNumberOfPoints(), 6u);
+    EXPECT_EQ(clusterLabels.getNumberOfIndices(), 5u);
+    EXPECT_TRUE(clusterLabels.isDisjoint());
+
+    EXPECT_EQ(getClusterIndices(clusterLabels, 0), std::vector<std::uint32_t>({ 1, 3, 5 }));
+    EXPECT_TRUE(clusterLabels.getClusterIndices(1).empty());
+    EXPECT_EQ(getClusterIndices(clusterLabels, 2), std::vector<std::uint32_t>({ 0, 4 }));
+
+    EXPECT_EQ(clusterLabels.getLabels(), std::vector<std::uint32_t>({ 2, 0, NO_CLUSTER, 0, 2, 0 }));
+    EXPECT_EQ(clusterLabels.getOffsets(), std::vector<std::size_t>({ 0, 3, 3, 5 }));
+
+    // The number of points can exceed the largest index
+    EXPECT_EQ(ClusterLabels::fromClusters(clusters, 10).getNumberOfPoints(), 10u);
+    EXPECT_EQ(ClusterLabels::fromClusters(clusters, 10).getLabel(9), NO_CLUSTER);
+}
+
+
+TEST(ClusterLabels, fromClustersDetectsOverlap)
+{
+    const std::vector<TestCluster> clusters{ { { 0, 2, 2 } }, { { 2, 3 } } };
+
+    const auto clusterLabels = ClusterLabels::fromClusters(clusters);
+
+    EXPECT_FALSE(clusterLabels.isDisjoint());
+    EXPECT_TRUE(clusterLabels.getLabels().empty());
+    EXPECT_EQ(clusterLabels.getLabel(2), NO_CLUSTER);
+
+    // Duplicate indices within a cluster are removed
+    EXPECT_EQ(getClusterIndices(clusterLabels, 0), std::vector<std::uint32_t>({ 0, 2 }));
+    EXPECT_EQ(getClusterIndices(clusterLabels, 1), std::vector<std::uint32_t>({ 2, 3 }));
+}
+
+
+TEST(ClusterLabels, fromLabelsMatchesFromClusters)
+{
+    constexpr std::uint32_t numberOfPoints = 1000;
+    constexpr std::uint32_t numberOfClusters = 7;
+
+    std::mt19937 randomNumberEngine;
+    std::uniform_int_distribution<std::uint32_t> labelDistribution(0, numberOfClusters);
+
+    std::vector<std::uint32_t> labels(numberOfPoints);
+    std::vector<TestCluster> clusters(numberOfClusters);
+
+    for (std::uint32_t pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+    {
+        // The extra label stands for unclustered points
+        const auto label = labelDistribution(randomNumberEngine);
+
+        labels[pointIndex] = (label == numberOfClusters) ? NO_CLUSTER : label;
+
+        if (label < numberOfClusters)
+            clusters[label].indices.push_back(pointIndex);
+    }
+
+    const auto fromLabels = ClusterLabels::fromLabels(labels, numberOfClusters);
+    const auto fromClusters = ClusterLabels::fromClusters(clusters, numberOfPoints);
+
+    EXPECT_EQ(fromLabels.getLabels(), labels);
+    EXPECT_EQ(fromLabels.getLabels(), fromClusters.getLabels());
+    EXPECT_EQ(fromLabels.getOffsets(), fromClusters.getOffsets());
+    EXPECT_EQ(fromLabels.getIndices(), fromClusters.getIndices());
+
+    EXPECT_THROW(ClusterLabels::fromLabels({ 0, 3 }, 3), std::runtime_error);
+}
+
+
+TEST(ClusterLabels, getPointIndices)
+{
+    const std::vector<TestCluster> clusters{ { { 0, 4 } }, { { 1, 5 } }, { { 2 } }, { { 3, 6 } } };
+
+    const auto clusterLabels = ClusterLabels::fromClusters(clusters);
+
+    EXPECT_TRUE(clusterLabels.getPointIndices({}).empty());
+    EXPECT_EQ(clusterLabels.getPointIndices({ 1 }), std::vector<std::uint32_t>({ 1, 5 }));
+
+    // Sorted and unique, also for duplicate and out of range cluster indices
+    EXPECT_EQ(clusterLabels.getPointIndices({ 3, 0, 3, 42 }), std::vector<std::uint32_t>({ 0, 3, 4, 6 }));
+
+    // Large selections scan the label array
+    EXPECT_EQ(clusterLabels.getPointIndices({ 0, 1, 2, 3 }), std::vector<std::uint32_t>({ 0, 1, 2, 3, 4, 5, 6 }));
+
+    // Overlapping clusters share points
+    const auto overlappingLabels = ClusterLabels::fromClusters(std::vector<TestCluster>{ { { 0, 1 } }, { { 1, 2 } } });
+
+    EXPECT_EQ(overlappingLabels.getPointIndices({ 0, 1 }), std::vector<std::uint32_t>({ 0, 1, 2 }));
+}
+
+
+TEST(ClusterLabels, relabeledMergesAndRemovesClusters)
+{
+    const std::vector<TestCluster> clusters{ { { 0, 4 } }, { { 1, 5 } }, { { 2 } }, { { 3 } } };
+
+    const auto clusterLabels = ClusterLabels::fromClusters(clusters);
+
+    // Merge cluster 2 into cluster 0, and remove cluster 3
+    const auto relabeled = clusterLabels.relabeled({ 0, 1, 0, NO_CLUSTER }, 2);
+
+    EXPECT_EQ(relabeled.getNumberOfClusters(), 2u);
+    EXPECT_EQ(relabeled.getNumberOfPoints(), clusterLabels.getNumberOfPoints());
+    EXPECT_EQ(getClusterIndices(relabeled, 0), std::vector<std::uint32_t>({ 0, 2, 4 }));
+    EXPECT_EQ(getClusterIndices(relabeled, 1), std::vector<std::uint32_t>({ 1, 5 }));
+    EXPECT_EQ(relabeled.getLabel(3), NO_CLUSTER);
+
+    // Overlapping clusters that are merged do not get duplicate indices
+    const auto overlappingLabels = ClusterLabels::fromClusters(std::vector<TestCluster>{ { { 0, 1 } }, { { 1, 2 } } });
+    const auto mergedLabels = overlappingLabels.relabeled({ 0, 0 }, 1);
+
+    EXPECT_TRUE(mergedLabels.isDisjoint());
+    EXPECT_EQ(getClusterIndices(mergedLabels, 0), std::vector<std::uint32_t>({ 0, 1, 2 }));
+
+    EXPECT_THROW(clusterLabels.relabeled({ 0, 1 }, 2), std::runtime_error);
+    EXPECT_THROW(clusterLabels.relabeled({ 0, 1, 2, 3 }, 2), std::runtime_error);
+}
@@ -96,8 +96,8 @@ void Cluster::colorizeClusters(QVector<Cluster>& clusters, const QImage& colorMa
     const auto& scaledColorMapImage = colorMapImage.scaled(static_cast<std::int32_t>(clusters.size()), 1);
 
     // Color clusters according to the color map image
-    for (auto& cluster : clusters)
-        cluster.setColor(scaledColorMapImage.pixel(clusters.indexOf(cluster), 0));
+    for (qsizetype clusterIndex = 0; clusterIndex < clusters.size(); ++clusterIndex)
+        clusters[clusterIndex].setColor(scaledColorMapImage.pixel(static_cast<std::int32_t>(clusterIndex), 0));
 }
 
 Cluster Cluster::copy() const
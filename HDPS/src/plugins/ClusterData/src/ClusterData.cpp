@@ -9,6 +9,7 @@
 #include "DataHierarchyItem.h"
 #include "event/Event.h"
 #include "PointData/PointData.h"
+#include "PointData/ClusterStatistics.h"
 
 #include "Application.h"
 
@@ -17,14 +18,23 @@
 #include <QtCore>
 #include <QtDebug>
 
+#include <numeric>
 #include <set>
+#include <stdexcept>
 
 Q_PLUGIN_METADATA(IID "hdps.ClusterData")
 
 using namespace mv::util;
 
 ClusterData::ClusterData(const mv::plugin::PluginFactory* factory) :
-    mv::plugin::RawData(factory, ClusterType)
+    mv::plugin::RawData(factory, ClusterType),
+    _clusters(),
+    _labelsMutex(),
+    _labels(),
+    _labelsDataGeneration(0),
+    _labelsNumberOfIndices(0),
+    _statisticsMutex(),
+    _statisticsCache()
 {
 }
 
@@ -42,6 +52,13 @@ Dataset<DatasetImpl> ClusterData::createDataSet(const QString& guid /*= ""*/) co
 }
 
 QVector<Cluster>& ClusterData::getClusters()
+{
+    invalidateLabels();
+
+    return _clusters;
+}
+
+const QVector<Cluster>& ClusterData::getClusters() const
 {
     return _clusters;
 }
@@ -49,20 +66,25 @@ QVector<Cluster>& ClusterData::getClusters()
 void ClusterData::addCluster(Cluster& cluster)
 {
     _clusters.push_back(cluster);
+
+    invalidateLabels();
 }
 
 void ClusterData::removeClusterById(const QString& id)
 {
-    _clusters.erase(std::remove_if(_clusters.begin(), _clusters.end(), [id](const Cluster& cluster) -> bool
-    {
-        return cluster.getId() == id;
-    }), _clusters.end());
+    removeClustersById({ id });
 }
 
 void ClusterData::removeClustersById(const QStringList& ids)
 {
-    for (auto& clusterId : ids)
-        removeClusterById(clusterId);
+    const auto idsSet = QSet<QString>(ids.begin(), ids.end());
+
+    _clusters.erase(std::remove_if(_clusters.begin(), _clusters.end(), [&idsSet](const Cluster& cluster) -> bool
+    {
+        return idsSet.contains(cluster.getId());
+    }), _clusters.end());
+
+    invalidateLabels();
 }
 
 std::int32_t ClusterData::getClusterIndex(const QString& clusterName) const
@@ -81,6 +103,233 @@ std::int32_t ClusterData::getClusterIndex(const QString& clusterName) const
     return -1;
 }
 
+std::shared_ptr<const ClusterLabels> ClusterData::getLabels(std::uint64_t dataGeneration) const
+{
+    std::lock_guard<std::mutex> lock(_labelsMutex);
+
+    const auto numberOfIndices = getNumberOfIndices();
+
+    const auto isCacheValid = _labels && _labelsDataGeneration == dataGeneration && _labels->getNumberOfClusters() == static_cast<std::uint32_t>(_clusters.size()) && _labelsNumberOfIndices == numberOfIndices;
+
+    if (!isCacheValid) {
+        _labels                 = std::make_shared<const ClusterLabels>(ClusterLabels::fromClusters(_clusters));
+        _labelsDataGeneration   = dataGeneration;
+        _labelsNumberOfIndices  = numberOfIndices;
+    }
+
+    return _labels;
+}
+
+void ClusterData::setClustersFromLabels(std::vector<std::uint32_t> labels, std::uint32_t numberOfClusters, const QStringList& names /*= QStringList()*/)
+{
+    // The counting sort of the labels yields the sorted point indices of all clusters at once
+    const auto clusterLabels = ClusterLabels::fromLabels(std::move(labels), numberOfClusters);
+
+    QVector<Cluster> clusters(numberOfClusters);
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex) {
+        auto& cluster = clusters[clusterIndex];
+
+        const auto clusterIndices = clusterLabels.getClusterIndices(clusterIndex);
+
+        cluster.setName(clusterIndex < static_cast<std::uint32_t>(names.size()) && !names[clusterIndex].isEmpty() ? names[clusterIndex] : QString::number(clusterIndex));
+        cluster.getIndices().assign(clusterIndices.begin(), clusterIndices.end());
+    }
+
+    Cluster::colorizeClusters(clusters);
+
+    _clusters = std::move(clusters);
+
+    invalidateLabels();
+}
+
+std::vector<std::uint32_t> ClusterData::mergeClusters(const std::vector<std::uint32_t>& clusterIndices, std::uint64_t dataGeneration)
+{
+    const auto numberOfClusters = static_cast<std::uint32_t>(_clusters.size());
+
+    for (const auto clusterIndex : clusterIndices)
+        if (clusterIndex >= numberOfClusters)
+            throw std::runtime_error(QString("Cannot merge clusters, cluster index %1 is out of range").arg(clusterIndex).toStdString());
+
+    std::vector<std::uint32_t> mapping(numberOfClusters);
+
+    std::iota(mapping.begin(), mapping.end(), 0);
+
+    if (clusterIndices.size() < 2)
+        return mapping;
+
+    const auto labels       = getLabels(dataGeneration);
+    const auto mergeIndex   = clusterIndices.front();
+
+    // Flag the clusters that are merged into the merge cluster (and are removed afterwards)
+    std::vector<std::uint8_t> isMerged(numberOfClusters, 0);
+
+    for (const auto clusterIndex : clusterIndices)
+        if (clusterIndex != mergeIndex)
+            isMerged[clusterIndex] = 1;
+
+    // Compacted index of the remaining clusters, merged clusters map to the merge cluster
+    std::uint32_t numberOfRemainingClusters = 0;
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+        mapping[clusterIndex] = isMerged[clusterIndex] ? ClusterLabels::NO_CLUSTER : numberOfRemainingClusters++;
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+        if (isMerged[clusterIndex])
+            mapping[clusterIndex] = mapping[mergeIndex];
+
+    const auto mergedLabels = labels->relabeled(mapping, numberOfRemainingClusters);
+
+    // The merged point indices are sorted and unique
+    const auto mergedIndices = mergedLabels.getClusterIndices(mapping[mergeIndex]);
+
+    _clusters[mergeIndex].getIndices().assign(mergedIndices.begin(), mergedIndices.end());
+
+    compactClusters(isMerged);
+
+    invalidateLabels();
+
+    return mapping;
+}
+
+std::vector<std::uint32_t> ClusterData::removeClusters(const std::vector<std::uint32_t>& clusterIndices)
+{
+    const auto numberOfClusters = static_cast<std::uint32_t>(_clusters.size());
+
+    std::vector<std::uint8_t> isRemoved(numberOfClusters, 0);
+
+    for (const auto clusterIndex : clusterIndices)
+        if (clusterIndex < numberOfClusters)
+            isRemoved[clusterIndex] = 1;
+
+    std::vector<std::uint32_t> mapping(numberOfClusters);
+
+    std::uint32_t numberOfRemainingClusters = 0;
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+        mapping[clusterIndex] = isRemoved[clusterIndex] ? ClusterLabels::NO_CLUSTER : numberOfRemainingClusters++;
+
+    if (numberOfRemainingClusters == numberOfClusters)
+        return mapping;
+
+    compactClusters(isRemoved);
+
+    invalidateLabels();
+
+    return mapping;
+}
+
+void ClusterData::recolorClusters(const std::vector<std::uint32_t>& clusterIndices, const QVector<QColor>& colors)
+{
+    if (colors.size() != 1 && colors.size() != static_cast<qsizetype>(clusterIndices.size()))
+        throw std::runtime_error("Cannot recolor clusters, the number of colors does not match the number of clusters");
+
+    const auto numberOfClusters = static_cast<std::uint32_t>(_clusters.size());
+
+    for (std::size_t index = 0; index < clusterIndices.size(); ++index)
+        if (clusterIndices[index] < numberOfClusters)
+            _clusters[clusterIndices[index]].setColor(colors[colors.size() == 1 ? 0 : static_cast<qsizetype>(index)]);
+}
+
+std::shared_ptr<const mv::ClusterStatistics> ClusterData::getStatistics(const Dataset<Points>& points, std::uint64_t dataGeneration, bool computeMedians, const std::atomic<bool>& abortRequested) const
+{
+    if (!points.isValid())
+        throw std::runtime_error("Cannot compute cluster statistics without points");
+
+    // Changes of the clusters replace the labels
+    const auto labels = getLabels(dataGeneration);
+
+    // The values of a subset change with the raw data of its full dataset
+    auto pointsDataGeneration = points->getDataGeneration();
+
+    if (!points->isFull() && points->getFullDataset<DatasetImpl>().isValid())
+        pointsDataGeneration += points->getFullDataset<DatasetImpl>()->getDataGeneration();
+
+    {
+        std::lock_guard<std::mutex> lock(_statisticsMutex);
+
+        const auto& cache = _statisticsCache;
+
+        const auto isCacheValid = cache._statistics && cache._labels.lock() == labels && cache._pointsId == points->getId() && cache._pointsDataGeneration == pointsDataGeneration &&
+            cache._statistics->numberOfDimensions == points->getNumDimensions() && (!computeMedians || !cache._statistics->medians.empty());
+
+        if (isCacheValid)
+            return cache._statistics;
+    }
+
+    // Computed without holding the mutex, so that other requests (and the ones that are aborted) do not wait for this computation
+    auto statistics = std::make_shared<mv::ClusterStatistics>();
+
+    // Disjoint clusters come with dense labels, so that the means and standard deviations take a single pass over the points
+    if (!points->computeClusterStatistics(labels->getLabels(), labels->getOffsets(), labels->getIndices(), computeMedians, *statistics, abortRequested))
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(_statisticsMutex);
+
+    auto& cache = _statisticsCache;
+
+    cache._statistics           = std::move(statistics);
+    cache._labels               = labels;
+    cache._pointsId             = points->getId();
+    cache._pointsDataGeneration = pointsDataGeneration;
+
+    return cache._statistics;
+}
+
+void ClusterData::applyStatistics(const mv::ClusterStatistics& statistics)
+{
+    const auto numberOfClusters     = std::min(static_cast<std::size_t>(_clusters.size()), statistics.numberOfClusters);
+    const auto numberOfDimensions   = statistics.numberOfDimensions;
+
+    // Copy the rows of the statistics matrices to the clusters
+    for (std::size_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex) {
+        auto& cluster = _clusters[static_cast<qsizetype>(clusterIndex)];
+
+        const auto first    = clusterIndex * numberOfDimensions;
+        const auto last     = first + numberOfDimensions;
+
+        cluster.getMean().assign(statistics.means.begin() + first, statistics.means.begin() + last);
+        cluster.getStandardDeviation().assign(statistics.standardDeviations.begin() + first, statistics.standardDeviations.begin() + last);
+
+        if (!statistics.medians.empty())
+            cluster.getMedian().assign(statistics.medians.begin() + first, statistics.medians.begin() + last);
+    }
+}
+
+std::size_t ClusterData::getNumberOfIndices() const
+{
+    std::size_t numberOfIndices = 0;
+
+    for (const auto& cluster : _clusters)
+        numberOfIndices += cluster.getIndices().size();
+
+    return numberOfIndices;
+}
+
+void ClusterData::compactClusters(const std::vector<std::uint8_t>& isRemoved)
+{
+    qsizetype numberOfRemainingClusters = 0;
+
+    for (qsizetype clusterIndex = 0; clusterIndex < _clusters.size(); ++clusterIndex) {
+        if (isRemoved[clusterIndex])
+            continue;
+
+        if (numberOfRemainingClusters != clusterIndex)
+            _clusters[numberOfRemainingClusters] = std::move(_clusters[clusterIndex]);
+
+        ++numberOfRemainingClusters;
+    }
+
+    _clusters.resize(numberOfRemainingClusters);
+}
+
+void ClusterData::invalidateLabels()
+{
+    std::lock_guard<std::mutex> lock(_labelsMutex);
+
+    _labels.reset();
+}
+
 void ClusterData::fromVariantMap(const QVariantMap& variantMap)
 {
     WidgetAction::fromVariantMap(variantMap);
@@ -91,71 +340,114 @@ void ClusterData::fromVariantMap(const QVariantMap& variantMap)
     variantMapMustContain(dataMap, "NumberOfIndices");
 
     // Packed indices for all clusters
-    QVector<std::uint32_t> packedIndices;
-
-    packedIndices.resize(dataMap["NumberOfIndices"].toInt());
+    std::vector<std::uint32_t> packedIndices(dataMap["NumberOfIndices"].value<std::uint64_t>());
 
     // Convert raw data to indices
     populateDataBufferFromVariantMap(dataMap["IndicesRawData"].toMap(), (char*)packedIndices.data());
 
-    if (dataMap.contains("ClustersRawData")) {
-        QByteArray clustersByteArray;
+    if (dataMap.contains("ClusterOffsetsRawData")) {
+        variantMapMustContain(dataMap, "NumberOfClusters");
+        variantMapMustContain(dataMap, "ClusterColorsRawData");
+        variantMapMustContain(dataMap, "ClusterStringsRawData");
+        variantMapMustContain(dataMap, "ClusterStringsSize");
+        variantMapMustContain(dataMap, "ClusterStringOffsetsRawData");
 
-        QDataStream clustersDataStream(&clustersByteArray, QIODevice::ReadOnly);
+        const auto numberOfClusters = dataMap["NumberOfClusters"].value<std::uint64_t>();
 
-        const auto clustersRawDataSize = dataMap["ClustersRawDataSize"].toInt();
+        // Offset of each cluster in the packed indices, followed by the number of packed indices
+        std::vector<std::uint64_t> offsets(numberOfClusters + 1);
 
-        clustersByteArray.resize(clustersRawDataSize);
+        populateDataBufferFromVariantMap(dataMap["ClusterOffsetsRawData"].toMap(), (char*)offsets.data());
 
-        populateDataBufferFromVariantMap(dataMap["ClustersRawData"].toMap(), (char*)clustersByteArray.data());
+        // Cluster colors in #AARRGGBB format
+        std::vector<QRgb> colors(numberOfClusters);
 
-        QVariantList clusters;
+        populateDataBufferFromVariantMap(dataMap["ClusterColorsRawData"].toMap(), (char*)colors.data());
+
+        // String table with the UTF-8 encoded names of all clusters, followed by their identifiers
+        QByteArray strings;
 
-        clustersDataStream >> clusters;
+        strings.resize(dataMap["ClusterStringsSize"].value<qsizetype>());
 
-        _clusters.resize(clusters.count());
+        populateDataBufferFromVariantMap(dataMap["ClusterStringsRawData"].toMap(), strings.data());
 
-        long clusterIndex = 0;
+        std::vector<std::uint64_t> stringOffsets(2 * numberOfClusters + 1);
 
-        for (const auto& clusterVariant : clusters) {
-            const auto clusterMap = clusterVariant.toMap();
+        populateDataBufferFromVariantMap(dataMap["ClusterStringOffsetsRawData"].toMap(), (char*)stringOffsets.data());
 
-            auto& cluster = _clusters[clusterIndex];
+        for (std::uint64_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+            if (offsets[clusterIndex] > offsets[clusterIndex + 1])
+                throw std::runtime_error("Cluster offsets are not ascending");
 
-            cluster.setName(clusterMap["Name"].toString());
-            cluster.setId(clusterMap["ID"].toString());
-            cluster.setColor(clusterMap["Color"].toString());
+        for (std::uint64_t stringIndex = 0; stringIndex < 2 * numberOfClusters; ++stringIndex)
+            if (stringOffsets[stringIndex] > stringOffsets[stringIndex + 1])
+                throw std::runtime_error("Cluster string offsets are not ascending");
 
-            const auto globalIndicesOffset  = clusterMap["GlobalIndicesOffset"].toInt();
-            const auto numberOfIndices      = clusterMap["NumberOfIndices"].toInt();
+        if (offsets.back() != packedIndices.size() || stringOffsets.back() != static_cast<std::uint64_t>(strings.size()))
+            throw std::runtime_error("Cluster offsets do not match the serialized data");
 
-            cluster.getIndices() = std::vector<std::uint32_t>(packedIndices.begin() + globalIndicesOffset, packedIndices.begin() + globalIndicesOffset + numberOfIndices);
+        const auto getString = [&strings, &stringOffsets](std::uint64_t stringIndex) -> QString {
+            return QString::fromUtf8(strings.constData() + stringOffsets[stringIndex], static_cast<qsizetype>(stringOffsets[stringIndex + 1] - stringOffsets[stringIndex]));
+        };
 
-            ++clusterIndex;
+        _clusters.resize(static_cast<qsizetype>(numberOfClusters));
+
+        for (std::uint64_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex) {
+            auto& cluster = _clusters[static_cast<qsizetype>(clusterIndex)];
+
+            cluster.setName(getString(clusterIndex));
+            cluster.setId(getString(numberOfClusters + clusterIndex));
+            cluster.setColor(QColor::fromRgba(colors[clusterIndex]));
+            cluster.getIndices().assign(packedIndices.begin() + offsets[clusterIndex], packedIndices.begin() + offsets[clusterIndex + 1]);
         }
     }
-    
-    // For backwards compatibility
-    if (dataMap.contains("Clusters")) {
-        const auto clustersList = dataMap["Clusters"].toList();
+    else {
+        QVariantList clusters;
 
-        _clusters.resize(clustersList.count());
+        if (dataMap.contains("ClustersRawData")) {
+            QByteArray clustersByteArray;
 
-        for (const auto& clusterVariant : clustersList) {
-            const auto clusterMap   = clusterVariant.toMap();
-            const auto clusterIndex = clustersList.indexOf(clusterMap);
+            QDataStream clustersDataStream(&clustersByteArray, QIODevice::ReadOnly);
 
-            auto& cluster = _clusters[clusterIndex];
+            const auto clustersRawDataSize = dataMap["ClustersRawDataSize"].toInt();
 
-            cluster.setName(clusterMap["Name"].toString());
-            cluster.setId(clusterMap["ID"].toString());
-            cluster.setColor(clusterMap["Color"].toString());
+            clustersByteArray.resize(clustersRawDataSize);
 
-            const auto globalIndicesOffset  = clusterMap["GlobalIndicesOffset"].toInt();
-            const auto numberOfIndices      = clusterMap["NumberOfIndices"].toInt();
+            populateDataBufferFromVariantMap(dataMap["ClustersRawData"].toMap(), (char*)clustersByteArray.data());
 
-            cluster.getIndices() = std::vector<std::uint32_t>(packedIndices.begin() + globalIndicesOffset, packedIndices.begin() + globalIndicesOffset + numberOfIndices);
+            clustersDataStream >> clusters;
         }
+
+        // For backwards compatibility
+        if (dataMap.contains("Clusters"))
+            clusters = dataMap["Clusters"].toList();
+
+        fromLegacyVariantList(clusters, packedIndices);
+    }
+
+    invalidateLabels();
+}
+
+void ClusterData::fromLegacyVariantList(const QVariantList& clusters, const std::vector<std::uint32_t>& packedIndices)
+{
+    _clusters.resize(clusters.count());
+
+    for (qsizetype clusterIndex = 0; clusterIndex < clusters.count(); ++clusterIndex) {
+        const auto clusterMap = clusters[clusterIndex].toMap();
+
+        auto& cluster = _clusters[clusterIndex];
+
+        cluster.setName(clusterMap["Name"].toString());
+        cluster.setId(clusterMap["ID"].toString());
+        cluster.setColor(clusterMap["Color"].toString());
+
+        const auto globalIndicesOffset  = clusterMap["GlobalIndicesOffset"].value<std::uint64_t>();
+        const auto numberOfIndices      = clusterMap["NumberOfIndices"].value<std::uint64_t>();
+
+        if (globalIndicesOffset + numberOfIndices > packedIndices.size())
+            throw std::runtime_error("Cluster indices are out of range of the serialized indices");
+
+        cluster.getIndices().assign(packedIndices.begin() + globalIndicesOffset, packedIndices.begin() + globalIndicesOffset + numberOfIndices);
     }
 }
 
@@ -163,46 +455,56 @@ QVariantMap ClusterData::toVariantMap() const
 {
     auto variantMap = WidgetAction::toVariantMap();
 
-    std::vector<std::uint32_t> indices;
+    const auto numberOfClusters = static_cast<std::uint64_t>(_clusters.size());
 
-    for (const auto& cluster : _clusters)
-        indices.insert(indices.end(), cluster.getIndices().begin(), cluster.getIndices().end());
+    // Columns of the cluster properties
+    std::vector<std::uint64_t> offsets;
+    std::vector<QRgb> colors;
+    std::vector<std::uint64_t> stringOffsets;
 
-    QVariantMap indicesRawData = rawDataToVariantMap((char*)indices.data(), indices.size() * sizeof(std::uint32_t), true);
+    offsets.reserve(numberOfClusters + 1);
+    colors.reserve(numberOfClusters);
+    stringOffsets.reserve(2 * numberOfClusters + 1);
 
-    std::size_t globalIndicesOffset = 0;
+    offsets.push_back(0);
 
-    QVariantList clusters;
+    for (const auto& cluster : _clusters) {
+        offsets.push_back(offsets.back() + cluster.getIndices().size());
+        colors.push_back(cluster.getColor().rgba());
+    }
 
-    clusters.reserve(_clusters.count());
+    // Packed indices for all clusters
+    std::vector<std::uint32_t> indices;
 
-    for (const auto& cluster : _clusters) {
-        const auto numberOfIndicesInCluster = cluster.getIndices().size();
+    indices.reserve(offsets.back());
 
-        clusters.push_back(QVariantMap({
-            { "Name", cluster.getName() },
-            { "ID", cluster.getId() },
-            { "Color", cluster.getColor() },
-            { "GlobalIndicesOffset", QVariant::fromValue(globalIndicesOffset) },
-            { "NumberOfIndices", QVariant::fromValue(numberOfIndicesInCluster) }
-        }));
+    for (const auto& cluster : _clusters)
+        indices.insert(indices.end(), cluster.getIndices().begin(), cluster.getIndices().end());
 
-        globalIndicesOffset += numberOfIndicesInCluster;
-    }
+    // String table with the UTF-8 encoded names of all clusters, followed by their identifiers
+    QByteArray strings;
 
-    // https://stackoverflow.com/questions/19537186/serializing-qvariant-through-qdatastream
+    stringOffsets.push_back(0);
 
-    QByteArray clustersByteArray;
-    QDataStream clustersDataStream(&clustersByteArray, QIODevice::WriteOnly);
+    const auto appendString = [&strings, &stringOffsets](const QString& string) -> void {
+        strings.append(string.toUtf8());
+        stringOffsets.push_back(static_cast<std::uint64_t>(strings.size()));
+    };
 
-    clustersDataStream << clusters;
+    for (const auto& cluster : _clusters)
+        appendString(cluster.getName());
 
-    QVariantMap clustersRawData = rawDataToVariantMap((char*)clustersByteArray.data(), clustersByteArray.size(), true);
+    for (const auto& cluster : _clusters)
+        appendString(cluster.getId());
 
     variantMap.insert({
-        { "ClustersRawData", clustersRawData },
-        { "ClustersRawDataSize", clustersByteArray.size() },
-        { "IndicesRawData", indicesRawData },
+        { "NumberOfClusters", QVariant::fromValue(numberOfClusters) },
+        { "ClusterOffsetsRawData", rawDataToVariantMap((char*)offsets.data(), offsets.size() * sizeof(std::uint64_t), true, -1, false, sizeof(std::uint64_t)) },
+        { "ClusterColorsRawData", rawDataToVariantMap((char*)colors.data(), colors.size() * sizeof(QRgb), true, -1, false, sizeof(QRgb)) },
+        { "ClusterStringsRawData", rawDataToVariantMap(strings.constData(), strings.size(), true) },
+        { "ClusterStringsSize", QVariant::fromValue(strings.size()) },
+        { "ClusterStringOffsetsRawData", rawDataToVariantMap((char*)stringOffsets.data(), stringOffsets.size() * sizeof(std::uint64_t), true, -1, false, sizeof(std::uint64_t)) },
+        { "IndicesRawData", rawDataToVariantMap((char*)indices.data(), indices.size() * sizeof(std::uint32_t), true, -1, false, sizeof(std::uint32_t)) },
         { "NumberOfIndices", QVariant::fromValue(indices.size()) }
     });
 
@@ -259,31 +561,90 @@ void Clusters::removeClustersById(const QStringList& ids)
     getRawData<ClusterData>().removeClustersById(ids);
 }
 
-QIcon Clusters::getIcon(const QColor& color /*= Qt::black*/) const
+std::shared_ptr<const ClusterLabels> Clusters::getLabels() const
 {
-    return Application::getIconFont("FontAwesome").getIcon("th-large", color);
+    return getRawData<ClusterData>().getLabels(getDataGeneration());
 }
 
-std::vector<std::uint32_t> Clusters::getSelectedIndices() const
+void Clusters::setClustersFromLabels(std::vector<std::uint32_t> labels, std::uint32_t numberOfClusters, const QStringList& names /*= QStringList()*/)
+{
+    getRawData<ClusterData>().setClustersFromLabels(std::move(labels), numberOfClusters, names);
+
+    getSelectionIndices().clear();
+
+    events().notifyDatasetDataChanged(this);
+}
+
+void Clusters::mergeClusters(const std::vector<std::uint32_t>& clusterIndices)
 {
-    // Indices that are selected
-    std::vector<std::uint32_t> selectedIndices;
+    remapSelection(getRawData<ClusterData>().mergeClusters(clusterIndices, getDataGeneration()));
 
-    // Gather indices
-    for (const auto& clusterIndex : getSelection<Clusters>()->indices) {
+    events().notifyDatasetDataChanged(this);
+}
 
-        // Get reference to selected cluster
-        const auto selectedCluster = getClusters()[clusterIndex];
+void Clusters::removeClusters(const std::vector<std::uint32_t>& clusterIndices)
+{
+    remapSelection(getRawData<ClusterData>().removeClusters(clusterIndices));
 
-        // Add cluster indices to selected indices
-        selectedIndices.insert(selectedIndices.end(), selectedCluster.getIndices().begin(), selectedCluster.getIndices().end());
-    }
+    events().notifyDatasetDataChanged(this);
+}
 
-    // Remove duplicates
-    std::sort(selectedIndices.begin(), selectedIndices.end());
-    selectedIndices.erase(unique(selectedIndices.begin(), selectedIndices.end()), selectedIndices.end());
+void Clusters::recolorClusters(const std::vector<std::uint32_t>& clusterIndices, const QVector<QColor>& colors)
+{
+    getRawData<ClusterData>().recolorClusters(clusterIndices, colors);
 
-    return selectedIndices;
+    events().notifyDatasetDataChanged(this);
+}
+
+std::shared_ptr<const mv::ClusterStatistics> Clusters::computeStatistics(bool computeMedians /*= true*/)
+{
+    const std::atomic<bool> abortRequested{ false };
+
+    return computeStatistics(computeMedians, abortRequested);
+}
+
+std::shared_ptr<const mv::ClusterStatistics> Clusters::computeStatistics(bool computeMedians, const std::atomic<bool>& abortRequested)
+{
+    const auto points       = getDataHierarchyItem().getParent().getDataset<Points>();
+    const auto statistics   = getRawData<ClusterData>().getStatistics(points, getDataGeneration(), computeMedians, abortRequested);
+
+    if (!statistics)
+        return nullptr;
+
+    // Not through getClusters(), which would invalidate the labels the statistics are cached for
+    getRawData<ClusterData>().applyStatistics(*statistics);
+
+    return statistics;
+}
+
+void Clusters::remapSelection(const std::vector<std::uint32_t>& mapping)
+{
+    auto& selectionIndices = getSelectionIndices();
+
+    std::vector<std::uint32_t> remappedSelectionIndices;
+
+    remappedSelectionIndices.reserve(selectionIndices.size());
+
+    for (const auto clusterIndex : selectionIndices)
+        if (clusterIndex < mapping.size() && mapping[clusterIndex] != ClusterLabels::NO_CLUSTER)
+            remappedSelectionIndices.push_back(mapping[clusterIndex]);
+
+    // Merged clusters map to the same cluster
+    std::sort(remappedSelectionIndices.begin(), remappedSelectionIndices.end());
+    remappedSelectionIndices.erase(std::unique(remappedSelectionIndices.begin(), remappedSelectionIndices.end()), remappedSelectionIndices.end());
+
+    selectionIndices = std::move(remappedSelectionIndices);
+}
+
+QIcon Clusters::getIcon(const QColor& color /*= Qt::black*/) const
+{
+    return Application::getIconFont("FontAwesome").getIcon("th-large", color);
+}
+
+std::vector<std::uint32_t> Clusters::getSelectedIndices() const
+{
+    // Union of the point indices of the selected clusters, from the cached labels
+    return getLabels()->getPointIndices(getSelection<Clusters>()->indices);
 }
 
 void Clusters::fromVariantMap(const QVariantMap& variantMap)
@@ -316,28 +677,10 @@ void Clusters::setSelectionIndices(const std::vector<std::uint32_t>& indices)
     events().notifyDatasetDataSelectionChanged(this);
 
     // Get reference to input dataset
-    auto points             = getDataHierarchyItem().getParent().getDataset<Points>();
-    auto selection          = points->getSelection<Points>();
-    auto selectionIndices   = selection->indices;
-
-    selectionIndices.clear();
-    selectionIndices.reserve(indices.size());
-
-    std::vector<std::uint32_t> globalIndices;
-
-    points->getGlobalIndices(globalIndices);
-
-    // Append point indices per cluster
-    for (auto clusterSelectionIndex : getSelection<Clusters>()->indices) {
-        const auto cluster = getClusters().at(clusterSelectionIndex);
-        selectionIndices.insert(selectionIndices.end(), cluster.getIndices().begin(), cluster.getIndices().end());
-    }
-
-    // Remove duplicates
-    std::sort(selectionIndices.begin(), selectionIndices.end());
-    selectionIndices.erase(unique(selectionIndices.begin(), selectionIndices.end()), selectionIndices.end());
+    auto points = getDataHierarchyItem().getParent().getDataset<Points>();
 
-    points->setSelectionIndices(selectionIndices);
+    // Select the (sorted and unique) point indices of the selected clusters
+    points->setSelectionIndices(getSelectedIndices());
 
     events().notifyDatasetDataSelectionChanged(points);
 }
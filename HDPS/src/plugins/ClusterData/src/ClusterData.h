@@ -7,6 +7,7 @@
 #include "clusterdata_export.h"
 
 #include "Cluster.h"
+#include "ClusterLabels.h"
 
 #include <event/EventListener.h>
 #include <Application.h>
@@ -18,6 +19,9 @@
 #include <QColor>
 #include <QUuid>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 using namespace mv;
@@ -25,6 +29,11 @@ using namespace mv;
 const mv::DataType ClusterType = mv::DataType(QString("Clusters"));
 
 class InfoAction;
+class Points;
+
+namespace mv {
+    struct ClusterStatistics;
+}
 
 class CLUSTERDATA_EXPORT ClusterData : public mv::plugin::RawData
 {
@@ -41,9 +50,12 @@ public:
      */
     Dataset<DatasetImpl> createDataSet(const QString& guid = "") const override;
 
-    /** Returns reference to the clusters */
+    /** Returns reference to the clusters, and invalidates the cached labels (as the clusters may be modified through the reference) */
     QVector<Cluster>& getClusters();
 
+    /** Returns const reference to the clusters */
+    const QVector<Cluster>& getClusters() const;
+
     /**
      * Adds a cluster
      * @param cluster Cluster to add
@@ -69,6 +81,79 @@ public:
      */
     std::int32_t getClusterIndex(const QString& clusterName) const;
 
+public: // Labels
+
+    /**
+     * Get the point to cluster labels (and inverted index) of the clusters, which are cached until the clusters are accessed mutably or the
+     * data generation changes (may be called from worker threads, as long as the clusters are not modified in the meantime)
+     * @param dataGeneration Data generation of the clusters dataset (the cache is also rebuilt when the number of clusters or indices changes)
+     * @return Shared pointer to the cluster labels (remains valid when the clusters change)
+     */
+    std::shared_ptr<const ClusterLabels> getLabels(std::uint64_t dataGeneration) const;
+
+    /**
+     * Replaces the clusters by the clusters of a dense point to cluster label array, in O(n + k)
+     * @param labels Cluster label per point (ClusterLabels::NO_CLUSTER for unclustered points)
+     * @param numberOfClusters Number of clusters (labels must be smaller)
+     * @param names Cluster names (the cluster index is used for missing names)
+     */
+    void setClustersFromLabels(std::vector<std::uint32_t> labels, std::uint32_t numberOfClusters, const QStringList& names = QStringList());
+
+    /**
+     * Merges clusters into the first of \p clusterIndices (which keeps its name, identifier and color), in O(n + k)
+     * @param clusterIndices Indices of the clusters to merge
+     * @param dataGeneration Data generation of the clusters dataset
+     * @return New cluster index per current cluster index
+     */
+    std::vector<std::uint32_t> mergeClusters(const std::vector<std::uint32_t>& clusterIndices, std::uint64_t dataGeneration);
+
+    /**
+     * Removes clusters by their indices, in O(k)
+     * @param clusterIndices Indices of the clusters to remove
+     * @return New cluster index per current cluster index (ClusterLabels::NO_CLUSTER for removed clusters)
+     */
+    std::vector<std::uint32_t> removeClusters(const std::vector<std::uint32_t>& clusterIndices);
+
+    /**
+     * Recolors clusters by their indices, in O(k)
+     * @param clusterIndices Indices of the clusters to recolor
+     * @param colors Color per cluster index, or a single color for all clusters
+     */
+    void recolorClusters(const std::vector<std::uint32_t>& clusterIndices, const QVector<QColor>& colors);
+
+public: // Statistics
+
+    /**
+     * Get the mean, standard deviation and median of each dimension per cluster, computed over \p points in parallel, and cached
+     * until the clusters or the points change (may be called from worker threads)
+     * @param points Smart pointer to the points the cluster indices refer to
+     * @param dataGeneration Data generation of the clusters dataset
+     * @param computeMedians Whether to compute the medians as well (medians are computed at most once per cached result)
+     * @param abortRequested Stops the computation when set (for example by the task of a worker thread)
+     * @return Shared pointer to the cluster statistics (nullptr when the computation was aborted)
+     */
+    std::shared_ptr<const mv::ClusterStatistics> getStatistics(const Dataset<Points>& points, std::uint64_t dataGeneration, bool computeMedians, const std::atomic<bool>& abortRequested) const;
+
+    /**
+     * Copies the means, standard deviations and medians of \p statistics to the clusters (which does not invalidate the cached labels)
+     * @param statistics Cluster statistics
+     */
+    void applyStatistics(const mv::ClusterStatistics& statistics);
+
+private:
+
+    /** Get the total number of indices over all clusters */
+    std::size_t getNumberOfIndices() const;
+
+    /**
+     * Removes the flagged clusters, preserving the order of the others
+     * @param isRemoved Whether to remove the cluster, per cluster index
+     */
+    void compactClusters(const std::vector<std::uint8_t>& isRemoved);
+
+    /** Releases the cached labels, so that they are rebuilt from the clusters when requested */
+    void invalidateLabels();
+
 public: // Serialization
 
     /**
@@ -78,13 +163,37 @@ public: // Serialization
     void fromVariantMap(const QVariantMap& variantMap) override;
 
     /**
-     * Save widget action to variant
+     * Save widget action to variant, in a columnar binary layout: a string table with the names and identifiers, an array
+     * of colors, an array of offsets into the packed indices, and the packed indices of all clusters
      * @return Variant representation of the widget action
      */
     QVariantMap toVariantMap() const override;
 
 private:
-    QVector<Cluster>    _clusters;      /** Clusters data */
+
+    /**
+     * Load clusters from the per-cluster variant maps of projects that were saved before the columnar layout
+     * @param clusters Variant list with a variant map per cluster
+     * @param packedIndices Packed indices for all clusters
+     */
+    void fromLegacyVariantList(const QVariantList& clusters, const std::vector<std::uint32_t>& packedIndices);
+
+    /** Cluster statistics, with the state of the clusters and points they were computed for */
+    struct StatisticsCache
+    {
+        QString                                         _pointsId;                          /** Globally unique identifier of the points */
+        std::uint64_t                                   _pointsDataGeneration = 0;          /** Data generation of the points (and their full dataset) */
+        std::weak_ptr<const ClusterLabels>              _labels;                            /** Labels the statistics were computed for (not kept alive by the cache) */
+        std::shared_ptr<const mv::ClusterStatistics>    _statistics;                        /** Cached statistics */
+    };
+
+    QVector<Cluster>                                _clusters;                  /** Clusters data */
+    mutable std::mutex                              _labelsMutex;               /** Guards the cached labels (not the clusters, which must not be modified while labels are requested from worker threads) */
+    mutable std::shared_ptr<const ClusterLabels>    _labels;                    /** Cached point to cluster labels */
+    mutable std::uint64_t                           _labelsDataGeneration;      /** Data generation of the clusters dataset for which the labels were built */
+    mutable std::size_t                             _labelsNumberOfIndices;     /** Total number of cluster indices when the labels were built */
+    mutable std::mutex                              _statisticsMutex;           /** Guards the statistics cache (but is not held during the computation) */
+    mutable StatisticsCache                         _statisticsCache;           /** Cached cluster statistics */
 };
 
 // =============================================================================
@@ -110,7 +219,7 @@ public:
 
     const QVector<Cluster>& getClusters() const
     {
-        return getRawData<ClusterData>().getClusters();
+        return static_cast<const ClusterData&>(getRawData<ClusterData>()).getClusters();
     }
 
     /**
@@ -131,6 +240,55 @@ public:
      */
     void removeClustersById(const QStringList& ids);
 
+    /**
+     * Get the point to cluster labels (and inverted index) of the clusters, cached until the clusters change
+     * @return Shared pointer to the cluster labels
+     */
+    std::shared_ptr<const ClusterLabels> getLabels() const;
+
+    /**
+     * Replaces the clusters by the clusters of a dense point to cluster label array, in O(n + k)
+     * @param labels Cluster label per point (ClusterLabels::NO_CLUSTER for unclustered points)
+     * @param numberOfClusters Number of clusters (labels must be smaller)
+     * @param names Cluster names (the cluster index is used for missing names)
+     */
+    void setClustersFromLabels(std::vector<std::uint32_t> labels, std::uint32_t numberOfClusters, const QStringList& names = QStringList());
+
+    /**
+     * Merges clusters into the first of \p clusterIndices, in O(n + k)
+     * @param clusterIndices Indices of the clusters to merge
+     */
+    void mergeClusters(const std::vector<std::uint32_t>& clusterIndices);
+
+    /**
+     * Removes clusters by their indices, in O(n + k)
+     * @param clusterIndices Indices of the clusters to remove
+     */
+    void removeClusters(const std::vector<std::uint32_t>& clusterIndices);
+
+    /**
+     * Recolors clusters by their indices, in O(k)
+     * @param clusterIndices Indices of the clusters to recolor
+     * @param colors Color per cluster index, or a single color for all clusters
+     */
+    void recolorClusters(const std::vector<std::uint32_t>& clusterIndices, const QVector<QColor>& colors);
+
+    /**
+     * Computes the mean, standard deviation and median of each dimension per cluster over the points of the parent dataset, stores them
+     * in the clusters, and returns them as one matrix per statistic (e.g. for heatmaps); cached until the clusters or the points change
+     * @param computeMedians Whether to compute the medians as well
+     * @return Shared pointer to the cluster statistics
+     */
+    std::shared_ptr<const mv::ClusterStatistics> computeStatistics(bool computeMedians = true);
+
+    /**
+     * Computes the cluster statistics like computeStatistics(bool), unless it is aborted
+     * @param computeMedians Whether to compute the medians as well
+     * @param abortRequested Stops the computation when set
+     * @return Shared pointer to the cluster statistics (nullptr when the computation was aborted, the clusters are left untouched then)
+     */
+    std::shared_ptr<const mv::ClusterStatistics> computeStatistics(bool computeMedians, const std::atomic<bool>& abortRequested);
+
     /**
      * Get a copy of the dataset
      * @return Smart pointer to copy of dataset
@@ -211,9 +369,17 @@ public: // Selection
     /** Invert item selection */
     void selectInvert() override;
 
-    /** Gets concatenated indices for all selected clusters */
+    /** Gets the (sorted and unique) point indices of all selected clusters */
     std::vector<std::uint32_t> getSelectedIndices() const;
 
+private:
+
+    /**
+     * Maps the cluster selection after clusters were merged or removed
+     * @param mapping New cluster index per current cluster index (ClusterLabels::NO_CLUSTER for removed clusters)
+     */
+    void remapSelection(const std::vector<std::uint32_t>& mapping);
+
 public: // Serialization
 
     /**
@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "ClusterLabels.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+ClusterLabels ClusterLabels::fromLabels(std::vector<std::uint32_t> labels, std::uint32_t numberOfClusters)
+{
+    if (labels.size() > std::numeric_limits<std::uint32_t>::max())
+        throw std::runtime_error("Too many points for cluster labels");
+
+    ClusterLabels clusterLabels;
+
+    // Count the points per cluster
+    std::vector<std::size_t> counts(numberOfClusters, 0);
+
+    for (const auto label : labels) {
+        if (label == NO_CLUSTER)
+            continue;
+
+        if (label >= numberOfClusters)
+            throw std::runtime_error("Cluster label " + std::to_string(label) + " is out of range");
+
+        ++counts[label];
+    }
+
+    // Exclusive prefix sum of the counts gives the cluster offsets
+    clusterLabels._offsets.resize(static_cast<std::size_t>(numberOfClusters) + 1);
+    clusterLabels._offsets[0] = 0;
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+        clusterLabels._offsets[clusterIndex + 1] = clusterLabels._offsets[clusterIndex] + counts[clusterIndex];
+
+    // Scatter the points in ascending order, so that the indices of each cluster end up sorted
+    clusterLabels._indices.resize(clusterLabels._offsets.back());
+
+    std::vector<std::size_t> positions(clusterLabels._offsets.begin(), clusterLabels._offsets.end() - 1);
+
+    for (std::uint32_t pointIndex = 0; pointIndex < static_cast<std::uint32_t>(labels.size()); ++pointIndex) {
+        const auto label = labels[pointIndex];
+
+        if (label != NO_CLUSTER)
+            clusterLabels._indices[positions[label]++] = pointIndex;
+    }
+
+    clusterLabels._numberOfPoints   = static_cast<std::uint32_t>(labels.size());
+    clusterLabels._labels           = std::move(labels);
+    clusterLabels._isDisjoint       = true;
+
+    return clusterLabels;
+}
+
+std::uint32_t ClusterLabels::getNumberOfClusters() const
+{
+    return static_cast<std::uint32_t>(_offsets.size() - 1);
+}
+
+std::uint32_t ClusterLabels::getNumberOfPoints() const
+{
+    return _numberOfPoints;
+}
+
+std::size_t ClusterLabels::getNumberOfIndices() const
+{
+    return _indices.size();
+}
+
+bool ClusterLabels::isDisjoint() const
+{
+    return _isDisjoint;
+}
+
+const std::vector<std::uint32_t>& ClusterLabels::getLabels() const
+{
+    return _labels;
+}
+
+std::uint32_t ClusterLabels::getLabel(std::uint32_t pointIndex) const
+{
+    if (pointIndex >= _labels.size())
+        return NO_CLUSTER;
+
+    return _labels[pointIndex];
+}
+
+ClusterLabels::IndexRange ClusterLabels::getClusterIndices(std::uint32_t clusterIndex) const
+{
+    if (clusterIndex >= getNumberOfClusters())
+        throw std::runtime_error("Cluster index " + std::to_string(clusterIndex) + " is out of range");
+
+    return IndexRange(_indices.data() + _offsets[clusterIndex], _indices.data() + _offsets[clusterIndex + 1]);
+}
+
+const std::vector<std::size_t>& ClusterLabels::getOffsets() const
+{
+    return _offsets;
+}
+
+const std::vector<std::uint32_t>& ClusterLabels::getIndices() const
+{
+    return _indices;
+}
+
+std::vector<std::uint32_t> ClusterLabels::getPointIndices(const std::vector<std::uint32_t>& clusterIndices) const
+{
+    const auto numberOfClusters = getNumberOfClusters();
+
+    // Flag the selected clusters (so that duplicate cluster indices are only counted once)
+    std::vector<std::uint8_t> isSelected(numberOfClusters, 0);
+
+    std::size_t numberOfSelectedClusters    = 0;
+    std::size_t numberOfSelectedIndices     = 0;
+    std::uint32_t lastSelectedCluster       = NO_CLUSTER;
+
+    for (const auto clusterIndex : clusterIndices) {
+        if (clusterIndex >= numberOfClusters || isSelected[clusterIndex])
+            continue;
+
+        isSelected[clusterIndex] = 1;
+
+        ++numberOfSelectedClusters;
+
+        numberOfSelectedIndices += _offsets[clusterIndex + 1] - _offsets[clusterIndex];
+        lastSelectedCluster     = clusterIndex;
+    }
+
+    std::vector<std::uint32_t> pointIndices;
+
+    if (numberOfSelectedClusters == 0)
+        return pointIndices;
+
+    // The indices of a single cluster are already sorted and unique
+    if (numberOfSelectedClusters == 1) {
+        const auto clusterIndicesRange = getClusterIndices(lastSelectedCluster);
+
+        pointIndices.assign(clusterIndicesRange.begin(), clusterIndicesRange.end());
+
+        return pointIndices;
+    }
+
+    pointIndices.reserve(numberOfSelectedIndices);
+
+    // Scan the label array when sorting the gathered indices would be more expensive than visiting all points
+    const auto sortCost = static_cast<double>(numberOfSelectedIndices) * std::log2(static_cast<double>(numberOfSelectedIndices));
+
+    if (_isDisjoint && sortCost >= static_cast<double>(_numberOfPoints)) {
+        for (std::uint32_t pointIndex = 0; pointIndex < _numberOfPoints; ++pointIndex) {
+            const auto label = _labels[pointIndex];
+
+            if (label != NO_CLUSTER && isSelected[label])
+                pointIndices.push_back(pointIndex);
+        }
+
+        return pointIndices;
+    }
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+        if (isSelected[clusterIndex])
+            pointIndices.insert(pointIndices.end(), _indices.begin() + _offsets[clusterIndex], _indices.begin() + _offsets[clusterIndex + 1]);
+
+    std::sort(pointIndices.begin(), pointIndices.end());
+
+    // Overlapping clusters may share points
+    if (!_isDisjoint)
+        pointIndices.erase(std::unique(pointIndices.begin(), pointIndices.end()), pointIndices.end());
+
+    return pointIndices;
+}
+
+ClusterLabels ClusterLabels::relabeled(const std::vector<std::uint32_t>& mapping, std::uint32_t numberOfClusters) const
+{
+    if (mapping.size() != getNumberOfClusters())
+        throw std::runtime_error("Cluster label mapping size does not match the number of clusters");
+
+    for (const auto label : mapping)
+        if (label != NO_CLUSTER && label >= numberOfClusters)
+            throw std::runtime_error("Cluster label " + std::to_string(label) + " is out of range");
+
+    if (_isDisjoint) {
+        std::vector<std::uint32_t> labels(_labels.size());
+
+        for (std::size_t pointIndex = 0; pointIndex < _labels.size(); ++pointIndex)
+            labels[pointIndex] = _labels[pointIndex] == NO_CLUSTER ? NO_CLUSTER : mapping[_labels[pointIndex]];
+
+        return fromLabels(std::move(labels), numberOfClusters);
+    }
+
+    // Overlapping clusters: gather the index ranges per new cluster, and let initialize() sort and deduplicate them
+    ClusterLabels clusterLabels;
+
+    clusterLabels._offsets.assign(static_cast<std::size_t>(numberOfClusters) + 1, 0);
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < mapping.size(); ++clusterIndex)
+        if (mapping[clusterIndex] != NO_CLUSTER)
+            clusterLabels._offsets[mapping[clusterIndex] + 1] += _offsets[clusterIndex + 1] - _offsets[clusterIndex];
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+        clusterLabels._offsets[clusterIndex + 1] += clusterLabels._offsets[clusterIndex];
+
+    clusterLabels._indices.resize(clusterLabels._offsets.back());
+
+    std::vector<std::size_t> positions(clusterLabels._offsets.begin(), clusterLabels._offsets.end() - 1);
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < mapping.size(); ++clusterIndex) {
+        if (mapping[clusterIndex] == NO_CLUSTER)
+            continue;
+
+        auto& position = positions[mapping[clusterIndex]];
+
+        std::copy(_indices.begin() + _offsets[clusterIndex], _indices.begin() + _offsets[clusterIndex + 1], clusterLabels._indices.begin() + position);
+
+        position += _offsets[clusterIndex + 1] - _offsets[clusterIndex];
+    }
+
+    clusterLabels.initialize(_numberOfPoints);
+
+    return clusterLabels;
+}
+
+void ClusterLabels::initialize(std::uint32_t numberOfPoints)
+{
+    const auto numberOfClusters = getNumberOfClusters();
+
+    // Sort the indices of each cluster and remove duplicates, compacting the inverted index in place
+    std::size_t numberOfIndices = 0;
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex) {
+        const auto first    = _indices.begin() + _offsets[clusterIndex];
+        const auto last     = _indices.begin() + _offsets[clusterIndex + 1];
+
+        if (!std::is_sorted(first, last))
+            std::sort(first, last);
+
+        const auto unique = std::unique(first, last);
+
+        _offsets[clusterIndex] = numberOfIndices;
+
+        numberOfIndices = static_cast<std::size_t>(std::copy(first, unique, _indices.begin() + numberOfIndices) - _indices.begin());
+    }
+
+    _offsets[numberOfClusters] = numberOfIndices;
+
+    _indices.resize(numberOfIndices);
+
+    // Derive the number of points from the largest index (the last index of each cluster, as they are sorted)
+    _numberOfPoints = numberOfPoints;
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+        if (_offsets[clusterIndex + 1] > _offsets[clusterIndex])
+            _numberOfPoints = std::max(_numberOfPoints, _indices[_offsets[clusterIndex + 1] - 1] + 1);
+
+    // Build the label array, which is only possible when no point belongs to more than one cluster
+    _labels.assign(_numberOfPoints, NO_CLUSTER);
+    _isDisjoint = true;
+
+    for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters && _isDisjoint; ++clusterIndex) {
+        for (auto offset = _offsets[clusterIndex]; offset < _offsets[clusterIndex + 1]; ++offset) {
+            auto& label = _labels[_indices[offset]];
+
+            if (label != NO_CLUSTER) {
+                _isDisjoint = false;
+                break;
+            }
+
+            label = clusterIndex;
+        }
+    }
+
+    if (!_isDisjoint) {
+        _labels.clear();
+        _labels.shrink_to_fit();
+    }
+}
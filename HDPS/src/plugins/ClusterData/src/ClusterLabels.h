@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#pragma once
+
+#include "clusterdata_export.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Cluster labels class
+ *
+ * Point-oriented representation of a set of clusters: a dense point to cluster label array (when each
+ * point belongs to at most one cluster) together with an inverted index in compressed sparse row (CSR)
+ * layout, which stores the sorted point indices of all clusters back-to-back. Bulk operations like
+ * selecting by clusters, merging and removing clusters are linear in the number of points (and clusters),
+ * instead of requiring a concatenation and sort of the per-cluster index vectors.
+ *
+ */
+class CLUSTERDATA_EXPORT ClusterLabels
+{
+public:
+
+    /** Label of points that do not belong to any cluster */
+    static constexpr std::uint32_t NO_CLUSTER = std::numeric_limits<std::uint32_t>::max();
+
+    /** Contiguous range of point indices of one cluster */
+    class IndexRange
+    {
+    public:
+        IndexRange(const std::uint32_t* begin, const std::uint32_t* end) :
+            _begin(begin),
+            _end(end)
+        {
+        }
+
+        const std::uint32_t* begin() const { return _begin; }
+        const std::uint32_t* end() const { return _end; }
+        std::size_t size() const { return static_cast<std::size_t>(_end - _begin); }
+        bool empty() const { return _begin == _end; }
+
+    private:
+        const std::uint32_t*    _begin;     /** Pointer to the first index */
+        const std::uint32_t*    _end;       /** Pointer past the last index */
+    };
+
+public: // Construction
+
+    /** Constructs empty cluster labels */
+    ClusterLabels() = default;
+
+    /**
+     * Builds the labels from a sequence of clusters (e.g. a QVector<Cluster>), in O(n + k) for n indices and k clusters (plus a sort of clusters with unsorted indices)
+     * @param clusters Clusters which provide getIndices()
+     * @param numberOfPoints Number of points (zero to derive it from the largest index)
+     * @return Cluster labels
+     */
+    template<typename Clusters>
+    static ClusterLabels fromClusters(const Clusters& clusters, std::uint32_t numberOfPoints = 0)
+    {
+        ClusterLabels clusterLabels;
+
+        clusterLabels._offsets.reserve(static_cast<std::size_t>(clusters.size()) + 1);
+
+        for (const auto& cluster : clusters)
+            clusterLabels._offsets.push_back(clusterLabels._offsets.back() + cluster.getIndices().size());
+
+        clusterLabels._indices.reserve(clusterLabels._offsets.back());
+
+        for (const auto& cluster : clusters)
+            clusterLabels._indices.insert(clusterLabels._indices.end(), cluster.getIndices().begin(), cluster.getIndices().end());
+
+        clusterLabels.initialize(numberOfPoints);
+
+        return clusterLabels;
+    }
+
+    /**
+     * Builds the labels from a dense point to cluster label array, with a counting sort in O(n + k)
+     * @param labels Cluster label per point (NO_CLUSTER for unclustered points)
+     * @param numberOfClusters Number of clusters (labels must be smaller)
+     * @return Cluster labels
+     */
+    static ClusterLabels fromLabels(std::vector<std::uint32_t> labels, std::uint32_t numberOfClusters);
+
+public: // Getters
+
+    /** Get the number of clusters */
+    std::uint32_t getNumberOfClusters() const;
+
+    /** Get the number of points (one past the largest point index) */
+    std::uint32_t getNumberOfPoints() const;
+
+    /** Get the total number of indices over all clusters */
+    std::size_t getNumberOfIndices() const;
+
+    /** Get whether each point belongs to at most one cluster (only then the dense label array is available) */
+    bool isDisjoint() const;
+
+    /**
+     * Get the dense point to cluster label array
+     * @return Cluster label per point (empty when the clusters overlap)
+     */
+    const std::vector<std::uint32_t>& getLabels() const;
+
+    /**
+     * Get the cluster label of \p pointIndex
+     * @param pointIndex Point index
+     * @return Cluster index (NO_CLUSTER when the point is not clustered, or when the clusters overlap)
+     */
+    std::uint32_t getLabel(std::uint32_t pointIndex) const;
+
+    /**
+     * Get the (sorted) point indices of a cluster
+     * @param clusterIndex Cluster index
+     * @return Range of point indices
+     */
+    IndexRange getClusterIndices(std::uint32_t clusterIndex) const;
+
+    /**
+     * Get the offsets of the clusters in the inverted index (one more than the number of clusters)
+     * @return Offsets
+     */
+    const std::vector<std::size_t>& getOffsets() const;
+
+    /**
+     * Get the inverted index, the sorted point indices of all clusters back-to-back
+     * @return Packed point indices
+     */
+    const std::vector<std::uint32_t>& getIndices() const;
+
+public: // Bulk operations
+
+    /**
+     * Get the union of the point indices of \p clusterIndices, sorted and without duplicates; gathers from the inverted
+     * index for small selections, and scans the label array otherwise, so that the cost is at most O(n)
+     * @param clusterIndices Cluster indices (out of range indices are ignored)
+     * @return Point indices
+     */
+    std::vector<std::uint32_t> getPointIndices(const std::vector<std::uint32_t>& clusterIndices) const;
+
+    /**
+     * Get a copy with the clusters relabeled by \p mapping, which merges clusters that map to the same new label and
+     * removes clusters that map to NO_CLUSTER, in O(n + k)
+     * @param mapping New cluster index per current cluster index
+     * @param numberOfClusters Number of clusters after relabeling (mapped labels must be smaller)
+     * @return Relabeled cluster labels
+     */
+    ClusterLabels relabeled(const std::vector<std::uint32_t>& mapping, std::uint32_t numberOfClusters) const;
+
+private:
+
+    /**
+     * Sorts the indices per cluster and builds the label array from the offsets and indices
+     * @param numberOfPoints Number of points (zero to derive it from the largest index)
+     */
+    void initialize(std::uint32_t numberOfPoints);
+
+private:
+    std::vector<std::uint32_t>  _labels;                /** Cluster label per point (empty when the clusters overlap) */
+    std::vector<std::size_t>    _offsets = { 0 };       /** Offset of each cluster in the inverted index (plus the total) */
+    std::vector<std::uint32_t>  _indices;               /** Inverted index: sorted point indices per cluster, back-to-back */
+    std::uint32_t               _numberOfPoints = 0;    /** Number of points */
+    bool                        _isDisjoint = true;     /** Whether each point belongs to at most one cluster */
+};
@@ -11,6 +11,8 @@
 #include <QHeaderView>
 #include <QVBoxLayout>
 
+#include <utility>
+
 ClustersAction::ClustersAction(QObject* parent, Dataset<Clusters> clustersDataset /*= Dataset<Clusters>()*/) :
     WidgetAction(parent, "Clusters"),
     _clustersDataset(),
@@ -87,7 +89,7 @@ void ClustersAction::updateClustersModel()
 
 void ClustersAction::updateClustersDataset()
 {
-    if (_clustersModel.getClusters() == _clustersDataset->getClusters())
+    if (_clustersModel.getClusters() == std::as_const(*_clustersDataset).getClusters())
         return;
 
     _clustersDataset->getClusters() = _clustersModel.getClusters();
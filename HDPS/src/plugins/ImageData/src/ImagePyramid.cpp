@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "ImagePyramid.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+ImagePyramid::ImagePyramid(std::uint32_t tileSize /*= DEFAULT_TILE_SIZE*/, std::size_t cacheCapacity /*= DEFAULT_CACHE_CAPACITY*/) :
+    _imageSize(),
+    _tileSize(std::max(tileSize, 1u)),
+    _cacheCapacity(cacheCapacity),
+    _tileLoader(),
+    _leastRecentlyUsed(),
+    _cache()
+{
+}
+
+QSize ImagePyramid::getImageSize() const
+{
+    return _imageSize;
+}
+
+void ImagePyramid::setImageSize(const QSize& imageSize)
+{
+    if (imageSize == _imageSize)
+        return;
+
+    _imageSize = imageSize;
+
+    clear();
+}
+
+void ImagePyramid::setTileLoader(const TileLoader& tileLoader)
+{
+    _tileLoader = tileLoader;
+
+    clear();
+}
+
+std::uint32_t ImagePyramid::getTileSize() const
+{
+    return _tileSize;
+}
+
+std::uint32_t ImagePyramid::getNumberOfLevels() const
+{
+    if (_imageSize.isEmpty())
+        return 0;
+
+    std::uint32_t numberOfLevels = 1;
+
+    for (auto levelSize = _imageSize; static_cast<std::uint32_t>(std::max(levelSize.width(), levelSize.height())) > _tileSize; levelSize = getLevelSize(numberOfLevels - 1))
+        ++numberOfLevels;
+
+    return numberOfLevels;
+}
+
+QSize ImagePyramid::getLevelSize(std::uint32_t level) const
+{
+    if (_imageSize.isEmpty() || level >= 31)
+        return QSize(std::min(_imageSize.width(), 1), std::min(_imageSize.height(), 1));
+
+    // Round up, so that the last odd pixel of a level still ends up in the next level
+    const auto scale = 1 << level;
+
+    return QSize((_imageSize.width() + scale - 1) / scale, (_imageSize.height() + scale - 1) / scale);
+}
+
+QSize ImagePyramid::getNumberOfTiles(std::uint32_t level) const
+{
+    const auto levelSize    = getLevelSize(level);
+    const auto tileSize     = static_cast<int>(_tileSize);
+
+    return QSize((levelSize.width() + tileSize - 1) / tileSize, (levelSize.height() + tileSize - 1) / tileSize);
+}
+
+std::shared_ptr<const ImagePyramid::Tile> ImagePyramid::getTile(std::uint32_t dimensionIndex, std::uint32_t level, std::uint32_t column, std::uint32_t row)
+{
+    if (level >= getNumberOfLevels())
+        throw std::runtime_error("Image pyramid level is out of range");
+
+    const auto numberOfTiles = getNumberOfTiles(level);
+
+    if (column >= static_cast<std::uint32_t>(numberOfTiles.width()) || row >= static_cast<std::uint32_t>(numberOfTiles.height()))
+        throw std::runtime_error("Image pyramid tile is out of range");
+
+    const TileKey tileKey{ dimensionIndex, level, column, row };
+
+    // Move cached tiles to the front of the LRU list
+    if (auto it = _cache.find(tileKey); it != _cache.end()) {
+        _leastRecentlyUsed.splice(_leastRecentlyUsed.begin(), _leastRecentlyUsed, it->second.second);
+
+        return it->second.first;
+    }
+
+    // Computing a coarse tile recursively fetches (and caches) the tiles below it
+    auto tile = computeTile(tileKey);
+
+    _leastRecentlyUsed.push_front(tileKey);
+    _cache[tileKey] = { tile, _leastRecentlyUsed.begin() };
+
+    evict();
+
+    return tile;
+}
+
+QRect ImagePyramid::getScalarData(std::uint32_t dimensionIndex, std::uint32_t level, const QRect& rectangle, QVector<float>& scalarData)
+{
+    if (level >= getNumberOfLevels())
+        throw std::runtime_error("Image pyramid level is out of range");
+
+    const auto clippedRectangle = rectangle.intersected(QRect(QPoint(0, 0), getLevelSize(level)));
+
+    scalarData.clear();
+
+    if (clippedRectangle.isEmpty())
+        return clippedRectangle;
+
+    scalarData.resize(static_cast<qsizetype>(clippedRectangle.width()) * clippedRectangle.height());
+
+    const auto tileSize = static_cast<int>(_tileSize);
+
+    // Copy the overlapping part of each tile row by row
+    for (int row = clippedRectangle.top() / tileSize; row <= clippedRectangle.bottom() / tileSize; ++row) {
+        for (int column = clippedRectangle.left() / tileSize; column <= clippedRectangle.right() / tileSize; ++column) {
+            const auto tile     = getTile(dimensionIndex, level, column, row);
+            const auto overlap  = tile->rectangle.intersected(clippedRectangle);
+
+            for (int y = overlap.top(); y <= overlap.bottom(); ++y) {
+                const auto source = tile->scalarData.data() + static_cast<std::size_t>(y - tile->rectangle.top()) * tile->rectangle.width() + (overlap.left() - tile->rectangle.left());
+                const auto target = scalarData.data() + static_cast<std::size_t>(y - clippedRectangle.top()) * clippedRectangle.width() + (overlap.left() - clippedRectangle.left());
+
+                std::copy(source, source + overlap.width(), target);
+            }
+        }
+    }
+
+    return clippedRectangle;
+}
+
+std::size_t ImagePyramid::getCacheCapacity() const
+{
+    return _cacheCapacity;
+}
+
+void ImagePyramid::setCacheCapacity(std::size_t cacheCapacity)
+{
+    _cacheCapacity = cacheCapacity;
+
+    evict();
+}
+
+std::size_t ImagePyramid::getNumberOfCachedTiles() const
+{
+    return _cache.size();
+}
+
+void ImagePyramid::clear()
+{
+    _leastRecentlyUsed.clear();
+    _cache.clear();
+}
+
+std::size_t ImagePyramid::TileKeyHash::operator()(const TileKey& tileKey) const
+{
+    auto hash = static_cast<std::size_t>(tileKey.dimensionIndex);
+
+    for (const auto value : { tileKey.level, tileKey.column, tileKey.row })
+        hash = hash * 1000003u ^ value;
+
+    return hash;
+}
+
+std::shared_ptr<const ImagePyramid::Tile> ImagePyramid::computeTile(const TileKey& tileKey)
+{
+    const auto tileSize = static_cast<int>(_tileSize);
+
+    auto tile = std::make_shared<Tile>();
+
+    tile->rectangle = QRect(tileKey.column * tileSize, tileKey.row * tileSize, tileSize, tileSize).intersected(QRect(QPoint(0, 0), getLevelSize(tileKey.level)));
+    tile->scalarData.resize(static_cast<std::size_t>(tile->rectangle.width()) * tile->rectangle.height());
+
+    if (tileKey.level == 0) {
+        if (!_tileLoader)
+            throw std::runtime_error("Image pyramid has no tile loader");
+
+        _tileLoader(tileKey.dimensionIndex, tile->rectangle, tile->scalarData.data());
+
+        return tile;
+    }
+
+    // Downsample the (up to) four tiles of the finer level with a 2x2 box filter
+    const auto& rectangle = tile->rectangle;
+
+    QVector<float> finerScalarData;
+
+    const auto finerRectangle   = getScalarData(tileKey.dimensionIndex, tileKey.level - 1, QRect(2 * rectangle.left(), 2 * rectangle.top(), 2 * rectangle.width(), 2 * rectangle.height()), finerScalarData);
+    const auto finerWidth       = finerRectangle.width();
+    const auto finerHeight      = finerRectangle.height();
+
+    for (int y = 0; y < rectangle.height(); ++y) {
+        const auto y0 = 2 * y;
+        const auto y1 = std::min(y0 + 1, finerHeight - 1);
+
+        for (int x = 0; x < rectangle.width(); ++x) {
+            const auto x0 = 2 * x;
+            const auto x1 = std::min(x0 + 1, finerWidth - 1);
+
+            // At an odd border the missing pixels repeat the border pixels
+            const auto sum = finerScalarData[y0 * finerWidth + x0] + finerScalarData[y0 * finerWidth + x1] + finerScalarData[y1 * finerWidth + x0] + finerScalarData[y1 * finerWidth + x1];
+
+            tile->scalarData[static_cast<std::size_t>(y) * rectangle.width() + x] = 0.25f * sum;
+        }
+    }
+
+    return tile;
+}
+
+void ImagePyramid::evict()
+{
+    while (_cache.size() > _cacheCapacity && !_leastRecentlyUsed.empty()) {
+        _cache.erase(_leastRecentlyUsed.back());
+        _leastRecentlyUsed.pop_back();
+    }
+}
@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#pragma once
+
+#include "Common.h"
+
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Image pyramid class
+ *
+ * Tiled, multi-resolution representation of the scalar data of an image. Level zero has the full
+ * resolution and each next level halves the width and height (2x2 box filter), up to the level
+ * that fits in a single tile. Tiles are computed on demand: level zero tiles are loaded with the
+ * tile loader and the tiles of coarser levels are downsampled from the four tiles below them.
+ * Computed tiles are kept in a least recently used (LRU) cache, so that viewers can request the
+ * visible tiles at screen resolution without ever producing the full resolution image.
+ *
+ * The image pyramid is not thread-safe.
+ */
+class IMAGEDATA_EXPORT ImagePyramid
+{
+public:
+
+    /** Scalar data of a tile */
+    struct Tile
+    {
+        QRect               rectangle;      /** Rectangle of the tile in level pixel coordinates (clipped to the level size) */
+        std::vector<float>  scalarData;     /** Scalars row by row */
+    };
+
+    /**
+     * Function that loads the full resolution scalars of a dimension for a rectangle
+     * @param dimensionIndex Dimension index
+     * @param rectangle Rectangle (in image coordinates, inside the image)
+     * @param scalarData Output for the scalars of the rectangle, row by row
+     */
+    using TileLoader = std::function<void(std::uint32_t dimensionIndex, const QRect& rectangle, float* scalarData)>;
+
+    /**
+     * Constructor
+     * @param tileSize Width and height of the tiles
+     * @param cacheCapacity Maximum number of cached tiles
+     */
+    ImagePyramid(std::uint32_t tileSize = DEFAULT_TILE_SIZE, std::size_t cacheCapacity = DEFAULT_CACHE_CAPACITY);
+
+    /** Get the full resolution image size */
+    QSize getImageSize() const;
+
+    /**
+     * Sets the full resolution image size (clears the cache when it changes)
+     * @param imageSize Image size
+     */
+    void setImageSize(const QSize& imageSize);
+
+    /**
+     * Sets the function that loads the full resolution scalars (clears the cache)
+     * @param tileLoader Tile loader
+     */
+    void setTileLoader(const TileLoader& tileLoader);
+
+    /** Get the width and height of the tiles */
+    std::uint32_t getTileSize() const;
+
+    /** Get the number of levels (at least one for a non-empty image) */
+    std::uint32_t getNumberOfLevels() const;
+
+    /**
+     * Get the size of the image at \p level
+     * @param level Level (zero for full resolution)
+     * @return Image size at the level
+     */
+    QSize getLevelSize(std::uint32_t level) const;
+
+    /**
+     * Get the number of tile columns and rows at \p level
+     * @param level Level
+     * @return Number of tiles along the width and the height
+     */
+    QSize getNumberOfTiles(std::uint32_t level) const;
+
+    /**
+     * Get a tile, computes it when it is not cached; throws a std::runtime_error when the tile does not exist
+     * @param dimensionIndex Dimension index
+     * @param level Level
+     * @param column Tile column
+     * @param row Tile row
+     * @return Shared pointer to the tile
+     */
+    std::shared_ptr<const Tile> getTile(std::uint32_t dimensionIndex, std::uint32_t level, std::uint32_t column, std::uint32_t row);
+
+    /**
+     * Get the scalar data of a rectangle at a level, composed from (cached) tiles; throws a std::runtime_error for an invalid level
+     * @param dimensionIndex Dimension index
+     * @param level Level
+     * @param rectangle Rectangle in level pixel coordinates (clipped to the level size)
+     * @param scalarData Scalars of the clipped rectangle, row by row (output)
+     * @return Clipped rectangle
+     */
+    QRect getScalarData(std::uint32_t dimensionIndex, std::uint32_t level, const QRect& rectangle, QVector<float>& scalarData);
+
+    /** Get the maximum number of cached tiles */
+    std::size_t getCacheCapacity() const;
+
+    /**
+     * Sets the maximum number of cached tiles (evicts the least recently used tiles when needed)
+     * @param cacheCapacity Maximum number of cached tiles
+     */
+    void setCacheCapacity(std::size_t cacheCapacity);
+
+    /** Get the number of cached tiles */
+    std::size_t getNumberOfCachedTiles() const;
+
+    /** Removes all tiles from the cache (for instance when the underlying data changed) */
+    void clear();
+
+private:
+
+    /** Key of a tile in the cache */
+    struct TileKey
+    {
+        std::uint32_t   dimensionIndex;
+        std::uint32_t   level;
+        std::uint32_t   column;
+        std::uint32_t   row;
+
+        bool operator==(const TileKey& other) const {
+            return dimensionIndex == other.dimensionIndex && level == other.level && column == other.column && row == other.row;
+        }
+    };
+
+    /** Hash of a tile key */
+    struct TileKeyHash
+    {
+        std::size_t operator()(const TileKey& tileKey) const;
+    };
+
+    /** Cached tile and its position in the LRU list */
+    using CacheEntry = std::pair<std::shared_ptr<const Tile>, std::list<TileKey>::iterator>;
+
+    /**
+     * Computes a tile
+     * @param tileKey Key of the tile
+     * @return Shared pointer to the computed tile
+     */
+    std::shared_ptr<const Tile> computeTile(const TileKey& tileKey);
+
+    /** Evicts the least recently used tiles until the cache fits its capacity */
+    void evict();
+
+public:
+    static constexpr std::uint32_t  DEFAULT_TILE_SIZE       = 256;      /** Default width and height of the tiles */
+    static constexpr std::size_t    DEFAULT_CACHE_CAPACITY  = 1024;     /** Default maximum number of cached tiles (256 MB of 256x256 tiles) */
+
+private:
+    QSize                                                   _imageSize;         /** Full resolution image size */
+    std::uint32_t                                           _tileSize;          /** Width and height of the tiles */
+    std::size_t                                             _cacheCapacity;     /** Maximum number of cached tiles */
+    TileLoader                                              _tileLoader;        /** Loads full resolution scalars */
+    std::list<TileKey>                                      _leastRecentlyUsed; /** Cached tile keys, most recently used first */
+    std::unordered_map<TileKey, CacheEntry, TileKeyHash>    _cache;             /** Cached tiles */
+};
@@ -7,6 +7,7 @@
 #include "InfoAction.h"
 
 #include <util/Exception.h>
+#include <util/ScalarStatistics.h>
 #include <util/Timer.h>
 
 #include <DataHierarchyItem.h>
@@ -17,6 +18,11 @@
 
 #include <QDebug>
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+
 using namespace mv::util;
 
 Images::Images(mv::CoreInterface* core, QString dataName, const QString& guid /*= ""*/) :
@@ -25,7 +31,15 @@ Images::Images(mv::CoreInterface* core, QString dataName, const QString& guid /*
     _imageData(nullptr),
     _infoAction(),
     _visibleRectangle(),
-    _maskData()
+    _maskData(),
+    _maskState(),
+    _maskRevision(0),
+    _globalIndices(),
+    _globalIndicesRevision(0),
+    _selectionRasterCache(),
+    _pyramid(),
+    _pyramidState(),
+    _pyramidPixelPoints()
 {
     _imageData = &getRawData<ImageData>();
 
@@ -227,14 +241,10 @@ void Images::getScalarData(const std::uint32_t& dimensionIndex, QVector<float>&
                 break;
         }
 
-        // Initialize scalar data range
-        scalarDataRange = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+        // Compute the actual scalar data range (vectorized and multithreaded)
+        const auto statistics = computeScalarStatistics(scalarData.constData(), static_cast<std::size_t>(scalarData.count()));
 
-        // Compute the actual scalar data range
-        for (auto& scalar : scalarData) {
-            scalarDataRange.first   = std::min(scalar, scalarDataRange.first);
-            scalarDataRange.second  = std::max(scalar, scalarDataRange.second);
-        }
+        scalarDataRange = { statistics.minimum, statistics.maximum };
     }
     catch (std::exception& e)
     {
@@ -247,140 +257,249 @@ void Images::getScalarData(const std::uint32_t& dimensionIndex, QVector<float>&
 
 void Images::getMaskData(std::vector<std::uint8_t>& maskData)
 {
-    if (!_maskData.empty())
-        maskData = _maskData;
-    else
-        computeMaskData();
+    // Computes the mask data only if the input dataset changed
+    computeMaskData();
+
+    maskData = _maskData;
 }
 
 void Images::getSelectionData(std::vector<std::uint8_t>& selectionImageData, std::vector<std::uint32_t>& selectedIndices, QRect& selectionBoundaries)
 {
     try
     {
-        // Get smart pointer to parent dataset
-        auto parentDataset = getDataHierarchyItem().getParent().getDataset<DatasetImpl>();
+        updateSelectionRasterCache();
 
-        // Generate selection data for points
-        if (parentDataset->getDataType() == PointType) {
-            
-            // Obtain reference to the point source input dataset
-            auto points = Dataset<Points>(parentDataset);
+        selectionImageData  = _selectionRasterCache.raster;
+        selectedIndices     = _selectionRasterCache.selectedIndices;
+        selectionBoundaries = _selectionRasterCache.boundaries;
+    }
+    catch (std::exception& e)
+    {
+        exceptionMessageBox("Unable to get image selection data", e);
+    }
+    catch (...) {
+        exceptionMessageBox("Unable to get image selection data");
+    }
+}
 
-            // Get selection indices from points dataset
-            auto& selectionIndices = points->getSelection<Points>()->indices;
+const std::vector<std::uint8_t>& Images::getSelectionRaster(QRect& dirtyRectangle)
+{
+    try
+    {
+        updateSelectionRasterCache();
+    }
+    catch (std::exception& e)
+    {
+        exceptionMessageBox("Unable to get image selection raster", e);
+    }
+    catch (...) {
+        exceptionMessageBox("Unable to get image selection raster");
+    }
 
-            // Clear the selected indices
-            selectedIndices.clear();
-            selectedIndices.reserve(getNumberOfPixels());
+    dirtyRectangle = _selectionRasterCache.dirtyRectangle;
 
-            const auto imageWidth = getImageSize().width();
+    _selectionRasterCache.dirtyRectangle = QRect();
 
-            // Fill selection data with non-selected
-            std::fill(selectionImageData.begin(), selectionImageData.end(), 0);
+    return _selectionRasterCache.raster;
+}
 
-            // Computes and caches the mask data
-            computeMaskData();
+std::uint32_t Images::getNumberOfPyramidLevels()
+{
+    updatePyramid();
 
-            // Global indices into data
-            std::vector<std::uint32_t> globalIndices;
+    return _pyramid.getNumberOfLevels();
+}
 
-            // Get global indices from points
-            points->getGlobalIndices(globalIndices);
+QSize Images::getPyramidLevelSize(std::uint32_t level)
+{
+    updatePyramid();
 
-            // Iterate over selection indices and modify the selection boundaries when not masked
-            for (const auto& selectionIndex : selectionIndices) {
+    return _pyramid.getLevelSize(level);
+}
 
-                // Do not continue if masked
-                if (_maskData[selectionIndex] == 0)
-                    continue;
+QRect Images::getScalarDataForRectangle(std::uint32_t dimensionIndex, std::uint32_t level, const QRect& rectangle, QVector<float>& scalarData)
+{
+    updatePyramid();
 
-                // Selected item is present in the (sub)set, so add it
-                selectedIndices.push_back(selectionIndex);
+    return _pyramid.getScalarData(dimensionIndex, level, rectangle, scalarData);
+}
 
-                // Assign selected pixel
-                selectionImageData[selectionIndex] = 255;
-            }
-        }
+void Images::updateSelectionRasterCache()
+{
+    // Get smart pointer to parent dataset
+    auto parentDataset = getDataHierarchyItem().getParent().getDataset<DatasetImpl>();
 
-        // Generate selection data for clusters
-        if (parentDataset->getDataType() == ClusterType) {
+    auto& cache = _selectionRasterCache;
 
-            // Computes and caches the mask data
-            computeMaskData();
+    // The selected pixels are masked, so bring the mask up to date first
+    computeMaskData();
 
-            // Obtain reference to the cluster source input dataset
-            auto sourceClusters = parentDataset->getSelection<Clusters>();
+    const auto numberOfPixels           = getNumberOfPixels();
+    const auto datasetId                = parentDataset.getDatasetId();
+    const auto selectionGeneration      = parentDataset->getSelectionGeneration();
+    const auto dataGeneration           = parentDataset->getDataGeneration();
+    const auto globalIndicesRevision    = parentDataset->getDataType() == ClusterType ? parentDataset->getParent()->getSourceDataset<Points>()->getGlobalIndicesRevision() : 0;
+    const auto isSameDataset            = datasetId == cache.datasetId && cache.raster.size() == numberOfPixels;
 
-            // Clear the selected indices
-            selectedIndices.clear();
-            selectedIndices.reserve(getNumberOfPixels());
+    // Nothing to do if neither the selection nor the state it is derived from changed since the last update
+    if (isSameDataset && selectionGeneration == cache.selectionGeneration && dataGeneration == cache.dataGeneration && globalIndicesRevision == cache.globalIndicesRevision && _maskRevision == cache.maskRevision)
+        return;
 
-            const auto imageWidth = getImageSize().width();
+    std::vector<std::uint32_t> selectedIndices;
 
-            // Fill selection data with non-selected
-            std::fill(selectionImageData.begin(), selectionImageData.end(), 0);
+    computeSelectedPixelIndices(selectedIndices);
 
-            // Get clusters input points dataset
-            auto points = parentDataset->getParent()->getSourceDataset<Points>();
+    auto sortedPixelIndices = selectedIndices;
 
-            // Global indices into data
-            std::vector<std::uint32_t> globalIndices;
+    std::sort(sortedPixelIndices.begin(), sortedPixelIndices.end());
+    sortedPixelIndices.erase(std::unique(sortedPixelIndices.begin(), sortedPixelIndices.end()), sortedPixelIndices.end());
 
-            // Get global indices from points
-            points->getGlobalIndices(globalIndices);
+    if (isSameDataset) {
 
-            // Iterate over all clusters and populate the selection data
-            for (const auto& clusterIndex : sourceClusters->indices) {
-                
-                // Get reference to cluster
-                const auto& cluster = sourceClusters->getClusters()[clusterIndex];
-                
-                // Iterate over all indices in the cluster
-                for (const auto& index : cluster.getIndices()) {
+        // Only update the pixels that were selected or deselected, and bound them by the dirty rectangle
+        auto left   = std::numeric_limits<int>::max();
+        auto right  = std::numeric_limits<int>::lowest();
+        auto top    = std::numeric_limits<int>::max();
+        auto bottom = std::numeric_limits<int>::lowest();
 
-                    // Get the global pixel index
-                    const auto globalPixelIndex = globalIndices[index];
+        const auto updatePixel = [this, &cache, &left, &right, &top, &bottom](std::uint32_t pixelIndex, std::uint8_t value) -> void {
+            cache.raster[pixelIndex] = value;
 
-                    // Add the global index to the list of selected indices
-                    selectedIndices.push_back(globalPixelIndex);
+            const auto pixelCoordinate = getPixelCoordinateFromPixelIndex(pixelIndex);
 
-                    // Assign selected pixel
-                    selectionImageData[globalPixelIndex] = 255;
-                }
+            left    = std::min(left, pixelCoordinate.x());
+            right   = std::max(right, pixelCoordinate.x());
+            top     = std::min(top, pixelCoordinate.y());
+            bottom  = std::max(bottom, pixelCoordinate.y());
+        };
+
+        const auto& previousPixelIndices = cache.sortedPixelIndices;
+
+        auto previous   = previousPixelIndices.begin();
+        auto current    = sortedPixelIndices.begin();
+
+        while (previous != previousPixelIndices.end() || current != sortedPixelIndices.end()) {
+            if (current == sortedPixelIndices.end() || (previous != previousPixelIndices.end() && *previous < *current))
+                updatePixel(*previous++, 0);
+            else if (previous == previousPixelIndices.end() || *current < *previous)
+                updatePixel(*current++, 255);
+            else {
+                ++previous;
+                ++current;
             }
         }
 
-        // Initialize selection boundaries with numeric extremes
-        selectionBoundaries.setTop(std::numeric_limits<int>::max());
-        selectionBoundaries.setBottom(std::numeric_limits<int>::lowest());
-        selectionBoundaries.setLeft(std::numeric_limits<int>::max());
-        selectionBoundaries.setRight(std::numeric_limits<int>::lowest());
+        if (left <= right)
+            cache.dirtyRectangle = cache.dirtyRectangle.united(QRect(QPoint(left, top), QPoint(right, bottom)));
+    }
+    else {
+        cache.raster.assign(numberOfPixels, 0);
 
-        // Compute the selection boundaries from the selected indices
-        for (const auto& selectedIndex : selectedIndices) {
+        for (const auto& pixelIndex : sortedPixelIndices)
+            cache.raster[pixelIndex] = 255;
 
-            // Compute global pixel coordinate
-            const auto globalPixelCoordinate = getPixelCoordinateFromPixelIndex(selectedIndex);
+        cache.dirtyRectangle = getRectangle();
+    }
 
-            // Add pixel pixel coordinate and possibly inflate the selection boundaries
-            selectionBoundaries.setLeft(std::min(selectionBoundaries.left(), globalPixelCoordinate.x()));
-            selectionBoundaries.setRight(std::max(selectionBoundaries.right(), globalPixelCoordinate.x()));
-            selectionBoundaries.setTop(std::min(selectionBoundaries.top(), globalPixelCoordinate.y()));
-            selectionBoundaries.setBottom(std::max(selectionBoundaries.bottom(), globalPixelCoordinate.y()));
-        }
+    // Initialize selection boundaries with numeric extremes
+    QRect selectionBoundaries;
+
+    selectionBoundaries.setTop(std::numeric_limits<int>::max());
+    selectionBoundaries.setBottom(std::numeric_limits<int>::lowest());
+    selectionBoundaries.setLeft(std::numeric_limits<int>::max());
+    selectionBoundaries.setRight(std::numeric_limits<int>::lowest());
+
+    // Compute the selection boundaries from the selected indices
+    for (const auto& selectedIndex : sortedPixelIndices) {
 
-        // Tweak selection boundaries
-        selectionBoundaries = selectionBoundaries.marginsAdded(QMargins(0, 0, 1, 1));
+        // Compute global pixel coordinate
+        const auto globalPixelCoordinate = getPixelCoordinateFromPixelIndex(selectedIndex);
+
+        // Add pixel pixel coordinate and possibly inflate the selection boundaries
+        selectionBoundaries.setLeft(std::min(selectionBoundaries.left(), globalPixelCoordinate.x()));
+        selectionBoundaries.setRight(std::max(selectionBoundaries.right(), globalPixelCoordinate.x()));
+        selectionBoundaries.setTop(std::min(selectionBoundaries.top(), globalPixelCoordinate.y()));
+        selectionBoundaries.setBottom(std::max(selectionBoundaries.bottom(), globalPixelCoordinate.y()));
     }
-    catch (std::exception& e)
-    {
-        exceptionMessageBox("Unable to get image selection data", e);
+
+    // Tweak selection boundaries
+    cache.boundaries            = selectionBoundaries.marginsAdded(QMargins(0, 0, 1, 1));
+    cache.datasetId             = datasetId;
+    cache.selectionGeneration   = selectionGeneration;
+    cache.dataGeneration        = dataGeneration;
+    cache.globalIndicesRevision = globalIndicesRevision;
+    cache.maskRevision          = _maskRevision;
+    cache.selectedIndices       = std::move(selectedIndices);
+    cache.sortedPixelIndices    = std::move(sortedPixelIndices);
+}
+
+void Images::computeSelectedPixelIndices(std::vector<std::uint32_t>& selectedIndices)
+{
+    // Get smart pointer to parent dataset
+    auto parentDataset = getDataHierarchyItem().getParent().getDataset<DatasetImpl>();
+
+    selectedIndices.clear();
+
+    // Generate selection data for points
+    if (parentDataset->getDataType() == PointType) {
+
+        // Obtain reference to the point source input dataset
+        auto points = Dataset<Points>(parentDataset);
+
+        // Get selection indices from points dataset
+        const auto& selectionIndices = points->getSelection<Points>()->indices;
+
+        selectedIndices.reserve(selectionIndices.size());
+
+        // Computes and caches the mask data
+        computeMaskData();
+
+        // Only add selection indices that are not masked
+        for (const auto& selectionIndex : selectionIndices)
+            if (_maskData[selectionIndex] != 0)
+                selectedIndices.push_back(selectionIndex);
     }
-    catch (...) {
-        exceptionMessageBox("Unable to get image selection data");
+
+    // Generate selection data for clusters
+    if (parentDataset->getDataType() == ClusterType) {
+
+        // Obtain reference to the cluster source input dataset
+        auto sourceClusters = parentDataset->getSelection<Clusters>();
+
+        // Get clusters input points dataset
+        auto points = parentDataset->getParent()->getSourceDataset<Points>();
+
+        // Global indices into data (only copied when they changed)
+        const auto globalIndicesRevision = points->getGlobalIndicesRevision();
+
+        if (globalIndicesRevision != _globalIndicesRevision) {
+            points->getGlobalIndices(_globalIndices);
+
+            _globalIndicesRevision = globalIndicesRevision;
+        }
+
+        // Iterate over all clusters and add the global pixel indices of their points
+        for (const auto& clusterIndex : sourceClusters->indices)
+            for (const auto& index : std::as_const(*sourceClusters).getClusters()[clusterIndex].getIndices())
+                selectedIndices.push_back(_globalIndices[index]);
     }
 }
 
+std::vector<const LinkedData*> Images::getReceivedLinkedData(const Dataset<DatasetImpl>& dataset)
+{
+    std::vector<const LinkedData*> receivedLinkedData;
+
+    if (!hasLinkedDataFlag(DatasetImpl::LinkedDataFlag::Receive))
+        return receivedLinkedData;
+
+    // Only linked data with the same original full data, because we don't want to add data here that belongs to a different dataset
+    for (const LinkedData& linkedData : dataset->getLinkedData())
+        if (linkedData.getTargetDataset()->getFullDataset<Points>() == dataset->getSourceDataset<Points>()->getFullDataset<Points>())
+            receivedLinkedData.push_back(&linkedData);
+
+    return receivedLinkedData;
+}
+
 void Images::getScalarDataForImageSequence(const std::uint32_t& dimensionIndex, QVector<float>& scalarData, QPair<float, float>& scalarDataRange)
 {
     // Get smart pointer to parent dataset
@@ -391,45 +510,28 @@ void Images::getScalarDataForImageSequence(const std::uint32_t& dimensionIndex,
         // Obtain reference to the points source input dataset
         auto points = parentDataset->getSourceDataset<Points>();
 
-        QSize sourceImageSize = getImageSize(), targetImageSize;
-
-        // Establish target image size based on sub-sampling
-        targetImageSize.setWidth(static_cast<int>(floorf(sourceImageSize.width())));
-        targetImageSize.setHeight(static_cast<int>(floorf(sourceImageSize.height())));
+        const auto noPixels             = std::min(getNumberOfPixels(), static_cast<std::uint32_t>(scalarData.count()));
+        const auto& selectionIndices    = points->getSelection<Points>()->indices;
 
-        points->visitData([this, points, dimensionIndex, &scalarData, sourceImageSize, targetImageSize](auto pointData) {
-            const auto dimensionId      = dimensionIndex;
-            const auto imageSize        = _imageData->getImageSize();
-            const auto noPixels         = getNumberOfPixels();
-            const auto selection        = points->getSelection<Points>();
-            const auto selectionIndices = selection->indices;
-            const auto selectionSize    = selectionIndices.size();
+        if (!selectionIndices.empty()) {
 
-            if (!selectionIndices.empty()) {
-                for (std::uint32_t p = 0; p < noPixels; p++) {
-                    auto sum = 0.0f;
+            // Average the selected frames: each frame is a point, so the frames are accumulated row by row (in parallel)
+            std::vector<float> means;
 
-                    for (auto selectionIndex : selectionIndices)
-                        sum += pointData[selectionIndex][p];
+            points->computeMeanPerDimension(means, selectionIndices);
 
-                    scalarData[p] = static_cast<float>(sum / selectionSize);
-                }
-            }
-            else {
-
-                // Populate scalar data vector with pixel data
-                for (std::int32_t pixelX = 0; pixelX < targetImageSize.width(); pixelX++) {
-                    for (std::int32_t pixelY = 0; pixelY < targetImageSize.height(); pixelY++) {
+            std::copy_n(means.begin(), std::min<std::size_t>(noPixels, means.size()), scalarData.begin());
+        }
+        else {
 
-                        // Compute the source and target pixel index
-                        const auto targetPixelIndex = pixelY * targetImageSize.width() + pixelX;
+            // Populate scalar data vector with the pixels of the frame, which are contiguous in the point
+            points->visitData([dimensionIndex, noPixels, &scalarData](auto pointData) {
+                const auto frame = pointData[dimensionIndex];
 
-                        // And assign the scalar data
-                        scalarData[targetPixelIndex] = pointData[dimensionIndex][targetPixelIndex];
-                    }
-                }
-            }
-        });
+                for (std::uint32_t pixelIndex = 0; pixelIndex < noPixels; pixelIndex++)
+                    scalarData[pixelIndex] = frame[pixelIndex];
+            });
+        }
     }
 
     if (parentDataset->getDataType() == ClusterType) {
@@ -450,33 +552,33 @@ void Images::getScalarDataForImageStack(const std::uint32_t& dimensionIndex, QVe
         points->getGlobalIndices(globalIndices);
 
         if (points->isFull()) {
-            points->visitData([this, &points, dimensionIndex, &globalIndices, &scalarData](auto pointData) {
-                for (std::int32_t localPointIndex = 0; localPointIndex < globalIndices.size(); localPointIndex++) {
-                    const auto targetPixelIndex = globalIndices[localPointIndex];
-                    
-                    if (hasLinkedDataFlag(DatasetImpl::LinkedDataFlag::Receive)) {
-                        
-                        // If the data has any linked data
-                        for (LinkedData& linkedData : points->getLinkedData())
-                        {
-                            // Check if the linked data has the same original full data, because we don't want to
-                            // add data here that belongs to a different dataset
-                            if (linkedData.getTargetDataset()->getFullDataset<Points>() == points->getSourceDataset<Points>()->getFullDataset<Points>())
-                            {
-                                SelectionMap::Indices linkedIndices;
-
-                                linkedData.getMapping().populateMappingIndices(targetPixelIndex, linkedIndices);
-                                
-                                // Fill in the data for all the linked data indices based on the location of the original id
-                                for (unsigned int linkedIndex : linkedIndices)
-                                    scalarData[linkedIndex] = pointData[localPointIndex][dimensionIndex];
-                            }
-                        }
-                    }
-                    
-                    scalarData[targetPixelIndex] = pointData[localPointIndex][dimensionIndex];
+
+            // Extract the values of the dimension at once (vectorized), instead of visiting the points one by one
+            std::vector<float> dimensionValues;
+
+            points->extractDataForDimension(dimensionValues, dimensionIndex);
+
+            // Determine the linked data once instead of for every point
+            const auto receivedLinkedData = getReceivedLinkedData(points);
+
+            SelectionMap::Indices linkedIndices;
+
+            for (std::size_t localPointIndex = 0; localPointIndex < globalIndices.size(); localPointIndex++) {
+                const auto targetPixelIndex = globalIndices[localPointIndex];
+                const auto value            = dimensionValues[localPointIndex];
+
+                // Fill in the data for all the linked data indices based on the location of the original id
+                for (const auto linkedData : receivedLinkedData) {
+                    linkedIndices.clear();
+
+                    linkedData->getMapping().populateMappingIndices(targetPixelIndex, linkedIndices);
+
+                    for (unsigned int linkedIndex : linkedIndices)
+                        scalarData[linkedIndex] = value;
                 }
-            });
+
+                scalarData[targetPixelIndex] = value;
+            }
         }
         else {
             points->visitData([this, dimensionIndex, &globalIndices, &scalarData](auto pointData) {
@@ -508,7 +610,7 @@ void Images::getScalarDataForImageStack(const std::uint32_t& dimensionIndex, QVe
         auto clusterIndex = 0;
 
         // Iterate over all clusters
-        for (auto& cluster : clusters->getClusters()) {
+        for (const auto& cluster : std::as_const(*clusters).getClusters()) {
             if (hasLinkedDataFlag(DatasetImpl::LinkedDataFlag::Receive)) {
 
                 // If the data has any linked data
@@ -547,104 +649,78 @@ void Images::computeMaskData()
     // Get reference to input dataset
     auto inputDataset = getParent();
 
-    // Allocate mask data
-    if (_maskData.size() != getNumberOfPixels())
-        _maskData.resize(getNumberOfPixels());
-
-    // Generate mask data for points
-    if (inputDataset->getDataType() == PointType) {
+    // State of the input that determines the mask (the mask is only recomputed when it changed)
+    MaskState maskState;
 
-        // Obtain reference to the points dataset
-        auto points = Dataset<Points>(inputDataset);
+    maskState.datasetId             = inputDataset.getDatasetId();
+    maskState.dataGeneration        = inputDataset->getDataGeneration();
+    maskState.receivesLinkedData    = hasLinkedDataFlag(DatasetImpl::LinkedDataFlag::Receive);
 
-        // All masked by default
-        std::fill(_maskData.begin(), _maskData.end(), 0);
-
-        // Global indices into data
-        std::vector<std::uint32_t> globalIndices;
+    if (inputDataset->getDataType() == PointType) {
+        maskState.globalIndicesRevision = Dataset<Points>(inputDataset)->getGlobalIndicesRevision();
+        maskState.numberOfItems         = Dataset<Points>(inputDataset)->getNumPoints();
+    }
 
-        // Get global indices from points
-        points->getGlobalIndices(globalIndices);
+    // Clusters that are edited without a data changed notification are still detected when their size changes
+    if (inputDataset->getDataType() == ClusterType)
+        for (const auto& cluster : std::as_const(*Dataset<Clusters>(inputDataset)).getClusters())
+            maskState.numberOfItems += cluster.getIndices().size();
 
-        // Loop over all point indices and unmask them
-        points->visitData([this, &points, &globalIndices](auto pointData) {
-            for (std::int32_t localPointIndex = 0; localPointIndex < globalIndices.size(); localPointIndex++) {
-                const auto targetPixelIndex = globalIndices[localPointIndex];
+    if (_maskData.size() == getNumberOfPixels() && maskState == _maskState)
+        return;
 
-                if (hasLinkedDataFlag(DatasetImpl::LinkedDataFlag::Receive)) {
+    _maskState = maskState;
 
-                    // If the data has any linked data
-                    for (LinkedData& linkedData : points->getLinkedData())
-                    {
-                        // Check if the linked data has the same original full data, because we don't want to
-                        // add data here that belongs to a different dataset
-                        if (linkedData.getTargetDataset()->getFullDataset<Points>() == points->getSourceDataset<Points>()->getFullDataset<Points>())
-                        {
-                            SelectionMap::Indices linkedIndices;
+    ++_maskRevision;
 
-                            linkedData.getMapping().populateMappingIndices(targetPixelIndex, linkedIndices);
+    // Allocate mask data and mask out all pixels
+    _maskData.assign(getNumberOfPixels(), 0);
 
-                            // Fill in the data for all the linked data indices based on the location of the original id
-                            for (unsigned int linkedIndex : linkedIndices)
-                                _maskData[linkedIndex] = 255;
-                        }
-                    }
-                }
+    // Unmasks the pixel and the pixels it maps to in the linked data
+    const auto unmask = [this](const std::vector<const LinkedData*>& receivedLinkedData, std::uint32_t pixelIndex, SelectionMap::Indices& linkedIndices) -> void {
+        for (const auto linkedData : receivedLinkedData) {
+            linkedData->getMapping().populateMappingIndices(pixelIndex, linkedIndices);
 
-                _maskData[targetPixelIndex] = 255;
-            }
-        });
-    }
+            for (unsigned int linkedIndex : linkedIndices)
+                _maskData[linkedIndex] = 255;
+        }
 
-    // Generate mask data for clusters
-    if (inputDataset->getDataType() == ClusterType) {
+        _maskData[pixelIndex] = 255;
+    };
 
-        // Obtain reference to the clusters dataset
-        auto clusters = Dataset<Clusters>(inputDataset);
+    SelectionMap::Indices linkedIndices;
 
-        // Mask out all points
-        std::fill(_maskData.begin(), _maskData.end(), 0);
+    // Generate mask data for points
+    if (inputDataset->getDataType() == PointType) {
 
-        // Get clusters input points dataset
-        auto points = clusters->getParent()->getSourceDataset<Points>();
-        auto embedding = clusters->getParent();
+        // Obtain reference to the points dataset
+        auto points = Dataset<Points>(inputDataset);
 
         // Global indices into data
-        //std::vector<std::uint32_t> globalIndices;
+        std::vector<std::uint32_t> globalIndices;
 
         // Get global indices from points
-        //points->getGlobalIndices(globalIndices);
+        points->getGlobalIndices(globalIndices);
 
-        // Iterate over all clusters
-        for (auto& cluster : clusters->getClusters()) {
+        const auto receivedLinkedData = getReceivedLinkedData(points);
 
-            if (hasLinkedDataFlag(DatasetImpl::LinkedDataFlag::Receive)) {
+        // Loop over all point indices and unmask them
+        for (const auto& targetPixelIndex : globalIndices)
+            unmask(receivedLinkedData, targetPixelIndex, linkedIndices);
+    }
 
-                // If the data has any linked data
-                for (LinkedData& linkedData : embedding->getLinkedData())
-                {
-                    // Check if the linked data has the same original full data, because we don't want to
-                    // add data here that belongs to a different dataset
-                    if (linkedData.getTargetDataset()->getFullDataset<Points>() == embedding->getSourceDataset<Points>()->getFullDataset<Points>())
-                    {
-                        for (const auto globalPointIndex : cluster.getIndices())
-                        {
-                            SelectionMap::Indices linkedIndices;
+    // Generate mask data for clusters
+    if (inputDataset->getDataType() == ClusterType) {
 
-                            linkedData.getMapping().populateMappingIndices(globalPointIndex, linkedIndices);
+        // Obtain reference to the clusters dataset
+        auto clusters = Dataset<Clusters>(inputDataset);
 
-                            // Fill in the data for all the linked data indices based on the location of the original id
-                            for (unsigned int linkedIndex : linkedIndices)
-                                _maskData[linkedIndex] = 255;
-                        }
-                    }
-                }
-            }
+        const auto receivedLinkedData = getReceivedLinkedData(clusters->getParent());
 
-            // Iterate over all indices in the cluster and assign cluster index to scalar data
+        // Iterate over all clusters and unmask their points (const access keeps the cached cluster labels)
+        for (const auto& cluster : std::as_const(*clusters).getClusters())
             for (const auto globalPointIndex : cluster.getIndices())
-                _maskData[globalPointIndex] = 255;
-        }
+                unmask(receivedLinkedData, globalPointIndex, linkedIndices);
     }
 
     // Initialize visible rectangle with numeric extremes
@@ -653,23 +729,26 @@ void Images::computeMaskData()
     _visibleRectangle.setLeft(std::numeric_limits<int>::max());
     _visibleRectangle.setRight(std::numeric_limits<int>::lowest());
 
-    // Loop over mask elements and compute the visible rectangle
-    for (std::int32_t maskIndex = 0; maskIndex < _maskData.size(); maskIndex++) {
+    const auto imageWidth = getImageSize().width();
+
+    // Loop over the mask rows and compute the visible rectangle from the first and last visible pixel of each row
+    for (std::int32_t rowIndex = 0; imageWidth > 0 && rowIndex < getImageSize().height(); rowIndex++) {
+        const auto rowBegin = _maskData.begin() + static_cast<std::size_t>(rowIndex) * imageWidth;
+        const auto rowEnd   = rowBegin + imageWidth;
+        const auto first    = std::find_if(rowBegin, rowEnd, [](std::uint8_t mask) { return mask > 0; });
 
-        // Only include visible pixels
-        if (_maskData[maskIndex] <= 0)
+        // Only include rows with visible pixels
+        if (first == rowEnd)
             continue;
 
-        // Compute pixel coordinate from mask index
-        const auto pixelCoordinate = QPoint(maskIndex % getImageSize().width(), static_cast<std::int32_t>(floorf(maskIndex / static_cast<float>(getImageSize().width()))));
+        const auto last = std::find_if(std::make_reverse_iterator(rowEnd), std::make_reverse_iterator(first), [](std::uint8_t mask) { return mask > 0; });
 
-        // Add pixel coordinate and possibly inflate the visible rectangle
-        _visibleRectangle.setLeft(std::min(_visibleRectangle.left(), pixelCoordinate.x()));
-        _visibleRectangle.setRight(std::max(_visibleRectangle.right(), pixelCoordinate.x()));
-        _visibleRectangle.setTop(std::min(_visibleRectangle.top(), pixelCoordinate.y()));
-        _visibleRectangle.setBottom(std::max(_visibleRectangle.bottom(), pixelCoordinate.y()));
+        // Add the visible pixels of the row and possibly inflate the visible rectangle
+        _visibleRectangle.setLeft(std::min(_visibleRectangle.left(), static_cast<std::int32_t>(first - rowBegin)));
+        _visibleRectangle.setRight(std::max(_visibleRectangle.right(), static_cast<std::int32_t>(last.base() - rowBegin - 1)));
+        _visibleRectangle.setTop(std::min(_visibleRectangle.top(), rowIndex));
+        _visibleRectangle.setBottom(std::max(_visibleRectangle.bottom(), rowIndex));
     }
-    
 }
 
 QPoint Images::getPixelCoordinateFromPixelIndex(const std::int32_t& pixelIndex) const
@@ -682,6 +761,137 @@ std::int32_t Images::getPixelIndexFromPixelCoordinate(const QPoint& pixelCoordin
     return pixelCoordinate.y() * getImageSize().width() + pixelCoordinate.x();
 }
 
+void Images::updatePyramid()
+{
+    auto parent = getParent();
+
+    // The tiles are cached until the values (or for a subset, the points) they are computed from change
+    PyramidState pyramidState;
+
+    pyramidState.datasetId      = parent.getDatasetId();
+    pyramidState.dataGeneration = parent->getDataGeneration();
+
+    if (parent->getDataType() == PointType) {
+        auto points = Dataset<Points>(parent);
+
+        pyramidState.sourceDataGeneration   = points->getSourceDataset<Points>()->getDataGeneration();
+        pyramidState.globalIndicesRevision  = points->getGlobalIndicesRevision();
+        pyramidState.numberOfItems          = points->getNumPoints();
+    }
+
+    if (_pyramid.getImageSize() == getImageSize() && pyramidState == _pyramidState)
+        return;
+
+    _pyramidState = pyramidState;
+
+    _pyramidPixelPoints.clear();
+
+    // The pixels of a subset image stack are looked up by pixel index, so sort the points by their (global) pixel index once
+    if (_imageData->getType() == ImageData::Stack && parent->getDataType() == PointType && !Dataset<Points>(parent)->isFull()) {
+        std::vector<std::uint32_t> globalIndices;
+
+        Dataset<Points>(parent)->getGlobalIndices(globalIndices);
+
+        _pyramidPixelPoints.reserve(globalIndices.size());
+
+        for (std::uint32_t localPointIndex = 0; localPointIndex < globalIndices.size(); localPointIndex++)
+            _pyramidPixelPoints.emplace_back(globalIndices[localPointIndex], localPointIndex);
+
+        std::sort(_pyramidPixelPoints.begin(), _pyramidPixelPoints.end());
+    }
+
+    _pyramid.setImageSize(getImageSize());
+    _pyramid.setTileLoader([this](std::uint32_t dimensionIndex, const QRect& rectangle, float* scalarData) -> void {
+        loadPyramidTile(dimensionIndex, rectangle, scalarData);
+    });
+}
+
+void Images::loadPyramidTile(std::uint32_t dimensionIndex, const QRect& rectangle, float* scalarData)
+{
+    auto parent = getParent();
+
+    if (parent->getDataType() != PointType)
+        throw std::runtime_error("Image pyramid tiles are only available for point data");
+
+    const auto imageWidth       = static_cast<std::uint32_t>(getImageSize().width());
+    const auto rectangleWidth   = static_cast<std::uint32_t>(rectangle.width());
+
+    switch (_imageData->getType())
+    {
+        case ImageData::Sequence:
+        {
+            auto points = parent->getSourceDataset<Points>();
+
+            if (dimensionIndex >= points->getNumPoints())
+                throw std::runtime_error("Image index is out of range");
+
+            // Each image is a point, so a tile row is a contiguous range of its dimensions
+            points->visitData([dimensionIndex, imageWidth, rectangleWidth, &rectangle, scalarData](auto pointData) {
+                const auto image = pointData[dimensionIndex];
+
+                for (int y = rectangle.top(); y <= rectangle.bottom(); y++) {
+                    const auto rowOffset    = static_cast<std::size_t>(y) * imageWidth;
+                    const auto target       = scalarData + static_cast<std::size_t>(y - rectangle.top()) * rectangleWidth;
+
+                    for (std::uint32_t x = 0; x < rectangleWidth; x++)
+                        target[x] = image[rowOffset + rectangle.left() + x];
+                }
+            });
+
+            break;
+        }
+
+        case ImageData::Stack:
+        {
+            auto points = Dataset<Points>(parent);
+
+            if (dimensionIndex >= points->getNumDimensions())
+                throw std::runtime_error("Dimension index is out of range");
+
+            if (points->isFull()) {
+
+                // Each pixel is a point
+                points->visitData([dimensionIndex, imageWidth, rectangleWidth, &rectangle, scalarData](auto pointData) {
+                    for (int y = rectangle.top(); y <= rectangle.bottom(); y++) {
+                        const auto rowOffset    = static_cast<std::size_t>(y) * imageWidth;
+                        const auto target       = scalarData + static_cast<std::size_t>(y - rectangle.top()) * rectangleWidth;
+
+                        for (std::uint32_t x = 0; x < rectangleWidth; x++)
+                            target[x] = pointData[rowOffset + rectangle.left() + x][dimensionIndex];
+                    }
+                });
+            }
+            else {
+
+                // Pixels without a point in the subset are zero
+                std::fill_n(scalarData, static_cast<std::size_t>(rectangleWidth) * rectangle.height(), 0.0f);
+
+                points->visitData([this, dimensionIndex, imageWidth, rectangleWidth, &rectangle, scalarData](auto pointData) {
+                    for (int y = rectangle.top(); y <= rectangle.bottom(); y++) {
+
+                        // Pixel indices in 64 bits, so that the row end does not wrap around for large images
+                        const auto rowBegin = static_cast<std::uint64_t>(y) * imageWidth + rectangle.left();
+                        const auto rowEnd   = rowBegin + rectangleWidth;
+                        const auto target   = scalarData + static_cast<std::size_t>(y - rectangle.top()) * rectangleWidth;
+
+                        auto pixelPoint = std::lower_bound(_pyramidPixelPoints.begin(), _pyramidPixelPoints.end(), rowBegin, [](const std::pair<std::uint32_t, std::uint32_t>& pixelPoint, std::uint64_t pixelIndex) -> bool {
+                            return pixelPoint.first < pixelIndex;
+                        });
+
+                        for (; pixelPoint != _pyramidPixelPoints.end() && pixelPoint->first < rowEnd; ++pixelPoint)
+                            target[pixelPoint->first - rowBegin] = pointData[pixelPoint->second][dimensionIndex];
+                    }
+                });
+            }
+
+            break;
+        }
+
+        default:
+            throw std::runtime_error("Image pyramid tiles are not available for this image collection type");
+    }
+}
+
 void Images::fromVariantMap(const QVariantMap& variantMap)
 {
     DatasetImpl::fromVariantMap(variantMap);
@@ -7,6 +7,7 @@
 #include "Common.h"
 #include "Image.h"
 #include "ImageData.h"
+#include "ImagePyramid.h"
 
 #include <Set.h>
 
@@ -198,6 +199,42 @@ public:
      */
     void getSelectionData(std::vector<std::uint8_t>& selectionImageData, std::vector<std::uint32_t>& selectedIndices, QRect& selectionBoundaries);
 
+    /**
+     * Get the selection raster, which is cached per source dataset and selection generation, and only
+     * updated where the selection changed
+     * @param dirtyRectangle Rectangle (in image coordinates) that bounds the pixels that changed since the previous call (empty if none)
+     * @return Selection raster with 255 for selected pixels and 0 otherwise
+     */
+    const std::vector<std::uint8_t>& getSelectionRaster(QRect& dirtyRectangle);
+
+public: // Image pyramid
+
+    /**
+     * Get the number of levels of the image pyramid, level zero has the full resolution and each next level halves the width and height
+     * @return Number of pyramid levels
+     */
+    std::uint32_t getNumberOfPyramidLevels();
+
+    /**
+     * Get the image size at \p level of the image pyramid
+     * @param level Pyramid level
+     * @return Image size at the level
+     */
+    QSize getPyramidLevelSize(std::uint32_t level);
+
+    /**
+     * Get the scalar data of a rectangle at a level of the image pyramid, so that viewers only fetch the visible
+     * tiles at screen resolution instead of the full resolution image. Tiles are computed on demand and cached.
+     * Only point data is supported; for image sequences the scalars are those of image \p dimensionIndex.
+     * Throws a std::runtime_error when the scalar data cannot be produced.
+     * @param dimensionIndex Dimension index (image index for image sequences)
+     * @param level Pyramid level
+     * @param rectangle Rectangle in pixel coordinates of the level
+     * @param scalarData Scalars of the rectangle clipped to the level, row by row (output)
+     * @return Clipped rectangle
+     */
+    QRect getScalarDataForRectangle(std::uint32_t dimensionIndex, std::uint32_t level, const QRect& rectangle, QVector<float>& scalarData);
+
 protected:
 
     /**
@@ -216,9 +253,21 @@ protected:
      */
     void getScalarDataForImageStack(const std::uint32_t& dimensionIndex, QVector<float>& scalarData, QPair<float, float>& scalarDataRange);
 
-    /** Computes and caches the mask data */
+    /** Computes and caches the mask data (only when the input dataset, its data or its global indices changed since the last computation) */
     void computeMaskData();
 
+    /** Updates the cached selection raster when the selection, the mask or the clusters changed (incrementally for the same dataset) */
+    void updateSelectionRasterCache();
+
+    /**
+     * Computes the selected (and unmasked) pixel indices
+     * @param selectedIndices Selected pixel indices (output)
+     */
+    void computeSelectedPixelIndices(std::vector<std::uint32_t>& selectedIndices);
+
+    /** Get the linked datasets of \p dataset that share its original full data, if the linked data flags allow receiving */
+    std::vector<const mv::LinkedData*> getReceivedLinkedData(const mv::Dataset<mv::DatasetImpl>& dataset);
+
     /**
      * Get pixel coordinate from pixel index
      * @param pixelIndex Pixel index
@@ -232,6 +281,17 @@ protected:
      */
     std::int32_t getPixelIndexFromPixelCoordinate(const QPoint& pixelCoordinate) const;
 
+    /** Resets the image pyramid when the image size, the parent dataset, its values or its global indices changed */
+    void updatePyramid();
+
+    /**
+     * Loads the full resolution scalars of a rectangle for the image pyramid
+     * @param dimensionIndex Dimension index
+     * @param rectangle Rectangle (in image coordinates)
+     * @param scalarData Scalars of the rectangle, row by row (output)
+     */
+    void loadPyramidTile(std::uint32_t dimensionIndex, const QRect& rectangle, float* scalarData);
+
 public: // Serialization
 
     /**
@@ -247,9 +307,61 @@ public: // Serialization
     QVariantMap toVariantMap() const override;
 
 private:
+
+    /** State of the input dataset that the mask data was computed for */
+    struct MaskState
+    {
+        QString         datasetId;                      /** Identifier of the input dataset */
+        std::uint64_t   dataGeneration = 0;             /** Data generation of the input dataset */
+        std::uint64_t   globalIndicesRevision = 0;      /** Revision of the global indices of the input points (zero for clusters) */
+        std::size_t     numberOfItems = 0;              /** Number of points (or clustered points) */
+        bool            receivesLinkedData = false;     /** Whether pixels of linked data are unmasked as well */
+
+        bool operator==(const MaskState& other) const {
+            return datasetId == other.datasetId && dataGeneration == other.dataGeneration && globalIndicesRevision == other.globalIndicesRevision && numberOfItems == other.numberOfItems && receivesLinkedData == other.receivesLinkedData;
+        }
+    };
+
+    /** State of the parent dataset that the image pyramid tiles are computed from */
+    struct PyramidState
+    {
+        QString         datasetId;                      /** Identifier of the parent dataset */
+        std::uint64_t   dataGeneration = 0;             /** Data generation of the parent dataset */
+        std::uint64_t   sourceDataGeneration = 0;       /** Data generation of the source dataset of the parent (which holds the values of a subset) */
+        std::uint64_t   globalIndicesRevision = 0;      /** Revision of the global indices of the parent points */
+        std::size_t     numberOfItems = 0;              /** Number of points of the parent dataset */
+
+        bool operator==(const PyramidState& other) const {
+            return datasetId == other.datasetId && dataGeneration == other.dataGeneration && sourceDataGeneration == other.sourceDataGeneration && globalIndicesRevision == other.globalIndicesRevision && numberOfItems == other.numberOfItems;
+        }
+    };
+
+    /** Selection raster, cached for a source dataset and the state it was derived from */
+    struct SelectionRasterCache
+    {
+        QString                     datasetId;                  /** Identifier of the dataset the selection was derived from */
+        std::uint64_t               selectionGeneration = 0;    /** Selection generation of that dataset */
+        std::uint64_t               dataGeneration = 0;         /** Data generation of that dataset (a cluster selection depends on the clusters) */
+        std::uint64_t               globalIndicesRevision = 0;  /** Revision of the global indices of the clustered points (zero for points) */
+        std::uint64_t               maskRevision = 0;           /** Revision of the mask the selected pixels were masked with */
+        std::vector<std::uint8_t>   raster;                     /** Selection raster (255 for selected pixels) */
+        std::vector<std::uint32_t>  selectedIndices;            /** Selected pixel indices, in selection order */
+        std::vector<std::uint32_t>  sortedPixelIndices;         /** Sorted unique selected pixel indices (to determine the changed pixels) */
+        QRect                       boundaries;                 /** Boundaries of the selection (in image coordinates) */
+        QRect                       dirtyRectangle;             /** Bounds of the pixels that changed since the last getSelectionRaster(...) */
+    };
+
     std::vector<std::uint32_t>      _indices;               /** Selection indices */
     ImageData*                      _imageData;             /** Pointer to raw image data */
     QSharedPointer<InfoAction>      _infoAction;            /** Shared pointer to info action */
     QRect                           _visibleRectangle;      /** Rectangle which bounds the visible pixels */
     std::vector<std::uint8_t>       _maskData;              /** Mask data */
+    MaskState                       _maskState;             /** State of the input dataset the mask data was computed for */
+    std::uint64_t                   _maskRevision;          /** Incremented each time the mask data is computed */
+    std::vector<std::uint32_t>      _globalIndices;         /** Cached global indices of the clustered points */
+    std::uint64_t                   _globalIndicesRevision; /** Revision of the cached global indices (see Points::getGlobalIndicesRevision()) */
+    SelectionRasterCache            _selectionRasterCache;  /** Cached selection raster */
+    ImagePyramid                    _pyramid;               /** Tiled multi-resolution scalar data (computed on demand) */
+    PyramidState                    _pyramidState;          /** State of the parent dataset the pyramid tiles are computed from */
+    std::vector<std::pair<std::uint32_t, std::uint32_t>>    _pyramidPixelPoints;    /** Sorted (pixel index, point index) pairs of a subset image stack */
 };
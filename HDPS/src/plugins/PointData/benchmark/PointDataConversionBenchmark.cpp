@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// Measures the throughput of the point data conversion kernels, for each element type and each
+// instruction set that is supported by the CPU. Reports the number of gigabytes of source elements
+// converted per second.
+//
+// Usage: PointDataBenchmark [numberOfPoints] [numberOfDimensions]
+
+#include <PointDataConversion.h>
+
+#include <biovault_bfloat16/biovault_bfloat16.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using mv::ConversionInstructionSet;
+
+
+namespace
+{
+    constexpr int numberOfRepetitions{ 5 };
+
+    // Returns the highest throughput (in GB/s) of the specified number of repetitions of the function.
+    template <typename Function>
+    double measureThroughput(const std::size_t numberOfBytes, Function function)
+    {
+        double minimumSeconds = std::numeric_limits<double>::max();
+
+        for (int repetition{}; repetition < numberOfRepetitions; ++repetition)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+            minimumSeconds = std::min(minimumSeconds, duration.count());
+        }
+        return numberOfBytes / minimumSeconds / 1e9;
+    }
+
+
+    template <typename T>
+    void benchmarkElementType(const char* const typeName, const std::size_t numberOfPoints, const std::size_t numberOfDimensions)
+    {
+        const std::size_t numberOfElements = numberOfPoints * numberOfDimensions;
+
+        std::vector<T> elements(numberOfElements);
+
+        std::mt19937 randomNumberEngine;
+        std::uniform_int_distribution<int> distribution(0, 100);
+
+        for (auto& element : elements)
+            element = static_cast<T>(static_cast<float>(distribution(randomNumberEngine)));
+
+        // Random indices, like a selection that has been made in a scatter plot.
+        std::vector<unsigned int> indices(numberOfPoints / 2);
+        std::iota(indices.begin(), indices.end(), 0U);
+        std::shuffle(indices.begin(), indices.end(), randomNumberEngine);
+
+        std::vector<float> target(2 * numberOfPoints);
+
+        const auto dimensionIndex1 = std::size_t{};
+        const auto dimensionIndex2 = numberOfDimensions - 1;
+
+        for (const auto instructionSet : { ConversionInstructionSet::Scalar, ConversionInstructionSet::SSE2, ConversionInstructionSet::AVX2, ConversionInstructionSet::AVX512 })
+        {
+            if (instructionSet > mv::getSupportedConversionInstructionSet())
+                continue;
+
+            mv::setConversionInstructionSet(instructionSet);
+
+            // Converts a single column of column-major data.
+            const auto contiguous = measureThroughput(numberOfPoints * sizeof(T), [&]
+                {
+                    mv::convertElementsToFloat(elements.data(), numberOfPoints, target.data());
+                });
+
+            // Extracts two dimensions of row-major data, as for a scatter plot.
+            const auto strided = measureThroughput(2 * numberOfPoints * sizeof(T), [&]
+                {
+                    mv::gatherElementPairsToFloat(elements.data() + dimensionIndex1, elements.data() + dimensionIndex2, numberOfDimensions, numberOfPoints, target.data());
+                });
+
+            // Extracts two dimensions of the points at the indices, from row-major data.
+            const auto indexed = measureThroughput(2 * indices.size() * sizeof(T), [&]
+                {
+                    mv::gatherElementPairsToFloat(elements.data() + dimensionIndex1, elements.data() + dimensionIndex2, numberOfDimensions, indices.data(), indices.size(), target.data());
+                });
+
+            std::cout << std::left << std::setw(10) << typeName << std::setw(10) << mv::getConversionInstructionSetName(instructionSet)
+                << std::right << std::fixed << std::setprecision(2)
+                << std::setw(14) << contiguous << std::setw(14) << strided << std::setw(14) << indexed << std::endl;
+        }
+
+        mv::setConversionInstructionSet(mv::getSupportedConversionInstructionSet());
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    const std::size_t numberOfPoints = (argc > 1) ? std::stoull(argv[1]) : 10'000'000;
+    const std::size_t numberOfDimensions = (argc > 2) ? std::stoull(argv[2]) : 16;
+
+    if ((numberOfPoints == 0) || (numberOfDimensions == 0))
+    {
+        std::cerr << "The number of points and the number of dimensions should be greater than zero" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << numberOfPoints << " points, " << numberOfDimensions << " dimensions, throughput in GB/s of source elements" << std::endl;
+
+    std::cout << std::left << std::setw(10) << "Type" << std::setw(10) << "ISA"
+        << std::right << std::setw(14) << "Contiguous" << std::setw(14) << "Strided pair" << std::setw(14) << "Indexed pair" << std::endl;
+
+    benchmarkElementType<float>("float32", numberOfPoints, numberOfDimensions);
+    benchmarkElementType<biovault::bfloat16_t>("bfloat16", numberOfPoints, numberOfDimensions);
+    benchmarkElementType<std::int16_t>("int16", numberOfPoints, numberOfDimensions);
+    benchmarkElementType<std::uint16_t>("uint16", numberOfPoints, numberOfDimensions);
+    benchmarkElementType<std::int8_t>("int8", numberOfPoints, numberOfDimensions);
+    benchmarkElementType<std::uint8_t>("uint8", numberOfPoints, numberOfDimensions);
+
+    return EXIT_SUCCESS;
+}
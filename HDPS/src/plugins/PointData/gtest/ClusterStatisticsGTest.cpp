@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include "ClusterStatistics.h"
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace mv;
+
+
+namespace
+{
+    // Row-major and column-major copies of random data, with a random cluster label per point.
+    struct ClusteredData
+    {
+        ClusteredData(const std::size_t numberOfPoints, const std::size_t numberOfDimensions, const std::uint32_t numberOfClusters)
+            :
+            rowMajorData(numberOfPoints * numberOfDimensions),
+            columnMajorData(numberOfPoints * numberOfDimensions),
+            labels(numberOfPoints),
+            offsets(numberOfClusters + 1)
+        {
+            std::mt19937 randomNumberEngine;
+            std::uniform_int_distribution<int> valueDistribution(0, 255);
+            std::uniform_int_distribution<std::uint32_t> labelDistribution(0, numberOfClusters);
+
+            for (std::size_t pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+            {
+                for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+                {
+                    const auto value = static_cast<std::uint8_t>(valueDistribution(randomNumberEngine));
+
+                    rowMajorData[pointIndex * numberOfDimensions + dimensionIndex] = value;
+                    columnMajorData[dimensionIndex * numberOfPoints + pointIndex] = value;
+                }
+
+                // The label numberOfClusters stands for an unclustered point
+                const auto label = labelDistribution(randomNumberEngine);
+
+                labels[pointIndex] = (label == numberOfClusters) ? NO_CLUSTER_LABEL : label;
+            }
+
+            // Inverted index of the labels
+            for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+            {
+                offsets[clusterIndex] = clusterIndices.size();
+
+                for (std::uint32_t pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+                {
+                    if (labels[pointIndex] == clusterIndex)
+                    {
+                        clusterIndices.push_back(pointIndex);
+                    }
+                }
+            }
+
+            offsets[numberOfClusters] = clusterIndices.size();
+        }
+
+        std::vector<std::uint8_t> rowMajorData;
+        std::vector<std::uint8_t> columnMajorData;
+        std::vector<std::uint32_t> labels;
+        std::vector<std::size_t> offsets;
+        std::vector<std::uint32_t> clusterIndices;
+    };
+}
+
+
+TEST(ClusterStatistics, matchesStraightforwardComputation)
+{
+    constexpr std::size_t numberOfPoints = 50'000;
+    constexpr std::size_t numberOfDimensions = 9;
+    constexpr std::uint32_t numberOfClusters = 40;
+
+    const ClusteredData clusteredData(numberOfPoints, numberOfDimensions, numberOfClusters);
+    const std::atomic<bool> abortRequested{ false };
+
+    for (const bool isColumnMajor : { false, true })
+    {
+        // Without labels, the clusters are processed as possibly overlapping clusters
+        for (const bool useLabels : { true, false })
+        {
+            ClusterStatistics statistics;
+
+            const auto& data = isColumnMajor ? clusteredData.columnMajorData : clusteredData.rowMajorData;
+            const auto labels = useLabels ? clusteredData.labels : std::vector<std::uint32_t>();
+
+            ASSERT_TRUE(computeClusterStatistics(data.data(), numberOfPoints, numberOfDimensions, isColumnMajor, labels, clusteredData.offsets, clusteredData.clusterIndices, true, statistics, abortRequested));
+            ASSERT_EQ(statistics.numberOfClusters, numberOfClusters);
+            ASSERT_EQ(statistics.medians.size(), numberOfClusters * numberOfDimensions);
+
+            for (std::uint32_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+            {
+                const auto begin = clusteredData.clusterIndices.begin() + clusteredData.offsets[clusterIndex];
+                const auto end = clusteredData.clusterIndices.begin() + clusteredData.offsets[clusterIndex + 1];
+                const auto numberOfClusterPoints = static_cast<std::size_t>(end - begin);
+
+                ASSERT_EQ(statistics.numbersOfPoints[clusterIndex], numberOfClusterPoints);
+
+                for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+                {
+                    std::vector<double> values;
+
+                    for (auto it = begin; it != end; ++it)
+                    {
+                        values.push_back(clusteredData.rowMajorData[*it * numberOfDimensions + dimensionIndex]);
+                    }
+
+                    double mean{};
+
+                    for (const auto value : values)
+                    {
+                        mean += value;
+                    }
+
+                    mean /= values.size();
+
+                    double sumOfSquaredDeviations{};
+
+                    for (const auto value : values)
+                    {
+                        sumOfSquaredDeviations += (value - mean) * (value - mean);
+                    }
+
+                    std::sort(values.begin(), values.end());
+
+                    const auto median = (values.size() % 2 == 1) ? values[values.size() / 2] : (values[values.size() / 2 - 1] + values[values.size() / 2]) / 2.0;
+                    const auto index = clusterIndex * numberOfDimensions + dimensionIndex;
+
+                    EXPECT_NEAR(statistics.means[index], mean, 1e-4);
+                    EXPECT_NEAR(statistics.standardDeviations[index], std::sqrt(sumOfSquaredDeviations / (values.size() - 1)), 1e-4);
+                    EXPECT_EQ(statistics.medians[index], static_cast<float>(median));
+                }
+            }
+        }
+    }
+}
+
+
+TEST(ClusterStatistics, stopsWhenAborted)
+{
+    const ClusteredData clusteredData(1000, 2, 3);
+    const std::atomic<bool> abortRequested{ true };
+
+    ClusterStatistics statistics;
+
+    EXPECT_FALSE(computeClusterStatistics(clusteredData.rowMajorData.data(), 1000, 2, false, clusteredData.labels, clusteredData.offsets, clusteredData.clusterIndices, true, statistics, abortRequested));
+}
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include "DimensionStatistics.h"
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace mv;
+
+
+namespace
+{
+    // Straightforward two-pass computation of the statistics of one dimension of row-major data.
+    DimensionStatisticsAccumulator computeExpectedStatistics(const std::vector<std::int16_t>& data, const std::size_t numberOfDimensions, const std::size_t dimensionIndex, const std::vector<std::uint32_t>& indices)
+    {
+        DimensionStatisticsAccumulator expected;
+
+        for (const auto index : indices)
+        {
+            const double value = data[index * numberOfDimensions + dimensionIndex];
+
+            expected.mean += value;
+            expected.numberOfNonZeroValues += (value != 0.0) ? 1 : 0;
+        }
+
+        expected.numberOfValues = indices.size();
+        expected.mean /= indices.size();
+
+        for (const auto index : indices)
+        {
+            const double deviation = data[index * numberOfDimensions + dimensionIndex] - expected.mean;
+            expected.sumOfSquaredDeviations += deviation * deviation;
+        }
+
+        return expected;
+    }
+}
+
+
+TEST(DimensionStatistics, matchesTwoPassComputation)
+{
+    constexpr std::size_t numberOfPoints = 100'000;
+    constexpr std::size_t numberOfDimensions = 7;
+
+    std::mt19937 randomNumberEngine;
+    std::uniform_int_distribution<int> distribution(-3, 1000);
+
+    std::vector<std::int16_t> rowMajorData(numberOfPoints * numberOfDimensions);
+
+    for (auto& value : rowMajorData)
+    {
+        const auto randomValue = distribution(randomNumberEngine);
+        value = static_cast<std::int16_t>(randomValue < 0 ? 0 : randomValue);
+    }
+
+    std::vector<std::int16_t> columnMajorData(rowMajorData.size());
+
+    for (std::size_t pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+    {
+        for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+        {
+            columnMajorData[dimensionIndex * numberOfPoints + pointIndex] = rowMajorData[pointIndex * numberOfDimensions + dimensionIndex];
+        }
+    }
+
+    std::vector<std::uint32_t> allIndices(numberOfPoints), subsetIndices;
+
+    for (std::uint32_t pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+    {
+        allIndices[pointIndex] = pointIndex;
+
+        if (pointIndex % 3 == 1)
+        {
+            subsetIndices.push_back(pointIndex);
+        }
+    }
+
+    const std::atomic<bool> abortRequested{ false };
+
+    for (const bool isColumnMajor : { false, true })
+    {
+        for (const std::vector<std::uint32_t>* const indices : { static_cast<const std::vector<std::uint32_t>*>(nullptr), static_cast<const std::vector<std::uint32_t>*>(&subsetIndices) })
+        {
+            std::vector<DimensionStatisticsAccumulator> accumulators;
+
+            const auto& data = isColumnMajor ? columnMajorData : rowMajorData;
+
+            ASSERT_TRUE(accumulateDimensionStatistics(data.data(), numberOfPoints, numberOfDimensions, isColumnMajor, indices, accumulators, abortRequested));
+            ASSERT_EQ(accumulators.size(), numberOfDimensions);
+
+            for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+            {
+                const auto expected = computeExpectedStatistics(rowMajorData, numberOfDimensions, dimensionIndex, (indices == nullptr) ? allIndices : *indices);
+                const auto& actual = accumulators[dimensionIndex];
+
+                EXPECT_EQ(actual.numberOfValues, expected.numberOfValues);
+                EXPECT_EQ(actual.numberOfNonZeroValues, expected.numberOfNonZeroValues);
+                EXPECT_NEAR(actual.mean, expected.mean, 1e-9 * std::abs(expected.mean));
+                EXPECT_NEAR(actual.sumOfSquaredDeviations, expected.sumOfSquaredDeviations, 1e-9 * expected.sumOfSquaredDeviations);
+            }
+        }
+    }
+}
+
+
+TEST(DimensionStatistics, stopsWhenAborted)
+{
+    const std::vector<float> data(1000, 1.0f);
+    const std::atomic<bool> abortRequested{ true };
+
+    std::vector<DimensionStatisticsAccumulator> accumulators;
+
+    EXPECT_FALSE(accumulateDimensionStatistics(data.data(), data.size(), 1, false, nullptr, accumulators, abortRequested));
+}
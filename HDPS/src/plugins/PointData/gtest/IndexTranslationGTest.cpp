@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include "IndexTranslation.h"
+
+#include <util/SelectionBitmap.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace mv;
+
+
+TEST(IndexTranslation, compactsSelectedLocalIndices)
+{
+    constexpr std::uint32_t numberOfGlobalIndices = 1'000'000;
+
+    std::mt19937 randomNumberEngine;
+    std::uniform_int_distribution<std::uint32_t> distribution(0, numberOfGlobalIndices - 1);
+
+    // A subset of every other point, in random order
+    std::vector<std::uint32_t> globalIndices;
+
+    for (std::uint32_t globalIndex = 0; globalIndex < numberOfGlobalIndices; globalIndex += 2)
+        globalIndices.push_back(globalIndex);
+
+    std::shuffle(globalIndices.begin(), globalIndices.end(), randomNumberEngine);
+
+    std::vector<std::uint32_t> selectionIndices(100'000);
+
+    for (auto& selectionIndex : selectionIndices)
+        selectionIndex = distribution(randomNumberEngine);
+
+    const util::SelectionBitmap globalSelection(selectionIndices);
+
+    std::vector<std::uint32_t> expected;
+
+    for (std::uint32_t localIndex = 0; localIndex < globalIndices.size(); ++localIndex)
+    {
+        if (globalSelection.contains(globalIndices[localIndex]))
+            expected.push_back(localIndex);
+    }
+
+    std::vector<std::uint32_t> actual{ 42 };
+
+    compactLocalSelectionIndices(globalIndices, globalSelection, actual);
+
+    EXPECT_EQ(actual, expected);
+
+    compactLocalSelectionIndices(globalIndices, util::SelectionBitmap(), actual);
+
+    EXPECT_TRUE(actual.empty());
+}
+
+
+TEST(IndexTranslation, composesAndGathers)
+{
+    // Three points with two dimensions
+    const std::vector<std::int16_t> rowMajorData{ 1, 2, 3, 4, 5, 6 };
+    const std::vector<std::int16_t> columnMajorData{ 1, 3, 5, 2, 4, 6 };
+
+    std::vector<std::uint32_t> indices{ 1, 0 };
+
+    // The subset contains points 2 and 0
+    composeIndices(indices, { 2, 0 });
+
+    ASSERT_EQ(indices, std::vector<std::uint32_t>({ 0, 2 }));
+
+    for (const bool isColumnMajor : { false, true })
+    {
+        std::vector<std::int16_t> result(indices.size() * 2);
+
+        gatherRows((isColumnMajor ? columnMajorData : rowMajorData).data(), 3, 2, isColumnMajor, indices, result.data());
+
+        EXPECT_EQ(result, std::vector<std::int16_t>({ 1, 2, 5, 6 }));
+    }
+}
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+// The file to be tested:
+#include <PointDataConversion.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <biovault_bfloat16/biovault_bfloat16.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using mv::ConversionInstructionSet;
+
+
+namespace
+{
+    // Restores the instruction set that was originally used by the kernels, at the end of a test.
+    class InstructionSetRestorer
+    {
+    public:
+        ~InstructionSetRestorer()
+        {
+            mv::setConversionInstructionSet(_instructionSet);
+        }
+
+    private:
+        const ConversionInstructionSet _instructionSet{ mv::getConversionInstructionSet() };
+    };
+
+
+    template <typename T>
+    std::vector<T> generateRandomElements(const std::size_t numberOfElements)
+    {
+        std::mt19937 randomNumberEngine;
+
+        std::vector<T> elements(numberOfElements);
+
+        if constexpr (std::is_integral_v<T>)
+        {
+            std::uniform_int_distribution<int> distribution(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
+
+            for (auto& element : elements)
+                element = static_cast<T>(distribution(randomNumberEngine));
+        }
+        else
+        {
+            std::uniform_real_distribution<float> distribution(-1e6f, 1e6f);
+
+            for (auto& element : elements)
+                element = static_cast<T>(distribution(randomNumberEngine));
+        }
+        return elements;
+    }
+
+
+    // Expects that each instruction set yields the same floats as a plain static_cast. Uses a number
+    // of points that is not a multiple of the vector width, to also exercise the remaining elements.
+    template <typename T>
+    void expectAllInstructionSetsConvertLikeStaticCast()
+    {
+        const InstructionSetRestorer instructionSetRestorer;
+
+        constexpr std::size_t numberOfPoints{ 1001 };
+        constexpr std::size_t numberOfDimensions{ 5 };
+        constexpr std::size_t dimensionIndex1{ 1 };
+        constexpr std::size_t dimensionIndex2{ 3 };
+
+        const auto elements = generateRandomElements<T>(numberOfPoints * numberOfDimensions);
+
+        std::vector<unsigned int> indices(numberOfPoints / 2);
+
+        for (std::size_t i{}; i < indices.size(); ++i)
+            indices[i] = static_cast<unsigned int>((i * 7) % numberOfPoints);
+
+        for (const auto instructionSet : { ConversionInstructionSet::Scalar, ConversionInstructionSet::SSE2, ConversionInstructionSet::AVX2, ConversionInstructionSet::AVX512 })
+        {
+            if (instructionSet > mv::getSupportedConversionInstructionSet())
+                continue;
+
+            mv::setConversionInstructionSet(instructionSet);
+
+            SCOPED_TRACE(mv::getConversionInstructionSetName(instructionSet));
+
+            std::vector<float> converted(elements.size());
+            mv::convertElementsToFloat(elements.data(), elements.size(), converted.data());
+
+            for (std::size_t i{}; i < elements.size(); ++i)
+                EXPECT_EQ(converted[i], static_cast<float>(elements[i]));
+
+            std::vector<float> gathered(numberOfPoints);
+            mv::gatherElementsToFloat(elements.data() + dimensionIndex1, numberOfDimensions, numberOfPoints, gathered.data());
+
+            for (std::size_t i{}; i < numberOfPoints; ++i)
+                EXPECT_EQ(gathered[i], static_cast<float>(elements[i * numberOfDimensions + dimensionIndex1]));
+
+            std::vector<float> indexed(indices.size());
+            mv::gatherElementsToFloat(elements.data() + dimensionIndex1, numberOfDimensions, indices.data(), indices.size(), indexed.data());
+
+            for (std::size_t i{}; i < indices.size(); ++i)
+                EXPECT_EQ(indexed[i], static_cast<float>(elements[indices[i] * numberOfDimensions + dimensionIndex1]));
+
+            std::vector<float> pairs(2 * numberOfPoints);
+            mv::gatherElementPairsToFloat(elements.data() + dimensionIndex1, elements.data() + dimensionIndex2, numberOfDimensions, numberOfPoints, pairs.data());
+
+            for (std::size_t i{}; i < numberOfPoints; ++i)
+            {
+                EXPECT_EQ(pairs[2 * i], static_cast<float>(elements[i * numberOfDimensions + dimensionIndex1]));
+                EXPECT_EQ(pairs[2 * i + 1], static_cast<float>(elements[i * numberOfDimensions + dimensionIndex2]));
+            }
+
+            std::vector<float> indexedPairs(2 * indices.size());
+            mv::gatherElementPairsToFloat(elements.data() + dimensionIndex1, elements.data() + dimensionIndex2, numberOfDimensions, indices.data(), indices.size(), indexedPairs.data());
+
+            for (std::size_t i{}; i < indices.size(); ++i)
+            {
+                EXPECT_EQ(indexedPairs[2 * i], static_cast<float>(elements[indices[i] * numberOfDimensions + dimensionIndex1]));
+                EXPECT_EQ(indexedPairs[2 * i + 1], static_cast<float>(elements[indices[i] * numberOfDimensions + dimensionIndex2]));
+            }
+
+            // Accumulated in the order of the indices, so the sums are exactly those of a plain loop.
+            std::vector<float> accumulated(numberOfDimensions, 1.0f);
+            mv::accumulateRowsToFloat(elements.data(), numberOfDimensions, indices.data(), indices.size(), numberOfDimensions, accumulated.data());
+
+            for (std::size_t j{}; j < numberOfDimensions; ++j)
+            {
+                auto expectedSum = 1.0f;
+
+                for (const auto index : indices)
+                    expectedSum += static_cast<float>(elements[index * numberOfDimensions + j]);
+
+                EXPECT_EQ(accumulated[j], expectedSum);
+            }
+        }
+    }
+}
+
+
+TEST(PointDataConversion, allInstructionSetsConvertLikeStaticCast)
+{
+    expectAllInstructionSetsConvertLikeStaticCast<float>();
+    expectAllInstructionSetsConvertLikeStaticCast<biovault::bfloat16_t>();
+    expectAllInstructionSetsConvertLikeStaticCast<std::int16_t>();
+    expectAllInstructionSetsConvertLikeStaticCast<std::uint16_t>();
+    expectAllInstructionSetsConvertLikeStaticCast<std::int8_t>();
+    expectAllInstructionSetsConvertLikeStaticCast<std::uint8_t>();
+}
+
+
+TEST(PointDataConversion, unsupportedInstructionSetFallsBackToSupportedOne)
+{
+    const InstructionSetRestorer instructionSetRestorer;
+
+    mv::setConversionInstructionSet(ConversionInstructionSet::AVX512);
+    EXPECT_LE(mv::getConversionInstructionSet(), mv::getSupportedConversionInstructionSet());
+
+    mv::setConversionInstructionSet(ConversionInstructionSet::Scalar);
+    EXPECT_EQ(mv::getConversionInstructionSet(), ConversionInstructionSet::Scalar);
+}
@@ -8,6 +8,8 @@
 // GoogleTest header file:
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 
 // Test template instantiations for the most common template arguments:
@@ -16,6 +18,8 @@ template class mv::PointDataIterator<std::vector<float>::iterator, const unsigne
 template class mv::PointDataIterator<std::vector<float>::iterator, std::vector<unsigned>::const_iterator, unsigned(*)(std::vector<unsigned>::const_iterator)>;
 template class mv::PointDataIterator<std::vector<float>::const_iterator, const unsigned*, unsigned(*)(const unsigned*)>;
 template class mv::PointDataIterator<std::vector<float>::const_iterator, std::vector<unsigned>::const_iterator, unsigned(*)(std::vector<unsigned>::const_iterator)>;
+template class mv::PointDataIterator<mv::StridedIterator<std::vector<float>::const_iterator>, const unsigned*, unsigned(*)(const unsigned*)>;
+template class mv::StridedIterator<std::vector<float>::iterator>;
 
 using mv::PointDataIterator;
 
@@ -139,3 +143,62 @@ TEST(PointDataIterator, satisfiesRandomAccessIteratorRequirements)
     }
 }
 
+
+
+TEST(PointDataIterator, viewsColumnMajorDataThroughStridedIterators)
+{
+    constexpr unsigned numberOfDimensions = 3;
+    constexpr std::ptrdiff_t numberOfPoints = 4;
+
+    // Row-major: point after point, and column-major: dimension after dimension.
+    std::vector<float> rowMajorData(numberOfPoints * numberOfDimensions);
+    std::vector<float> columnMajorData(rowMajorData.size());
+
+    for (std::ptrdiff_t pointIndex{}; pointIndex < numberOfPoints; ++pointIndex)
+    {
+        for (std::ptrdiff_t dimensionIndex{}; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+        {
+            const auto value = static_cast<float>(10 * pointIndex + dimensionIndex);
+
+            rowMajorData[pointIndex * numberOfDimensions + dimensionIndex] = value;
+            columnMajorData[dimensionIndex * numberOfPoints + pointIndex] = value;
+        }
+    }
+
+    const std::vector<unsigned> indices{ 3U, 0U, 2U };
+    const auto indexFunction = [](const auto indexIterator) { return *indexIterator; };
+
+    const auto rowMajorRange = mv::makePointDataRangeOfSubset(rowMajorData.begin(), indices, numberOfDimensions, indexFunction);
+    const auto columnMajorRange = mv::makePointDataRangeOfSubset(mv::StridedIterator(columnMajorData.begin(), numberOfPoints), indices, numberOfDimensions, indexFunction);
+
+    ASSERT_EQ(columnMajorRange.size(), rowMajorRange.size());
+
+    for (std::size_t i{}; i < indices.size(); ++i)
+    {
+        const auto rowMajorPointView = rowMajorRange[i];
+        const auto columnMajorPointView = columnMajorRange[i];
+
+        EXPECT_EQ(columnMajorPointView.index(), rowMajorPointView.index());
+        EXPECT_TRUE(std::equal(columnMajorPointView.begin(), columnMajorPointView.end(), rowMajorPointView.begin(), rowMajorPointView.end()));
+    }
+
+    const auto fullSetRange = mv::makePointDataRangeOfFullSet(
+        mv::StridedIterator(columnMajorData.begin(), numberOfPoints),
+        mv::StridedIterator(columnMajorData.begin(), numberOfPoints, static_cast<std::ptrdiff_t>(columnMajorData.size())),
+        numberOfDimensions,
+        [](const auto index) { return index; });
+
+    ASSERT_EQ(fullSetRange.size(), static_cast<std::size_t>(numberOfPoints));
+
+    // Writing through a strided point view must modify the column-major data in place.
+    for (auto pointView : fullSetRange)
+    {
+        pointView[1] = -1.0f;
+    }
+
+    for (std::ptrdiff_t pointIndex{}; pointIndex < numberOfPoints; ++pointIndex)
+    {
+        EXPECT_EQ(columnMajorData[numberOfPoints + pointIndex], -1.0f);
+        EXPECT_EQ(columnMajorData[pointIndex], static_cast<float>(10 * pointIndex));
+    }
+}
@@ -10,6 +10,8 @@
 // GoogleTest header file:
 #include <gtest/gtest.h>
 
+#include <QTemporaryFile>
+
 #include <random>
 
 
@@ -133,3 +135,205 @@ GTEST_TEST(Points, visitDataAllowsAccessToAnyRandomSubset)
             }
         });
 }
+
+
+GTEST_TEST(Points, memoryMappedDataIsVisitedLikeDataInMemory)
+{
+    testCore([](mv::CoreInterface& core)
+        {
+            using PointDataElementType = std::int16_t;
+            const auto numberOfDimensions = 3U;
+            const auto numberOfPoints = 42U;
+
+            const auto numberOfDataElements = numberOfDimensions * numberOfPoints;
+
+            const auto inputData =
+                generateRandomData<numberOfDataElements, PointDataElementType>(1, std::numeric_limits<PointDataElementType>::max());
+
+            QTemporaryFile temporaryFile;
+            ASSERT_TRUE(temporaryFile.open());
+
+            // Write a header before the data, to test mapping at an offset.
+            const std::uint64_t offset = 8;
+            temporaryFile.write(QByteArray(offset, '\0'));
+            temporaryFile.write(reinterpret_cast<const char*>(inputData.data()), inputData.size() * sizeof(PointDataElementType));
+            temporaryFile.flush();
+
+            auto& inMemoryPoints = addPointsToCore(core, "inMemoryPoints");
+            inMemoryPoints.setData(inputData, numberOfDimensions);
+
+            auto& memoryMappedPoints = addPointsToCore(core, "memoryMappedPoints");
+            memoryMappedPoints.setMemoryMappedData<PointDataElementType>(temporaryFile.fileName(), numberOfPoints, numberOfDimensions, offset);
+
+            ASSERT_TRUE(memoryMappedPoints.isMemoryMapped());
+            ASSERT_EQ(memoryMappedPoints.getNumPoints(), numberOfPoints);
+            ASSERT_EQ(memoryMappedPoints.getNumDimensions(), numberOfDimensions);
+
+            for (unsigned valueIndex{}; valueIndex < numberOfDataElements; ++valueIndex)
+            {
+                ASSERT_EQ(memoryMappedPoints.getValueAt(valueIndex), inMemoryPoints.getValueAt(valueIndex));
+            }
+
+            std::vector<float> inMemoryResult(numberOfPoints);
+            std::vector<float> memoryMappedResult(numberOfPoints);
+
+            inMemoryPoints.extractDataForDimension(inMemoryResult, 1);
+            memoryMappedPoints.extractDataForDimension(memoryMappedResult, 1);
+
+            ASSERT_EQ(memoryMappedResult, inMemoryResult);
+
+            // Copy-on-write: modifying the data must not affect the file.
+            memoryMappedPoints.setValueAt(0, 0.0f);
+
+            ASSERT_TRUE(memoryMappedPoints.isMemoryMapped());
+            ASSERT_EQ(memoryMappedPoints.getValueAt(0), 0.0f);
+
+            temporaryFile.seek(offset);
+            PointDataElementType firstElementInFile{};
+            temporaryFile.read(reinterpret_cast<char*>(&firstElementInFile), sizeof(firstElementInFile));
+
+            ASSERT_EQ(firstElementInFile, inputData.front());
+        });
+}
+
+
+GTEST_TEST(Points, columnMajorStorageLayoutYieldsSameDataAsRowMajor)
+{
+    testCore([](mv::CoreInterface& core)
+        {
+            using PointDataElementType = std::uint8_t;
+            const auto numberOfDimensions = 5U;
+            const auto numberOfPoints = 42U;
+
+            const auto numberOfDataElements = numberOfDimensions * numberOfPoints;
+
+            const auto inputData =
+                generateRandomData<numberOfDataElements, PointDataElementType>(1, std::numeric_limits<PointDataElementType>::max());
+
+            auto& rowMajorPoints = addPointsToCore(core, "rowMajorPoints");
+            rowMajorPoints.setData(inputData, numberOfDimensions);
+
+            auto& columnMajorPoints = addPointsToCore(core, "columnMajorPoints");
+            columnMajorPoints.setData(inputData, numberOfDimensions, PointData::StorageLayout::ColumnMajor);
+
+            ASSERT_EQ(columnMajorPoints.getStorageLayout(), PointData::StorageLayout::ColumnMajor);
+            ASSERT_EQ(columnMajorPoints.getNumPoints(), numberOfPoints);
+
+            for (unsigned valueIndex{}; valueIndex < numberOfDataElements; ++valueIndex)
+            {
+                ASSERT_EQ(columnMajorPoints.getValueAt(valueIndex), rowMajorPoints.getValueAt(valueIndex));
+            }
+
+            for (unsigned dimensionIndex{}; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+            {
+                std::vector<float> rowMajorResult;
+                std::vector<float> columnMajorResult;
+
+                rowMajorPoints.extractDataForDimension(rowMajorResult, dimensionIndex);
+                columnMajorPoints.extractDataForDimension(columnMajorResult, dimensionIndex);
+
+                ASSERT_EQ(columnMajorResult, rowMajorResult);
+            }
+
+            const std::vector<int> dimensionIndices{ 4, 1, 2 };
+
+            std::vector<float> rowMajorResult(numberOfPoints * dimensionIndices.size());
+            std::vector<float> columnMajorResult(numberOfPoints * dimensionIndices.size());
+
+            rowMajorPoints.populateDataForDimensions(rowMajorResult, dimensionIndices);
+            columnMajorPoints.populateDataForDimensions(columnMajorResult, dimensionIndices);
+
+            ASSERT_EQ(columnMajorResult, rowMajorResult);
+
+            // Visiting the data must not rearrange it.
+            columnMajorPoints.visitData([&inputData](auto pointData)
+                {
+                    for (const auto pointView : pointData)
+                    {
+                        ASSERT_TRUE(std::equal(pointView.begin(), pointView.end(), inputData.cbegin() + pointView.index() * pointView.size()));
+                    }
+                });
+
+            ASSERT_EQ(columnMajorPoints.getStorageLayout(), PointData::StorageLayout::ColumnMajor);
+
+            // Converting back must restore the original order of the elements.
+            columnMajorPoints.setStorageLayout(PointData::StorageLayout::RowMajor);
+
+            columnMajorPoints.constVisitFromBeginToEnd([&inputData](const auto beginOfData, const auto endOfData)
+                {
+                    ASSERT_TRUE(std::equal(beginOfData, endOfData, inputData.cbegin(), inputData.cend()));
+                });
+        });
+}
+
+
+GTEST_TEST(Points, globalIndicesFollowReassignedSubsetIndices)
+{
+    testCore([](mv::CoreInterface& core)
+        {
+            auto fullPoints = core.addDataset<Points>("Points", "fullPoints");
+            fullPoints->setData(std::vector<float>(10), 1);
+
+            fullPoints->getSelection<Points>()->indices = { 1, 2, 3 };
+
+            mv::Dataset<Points> subsetPoints = fullPoints->createSubsetFromSelection("subsetPoints");
+
+            std::vector<unsigned int> globalIndices;
+
+            subsetPoints->getGlobalIndices(globalIndices);
+            ASSERT_EQ(globalIndices, std::vector<unsigned int>({ 1, 2, 3 }));
+
+            const auto revision = subsetPoints->getGlobalIndicesRevision();
+
+            ASSERT_EQ(subsetPoints->getGlobalIndicesRevision(), revision);
+            ASSERT_NE(fullPoints->getGlobalIndicesRevision(), revision);
+
+            // The same number of indices, so only the revision of the indices tells that the cache is stale.
+            subsetPoints->indices = { 7, 8, 9 };
+
+            subsetPoints->getGlobalIndices(globalIndices);
+            ASSERT_EQ(globalIndices, std::vector<unsigned int>({ 7, 8, 9 }));
+            ASSERT_NE(subsetPoints->getGlobalIndicesRevision(), revision);
+        });
+}
+
+
+GTEST_TEST(Points, datasetGraphIndexFollowsAddedAndRemovedDatasets)
+{
+    testCore([](mv::CoreInterface& core)
+        {
+            auto& dataManager = core.getDataManager();
+
+            auto sourcePoints = core.addDataset<Points>("Points", "sourcePoints");
+            auto otherPoints = core.addDataset<Points>("Points", "otherPoints");
+            mv::Dataset<Points> derivedPoints = core.createDerivedDataset("derivedPoints", sourcePoints);
+
+            ASSERT_EQ(dataManager.getSet(sourcePoints->getId()), sourcePoints);
+            ASSERT_EQ(dataManager.getSet(derivedPoints->getId()), derivedPoints);
+            ASSERT_EQ(dataManager.getDerivedDatasets(sourcePoints), mv::Datasets({ derivedPoints }));
+            ASSERT_EQ(dataManager.getDerivedDatasets(sourcePoints->getRawDataName()), mv::Datasets({ derivedPoints }));
+            ASSERT_TRUE(dataManager.getDerivedDatasets(otherPoints).isEmpty());
+            ASSERT_TRUE(dataManager.getDatasetsByRawDataName(sourcePoints->getRawDataName()).contains(sourcePoints));
+
+            // Changing the source dataset moves the derived dataset in the index
+            auto revision = dataManager.getDatasetGraphRevision();
+
+            derivedPoints->setSourceDataSet(otherPoints);
+
+            ASSERT_GT(dataManager.getDatasetGraphRevision(), revision);
+            ASSERT_TRUE(dataManager.getDerivedDatasets(sourcePoints).isEmpty());
+            ASSERT_EQ(dataManager.getDerivedDatasets(otherPoints), mv::Datasets({ derivedPoints }));
+
+            // Removing the source dataset un-derives the derived dataset
+            const auto otherPointsId = otherPoints->getId();
+
+            revision = dataManager.getDatasetGraphRevision();
+
+            core.removeDataset(otherPoints);
+
+            ASSERT_GT(dataManager.getDatasetGraphRevision(), revision);
+            ASSERT_FALSE(dataManager.getSet(otherPointsId).isValid());
+            ASSERT_FALSE(derivedPoints->isDerivedData());
+            ASSERT_EQ(dataManager.getSet(derivedPoints->getId()), derivedPoints);
+        });
+}
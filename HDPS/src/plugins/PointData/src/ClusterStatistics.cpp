@@ -0,0 +1,406 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "ClusterStatistics.h"
+
+#include <util/Parallel.h>
+
+#include <biovault_bfloat16/biovault_bfloat16.h>
+
+#include <algorithm> // For clamp, max_element, min and nth_element.
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    constexpr std::size_t TARGET_BLOCK_SIZE             = 1 << 15;                  // Number of values per block (fits in the L2 cache).
+    constexpr std::size_t MINIMUM_ROWS_PER_THREAD       = 4096;                     // Fewer rows do not pay off the scheduling of a task.
+    constexpr std::size_t MAXIMUM_ACCUMULATOR_MEMORY    = std::size_t{ 1 } << 28;   // Upper bound of the memory of the accumulators of all threads together (in bytes).
+    constexpr std::size_t MAXIMUM_GATHERED_VALUES       = std::size_t{ 1 } << 22;   // Upper bound of the number of values that a thread gathers for the medians.
+
+    // Running statistics of all clusters and dimensions, owned by one thread.
+    struct ClusterAccumulators
+    {
+        ClusterAccumulators(const std::size_t numberOfClusters, const std::size_t numberOfDimensions)
+            :
+            numbersOfValues(numberOfClusters),
+            means(numberOfClusters * numberOfDimensions),
+            sumsOfSquaredDeviations(numberOfClusters * numberOfDimensions)
+        {
+        }
+
+        // Adds the values accumulated by the other accumulators to these ones.
+        void merge(const ClusterAccumulators& other, const std::size_t numberOfDimensions)
+        {
+            for (std::size_t clusterIndex = 0; clusterIndex < numbersOfValues.size(); ++clusterIndex)
+            {
+                const auto numberOfValues = numbersOfValues[clusterIndex];
+                const auto otherNumberOfValues = other.numbersOfValues[clusterIndex];
+
+                if (otherNumberOfValues == 0)
+                {
+                    continue;
+                }
+
+                const auto totalNumberOfValues = numberOfValues + otherNumberOfValues;
+                const auto otherWeight = static_cast<double>(otherNumberOfValues) / static_cast<double>(totalNumberOfValues);
+
+                for (auto index = clusterIndex * numberOfDimensions; index < (clusterIndex + 1) * numberOfDimensions; ++index)
+                {
+                    const auto delta = other.means[index] - means[index];
+
+                    means[index] += delta * otherWeight;
+                    sumsOfSquaredDeviations[index] += other.sumsOfSquaredDeviations[index] + delta * delta * static_cast<double>(numberOfValues) * otherWeight;
+                }
+
+                numbersOfValues[clusterIndex] = totalNumberOfValues;
+            }
+        }
+
+        std::vector<std::uint64_t> numbersOfValues;
+        std::vector<double> means;
+        std::vector<double> sumsOfSquaredDeviations;
+    };
+
+
+    // Accumulates a block of labeled rows of row-major values, with a Welford update per row.
+    template <typename T>
+    void accumulateRowMajorBlock(const T* const data, const std::size_t numberOfDimensions, const std::uint32_t* const labels,
+        const std::size_t firstRowIndex, const std::size_t numberOfRows, ClusterAccumulators& accumulators)
+    {
+        for (auto rowIndex = firstRowIndex; rowIndex < firstRowIndex + numberOfRows; ++rowIndex)
+        {
+            const auto label = labels[rowIndex];
+
+            if (label == mv::NO_CLUSTER_LABEL)
+            {
+                continue;
+            }
+
+            const auto weight = 1.0 / static_cast<double>(++accumulators.numbersOfValues[label]);
+
+            const T* const row = data + rowIndex * numberOfDimensions;
+            double* const means = accumulators.means.data() + label * numberOfDimensions;
+            double* const sumsOfSquaredDeviations = accumulators.sumsOfSquaredDeviations.data() + label * numberOfDimensions;
+
+            for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+            {
+                const double value = static_cast<float>(row[dimensionIndex]);
+                const auto delta = value - means[dimensionIndex];
+
+                means[dimensionIndex] += delta * weight;
+                sumsOfSquaredDeviations[dimensionIndex] += delta * (value - means[dimensionIndex]);
+            }
+        }
+    }
+
+
+    // Accumulates a block of labeled rows of column-major values. The Welford weight of each row is determined
+    // first, so that the values of each dimension can then be processed contiguously.
+    template <typename T>
+    void accumulateColumnMajorBlock(const T* const data, const std::size_t numberOfPoints, const std::size_t numberOfDimensions, const std::uint32_t* const labels,
+        const std::size_t firstRowIndex, const std::size_t numberOfRows, ClusterAccumulators& accumulators, std::vector<double>& weights)
+    {
+        for (std::size_t rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+        {
+            const auto label = labels[firstRowIndex + rowIndex];
+
+            weights[rowIndex] = (label == mv::NO_CLUSTER_LABEL) ? 0.0 : 1.0 / static_cast<double>(++accumulators.numbersOfValues[label]);
+        }
+
+        for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+        {
+            const T* const values = data + dimensionIndex * numberOfPoints + firstRowIndex;
+
+            for (std::size_t rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+            {
+                const auto label = labels[firstRowIndex + rowIndex];
+
+                if (label == mv::NO_CLUSTER_LABEL)
+                {
+                    continue;
+                }
+
+                const auto index = label * numberOfDimensions + dimensionIndex;
+                const double value = static_cast<float>(values[rowIndex]);
+                const auto delta = value - accumulators.means[index];
+
+                accumulators.means[index] += delta * weights[rowIndex];
+                accumulators.sumsOfSquaredDeviations[index] += delta * (value - accumulators.means[index]);
+            }
+        }
+    }
+
+
+    // Computes the means and sums of squared deviations of one cluster, in two passes over its points.
+    template <typename T>
+    void accumulateCluster(const T* const data, const std::size_t numberOfPoints, const std::size_t numberOfDimensions, const bool isColumnMajor,
+        const std::uint32_t* const pointIndices, const std::size_t numberOfPointIndices, double* const means, double* const sumsOfSquaredDeviations)
+    {
+        std::fill(means, means + numberOfDimensions, 0.0);
+        std::fill(sumsOfSquaredDeviations, sumsOfSquaredDeviations + numberOfDimensions, 0.0);
+
+        if (numberOfPointIndices == 0)
+        {
+            return;
+        }
+
+        const auto getValue = [=](const std::size_t pointIndex, const std::size_t dimensionIndex) -> double
+        {
+            return static_cast<float>(isColumnMajor ? data[dimensionIndex * numberOfPoints + pointIndex] : data[pointIndex * numberOfDimensions + dimensionIndex]);
+        };
+
+        for (std::size_t index = 0; index < numberOfPointIndices; ++index)
+        {
+            for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+            {
+                means[dimensionIndex] += getValue(pointIndices[index], dimensionIndex);
+            }
+        }
+
+        for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+        {
+            means[dimensionIndex] /= static_cast<double>(numberOfPointIndices);
+        }
+
+        for (std::size_t index = 0; index < numberOfPointIndices; ++index)
+        {
+            for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+            {
+                const auto deviation = getValue(pointIndices[index], dimensionIndex) - means[dimensionIndex];
+
+                sumsOfSquaredDeviations[dimensionIndex] += deviation * deviation;
+            }
+        }
+    }
+
+
+    // Returns the median of the (non-empty) range of values, which are partially reordered.
+    float computeMedian(float* const begin, float* const end)
+    {
+        const auto numberOfValues = static_cast<std::size_t>(end - begin);
+        const auto middle = begin + numberOfValues / 2;
+
+        std::nth_element(begin, middle, end);
+
+        if (numberOfValues % 2 == 1)
+        {
+            return *middle;
+        }
+
+        // The largest value of the lower half, which precedes the middle element after nth_element.
+        const auto lowerMiddle = *std::max_element(begin, middle);
+
+        return static_cast<float>((static_cast<double>(lowerMiddle) + static_cast<double>(*middle)) / 2.0);
+    }
+}
+
+
+template <typename T>
+bool mv::computeClusterStatistics(const T* const data, const std::size_t numberOfPoints, const std::size_t numberOfDimensions, const bool isColumnMajor,
+    const std::vector<std::uint32_t>& labels, const std::vector<std::size_t>& offsets, const std::vector<std::uint32_t>& clusterIndices,
+    const bool computeMedians, ClusterStatistics& statistics, const std::atomic<bool>& abortRequested)
+{
+    if (offsets.empty() || offsets.back() != clusterIndices.size())
+    {
+        throw std::runtime_error("Cluster offsets do not match the cluster indices");
+    }
+
+    if (!labels.empty() && labels.size() != numberOfPoints)
+    {
+        throw std::runtime_error("Number of cluster labels does not match the number of points");
+    }
+
+    const auto numberOfClusters = offsets.size() - 1;
+
+    for (const auto label : labels)
+    {
+        if (label != NO_CLUSTER_LABEL && label >= numberOfClusters)
+        {
+            throw std::runtime_error("Cluster label is out of range");
+        }
+    }
+
+    for (const auto pointIndex : clusterIndices)
+    {
+        if (pointIndex >= numberOfPoints)
+        {
+            throw std::runtime_error("Cluster point index is out of range");
+        }
+    }
+
+    statistics.numberOfClusters = numberOfClusters;
+    statistics.numberOfDimensions = numberOfDimensions;
+    statistics.numbersOfPoints.assign(numberOfClusters, 0);
+    statistics.means.assign(numberOfClusters * numberOfDimensions, 0.0f);
+    statistics.standardDeviations.assign(numberOfClusters * numberOfDimensions, 0.0f);
+    statistics.medians.assign(computeMedians ? numberOfClusters * numberOfDimensions : 0, 0.0f);
+
+    if (numberOfClusters == 0 || numberOfDimensions == 0)
+    {
+        return !abortRequested;
+    }
+
+    const auto numberOfHardwareThreads = mv::util::getNumberOfHardwareThreads();
+
+    ClusterAccumulators accumulators(numberOfClusters, numberOfDimensions);
+
+    if (!labels.empty())
+    {
+        // One pass over blocks of rows, each thread with its own accumulators (within the memory budget).
+        const auto accumulatorMemory = numberOfClusters * (sizeof(std::uint64_t) + 2 * sizeof(double) * numberOfDimensions);
+        const auto maximumNumberOfThreads = std::clamp<std::size_t>(MAXIMUM_ACCUMULATOR_MEMORY / accumulatorMemory, 1, numberOfHardwareThreads);
+        const auto numberOfThreads = std::clamp<std::size_t>(numberOfPoints / MINIMUM_ROWS_PER_THREAD, 1, maximumNumberOfThreads);
+        const auto numberOfRowsPerThread = (numberOfPoints + numberOfThreads - 1) / numberOfThreads;
+        const auto numberOfRowsPerBlock = std::max<std::size_t>(1, TARGET_BLOCK_SIZE / numberOfDimensions);
+
+        std::vector<ClusterAccumulators> threadAccumulators(numberOfThreads - 1, ClusterAccumulators(numberOfClusters, numberOfDimensions));
+
+        mv::util::parallelForEach(numberOfThreads, [&](const std::size_t threadIndex)
+        {
+            auto& localAccumulators = (threadIndex == 0) ? accumulators : threadAccumulators[threadIndex - 1];
+
+            std::vector<double> weights(isColumnMajor ? numberOfRowsPerBlock : 0);
+
+            const auto endRowIndex = std::min(numberOfPoints, (threadIndex + 1) * numberOfRowsPerThread);
+
+            for (auto firstRowIndex = threadIndex * numberOfRowsPerThread; firstRowIndex < endRowIndex; firstRowIndex += numberOfRowsPerBlock)
+            {
+                if (abortRequested)
+                {
+                    return;
+                }
+
+                const auto numberOfBlockRows = std::min(numberOfRowsPerBlock, endRowIndex - firstRowIndex);
+
+                if (isColumnMajor)
+                {
+                    accumulateColumnMajorBlock(data, numberOfPoints, numberOfDimensions, labels.data(), firstRowIndex, numberOfBlockRows, localAccumulators, weights);
+                }
+                else
+                {
+                    accumulateRowMajorBlock(data, numberOfDimensions, labels.data(), firstRowIndex, numberOfBlockRows, localAccumulators);
+                }
+            }
+        });
+
+        for (const auto& localAccumulators : threadAccumulators)
+        {
+            accumulators.merge(localAccumulators, numberOfDimensions);
+        }
+    }
+    else
+    {
+        // Overlapping clusters: each cluster is processed as a whole, by one of the threads.
+        std::atomic<std::size_t> nextClusterIndex{};
+
+        mv::util::parallelForEach(std::min(numberOfClusters, numberOfHardwareThreads), [&](std::size_t)
+        {
+            for (auto clusterIndex = nextClusterIndex++; clusterIndex < numberOfClusters && !abortRequested; clusterIndex = nextClusterIndex++)
+            {
+                const auto numberOfClusterIndices = offsets[clusterIndex + 1] - offsets[clusterIndex];
+
+                accumulateCluster(data, numberOfPoints, numberOfDimensions, isColumnMajor, clusterIndices.data() + offsets[clusterIndex], numberOfClusterIndices,
+                    accumulators.means.data() + clusterIndex * numberOfDimensions, accumulators.sumsOfSquaredDeviations.data() + clusterIndex * numberOfDimensions);
+
+                accumulators.numbersOfValues[clusterIndex] = numberOfClusterIndices;
+            }
+        });
+    }
+
+    if (abortRequested)
+    {
+        return false;
+    }
+
+    for (std::size_t clusterIndex = 0; clusterIndex < numberOfClusters; ++clusterIndex)
+    {
+        const auto numberOfValues = accumulators.numbersOfValues[clusterIndex];
+
+        statistics.numbersOfPoints[clusterIndex] = numberOfValues;
+
+        for (auto index = clusterIndex * numberOfDimensions; index < (clusterIndex + 1) * numberOfDimensions; ++index)
+        {
+            statistics.means[index] = static_cast<float>(accumulators.means[index]);
+            statistics.standardDeviations[index] = (numberOfValues < 2) ? 0.0f : static_cast<float>(std::sqrt(accumulators.sumsOfSquaredDeviations[index] / static_cast<double>(numberOfValues - 1)));
+        }
+    }
+
+    if (!computeMedians)
+    {
+        return true;
+    }
+
+    // The values of a cluster are gathered per dimension, with the clusters divided over the threads. Row-major values are
+    // gathered for a range of dimensions at once (transposed), so that each row is read contiguously.
+    std::atomic<std::size_t> nextClusterIndex{};
+
+    mv::util::parallelForEach(std::min(numberOfClusters, numberOfHardwareThreads), [&](std::size_t)
+    {
+        std::vector<float> values;
+
+        for (auto clusterIndex = nextClusterIndex++; clusterIndex < numberOfClusters && !abortRequested; clusterIndex = nextClusterIndex++)
+        {
+            const std::uint32_t* const pointIndices = clusterIndices.data() + offsets[clusterIndex];
+            const auto numberOfClusterPoints = offsets[clusterIndex + 1] - offsets[clusterIndex];
+
+            if (numberOfClusterPoints == 0)
+            {
+                continue;
+            }
+
+            const auto numberOfDimensionsPerRange = isColumnMajor ? 1 : std::clamp<std::size_t>(MAXIMUM_GATHERED_VALUES / numberOfClusterPoints, 1, numberOfDimensions);
+
+            values.resize(numberOfClusterPoints * numberOfDimensionsPerRange);
+
+            for (std::size_t firstDimensionIndex = 0; firstDimensionIndex < numberOfDimensions; firstDimensionIndex += numberOfDimensionsPerRange)
+            {
+                const auto numberOfRangeDimensions = std::min(numberOfDimensionsPerRange, numberOfDimensions - firstDimensionIndex);
+
+                if (isColumnMajor)
+                {
+                    const T* const dimensionValues = data + firstDimensionIndex * numberOfPoints;
+
+                    for (std::size_t index = 0; index < numberOfClusterPoints; ++index)
+                    {
+                        values[index] = static_cast<float>(dimensionValues[pointIndices[index]]);
+                    }
+                }
+                else
+                {
+                    for (std::size_t index = 0; index < numberOfClusterPoints; ++index)
+                    {
+                        const T* const row = data + static_cast<std::size_t>(pointIndices[index]) * numberOfDimensions + firstDimensionIndex;
+
+                        for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfRangeDimensions; ++dimensionIndex)
+                        {
+                            values[dimensionIndex * numberOfClusterPoints + index] = static_cast<float>(row[dimensionIndex]);
+                        }
+                    }
+                }
+
+                for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfRangeDimensions; ++dimensionIndex)
+                {
+                    float* const dimensionValues = values.data() + dimensionIndex * numberOfClusterPoints;
+
+                    statistics.medians[clusterIndex * numberOfDimensions + firstDimensionIndex + dimensionIndex] = computeMedian(dimensionValues, dimensionValues + numberOfClusterPoints);
+                }
+            }
+        }
+    });
+
+    return !abortRequested;
+}
+
+
+#define MV_INSTANTIATE_CLUSTER_STATISTICS_FUNCTIONS(T) \
+    template POINTDATA_EXPORT bool mv::computeClusterStatistics<T>(const T*, std::size_t, std::size_t, bool, const std::vector<std::uint32_t>&, \
+        const std::vector<std::size_t>&, const std::vector<std::uint32_t>&, bool, ClusterStatistics&, const std::atomic<bool>&);
+
+MV_INSTANTIATE_CLUSTER_STATISTICS_FUNCTIONS(float)
+MV_INSTANTIATE_CLUSTER_STATISTICS_FUNCTIONS(biovault::bfloat16_t)
+MV_INSTANTIATE_CLUSTER_STATISTICS_FUNCTIONS(std::int16_t)
+MV_INSTANTIATE_CLUSTER_STATISTICS_FUNCTIONS(std::uint16_t)
+MV_INSTANTIATE_CLUSTER_STATISTICS_FUNCTIONS(std::int8_t)
+MV_INSTANTIATE_CLUSTER_STATISTICS_FUNCTIONS(std::uint8_t)
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#ifndef HDPS_CLUSTERSTATISTICS_H
+#define HDPS_CLUSTERSTATISTICS_H
+
+#include "pointdata_export.h"
+
+#include <atomic>
+#include <cstddef> // For size_t
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/* Computation of the mean, standard deviation and median of all dimensions, per cluster of points.
+
+When each point belongs to at most one cluster, the means and standard deviations are computed in
+a single pass over the rows of the data, which are divided over multiple threads in blocks. Each
+thread keeps running (Welford) accumulators per cluster and dimension, which are merged at the
+end with the parallel variant of Welford's algorithm (Chan et al.). For row-major data the
+dimensions are in the inner loop, so that the updates of a row are vectorized. Overlapping
+clusters are processed per cluster instead, with the clusters divided over the threads.
+
+The medians are exact: the values of each cluster and dimension are gathered and partially sorted
+(nth_element), with the clusters divided over the threads.
+
+The computation is implemented for float, biovault::bfloat16_t, std::int16_t, std::uint16_t,
+std::int8_t and std::uint8_t.
+*/
+
+namespace mv
+{
+    /// Label of points that do not belong to any cluster.
+    constexpr std::uint32_t NO_CLUSTER_LABEL = std::numeric_limits<std::uint32_t>::max();
+
+    /// Mean, standard deviation and median of each dimension, per cluster. The values of cluster c and
+    /// dimension d are stored at index c * numberOfDimensions + d.
+    struct ClusterStatistics
+    {
+        std::size_t numberOfClusters{};                 ///< Number of clusters
+        std::size_t numberOfDimensions{};               ///< Number of dimensions
+        std::vector<std::uint64_t> numbersOfPoints;     ///< Number of points per cluster
+        std::vector<float> means;                       ///< Mean per cluster and dimension
+        std::vector<float> standardDeviations;          ///< Sample standard deviation per cluster and dimension (zero for fewer than two points)
+        std::vector<float> medians;                     ///< Median per cluster and dimension (empty when not computed)
+    };
+
+    /// Computes the statistics of each dimension, per cluster of points.
+    /// \param data Point data buffer (either row-major or column-major)
+    /// \param numberOfPoints Number of points in the buffer
+    /// \param numberOfDimensions Number of dimensions of the points
+    /// \param isColumnMajor Whether the values of each dimension are contiguous
+    /// \param labels Cluster label per point of the buffer (NO_CLUSTER_LABEL for unclustered points), or empty when clusters overlap
+    /// \param offsets Offset of each cluster in the cluster indices, followed by the total number of cluster indices
+    /// \param clusterIndices Indices of the points of all clusters (into the buffer), back-to-back
+    /// \param computeMedians Whether to compute the medians as well
+    /// \param statistics Statistics per cluster and dimension (output)
+    /// \param abortRequested Stops the computation (at the next block or cluster) when set
+    /// \return Whether the computation completed (not aborted)
+    template <typename T>
+    POINTDATA_EXPORT bool computeClusterStatistics(const T* data, std::size_t numberOfPoints, std::size_t numberOfDimensions, bool isColumnMajor,
+        const std::vector<std::uint32_t>& labels, const std::vector<std::size_t>& offsets, const std::vector<std::uint32_t>& clusterIndices,
+        bool computeMedians, ClusterStatistics& statistics, const std::atomic<bool>& abortRequested);
+}
+
+#endif // HDPS_CLUSTERSTATISTICS_H
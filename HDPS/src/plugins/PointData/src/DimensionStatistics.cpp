@@ -0,0 +1,285 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "DimensionStatistics.h"
+
+#include <util/Parallel.h>
+
+#include <biovault_bfloat16/biovault_bfloat16.h>
+
+#include <algorithm> // For fill and min.
+
+namespace
+{
+    constexpr std::size_t TARGET_BLOCK_SIZE         = 1 << 15;  // Number of values per block (fits in the L2 cache).
+    constexpr std::size_t MINIMUM_ROWS_PER_THREAD   = 4096;     // Fewer rows do not pay off the scheduling of a task.
+
+    // Buffers for the statistics of a block, allocated once per thread.
+    struct BlockStatistics
+    {
+        explicit BlockStatistics(const std::size_t numberOfDimensions)
+            :
+            sums(numberOfDimensions),
+            sumsOfSquaredDeviations(numberOfDimensions),
+            numbersOfNonZeroValues(numberOfDimensions)
+        {
+        }
+
+        void clear()
+        {
+            std::fill(sums.begin(), sums.end(), 0.0);
+            std::fill(sumsOfSquaredDeviations.begin(), sumsOfSquaredDeviations.end(), 0.0);
+            std::fill(numbersOfNonZeroValues.begin(), numbersOfNonZeroValues.end(), 0u);
+        }
+
+        // Merges the statistics of the block into the accumulators (the block means are stored in sums).
+        void mergeInto(std::vector<mv::DimensionStatisticsAccumulator>& accumulators, const std::size_t numberOfRows) const
+        {
+            for (std::size_t dimensionIndex = 0; dimensionIndex < accumulators.size(); ++dimensionIndex)
+            {
+                accumulators[dimensionIndex].merge({ numberOfRows, numbersOfNonZeroValues[dimensionIndex], sums[dimensionIndex], sumsOfSquaredDeviations[dimensionIndex] });
+            }
+        }
+
+        std::vector<double> sums;
+        std::vector<double> sumsOfSquaredDeviations;
+        std::vector<std::uint32_t> numbersOfNonZeroValues;
+    };
+
+
+    // Accumulates a block of row-major values, in two passes: first the means, then the squared deviations.
+    template <typename T>
+    void accumulateRowMajorBlock(const T* const block, const std::size_t numberOfRows, const std::size_t numberOfDimensions,
+        BlockStatistics& blockStatistics, std::vector<mv::DimensionStatisticsAccumulator>& accumulators)
+    {
+        blockStatistics.clear();
+
+        double* const sums = blockStatistics.sums.data();
+        double* const sumsOfSquaredDeviations = blockStatistics.sumsOfSquaredDeviations.data();
+        std::uint32_t* const numbersOfNonZeroValues = blockStatistics.numbersOfNonZeroValues.data();
+
+        for (std::size_t rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+        {
+            const T* const row = block + rowIndex * numberOfDimensions;
+
+            for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+            {
+                const auto value = static_cast<float>(row[dimensionIndex]);
+
+                sums[dimensionIndex] += value;
+                numbersOfNonZeroValues[dimensionIndex] += (value != 0.0f) ? 1u : 0u;
+            }
+        }
+
+        for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+        {
+            sums[dimensionIndex] /= static_cast<double>(numberOfRows);
+        }
+
+        for (std::size_t rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+        {
+            const T* const row = block + rowIndex * numberOfDimensions;
+
+            for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+            {
+                const auto deviation = static_cast<float>(row[dimensionIndex]) - sums[dimensionIndex];
+
+                sumsOfSquaredDeviations[dimensionIndex] += deviation * deviation;
+            }
+        }
+
+        blockStatistics.mergeInto(accumulators, numberOfRows);
+    }
+
+
+    // Accumulates a block of rows of column-major values, of which the values of each dimension are contiguous.
+    template <typename T>
+    void accumulateColumnMajorBlock(const T* const data, const std::size_t numberOfPoints, const std::size_t firstRowIndex, const std::size_t numberOfRows,
+        BlockStatistics& blockStatistics, std::vector<mv::DimensionStatisticsAccumulator>& accumulators)
+    {
+        blockStatistics.clear();
+
+        for (std::size_t dimensionIndex = 0; dimensionIndex < accumulators.size(); ++dimensionIndex)
+        {
+            const T* const values = data + dimensionIndex * numberOfPoints + firstRowIndex;
+
+            double sum{};
+            std::uint32_t numberOfNonZeroValues{};
+
+            for (std::size_t rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+            {
+                const auto value = static_cast<float>(values[rowIndex]);
+
+                sum += value;
+                numberOfNonZeroValues += (value != 0.0f) ? 1u : 0u;
+            }
+
+            const auto mean = sum / static_cast<double>(numberOfRows);
+
+            double sumOfSquaredDeviations{};
+
+            for (std::size_t rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+            {
+                const auto deviation = static_cast<float>(values[rowIndex]) - mean;
+
+                sumOfSquaredDeviations += deviation * deviation;
+            }
+
+            blockStatistics.sums[dimensionIndex] = mean;
+            blockStatistics.sumsOfSquaredDeviations[dimensionIndex] = sumOfSquaredDeviations;
+            blockStatistics.numbersOfNonZeroValues[dimensionIndex] = numberOfNonZeroValues;
+        }
+
+        blockStatistics.mergeInto(accumulators, numberOfRows);
+    }
+}
+
+
+void mv::DimensionStatisticsAccumulator::merge(const DimensionStatisticsAccumulator& other)
+{
+    if (other.numberOfValues == 0)
+    {
+        return;
+    }
+
+    if (numberOfValues == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    const auto totalNumberOfValues = numberOfValues + other.numberOfValues;
+    const auto delta = other.mean - mean;
+    const auto otherWeight = static_cast<double>(other.numberOfValues) / static_cast<double>(totalNumberOfValues);
+
+    mean += delta * otherWeight;
+    sumOfSquaredDeviations += other.sumOfSquaredDeviations + delta * delta * static_cast<double>(numberOfValues) * otherWeight;
+    numberOfValues = totalNumberOfValues;
+    numberOfNonZeroValues += other.numberOfNonZeroValues;
+}
+
+
+template <typename T>
+bool mv::accumulateDimensionStatistics(const T* const data, const std::size_t numberOfPoints, const std::size_t numberOfDimensions, const bool isColumnMajor,
+    const std::vector<std::uint32_t>* const indices, std::vector<DimensionStatisticsAccumulator>& accumulators,
+    const std::atomic<bool>& abortRequested, const std::function<void(float)>& progressCallback)
+{
+    accumulators.assign(numberOfDimensions, {});
+
+    const std::size_t numberOfRows = (indices == nullptr) ? numberOfPoints : indices->size();
+
+    if (numberOfRows == 0 || numberOfDimensions == 0)
+    {
+        return !abortRequested;
+    }
+
+    const auto numberOfRowsPerBlock = std::max<std::size_t>(1, TARGET_BLOCK_SIZE / numberOfDimensions);
+    const auto numberOfThreads = mv::util::getNumberOfParallelRanges(numberOfRows, MINIMUM_ROWS_PER_THREAD);
+    const auto numberOfRowsPerThread = (numberOfRows + numberOfThreads - 1) / numberOfThreads;
+
+    std::vector<std::vector<DimensionStatisticsAccumulator>> threadAccumulators(numberOfThreads, std::vector<DimensionStatisticsAccumulator>(numberOfDimensions));
+    std::atomic<std::size_t> numberOfProcessedRows{};
+
+    const auto accumulateRows = [=, &threadAccumulators, &numberOfProcessedRows, &abortRequested, &progressCallback](const std::size_t threadIndex)
+    {
+        auto& localAccumulators = threadAccumulators[threadIndex];
+
+        BlockStatistics blockStatistics(numberOfDimensions);
+
+        // The values of the rows of a subset are gathered into a contiguous block first.
+        std::vector<float> gatheredBlock((indices == nullptr) ? 0 : numberOfRowsPerBlock * numberOfDimensions);
+
+        const auto endRowIndex = std::min(numberOfRows, (threadIndex + 1) * numberOfRowsPerThread);
+
+        for (auto firstRowIndex = threadIndex * numberOfRowsPerThread; firstRowIndex < endRowIndex; firstRowIndex += numberOfRowsPerBlock)
+        {
+            if (abortRequested)
+            {
+                return;
+            }
+
+            const auto numberOfBlockRows = std::min(numberOfRowsPerBlock, endRowIndex - firstRowIndex);
+
+            if (indices == nullptr)
+            {
+                if (isColumnMajor)
+                {
+                    accumulateColumnMajorBlock(data, numberOfPoints, firstRowIndex, numberOfBlockRows, blockStatistics, localAccumulators);
+                }
+                else
+                {
+                    accumulateRowMajorBlock(data + firstRowIndex * numberOfDimensions, numberOfBlockRows, numberOfDimensions, blockStatistics, localAccumulators);
+                }
+            }
+            else
+            {
+                if (isColumnMajor)
+                {
+                    // Gather the values of each dimension, so that they are contiguous per dimension (like column-major data).
+                    for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+                    {
+                        const T* const values = data + dimensionIndex * numberOfPoints;
+
+                        for (std::size_t rowIndex = 0; rowIndex < numberOfBlockRows; ++rowIndex)
+                        {
+                            gatheredBlock[dimensionIndex * numberOfBlockRows + rowIndex] = static_cast<float>(values[(*indices)[firstRowIndex + rowIndex]]);
+                        }
+                    }
+
+                    accumulateColumnMajorBlock(gatheredBlock.data(), numberOfBlockRows, 0, numberOfBlockRows, blockStatistics, localAccumulators);
+                }
+                else
+                {
+                    for (std::size_t rowIndex = 0; rowIndex < numberOfBlockRows; ++rowIndex)
+                    {
+                        const T* const row = data + static_cast<std::size_t>((*indices)[firstRowIndex + rowIndex]) * numberOfDimensions;
+
+                        for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+                        {
+                            gatheredBlock[rowIndex * numberOfDimensions + dimensionIndex] = static_cast<float>(row[dimensionIndex]);
+                        }
+                    }
+
+                    accumulateRowMajorBlock(gatheredBlock.data(), numberOfBlockRows, numberOfDimensions, blockStatistics, localAccumulators);
+                }
+            }
+
+            const auto processedRows = numberOfProcessedRows += numberOfBlockRows;
+
+            if (threadIndex == 0 && progressCallback)
+            {
+                progressCallback(static_cast<float>(processedRows) / static_cast<float>(numberOfRows));
+            }
+        }
+    };
+
+    mv::util::parallelForEach(numberOfThreads, accumulateRows);
+
+    if (abortRequested)
+    {
+        return false;
+    }
+
+    for (const auto& localAccumulators : threadAccumulators)
+    {
+        for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+        {
+            accumulators[dimensionIndex].merge(localAccumulators[dimensionIndex]);
+        }
+    }
+
+    return true;
+}
+
+
+#define MV_INSTANTIATE_DIMENSION_STATISTICS_FUNCTIONS(T) \
+    template POINTDATA_EXPORT bool mv::accumulateDimensionStatistics<T>(const T*, std::size_t, std::size_t, bool, const std::vector<std::uint32_t>*, \
+        std::vector<DimensionStatisticsAccumulator>&, const std::atomic<bool>&, const std::function<void(float)>&);
+
+MV_INSTANTIATE_DIMENSION_STATISTICS_FUNCTIONS(float)
+MV_INSTANTIATE_DIMENSION_STATISTICS_FUNCTIONS(biovault::bfloat16_t)
+MV_INSTANTIATE_DIMENSION_STATISTICS_FUNCTIONS(std::int16_t)
+MV_INSTANTIATE_DIMENSION_STATISTICS_FUNCTIONS(std::uint16_t)
+MV_INSTANTIATE_DIMENSION_STATISTICS_FUNCTIONS(std::int8_t)
+MV_INSTANTIATE_DIMENSION_STATISTICS_FUNCTIONS(std::uint8_t)
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#ifndef HDPS_DIMENSIONSTATISTICS_H
+#define HDPS_DIMENSIONSTATISTICS_H
+
+#include "pointdata_export.h"
+
+#include <atomic>
+#include <cstddef> // For size_t
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/* Computation of the mean and standard deviation of all dimensions of point data at once.
+
+The points are processed in blocks of rows. The mean and the sum of squared deviations of each
+block are computed in two passes over the (cache resident) block, with the dimensions in the
+inner loop, so that the loops are vectorized for row-major data. The block results are merged
+into running accumulators with the parallel variant of Welford's algorithm (Chan et al.), which
+is numerically stable. The rows are divided over multiple threads, whose accumulators are merged
+at the end.
+
+The computation is implemented for float, biovault::bfloat16_t, std::int16_t, std::uint16_t,
+std::int8_t and std::uint8_t.
+*/
+
+namespace mv
+{
+    /// Running statistics of the values of one dimension.
+    struct POINTDATA_EXPORT DimensionStatisticsAccumulator
+    {
+        std::uint64_t numberOfValues{};                 ///< Number of accumulated values
+        std::uint64_t numberOfNonZeroValues{};          ///< Number of accumulated values that are not zero
+        double mean{};                                  ///< Mean of the accumulated values
+        double sumOfSquaredDeviations{};                ///< Sum of the squared deviations from the mean
+
+        /// Adds the values accumulated by the other accumulator to this one.
+        void merge(const DimensionStatisticsAccumulator& other);
+    };
+
+    /// Accumulates the statistics of each dimension over the specified points.
+    /// \param data Point data buffer (either row-major or column-major)
+    /// \param numberOfPoints Number of points in the buffer
+    /// \param numberOfDimensions Number of dimensions of the points
+    /// \param isColumnMajor Whether the values of each dimension are contiguous
+    /// \param indices Indices of the points to accumulate (all points of the buffer when null)
+    /// \param accumulators Statistics per dimension (output)
+    /// \param abortRequested Stops the computation (at the next block) when set
+    /// \param progressCallback Optional, called regularly (from one of the threads) with the fraction of processed points
+    /// \return Whether the computation completed (not aborted)
+    template <typename T>
+    POINTDATA_EXPORT bool accumulateDimensionStatistics(const T* data, std::size_t numberOfPoints, std::size_t numberOfDimensions, bool isColumnMajor,
+        const std::vector<std::uint32_t>* indices, std::vector<DimensionStatisticsAccumulator>& accumulators,
+        const std::atomic<bool>& abortRequested, const std::function<void(float)>& progressCallback = {});
+}
+
+#endif // HDPS_DIMENSIONSTATISTICS_H
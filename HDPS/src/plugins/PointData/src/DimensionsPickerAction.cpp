@@ -4,30 +4,26 @@
 
 #include "DimensionsPickerAction.h"
 
+#include "DimensionStatistics.h"
+
 #include "Application.h"
 
+#include <util/Serialization.h>
+
 #include <QLabel>
 #include <QFileDialog>
 #include <QTableView>
 #include <QHeaderView>
-#include <QTime>
 #include <QAbstractEventDispatcher>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QThread>
 
+#include <cmath>
 #include <deque>
+#include <limits>
 #include <set>
 
-#if !defined(Q_OS_MAC)
-#ifndef Q_MOC_RUN
-#if defined(emit) // tbb defines emit which clashes with Qt's emit
-    #undef emit
-    #include <execution>
-    #define emit
-#endif
-#endif
-#endif
-
 using namespace mv;
 using namespace mv::gui;
 
@@ -41,7 +37,11 @@ DimensionsPickerAction::DimensionsPickerAction(QObject* parent, const QString& t
     _filterAction(*this),
     _selectAction(*this),
     _miscellaneousAction(*this),
-    _summaryUpdateAwakeConnection()
+    _summaryUpdateAwakeConnection(),
+    _statisticsTask(this, "Compute dimension statistics", true, Task::Status::Idle, true),
+    _statisticsThread(nullptr),
+    _statisticsAbortRequested(false),
+    _computedStatistics()
 {
     setText("Dimensions");
     setIconByName("columns");
@@ -74,11 +74,24 @@ DimensionsPickerAction::DimensionsPickerAction(QObject* parent, const QString& t
 
     // Compute statistics when triggered
     connect(&_selectAction.getComputeStatisticsAction(), &TriggerAction::triggered, this, &DimensionsPickerAction::computeStatistics);
+
+    // Stop the computation when the statistics task is killed
+    connect(&_statisticsTask, &Task::requestAbort, this, [this]() -> void {
+        _statisticsAbortRequested = true;
+    });
+
+    // The background thread reads the point data directly, so stop it (and wait for it) before the points are removed
+    connect(&_points, &Dataset<Points>::aboutToBeRemoved, this, &DimensionsPickerAction::abortComputeStatistics);
+
+    // Statistics of points that changed during the computation are meaningless, so stop the computation as well
+    connect(&_points, &Dataset<Points>::dataChanged, this, &DimensionsPickerAction::abortComputeStatistics);
 }
 
 DimensionsPickerAction::~DimensionsPickerAction()
 {
     disconnect(_summaryUpdateAwakeConnection);
+
+    abortComputeStatistics();
 }
 
 void DimensionsPickerAction::fromVariantMap(const QVariantMap& variantMap)
@@ -112,6 +125,19 @@ void DimensionsPickerAction::fromVariantMap(const QVariantMap& variantMap)
 
         const ModelResetter modelResetter(_proxyModel.get());
     }
+
+    // Restore the statistics, so that they do not need to be recomputed
+    if (variantMap.contains("Statistics") && _points.isValid()) {
+        const auto statisticsMap = variantMap["Statistics"].toMap();
+
+        if (statisticsMap["NumberOfPoints"].toUInt() == _points->getNumPoints() && statisticsMap["NumberOfDimensions"].toUInt() == _holder.getNumberOfDimensions()) {
+            std::vector<StatisticsPerDimension> statistics(_holder.getNumberOfDimensions());
+
+            mv::util::populateDataBufferFromVariantMap(statisticsMap["Raw"].toMap(), reinterpret_cast<char*>(statistics.data()));
+
+            setStatistics(std::move(statistics));
+        }
+    }
 }
 
 QVariantMap DimensionsPickerAction::toVariantMap() const
@@ -130,6 +156,16 @@ QVariantMap DimensionsPickerAction::toVariantMap() const
         { "DatasetID", datasetId }
     });
 
+    if (_points.isValid() && !_holder._statistics.empty()) {
+        const auto& statistics = _holder._statistics;
+
+        variantMap["Statistics"] = QVariantMap({
+            { "NumberOfPoints", _points->getNumPoints() },
+            { "NumberOfDimensions", static_cast<std::uint32_t>(statistics.size()) },
+            { "Raw", mv::util::rawDataToVariantMap(reinterpret_cast<const char*>(statistics.data()), statistics.size() * sizeof(StatisticsPerDimension), true, -1, false, sizeof(double)) }
+        });
+    }
+
     return variantMap;
 }
 
@@ -189,6 +225,8 @@ Dataset<Points> DimensionsPickerAction::getPointsDataset() const
 
 void DimensionsPickerAction::setPointsDataset(const Dataset<Points>& points)
 {
+    abortComputeStatistics();
+
     _points = points;
 
     if (_points.isValid()) {
@@ -369,132 +407,136 @@ void DimensionsPickerAction::selectDimensions(const QVector<std::int32_t>& dimen
 
 void DimensionsPickerAction::computeStatistics()
 {
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    {
-        const ModelResetter modelResetter(_proxyModel.get());
+    if (_statisticsThread != nullptr || !_points.isValid())
+        return;
 
-        auto& statistics = _holder._statistics;
-        statistics.clear();
+    const auto& rawPointData = _points->getRawData<PointData>();
 
-        if (_points.isValid())
-        {
-            QTime time = time.currentTime();
-            
-            const auto& pointData = *_points;
+    // The indices of a subset are copied, so that the background thread does not access the dataset
+    const auto indices = _points->isFull() ? std::vector<std::uint32_t>() : std::vector<std::uint32_t>(_points->indices.cbegin(), _points->indices.cend());
+    const auto isFull  = _points->isFull();
 
-            pointData.visitFromBeginToEnd([&statistics, &pointData](auto beginOfData, auto endOfData)
-            {
-                const auto numberOfDimensions = pointData.getNumDimensions();
-                const auto numberOfPoints = pointData.getNumPoints();
+    _statisticsAbortRequested = false;
+
+    _statisticsTask.setName(QString("Compute %1 dimension statistics").arg(_points->text()));
+    _statisticsTask.setRunning();
+    _statisticsTask.setProgress(0.0f);
+
+    _statisticsThread = QThread::create([this, &rawPointData, indices, isFull]() -> void {
+        const auto numberOfDimensions   = rawPointData.getNumDimensions();
+        const auto numberOfPoints       = isFull ? rawPointData.getNumPoints() : static_cast<unsigned int>(indices.size());
+        const auto isColumnMajor        = rawPointData.getStorageLayout() == PointData::StorageLayout::ColumnMajor;
+
+        constexpr static auto quiet_NaN = std::numeric_limits<double>::quiet_NaN();
+
+        std::vector<DimensionStatisticsAccumulator> accumulators;
+
+        // Process blocks of rows once for all dimensions (in parallel)
+        const auto completed = rawPointData.constVisitFromBeginToEnd<bool>([this, &rawPointData, &indices, isFull, numberOfDimensions, isColumnMajor, &accumulators](auto beginOfData, auto endOfData) -> bool {
+            const auto data = (beginOfData == endOfData) ? nullptr : &*beginOfData;
+
+            return accumulateDimensionStatistics(data, data == nullptr ? 0 : rawPointData.getNumPoints(), numberOfDimensions, isColumnMajor, isFull ? nullptr : &indices, accumulators, _statisticsAbortRequested, [this](float progress) -> void {
+                _statisticsTask.setProgress(progress);
+            });
+        });
+
+        _computedStatistics.clear();
+
+        if (!completed)
+            return;
+
+        _computedStatistics.resize(numberOfDimensions, { { quiet_NaN, quiet_NaN }, { quiet_NaN, quiet_NaN } });
+
+        if (numberOfPoints == 0 || accumulators.size() != numberOfDimensions)
+            return;
 
-                constexpr static auto quiet_NaN = std::numeric_limits<double>::quiet_NaN();
+        for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex) {
+            const auto& accumulator = accumulators[dimensionIndex];
 
-                if (numberOfPoints == 0)
+            const auto mean                     = accumulator.mean;
+            const auto numberOfNonZeroValues    = static_cast<double>(accumulator.numberOfNonZeroValues);
+
+            if (numberOfPoints == 1) {
+                _computedStatistics[dimensionIndex] = { { mean, mean }, { quiet_NaN, quiet_NaN } };
+                continue;
+            }
+
+            // Zero values do not contribute to the sum, so the mean of the non-zero values follows from the mean of all values
+            _computedStatistics[dimensionIndex] = StatisticsPerDimension
+            {
                 {
-                    statistics.resize(numberOfDimensions, { quiet_NaN, quiet_NaN, quiet_NaN, quiet_NaN });
-                }
-                else
+                    mean,
+                    (numberOfNonZeroValues == 0) ? quiet_NaN : (mean * numberOfPoints / numberOfNonZeroValues)
+                },
                 {
-                    statistics.resize(numberOfDimensions);
-                    const auto* const statisticsData = statistics.data();
-
-                    if (numberOfPoints == 1)
-                    {
-#ifndef __APPLE__
-                        (void)std::for_each_n(std::execution::par_unseq, statistics.begin(), numberOfDimensions,
-#else
-                        (void)std::for_each_n(statistics.begin(), numberOfDimensions,
-#endif
-                            [statisticsData, beginOfData](auto& statisticsPerDimension)
-                        {
-                            const auto i = &statisticsPerDimension - statisticsData;
-
-                            const double dataValue = beginOfData[i];
-                            statisticsPerDimension = { {dataValue, dataValue}, {quiet_NaN, quiet_NaN} };
-                        });
-                    }
-                    else
-                    {
-#ifndef __APPLE__
-                        (void)std::for_each_n(std::execution::par_unseq, statistics.begin(), numberOfDimensions,
-#else
-                        (void)std::for_each_n(statistics.begin(), numberOfDimensions,
-#endif
-                            [statisticsData, numberOfDimensions, numberOfPoints, beginOfData](auto& statisticsPerDimension)
-                        {
-                            const std::unique_ptr<double[]> data(new double[numberOfPoints]);
-                            {
-                                const auto i = &statisticsPerDimension - statisticsData;
-
-                                for (unsigned j{}; j < numberOfPoints; ++j)
-                                {
-                                    data[j] = beginOfData[j * numberOfDimensions + i];
-                                }
-                            }
-
-                            double sum{};
-                            unsigned numberOfNonZeroValues{};
-
-                            for (unsigned j{}; j < numberOfPoints; ++j)
-                            {
-                                const auto value = data[j];
-
-                                if (value != 0.0)
-                                {
-                                    sum += value;
-                                    ++numberOfNonZeroValues;
-                                }
-                            }
-                            const auto mean = sum / numberOfPoints;
-
-                            double sumOfSquares{};
-
-                            for (unsigned j{}; j < numberOfPoints; ++j)
-                            {
-                                const auto value = data[j] - mean;
-                                sumOfSquares += value * value;
-                            }
-
-                            static_assert(quiet_NaN != quiet_NaN);
-
-                            statisticsPerDimension = StatisticsPerDimension
-                            {
-                                {
-                                    mean,
-                                    (numberOfNonZeroValues == 0) ? quiet_NaN : (sum / numberOfNonZeroValues)
-                                },
-                                {
-                                    std::sqrt(sumOfSquares / (numberOfPoints - 1)),
-                                    (numberOfNonZeroValues == 0) ? quiet_NaN : std::sqrt(sumOfSquares / numberOfNonZeroValues)
-                                }
-                            };
-                        });
-                    }
+                    std::sqrt(accumulator.sumOfSquaredDeviations / (numberOfPoints - 1)),
+                    (numberOfNonZeroValues == 0) ? quiet_NaN : std::sqrt(accumulator.sumOfSquaredDeviations / numberOfNonZeroValues)
                 }
-            });
-            qDebug()
-                << " Duration: " << QTime::currentTime().msecsTo(time) << " microsecond(s)";
+            };
+        }
+    });
 
-            for (unsigned i{}; i <= 1; ++i)
-            {
-                std::set<double> distinctStandardDeviations;
+    // Apply the statistics in the GUI thread (unless the computation was aborted and waited for in the meantime)
+    connect(_statisticsThread, &QThread::finished, this, [this, statisticsThread = _statisticsThread]() -> void {
+        statisticsThread->deleteLater();
+
+        if (statisticsThread != _statisticsThread)
+            return;
+
+        _statisticsThread = nullptr;
+
+        if (_statisticsAbortRequested || _computedStatistics.empty()) {
+            _statisticsTask.setAborted();
+            return;
+        }
+
+        setStatistics(std::move(_computedStatistics));
+
+        _statisticsTask.setFinished();
+    });
+
+    _statisticsThread->start();
+}
+
+void DimensionsPickerAction::abortComputeStatistics()
+{
+    if (_statisticsThread == nullptr)
+        return;
+
+    _statisticsAbortRequested = true;
 
-                for (const auto& statisticsPerDimension : _holder._statistics)
+    _statisticsThread->wait();
+    _statisticsThread->deleteLater();
+    _statisticsThread = nullptr;
+
+    _statisticsTask.setAborted();
+}
+
+void DimensionsPickerAction::setStatistics(std::vector<StatisticsPerDimension> statistics)
+{
+    {
+        const ModelResetter modelResetter(_proxyModel.get());
+
+        _holder._statistics = std::move(statistics);
+
+        for (unsigned i{}; i <= 1; ++i)
+        {
+            std::set<double> distinctStandardDeviations;
+
+            for (const auto& statisticsPerDimension : _holder._statistics)
+            {
+                if (!std::isnan(statisticsPerDimension.standardDeviation[i]))
                 {
-                    if (!std::isnan(statisticsPerDimension.standardDeviation[i]))
-                    {
-                        distinctStandardDeviations.insert(statisticsPerDimension.standardDeviation[i]);
-                    }
+                    distinctStandardDeviations.insert(statisticsPerDimension.standardDeviation[i]);
                 }
-
-                _holder.distinctStandardDeviationsWithAndWithoutZero[i].assign(distinctStandardDeviations.cbegin(), distinctStandardDeviations.cend());
             }
 
-            assert(_selectAction.getSelectionThresholdAction().getMinimum() == 0);
-            updateSlider();
+            _holder.distinctStandardDeviationsWithAndWithoutZero[i].assign(distinctStandardDeviations.cbegin(), distinctStandardDeviations.cend());
         }
     }
-    QApplication::restoreOverrideCursor();
+
+    assert(_selectAction.getSelectionThresholdAction().getMinimum() == 0);
+    updateSlider();
 }
 
 void DimensionsPickerAction::updateSlider()
@@ -20,12 +20,17 @@
 
 #include "actions/StringAction.h"
 
+#include "BackgroundTask.h"
+
 #include <QTableView>
 
+#include <atomic>
+
 using namespace mv;
 using namespace mv::gui;
 
 class QMenu;
+class QThread;
 
 /**
  * Dimensions picker action class
@@ -237,9 +242,21 @@ public:
 
 protected:
     
-    /** Compute dimension statistics */
+    /**
+     * Compute dimension statistics in a background thread (progress is reported by the statistics task, which may be killed)
+     * The computation is aborted when the points are removed, changed or replaced
+     */
     void computeStatistics();
 
+    /** Aborts the statistics computation (if any) and waits for the background thread to finish */
+    void abortComputeStatistics();
+
+    /**
+     * Assigns computed (or loaded) statistics to the holder and updates the slider
+     * @param statistics Statistics per dimension
+     */
+    void setStatistics(std::vector<StatisticsPerDimension> statistics);
+
     /** Update the slider */
     void updateSlider();
 
@@ -292,6 +309,10 @@ protected:
     DimensionsPickerSelectAction                    _selectAction;                      /** Select action */
     DimensionsPickerMiscellaneousAction             _miscellaneousAction;               /** Miscellaneous settings action */
     QMetaObject::Connection                         _summaryUpdateAwakeConnection;      /** Update summary view when idle */
+    BackgroundTask                                  _statisticsTask;                    /** Reports the progress of the statistics computation */
+    QThread*                                        _statisticsThread;                  /** Background thread that computes the statistics (if running) */
+    std::atomic<bool>                               _statisticsAbortRequested;          /** Stops the statistics computation when set */
+    std::vector<StatisticsPerDimension>             _computedStatistics;                /** Statistics computed by the background thread */
 
     friend class Widget;
     friend class AbstractActionsManager;
@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "IndexTranslation.h"
+
+#include <util/Parallel.h>
+#include <util/SelectionBitmap.h>
+
+#include <biovault_bfloat16/biovault_bfloat16.h>
+
+#include <algorithm> // For max and min.
+
+namespace
+{
+    constexpr std::size_t MINIMUM_INDICES_PER_CHUNK = 1 << 16; // Fewer indices do not pay off the scheduling of a task.
+
+    std::size_t getNumberOfChunks(const std::size_t numberOfIndices)
+    {
+        return std::max<std::size_t>(1, mv::util::getNumberOfParallelRanges(numberOfIndices, MINIMUM_INDICES_PER_CHUNK));
+    }
+
+    // Calls function(chunkIndex, begin, end) for each chunk of the index range [0, numberOfIndices), in parallel.
+    template <typename Function>
+    void forEachChunk(const std::size_t numberOfIndices, const std::size_t numberOfChunks, const Function& function)
+    {
+        const auto numberOfIndicesPerChunk = (numberOfIndices + numberOfChunks - 1) / numberOfChunks;
+
+        mv::util::parallelForEach(numberOfChunks, [numberOfIndices, numberOfIndicesPerChunk, &function](const std::size_t chunkIndex)
+            {
+                const auto begin = std::min(numberOfIndices, chunkIndex * numberOfIndicesPerChunk);
+                const auto end = std::min(numberOfIndices, begin + numberOfIndicesPerChunk);
+
+                function(chunkIndex, begin, end);
+            });
+    }
+}
+
+
+void mv::composeIndices(std::vector<std::uint32_t>& indices, const std::vector<std::uint32_t>& mapping)
+{
+    forEachChunk(indices.size(), getNumberOfChunks(indices.size()), [&indices, &mapping](std::size_t, const std::size_t begin, const std::size_t end)
+        {
+            for (auto i = begin; i < end; ++i)
+            {
+                indices[i] = mapping[indices[i]];
+            }
+        });
+}
+
+
+void mv::compactLocalSelectionIndices(const std::vector<std::uint32_t>& globalIndices, const mv::util::SelectionBitmap& globalSelection,
+    std::vector<std::uint32_t>& localSelectionIndices)
+{
+    localSelectionIndices.clear();
+
+    if (globalIndices.empty() || globalSelection.isEmpty())
+    {
+        return;
+    }
+
+    const auto numberOfChunks = getNumberOfChunks(globalIndices.size());
+
+    // First pass: count the selected indices of each chunk.
+    std::vector<std::size_t> chunkOffsets(numberOfChunks + 1);
+
+    forEachChunk(globalIndices.size(), numberOfChunks, [&globalIndices, &globalSelection, &chunkOffsets](const std::size_t chunkIndex, const std::size_t begin, const std::size_t end)
+        {
+            std::size_t count{};
+
+            for (auto i = begin; i < end; ++i)
+            {
+                count += globalSelection.contains(globalIndices[i]) ? 1 : 0;
+            }
+
+            chunkOffsets[chunkIndex + 1] = count;
+        });
+
+    // Exclusive prefix sum: the offset of the first selected index of each chunk in the output.
+    for (std::size_t chunkIndex = 0; chunkIndex < numberOfChunks; ++chunkIndex)
+    {
+        chunkOffsets[chunkIndex + 1] += chunkOffsets[chunkIndex];
+    }
+
+    localSelectionIndices.resize(chunkOffsets.back());
+
+    // Second pass: write the selected indices of each chunk at its offset.
+    forEachChunk(globalIndices.size(), numberOfChunks, [&globalIndices, &globalSelection, &chunkOffsets, &localSelectionIndices](const std::size_t chunkIndex, const std::size_t begin, const std::size_t end)
+        {
+            auto* output = localSelectionIndices.data() + chunkOffsets[chunkIndex];
+
+            for (auto i = begin; i < end; ++i)
+            {
+                if (globalSelection.contains(globalIndices[i]))
+                {
+                    *output++ = static_cast<std::uint32_t>(i);
+                }
+            }
+        });
+}
+
+
+template <typename T>
+void mv::gatherRows(const T* const data, const std::size_t numberOfPoints, const std::size_t numberOfDimensions, const bool isColumnMajor,
+    const std::vector<std::uint32_t>& indices, T* const result)
+{
+    if (indices.empty() || numberOfDimensions == 0)
+    {
+        return;
+    }
+
+    forEachChunk(indices.size(), getNumberOfChunks(indices.size() * numberOfDimensions), [=, &indices](std::size_t, const std::size_t begin, const std::size_t end)
+        {
+            if (isColumnMajor)
+            {
+                // Per dimension, so that the reads stay within one column.
+                for (std::size_t dimensionIndex = 0; dimensionIndex < numberOfDimensions; ++dimensionIndex)
+                {
+                    const T* const values = data + dimensionIndex * numberOfPoints;
+
+                    for (auto i = begin; i < end; ++i)
+                    {
+                        result[i * numberOfDimensions + dimensionIndex] = values[indices[i]];
+                    }
+                }
+            }
+            else
+            {
+                for (auto i = begin; i < end; ++i)
+                {
+                    std::copy_n(data + static_cast<std::size_t>(indices[i]) * numberOfDimensions, numberOfDimensions, result + i * numberOfDimensions);
+                }
+            }
+        });
+}
+
+
+#define MV_INSTANTIATE_GATHER_ROWS(T) \
+    template POINTDATA_EXPORT void mv::gatherRows<T>(const T*, std::size_t, std::size_t, bool, const std::vector<std::uint32_t>&, T*);
+
+MV_INSTANTIATE_GATHER_ROWS(float)
+MV_INSTANTIATE_GATHER_ROWS(biovault::bfloat16_t)
+MV_INSTANTIATE_GATHER_ROWS(std::int16_t)
+MV_INSTANTIATE_GATHER_ROWS(std::uint16_t)
+MV_INSTANTIATE_GATHER_ROWS(std::int8_t)
+MV_INSTANTIATE_GATHER_ROWS(std::uint8_t)
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#ifndef HDPS_INDEXTRANSLATION_H
+#define HDPS_INDEXTRANSLATION_H
+
+#include "pointdata_export.h"
+
+#include <cstddef> // For size_t
+#include <cstdint>
+#include <vector>
+
+namespace mv::util
+{
+    class SelectionBitmap;
+}
+
+/* Parallel translation of indices between the global (raw data) and local (subset) index spaces.
+
+Selecting the local indices whose global index is in a selection is a stream compaction: the local
+index range is divided into chunks, the selected indices of each chunk are counted in parallel, an
+exclusive prefix sum over the chunk counts yields the output offset of each chunk, and a second
+parallel pass writes the selected local indices of each chunk at its offset. So the result is
+written in place (in ascending order), without intermediate per-point flags or per-thread buffers.
+*/
+
+namespace mv
+{
+    /// Composes an index mapping: replaces each index by the index it maps to (in parallel).
+    /// \param indices Indices into the mapping, which are replaced by the mapped indices
+    /// \param mapping The indices that the mapping maps to (for example the indices of a subset)
+    POINTDATA_EXPORT void composeIndices(std::vector<std::uint32_t>& indices, const std::vector<std::uint32_t>& mapping);
+
+    /// Gets the local indices of the points whose global index is selected.
+    /// \param globalIndices Global index of each local point
+    /// \param globalSelection Selected global indices
+    /// \param localSelectionIndices Selected local indices, in ascending order (output)
+    POINTDATA_EXPORT void compactLocalSelectionIndices(const std::vector<std::uint32_t>& globalIndices, const mv::util::SelectionBitmap& globalSelection,
+        std::vector<std::uint32_t>& localSelectionIndices);
+
+    /// Copies the rows at the specified indices into a contiguous row-major buffer (in parallel).
+    /// \param data Point data buffer (either row-major or column-major)
+    /// \param numberOfPoints Number of points in the buffer
+    /// \param numberOfDimensions Number of dimensions of the points
+    /// \param isColumnMajor Whether the values of each dimension are contiguous
+    /// \param indices Indices of the points to copy
+    /// \param result Row-major buffer of indices.size() * numberOfDimensions values (output)
+    template <typename T>
+    POINTDATA_EXPORT void gatherRows(const T* data, std::size_t numberOfPoints, std::size_t numberOfDimensions, bool isColumnMajor,
+        const std::vector<std::uint32_t>& indices, T* result);
+}
+
+#endif // HDPS_INDEXTRANSLATION_H
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "MemoryMappedFile.h"
+
+#include <stdexcept>
+
+namespace mv
+{
+    MemoryMappedFile::MemoryMappedFile(const QString& filePath, const std::uint64_t offset, const std::uint64_t numberOfBytes, const Mode mode /*= Mode::CopyOnWrite*/) :
+        _file(filePath),
+        _data(nullptr),
+        _numberOfBytes(numberOfBytes),
+        _mode(mode)
+    {
+        if (!_file.open(QIODevice::ReadOnly))
+            throw std::runtime_error(QString("Unable to map %1 into memory, cannot open file").arg(filePath).toStdString());
+
+        if (static_cast<std::uint64_t>(_file.size()) < offset + numberOfBytes)
+            throw std::runtime_error(QString("Unable to map %1 into memory, the file is smaller than the requested region").arg(filePath).toStdString());
+
+        // An empty region cannot be mapped, but there is nothing to access either
+        if (numberOfBytes == 0)
+            return;
+
+        // A private mapping allows writing to the pages while the file itself is only opened for reading
+        const auto flags = (mode == Mode::CopyOnWrite) ? QFileDevice::MapPrivateOption : QFileDevice::NoOptions;
+
+        _data = _file.map(static_cast<qint64>(offset), static_cast<qint64>(numberOfBytes), flags);
+
+        if (_data == nullptr)
+            throw std::runtime_error(QString("Unable to map %1 into memory: %2").arg(filePath, _file.errorString()).toStdString());
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        if (_data != nullptr)
+            _file.unmap(_data);
+    }
+}
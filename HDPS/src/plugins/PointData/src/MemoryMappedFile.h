@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#pragma once
+
+#include "pointdata_export.h"
+
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+
+namespace mv
+{
+    /**
+     * Memory mapped file class
+     *
+     * Maps a region of a binary file into the address space of the process, so
+     * that its content can be accessed as if it were in memory, while the
+     * operating system only pages in the parts that are actually touched.
+     * The region stays mapped for the lifetime of the object.
+     */
+    class POINTDATA_EXPORT MemoryMappedFile
+    {
+    public:
+
+        /** Determines how the mapped region may be accessed */
+        enum class Mode
+        {
+            ReadOnly,       /** The mapped region may only be read */
+            CopyOnWrite     /** The mapped region may be written to, changes are private to the process and never written back to the file */
+        };
+
+        /**
+         * Maps \p numberOfBytes bytes of the file at \p filePath, starting at byte \p offset
+         * @param filePath Path of the binary file on disk
+         * @param offset Offset (in bytes) of the region in the file
+         * @param numberOfBytes Size (in bytes) of the region
+         * @param mode Access mode of the mapped region
+         * @throws std::runtime_error when the file cannot be opened or mapped
+         */
+        MemoryMappedFile(const QString& filePath, std::uint64_t offset, std::uint64_t numberOfBytes, Mode mode = Mode::CopyOnWrite);
+
+        /** Unmaps the region and closes the file */
+        ~MemoryMappedFile();
+
+        // Explicitly delete its copy and move member functions.
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile(MemoryMappedFile&&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(MemoryMappedFile&&) = delete;
+
+        /** Get read-only pointer to the first byte of the mapped region (nullptr when the region is empty) */
+        const std::uint8_t* getData() const
+        {
+            return _data;
+        }
+
+        /** Get writable pointer to the first byte of the mapped region (nullptr when the region is empty), only to be written through when the region is writable */
+        std::uint8_t* getData()
+        {
+            return _data;
+        }
+
+        /** Get size (in bytes) of the mapped region */
+        std::uint64_t getNumberOfBytes() const
+        {
+            return _numberOfBytes;
+        }
+
+        /** Get access mode of the mapped region */
+        Mode getMode() const
+        {
+            return _mode;
+        }
+
+        /** Get whether the mapped region may be written to */
+        bool isWritable() const
+        {
+            return _mode == Mode::CopyOnWrite;
+        }
+
+        /** Get path of the mapped file */
+        QString getFilePath() const
+        {
+            return _file.fileName();
+        }
+
+    private:
+        QFile           _file;              /** Mapped file */
+        std::uint8_t*   _data;              /** Pointer to the mapped region */
+        std::uint64_t   _numberOfBytes;     /** Size of the mapped region */
+        Mode            _mode;              /** Access mode of the mapped region */
+    };
+}
@@ -8,6 +8,9 @@
 #endif
 
 #include "PointData.h"
+#include "ClusterStatistics.h"
+#include "PointDataConversion.h"
+#include "IndexTranslation.h"
 #include "InfoAction.h"
 #include "DimensionsPickerAction.h"
 #include "event/Event.h"
@@ -16,6 +19,8 @@
 #include <QtDebug>
 #include <QPainter>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <type_traits>
 #include <queue>
@@ -25,12 +30,55 @@
 #include "Application.h"
 
 #include <actions/GroupAction.h>
+#include <util/Parallel.h>
+#include <util/SelectionBitmap.h>
 #include <util/Serialization.h>
 #include <util/Timer.h>
 #include <DataHierarchyItem.h>
 
 Q_PLUGIN_METADATA(IID "nl.tudelft.PointData")
 
+namespace
+{
+    // The conversion kernels write the x and y coordinates of the points as pairs of floats.
+    static_assert(std::is_standard_layout_v<mv::Vector2f> && (sizeof(mv::Vector2f) == 2 * sizeof(float)));
+
+    // Minimum number of points and dimensions per task of computeMeanPerDimension, to keep the threading overhead small.
+    constexpr std::size_t minimumNumberOfPointsPerMeanTask{ 1024 };
+    constexpr std::size_t minimumNumberOfDimensionsPerMeanTask{ 1024 };
+
+    float* getFloatData(std::vector<mv::Vector2f>& points)
+    {
+        return reinterpret_cast<float*>(points.data());
+    }
+
+    // Copies the elements of a row-major matrix to the target, in column-major order (so the target
+    // holds the transposed matrix). Processes the matrix block by block, to stay cache friendly.
+    template <typename T>
+    void transpose(const T* const source, T* const target, const std::size_t numberOfRows, const std::size_t numberOfColumns)
+    {
+        constexpr std::size_t blockSize{ 64 };
+
+        for (std::size_t beginOfRows{}; beginOfRows < numberOfRows; beginOfRows += blockSize)
+        {
+            const auto endOfRows = std::min(beginOfRows + blockSize, numberOfRows);
+
+            for (std::size_t beginOfColumns{}; beginOfColumns < numberOfColumns; beginOfColumns += blockSize)
+            {
+                const auto endOfColumns = std::min(beginOfColumns + blockSize, numberOfColumns);
+
+                for (auto row = beginOfRows; row < endOfRows; ++row)
+                {
+                    for (auto column = beginOfColumns; column < endOfColumns; ++column)
+                    {
+                        target[column * numberOfRows + row] = source[row * numberOfColumns + column];
+                    }
+                }
+            }
+        }
+    }
+}
+
 // =============================================================================
 // PointData
 // =============================================================================
@@ -73,6 +121,48 @@ void PointData::setData(const std::nullptr_t, const std::size_t numPoints, const
     _numDimensions = static_cast<unsigned int>(numDimensions);
 }
 
+void PointData::setStorageLayout(const StorageLayout storageLayout)
+{
+    if (storageLayout == _storageLayout)
+        return;
+
+    const std::size_t numberOfPoints = getNumPoints();
+
+    // Row-major data is a (number of points x number of dimensions) matrix, column-major data is its transpose
+    const auto isRowMajor       = _storageLayout == StorageLayout::RowMajor;
+    const auto numberOfRows     = isRowMajor ? numberOfPoints : _numDimensions;
+    const auto numberOfColumns  = isRowMajor ? _numDimensions : numberOfPoints;
+
+    _vectorHolder = _vectorHolder.constVisit<VectorHolder>([numberOfRows, numberOfColumns](const auto& vec)
+        {
+            using ValueType = typename std::remove_reference_t<decltype(vec)>::value_type;
+
+            std::vector<ValueType> rearrangedData(numberOfRows * numberOfColumns);
+
+            transpose(vec.data(), rearrangedData.data(), numberOfRows, numberOfColumns);
+
+            return VectorHolder(std::move(rearrangedData));
+        });
+
+    _storageLayout = storageLayout;
+}
+
+std::size_t PointData::getElementIndex(const std::size_t pointIndex, const std::size_t dimensionIndex) const
+{
+    if (_storageLayout == StorageLayout::ColumnMajor)
+        return dimensionIndex * getNumPoints() + pointIndex;
+
+    return pointIndex * _numDimensions + dimensionIndex;
+}
+
+std::size_t PointData::getElementIndex(const std::size_t rowMajorIndex) const
+{
+    if (_storageLayout == StorageLayout::RowMajor)
+        return rowMajorIndex;
+
+    return getElementIndex(rowMajorIndex / _numDimensions, rowMajorIndex % _numDimensions);
+}
+
 void PointData::setDimensionNames(const std::vector<QString>& dimNames)
 {
     if (dimNames.empty())
@@ -84,16 +174,20 @@ void PointData::setDimensionNames(const std::vector<QString>& dimNames)
         qWarning() << "PointData: Number of dimension names does not equal the number of data dimensions";
 }
 
-float PointData::getValueAt(const std::size_t index) const
+float PointData::getValueAt(const std::size_t rowMajorIndex) const
 {
+    const auto index = getElementIndex(rowMajorIndex);
+
     return _vectorHolder.constVisit<float>([index](const auto& vec)
         {
             return vec[index];
         });
 }
 
-void PointData::setValueAt(const std::size_t index, const float newValue)
+void PointData::setValueAt(const std::size_t rowMajorIndex, const float newValue)
 {
+    const auto index = getElementIndex(rowMajorIndex);
+
     _vectorHolder.visit([index, newValue](auto& vec)
         {
             using value_type = typename std::remove_reference_t<decltype(vec)>::value_type;
@@ -109,125 +203,72 @@ void PointData::fromVariantMap(const QVariantMap& variantMap)
     const auto numberOfElements     = numberOfPoints * numberOfDimensions;
     const auto elementTypeIndex     = static_cast<PointData::ElementTypeSpecifier>(data["TypeIndex"].toInt());
     const auto rawData              = data["Raw"].toMap();
+    const auto storageLayout        = data.contains("StorageLayout") ? static_cast<StorageLayout>(data["StorageLayout"].toInt()) : StorageLayout::RowMajor;
 
-    switch (elementTypeIndex)
+    // Reads the raw data directly into the buffer that is subsequently moved into the vector holder
+    const auto populateData = [this, &rawData, numberOfElements, numberOfDimensions](auto typeTag)
     {
-        case PointData::ElementTypeSpecifier::float32:
-        {
-            std::vector<float> pointData;
+        std::vector<decltype(typeTag)> pointData(numberOfElements);
 
-            pointData.resize(numberOfElements);
+        populateDataBufferFromVariantMap(rawData, (char*)pointData.data());
+        setData(std::move(pointData), numberOfDimensions);
+    };
 
-            populateDataBufferFromVariantMap(rawData, (char*)pointData.data());
-            setData(pointData, numberOfDimensions);
+    switch (elementTypeIndex)
+    {
+        case PointData::ElementTypeSpecifier::float32:
+            populateData(float{});
             break;
-        }
 
         case PointData::ElementTypeSpecifier::bfloat16:
-        {
-            std::vector<biovault::bfloat16_t> pointData;
-
-            pointData.resize(numberOfElements);
-
-            populateDataBufferFromVariantMap(rawData, (char*)pointData.data());
-            setData(pointData, numberOfDimensions);
-
+            populateData(biovault::bfloat16_t{});
             break;
-        }
 
         case PointData::ElementTypeSpecifier::int16:
-        {
-            std::vector<std::int16_t> pointData;
-
-            pointData.resize(numberOfElements);
-
-            populateDataBufferFromVariantMap(rawData, (char*)pointData.data());
-            setData(pointData, numberOfDimensions);
+            populateData(std::int16_t{});
             break;
-        }
 
         case PointData::ElementTypeSpecifier::uint16:
-        {
-            std::vector<std::uint16_t> pointData;
-
-            pointData.resize(numberOfElements);
-
-            populateDataBufferFromVariantMap(rawData, (char*)pointData.data());
-            setData(pointData, numberOfDimensions);
+            populateData(std::uint16_t{});
             break;
-        }
 
         case PointData::ElementTypeSpecifier::int8:
-        {
-            std::vector<std::uint16_t> pointData;
-
-            pointData.resize(numberOfElements);
-
-            populateDataBufferFromVariantMap(rawData, (char*)pointData.data());
-            setData(pointData, numberOfDimensions);
+            populateData(std::int8_t{});
             break;
-        }
 
         case PointData::ElementTypeSpecifier::uint8:
-        {
-            std::vector<std::uint8_t> pointData;
-
-            pointData.resize(numberOfElements);
-
-            populateDataBufferFromVariantMap(rawData, (char*)pointData.data());
-            setData(pointData, numberOfDimensions);
+            populateData(std::uint8_t{});
             break;
-        }
 
         default:
             break;
     }
+
+    // The raw data is stored in this layout already
+    _storageLayout = storageLayout;
 }
 
 QVariantMap PointData::toVariantMap() const
 {
-    QVariantMap rawData;
-
     const auto typeSpecifier        = _vectorHolder.getElementTypeSpecifier();
     const auto typeSpecifierName    = _vectorHolder.getElementTypeNames()[static_cast<std::int32_t>(typeSpecifier)];
     const auto typeIndex            = static_cast<std::int32_t>(typeSpecifier);
-    const auto numberOfElements     = static_cast<std::uint64_t>(getNumPoints() * getNumDimensions());
+    const auto numberOfElements     = static_cast<std::uint64_t>(getNumPoints()) * getNumDimensions();
 
-    switch (typeSpecifier)
-    {
-        case ElementTypeSpecifier::float32:
-            rawData = rawDataToVariantMap((char*)_vectorHolder.getConstVector<float>().data(), numberOfElements * sizeof(float), true);
-            break;
-
-        case ElementTypeSpecifier::bfloat16:
-            rawData = rawDataToVariantMap((char*)_vectorHolder.getConstVector<biovault::bfloat16_t>().data(), numberOfElements * sizeof(biovault::bfloat16_t), true);
-            break;
-
-        case ElementTypeSpecifier::int16:
-            rawData = rawDataToVariantMap((char*)_vectorHolder.getConstVector<std::int16_t>().data(), numberOfElements * sizeof(std::int16_t), true);
-            break;
-
-        case ElementTypeSpecifier::uint16:
-            rawData = rawDataToVariantMap((char*)_vectorHolder.getConstVector<std::uint16_t>().data(), numberOfElements * sizeof(std::uint16_t), true);
-            break;
-
-        case ElementTypeSpecifier::int8:
-            rawData = rawDataToVariantMap((char*)_vectorHolder.getConstVector<std::int8_t>().data(), numberOfElements * sizeof(std::int8_t), true);
-            break;
-
-        case ElementTypeSpecifier::uint8:
-            rawData = rawDataToVariantMap((char*)_vectorHolder.getConstVector<std::uint8_t>().data(), numberOfElements * sizeof(std::uint8_t), true);
-            break;
+    // Works the same for data in memory and memory mapped data
+    const auto rawData = _vectorHolder.constVisit<QVariantMap>([numberOfElements](const auto& vec)
+        {
+            using ValueType = typename std::remove_reference_t<decltype(vec)>::value_type;
 
-        default:
-            break;
-    }
+            return rawDataToVariantMap((char*)vec.data(), numberOfElements * sizeof(ValueType), true, -1, true, sizeof(ValueType));
+        });
 
     return {
         { "TypeIndex", QVariant::fromValue(typeIndex) },
         { "TypeName", QVariant(typeSpecifierName) },
         { "Raw", QVariant::fromValue(rawData) },
-        { "NumberOfElements", QVariant::fromValue(numberOfElements) }
+        { "NumberOfElements", QVariant::fromValue(numberOfElements) },
+        { "StorageLayout", QVariant::fromValue(static_cast<std::int32_t>(_storageLayout)) }
     };
 }
 
@@ -237,15 +278,22 @@ void PointData::extractFullDataForDimension(std::vector<float>& result, const in
 
     result.resize(getNumPoints());
 
+    if (result.empty())
+        return;
+
     _vectorHolder.constVisit(
         [&result, this, dimensionIndex](const auto& vec)
         {
             const auto resultSize = result.size();
 
-            for (std::size_t i{}; i < resultSize; ++i)
+            if (_storageLayout == StorageLayout::ColumnMajor)
             {
-                result[i] = vec[i * _numDimensions + dimensionIndex];
+                // The values of the dimension are contiguous, so they are converted without gathering.
+                mv::convertElementsToFloat(vec.data() + resultSize * dimensionIndex, resultSize, result.data());
+                return;
             }
+
+            mv::gatherElementsToFloat(vec.data() + dimensionIndex, _numDimensions, resultSize, result.data());
         });
 }
 
@@ -257,16 +305,21 @@ void PointData::extractFullDataForDimensions(std::vector<mv::Vector2f>& result,
 
     result.resize(getNumPoints());
 
+    if (result.empty())
+        return;
+
     _vectorHolder.constVisit(
         [&result, this, dimensionIndex1, dimensionIndex2](const auto& vec)
         {
             const auto resultSize = result.size();
 
-            for (std::size_t i{}; i < resultSize; ++i)
+            if (_storageLayout == StorageLayout::ColumnMajor)
             {
-                const auto n = i * _numDimensions;
-                result[i].set(vec[n + dimensionIndex1], vec[n + dimensionIndex2]);
+                mv::gatherElementPairsToFloat(vec.data() + resultSize * dimensionIndex1, vec.data() + resultSize * dimensionIndex2, 1, resultSize, getFloatData(result));
+                return;
             }
+
+            mv::gatherElementPairsToFloat(vec.data() + dimensionIndex1, vec.data() + dimensionIndex2, _numDimensions, resultSize, getFloatData(result));
         });
 }
 
@@ -278,15 +331,91 @@ void PointData::extractDataForDimensions(std::vector<mv::Vector2f>& result, cons
 
     result.resize(indices.size());
 
+    if (result.empty())
+        return;
+
     _vectorHolder.constVisit(
-        [&result, this, dimensionIndex1, dimensionIndex2, indices](const auto& vec)
+        [&result, this, dimensionIndex1, dimensionIndex2, &indices](const auto& vec)
         {
             const auto resultSize = result.size();
 
-            for (std::size_t i{}; i < resultSize; ++i)
+            if (_storageLayout == StorageLayout::ColumnMajor)
+            {
+                const std::size_t numPoints = getNumPoints();
+
+                mv::gatherElementPairsToFloat(vec.data() + numPoints * dimensionIndex1, vec.data() + numPoints * dimensionIndex2, 1, indices.data(), resultSize, getFloatData(result));
+                return;
+            }
+
+            mv::gatherElementPairsToFloat(vec.data() + dimensionIndex1, vec.data() + dimensionIndex2, _numDimensions, indices.data(), resultSize, getFloatData(result));
+        });
+}
+
+void PointData::computeMeanPerDimension(std::vector<float>& means, const std::vector<std::uint32_t>& indices) const
+{
+    means.assign(_numDimensions, 0.0f);
+
+    if (indices.empty() || _numDimensions == 0)
+        return;
+
+    const std::size_t numberOfThreads = mv::util::getNumberOfHardwareThreads();
+    const std::size_t numberOfDimensions = _numDimensions;
+    const std::size_t numberOfIndices = indices.size();
+
+    _vectorHolder.constVisit(
+        [&means, &indices, this, numberOfThreads, numberOfDimensions, numberOfIndices](const auto& vec)
+        {
+            if (_storageLayout == StorageLayout::ColumnMajor)
+            {
+                // The values of each dimension are contiguous, so each task gathers whole dimensions.
+                const std::size_t numPoints = getNumPoints();
+
+                mv::util::parallelFor(numberOfDimensions, numberOfThreads, [&](const std::size_t beginDimension, const std::size_t endDimension)
+                    {
+                        std::vector<float> values(numberOfIndices);
+
+                        for (auto dimensionIndex = beginDimension; dimensionIndex < endDimension; ++dimensionIndex)
+                        {
+                            mv::gatherElementsToFloat(vec.data() + numPoints * dimensionIndex, 1, indices.data(), numberOfIndices, values.data());
+
+                            double sum{};
+
+                            for (const auto value : values)
+                                sum += value;
+
+                            means[dimensionIndex] = static_cast<float>(sum / numberOfIndices);
+                        }
+                    });
+                return;
+            }
+
+            // Each task accumulates a chunk of the points for a tile of the dimensions into its own sums.
+            // Many dimensions (like the pixels of image sequence frames) are divided over the tasks first.
+            const auto numberOfDimensionTiles = std::clamp<std::size_t>(numberOfDimensions / minimumNumberOfDimensionsPerMeanTask, 1, numberOfThreads);
+            const auto numberOfPointChunks = std::clamp<std::size_t>(numberOfIndices / minimumNumberOfPointsPerMeanTask, 1, std::max<std::size_t>(1, numberOfThreads / numberOfDimensionTiles));
+
+            std::vector<std::vector<float>> sums(numberOfPointChunks, std::vector<float>(numberOfDimensions, 0.0f));
+
+            mv::util::parallelForEach(numberOfPointChunks * numberOfDimensionTiles, [&](const std::size_t taskIndex)
+                {
+                    const auto pointChunk = taskIndex / numberOfDimensionTiles;
+                    const auto dimensionTile = taskIndex % numberOfDimensionTiles;
+                    const auto firstIndex = numberOfIndices * pointChunk / numberOfPointChunks;
+                    const auto lastIndex = numberOfIndices * (pointChunk + 1) / numberOfPointChunks;
+                    const auto firstDimension = numberOfDimensions * dimensionTile / numberOfDimensionTiles;
+                    const auto lastDimension = numberOfDimensions * (dimensionTile + 1) / numberOfDimensionTiles;
+
+                    mv::accumulateRowsToFloat(vec.data() + firstDimension, numberOfDimensions, indices.data() + firstIndex, lastIndex - firstIndex, lastDimension - firstDimension, sums[pointChunk].data() + firstDimension);
+                });
+
+            for (std::size_t dimensionIndex{}; dimensionIndex < numberOfDimensions; ++dimensionIndex)
             {
-                const auto n = std::size_t{ indices[i] } *_numDimensions;
-                result[i].set(vec[n + dimensionIndex1], vec[n + dimensionIndex2]);
+                double sum{};
+
+                for (const auto& sumsOfPointChunk : sums)
+                    sum += sumsOfPointChunk[dimensionIndex];
+
+                means[dimensionIndex] = static_cast<float>(sum / numberOfIndices);
             }
         });
 }
@@ -452,6 +581,187 @@ void Points::extractDataForDimensions(std::vector<mv::Vector2f>& result, const i
     }
 }
 
+void Points::computeMeanPerDimension(std::vector<float>& means, const std::vector<std::uint32_t>& indices) const
+{
+    if (isProxy()) {
+        means.assign(getNumDimensions(), 0.0f);
+
+        // Weigh the means of the proxy members by their number of points
+        auto pointIndexOffset = 0u;
+
+        for (auto proxyMember : getProxyMembers()) {
+            auto points = mv::Dataset<Points>(proxyMember);
+
+            const auto numberOfPoints = points->getNumPoints();
+
+            std::vector<std::uint32_t> memberIndices;
+
+            for (const auto index : indices)
+                if (index >= pointIndexOffset && index < pointIndexOffset + numberOfPoints)
+                    memberIndices.push_back(index - pointIndexOffset);
+
+            pointIndexOffset += numberOfPoints;
+
+            if (memberIndices.empty())
+                continue;
+
+            std::vector<float> memberMeans;
+
+            points->computeMeanPerDimension(memberMeans, memberIndices);
+
+            const auto weight = static_cast<float>(memberIndices.size()) / indices.size();
+
+            for (std::size_t dimensionIndex = 0; dimensionIndex < std::min(means.size(), memberMeans.size()); ++dimensionIndex)
+                means[dimensionIndex] += weight * memberMeans[dimensionIndex];
+        }
+    }
+    else {
+        const auto& rawPointData = getRawData<PointData>();
+
+        if (isFull()) {
+            rawPointData.computeMeanPerDimension(means, indices);
+        }
+        else {
+            // Translate the local indices to indices into the raw data
+            std::vector<std::uint32_t> rawIndices(indices.size());
+
+            for (std::size_t i = 0; i < indices.size(); ++i)
+                rawIndices[i] = this->indices[indices[i]];
+
+            rawPointData.computeMeanPerDimension(means, rawIndices);
+        }
+    }
+}
+
+mv::util::ScalarStatistics Points::getDimensionStatistics(const std::uint32_t dimensionIndex, const std::uint32_t numberOfBins /*= mv::util::ADAPTIVE_NUMBER_OF_BINS*/) const
+{
+    if (dimensionIndex >= getNumDimensions())
+        throw std::out_of_range("Dimension index is out of range");
+
+    // Data changes are usually notified for the full dataset, which shares its raw data with this subset
+    auto dataGeneration = getDataGeneration();
+
+    if (!isFull() && getFullDataset<DatasetImpl>().isValid())
+        dataGeneration += getFullDataset<DatasetImpl>()->getDataGeneration();
+
+    const auto key = std::make_pair(dimensionIndex, numberOfBins);
+
+    {
+        std::lock_guard<std::mutex> lock(_dimensionStatisticsMutex);
+
+        auto& cache = _dimensionStatisticsCache;
+
+        if (cache._dataGeneration != dataGeneration || cache._numberOfPoints != getNumPoints() || cache._numberOfDimensions != getNumDimensions()) {
+            cache._dataGeneration       = dataGeneration;
+            cache._numberOfPoints       = getNumPoints();
+            cache._numberOfDimensions   = getNumDimensions();
+
+            cache._statistics.clear();
+        }
+
+        if (const auto it = cache._statistics.find(key); it != cache._statistics.end())
+            return it->second;
+    }
+
+    mv::util::ScalarStatistics statistics;
+
+    if (!isProxy() && isFull()) {
+        const auto& rawPointData = getRawData<PointData>();
+
+        // Compute the statistics straight from the raw data (in its own element type)
+        rawPointData.constVisitFromBeginToEnd([&rawPointData, dimensionIndex, numberOfBins, &statistics](const auto begin, const auto end) -> void {
+            if (begin == end)
+                return;
+
+            const std::size_t numberOfPoints        = rawPointData.getNumPoints();
+            const std::size_t numberOfDimensions    = rawPointData.getNumDimensions();
+            const auto values                       = &*begin;
+
+            if (rawPointData.getStorageLayout() == PointData::StorageLayout::RowMajor)
+                statistics = mv::util::computeScalarStatistics(values + dimensionIndex, numberOfPoints, numberOfDimensions, numberOfBins);
+            else
+                statistics = mv::util::computeScalarStatistics(values + dimensionIndex * numberOfPoints, numberOfPoints, 1, numberOfBins);
+        });
+    }
+    else {
+        std::vector<float> values;
+
+        if (isProxy()) {
+            extractDataForDimension(values, dimensionIndex);
+        }
+        else {
+            const auto& rawPointData = getRawData<PointData>();
+
+            // Gather the values of the subset
+            values.resize(indices.size());
+
+            rawPointData.constVisitFromBeginToEnd([this, &rawPointData, dimensionIndex, &values](const auto begin, const auto) -> void {
+                const std::size_t numberOfPoints        = rawPointData.getNumPoints();
+                const std::size_t numberOfDimensions    = rawPointData.getNumDimensions();
+                const auto rowMajor                     = rawPointData.getStorageLayout() == PointData::StorageLayout::RowMajor;
+
+                for (std::size_t localIndex = 0; localIndex < indices.size(); ++localIndex) {
+                    const std::size_t pointIndex = indices[localIndex];
+
+                    values[localIndex] = static_cast<float>(begin[rowMajor ? pointIndex * numberOfDimensions + dimensionIndex : dimensionIndex * numberOfPoints + pointIndex]);
+                }
+            });
+        }
+
+        statistics = mv::util::computeScalarStatistics(values.data(), values.size(), 1, numberOfBins);
+    }
+
+    std::lock_guard<std::mutex> lock(_dimensionStatisticsMutex);
+
+    // Only cache when the data did not change in the meantime
+    if (_dimensionStatisticsCache._dataGeneration == dataGeneration)
+        _dimensionStatisticsCache._statistics[key] = statistics;
+
+    return statistics;
+}
+
+bool Points::computeClusterStatistics(const std::vector<std::uint32_t>& labels, const std::vector<std::size_t>& offsets, const std::vector<std::uint32_t>& clusterIndices, const bool computeMedians,
+    mv::ClusterStatistics& statistics, const std::atomic<bool>& abortRequested) const
+{
+    if (isProxy())
+        throw std::runtime_error("Cluster statistics are not supported for proxy datasets");
+
+    const auto numberOfPoints = getNumPoints();
+
+    if (labels.size() > numberOfPoints)
+        throw std::runtime_error("There are more cluster labels than points");
+
+    for (const auto index : clusterIndices)
+        if (index >= numberOfPoints)
+            throw std::out_of_range("Cluster point index is out of range");
+
+    const auto& rawPointData = getRawData<PointData>();
+
+    // Labels and indices of the points in the raw data
+    std::vector<std::uint32_t> rawLabels;
+    std::vector<std::uint32_t> rawClusterIndices;
+
+    if (!labels.empty()) {
+        rawLabels.assign(rawPointData.getNumPoints(), mv::NO_CLUSTER_LABEL);
+
+        for (std::size_t localIndex = 0; localIndex < labels.size(); ++localIndex)
+            rawLabels[isFull() ? localIndex : indices[localIndex]] = labels[localIndex];
+    }
+
+    if (!isFull()) {
+        rawClusterIndices = clusterIndices;
+
+        mv::composeIndices(rawClusterIndices, indices);
+    }
+
+    return rawPointData.constVisitFromBeginToEnd<bool>([&](const auto begin, const auto end) -> bool {
+        const auto data = (begin == end) ? nullptr : &*begin;
+
+        return mv::computeClusterStatistics(data, data == nullptr ? 0 : rawPointData.getNumPoints(), rawPointData.getNumDimensions(), rawPointData.getStorageLayout() == PointData::StorageLayout::ColumnMajor,
+            rawLabels, offsets, isFull() ? clusterIndices : rawClusterIndices, computeMedians, statistics, abortRequested);
+    });
+}
+
 bool Points::mayProxy(const Datasets& proxyDatasets) const
 {
     if (!DatasetImpl::mayProxy(proxyDatasets))
@@ -483,46 +793,54 @@ Dataset<DatasetImpl> Points::createSubsetFromSelection(const QString& guiName, c
     return Application::core()->createSubsetFromSelection(getSelection(), toSmartPointer(), guiName, parentDataSet, visible);
 }
 
-Dataset<DatasetImpl> Points::createSubsetFromVisibleSelection(const QString& guiName, const Dataset<DatasetImpl>& parentDataSet /*= Dataset<DatasetImpl>()*/, const bool& visible /*= true*/) const
+Dataset<DatasetImpl> Points::createSubsetFromVisibleSelection(const QString& guiName, const Dataset<DatasetImpl>& parentDataSet /*= Dataset<DatasetImpl>()*/, const bool& visible /*= true*/, const bool& materialize /*= false*/) const
 {
-    Dataset<Points> subsetSelection = getSelection()->copy();
-    std::vector<uint32_t>& selectionIndices = subsetSelection->getSelectionIndices();
-
-    //// Get the global indices of the parent dataset
-    //std::vector<uint32_t> globalIndices;
-    //getGlobalIndices(globalIndices);
-
-    //// Find the intersection of points that are selected, and the given indices
-    //std::vector<uint32_t>& smallVector = (globalIndices.size() < selectionIndices.size()) ? globalIndices : selectionIndices;
-    //std::vector<uint32_t>& largeVector = (globalIndices.size() < selectionIndices.size()) ? selectionIndices : globalIndices;
-    //
-    //// Sort the smallest vector
-    //sort(smallVector.begin(), smallVector.end());
-
-    //// Loop over large vector and binary search which values are in the smaller vector
-    //std::vector<uint32_t> intersection;
-    //std::copy_if(largeVector.begin(), largeVector.end(), std::back_inserter(intersection), [smallVector](uint32_t x)
-    //{
-    //    return std::binary_search(smallVector.begin(), smallVector.end(), x);
-    //});
-
     // Compute the indices that are selected in this local dataset
     std::vector<uint32_t> localSelectionIndices;
     getLocalSelectionIndices(localSelectionIndices);
 
     // If we make a subset from a subset, take the locally selected points from the previous subset
     if (!isFull())
-    {
-        for (uint32_t& localIndex : localSelectionIndices)
-            localIndex = indices[localIndex];
-    }
+        composeIndices(localSelectionIndices, indices);
+
     // If the data is full, then the locally selected points are the new subset
 
-    subsetSelection->indices = localSelectionIndices;
+    if (materialize && !isProxy())
+        return createMaterializedSubset(localSelectionIndices, guiName, parentDataSet, visible);
+
+    Dataset<Points> subsetSelection = getSelection()->copy();
+
+    subsetSelection->indices = std::move(localSelectionIndices);
 
     return _core->createSubsetFromSelection(subsetSelection, toSmartPointer(), guiName, parentDataSet, visible);
 }
 
+Dataset<DatasetImpl> Points::createMaterializedSubset(const std::vector<std::uint32_t>& rawDataIndices, const QString& guiName, const Dataset<DatasetImpl>& parentDataSet, const bool& visible) const
+{
+    auto materializedSubset = _core->addDataset<Points>("Points", guiName, parentDataSet);
+
+    const auto& rawPointData        = getRawData<PointData>();
+    const auto numberOfDimensions   = rawPointData.getNumDimensions();
+    const auto isColumnMajor        = rawPointData.getStorageLayout() == PointData::StorageLayout::ColumnMajor;
+
+    // Copy the rows of the subset into a contiguous buffer of the same element type
+    rawPointData.constVisitFromBeginToEnd([&rawPointData, &rawDataIndices, &materializedSubset, numberOfDimensions, isColumnMajor](auto beginOfData, auto endOfData) -> void {
+        std::vector<std::decay_t<decltype(*beginOfData)>> materializedData(rawDataIndices.size() * numberOfDimensions);
+
+        if (beginOfData != endOfData)
+            gatherRows(&*beginOfData, rawPointData.getNumPoints(), numberOfDimensions, isColumnMajor, rawDataIndices, materializedData.data());
+
+        materializedSubset->setData(std::move(materializedData), numberOfDimensions);
+    });
+
+    materializedSubset->setDimensionNames(getDimensionNames());
+    materializedSubset->getDataHierarchyItem().setVisible(visible);
+
+    events().notifyDatasetDataChanged(materializedSubset);
+
+    return materializedSubset;
+}
+
 QIcon Points::getIcon(const QColor& color /*= Qt::black*/) const
 {
     return mv::Application::getIconFont("FontAwesome").getIcon("database", color);
@@ -582,12 +900,16 @@ void Points::setProxyMembers(const Datasets& proxyMembers)
 
         targetPoints->getGlobalIndices(targetGlobalIndices);
 
+        // Proxy point indices of the member points
+        std::vector<std::uint32_t> proxyIndices(targetPoints->getNumPoints());
+
+        std::iota(proxyIndices.begin(), proxyIndices.end(), pointIndexOffset);
+
         // Selection map from proxy to member
         {
             SelectionMap selectionMapToTarget;
 
-            for (std::uint32_t pointIndex = 0; pointIndex < targetPoints->getNumPoints(); ++pointIndex)
-                selectionMapToTarget.getMap()[pointIndexOffset + pointIndex] = std::vector<std::uint32_t>({ targetGlobalIndices[pointIndex] });
+            selectionMapToTarget.setOneToOneMapping(proxyIndices, targetGlobalIndices);
 
             addLinkedData(targetPoints, selectionMapToTarget);
         }
@@ -596,8 +918,7 @@ void Points::setProxyMembers(const Datasets& proxyMembers)
         {
             SelectionMap selectionMapToSource;
 
-            for (std::uint32_t pointIndex = 0; pointIndex < targetPoints->getNumPoints(); ++pointIndex)
-                selectionMapToSource.getMap()[targetGlobalIndices[pointIndex]] = std::vector<std::uint32_t>({ pointIndexOffset + pointIndex });
+            selectionMapToSource.setOneToOneMapping(targetGlobalIndices, proxyIndices);
 
             targetPoints->addLinkedData(toSmartPointer(), selectionMapToSource);
 
@@ -627,16 +948,22 @@ void Points::setProxyMembers(const Datasets& proxyMembers)
 
 void Points::getGlobalIndices(std::vector<unsigned int>& globalIndices) const
 {
-    if (isProxy())
-    {
-        globalIndices.resize(getNumPoints(), 0);
-        std::iota(globalIndices.begin(), globalIndices.end(), 0);
-        return;
-    }
+    globalIndices = getGlobalIndicesCache()->_globalIndices;
+}
 
+std::uint64_t Points::getGlobalIndicesRevision() const
+{
+    return getGlobalIndicesCache()->_revision;
+}
+
+std::shared_ptr<const Points::GlobalIndicesCache> Points::getGlobalIndicesCache() const
+{
     // Traverse the chain of datasets back to the original source data
     // Any subsets traversed along the way are stored in the a subset chain
+    // (a proxy indexes its own points, so it has no chain)
     std::vector<Dataset<Points>> subsetChain;
+
+    if (!isProxy())
     {
         auto currentDataset = toSmartPointer<Points>();
 
@@ -655,18 +982,47 @@ void Points::getGlobalIndices(std::vector<unsigned int>& globalIndices) const
             subsetChain.push_back(currentDataset);
     }
 
+    // The composed indices remain valid as long as the dataset graph and the indices of the subsets in the chain
+    // are unchanged, without a chain the global indices are the local indices
+    const auto datasetGraphRevision = mv::data().getDatasetGraphRevision();
+
+    std::vector<std::uint64_t> subsetRevisions;
+    subsetRevisions.reserve(subsetChain.size());
+
+    for (const Dataset<Points>& subset : subsetChain)
+        subsetRevisions.push_back(subset->indices.getRevision());
+
+    if (auto cache = std::atomic_load(&_globalIndicesCache))
+    {
+        if ((subsetChain.empty() || cache->_datasetGraphRevision == datasetGraphRevision) && cache->_subsetRevisions == subsetRevisions && cache->_globalIndices.size() == getNumPoints())
+            return cache;
+    }
+
+    // Unique among all points datasets, so that a revision identifies the global indices of one dataset
+    static std::atomic<std::uint64_t> nextRevision{ 1 };
+
     // Find the original global indices of this dataset by transforming them
     // step by step traversing through the chain of subsets
+    auto cache = std::make_shared<GlobalIndicesCache>();
     {
-        globalIndices.resize(getNumPoints(), 0);
-        std::iota(globalIndices.begin(), globalIndices.end(), 0);
+        auto& composedIndices = cache->_globalIndices;
+
+        composedIndices.resize(getNumPoints(), 0);
+        std::iota(composedIndices.begin(), composedIndices.end(), 0);
 
         for (const Dataset<Points>& subset : subsetChain)
-        {
-            for (int i = 0; i < globalIndices.size(); i++)
-                globalIndices[i] = subset->indices[globalIndices[i]];
-        }
+            composeIndices(composedIndices, subset->indices);
     }
+
+    cache->_revision                = nextRevision++;
+    cache->_datasetGraphRevision    = datasetGraphRevision;
+    cache->_subsetRevisions         = std::move(subsetRevisions);
+
+    std::shared_ptr<const GlobalIndicesCache> constCache(std::move(cache));
+
+    std::atomic_store(&_globalIndicesCache, constCache);
+
+    return constCache;
 }
 
 void Points::selectedLocalIndices(const std::vector<unsigned int>& selectionIndices, std::vector<bool>& selected) const
@@ -678,27 +1034,21 @@ void Points::selectedLocalIndices(const std::vector<unsigned int>& selectionIndi
     getGlobalIndices(localGlobalIndices);
 
     if (isProxy()) {
-        selected.resize(getNumPoints(), false);
+        selected.assign(getNumPoints(), false);
 
         for (const auto& selectionIndex : selectionIndices) {
             selected[localGlobalIndices[selectionIndex]] = true;
         }
     }
     else {
+        selected.assign(localGlobalIndices.size(), false);
 
-        // In an array the size of the full raw data, mark selected points as true
-        std::vector<bool> globalSelection(getSourceDataset<Points>()->getNumRawPoints(), false);
+        // Compact the selected local indices (in parallel), rather than testing each local point serially
+        std::vector<unsigned int> localSelectionIndices;
+        compactLocalSelectionIndices(localGlobalIndices, SelectionBitmap(selectionIndices), localSelectionIndices);
 
-        for (const unsigned int& selectionIndex : selectionIndices)
-            globalSelection[selectionIndex] = true;
-
-        // For all local points find out which are selected
-        selected.resize(localGlobalIndices.size(), false);
-        for (int i = 0; i < localGlobalIndices.size(); i++)
-        {
-            if (globalSelection[localGlobalIndices[i]])
-                selected[i] = true;
-        }
+        for (const auto& localSelectionIndex : localSelectionIndices)
+            selected[localSelectionIndex] = true;
     }
 }
 
@@ -710,37 +1060,17 @@ void Points::getLocalSelectionIndices(std::vector<unsigned int>& localSelectionI
         return;
     }
 
-
     auto selection = getSelection<Points>();
 
     // Find the global indices of this dataset
     std::vector<unsigned int> localGlobalIndices;
     getGlobalIndices(localGlobalIndices);
 
-    // In an array the size of the full raw data, mark selected points as true
-    std::vector<bool> globalSelection(getSourceDataset<Points>()->getNumRawPoints(), false);
-    for (const unsigned int& selectionIndex : selection->indices)
-        globalSelection[selectionIndex] = true;
-
-    // For all local points find out which are selected
-    std::vector<bool> selected(localGlobalIndices.size(), false);
-    int indexCount = 0;
-    for (int i = 0; i < localGlobalIndices.size(); i++)
-    {
-        if (globalSelection[localGlobalIndices[i]])
-        {
-            selected[i] = true;
-            indexCount++;
-        }
-    }
+    // A compressed bitmap of the global selection, rather than an array the size of the full raw data
+    const SelectionBitmap globalSelection(selection->indices);
 
-    localSelectionIndices.resize(indexCount);
-    int c = 0;
-    for (int i = 0; i < selected.size(); i++)
-    {
-        if (selected[i])
-            localSelectionIndices[c++] = i;
-    }
+    // For all local points find out which are selected (in parallel)
+    compactLocalSelectionIndices(localGlobalIndices, globalSelection, localSelectionIndices);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -829,33 +1159,18 @@ void resolveLinkedPointData(LinkedData& linkedData, const std::vector<std::uint3
 
         const SelectionMap& mapping = linkedData.getMapping();
 
-        // Create separate vector of additional linked selected points
-        std::vector<unsigned int> linkedIndices;
-
-        // Reserve at least as much space as required for a 1-1 mapping
-        linkedIndices.reserve(indices.size());
-
-        for (const auto& selectionIndex : indices)
-        {
-            if (mapping.hasMappingForPointIndex(selectionIndex))
-            {
-                std::vector<std::uint32_t> mappedSelection;
-                mapping.populateMappingIndices(selectionIndex, mappedSelection);
-                linkedIndices.insert(linkedIndices.end(), mappedSelection.begin(), mappedSelection.end());
-            }
-        }
+        // Linked selected points (sorted and unique)
+        auto linkedIndices = mapping.mapSelection(indices);
 
         if (targetDataset->isProxy()) {
-            std::set<std::uint32_t> targetIndicesSet(targetSelection->indices.begin(), targetSelection->indices.end());
+            SelectionBitmap targetIndices(targetSelection->indices);
 
-            for (auto& [key, value] : const_cast<SelectionMap&>(mapping).getMap())
-                for (const auto& v : value)
-                    targetIndicesSet.erase(v);
+            // Replace the selection of the points that are mapped onto by the selection of the linked points
+            // (the mapping of linked data is always compressed, so the union of its target indices is precomputed)
+            targetIndices -= mapping.getTargetBitmap();
+            targetIndices |= SelectionBitmap(linkedIndices);
 
-            for (const auto& linkedIndex : linkedIndices)
-                targetIndicesSet.insert(linkedIndex);
-
-            targetSelection->indices = std::vector<std::uint32_t>(targetIndicesSet.begin(), targetIndicesSet.end());
+            targetSelection->indices = targetIndices.toIndices();
         }
         else {
             targetSelection->indices = linkedIndices;
@@ -919,15 +1234,12 @@ void Points::selectAll()
 {
     auto& selectionIndices = getSelection<Points>()->indices;
 
-    selectionIndices.clear();
-    selectionIndices.resize(getNumPoints());
-
     if (isFull()) {
+        selectionIndices.resize(getNumPoints());
         std::iota(selectionIndices.begin(), selectionIndices.end(), 0);
     }
     else {
-        for (const auto& index : indices)
-            selectionIndices.push_back(index);
+        selectionIndices = indices;
     }
 
     events().notifyDatasetDataSelectionChanged(this);
@@ -946,18 +1258,21 @@ void Points::selectInvert()
 {
     auto& selectionIndices = getSelection<Points>()->indices;
 
-    std::set<std::uint32_t> selectionSet(selectionIndices.begin(), selectionIndices.end());
-
-    const auto noPixels = getNumPoints();
+    auto selection = SelectionBitmap(selectionIndices);
 
-    selectionIndices.clear();
-    selectionIndices.reserve(noPixels - selectionSet.size());
+    if (isFull()) {
+        selection.invert(getNumPoints());
+    }
+    else {
+        // Select the points of this subset that are not selected yet
+        auto subset = SelectionBitmap(indices);
 
-    for (std::uint32_t i = 0; i < noPixels; i++) {
-        if (selectionSet.find(i) == selectionSet.end())
-            selectionIndices.push_back(i);
+        subset -= selection;
+        selection = std::move(subset);
     }
 
+    selectionIndices = selection.toIndices();
+
     events().notifyDatasetDataSelectionChanged(this);
 }
 
@@ -983,6 +1298,8 @@ void Points::fromVariantMap(const QVariantMap& variantMap)
         indices.resize(indicesMap["Count"].toInt());
 
         populateDataBufferFromVariantMap(indicesMap["Raw"].toMap(), (char*)indices.data());
+
+        indices.markModified();
     }
 
     // Fetch dimension names from map
@@ -1031,6 +1348,7 @@ void Points::fromVariantMap(const QVariantMap& variantMap)
             selectionSet->indices.resize(count);
 
             populateDataBufferFromVariantMap(selectionMap["Raw"].toMap(), (char*)selectionSet->indices.data());
+            selectionSet->indices.markModified();
 
             events().notifyDatasetDataSelectionChanged(this);
         }
@@ -1060,7 +1378,7 @@ QVariantMap Points::toVariantMap() const
     QVariantMap indices;
 
     indices["Count"]    = QVariant::fromValue(this->indices.size());
-    indices["Raw"]      = rawDataToVariantMap((char*)this->indices.data(), this->indices.size() * sizeof(std::uint32_t), true);
+    indices["Raw"]      = rawDataToVariantMap((char*)this->indices.data(), this->indices.size() * sizeof(std::uint32_t), true, -1, false, sizeof(std::uint32_t));
 
     QVariantMap selection;
 
@@ -1068,7 +1386,7 @@ QVariantMap Points::toVariantMap() const
         auto selectionSet = getSelection<Points>();
 
         selection["Count"]  = QVariant::fromValue(selectionSet->indices.size());
-        selection["Raw"]    = rawDataToVariantMap((char*)selectionSet->indices.data(), selectionSet->indices.size() * sizeof(std::uint32_t), true);
+        selection["Raw"]    = rawDataToVariantMap((char*)selectionSet->indices.data(), selectionSet->indices.size() * sizeof(std::uint32_t), true, -1, false, sizeof(std::uint32_t));
     }
 
     variantMap["Data"]                  = isFull() ? getRawData<PointData>().toVariantMap() : QVariantMap();
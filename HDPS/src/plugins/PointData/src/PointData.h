@@ -10,10 +10,16 @@
 
 #include "Set.h"
 #include "PointDataRange.h"
+#include "StridedIterator.h"
+#include "SubsetIndices.h"
+#include "PointDataSpan.h"
+#include "MemoryMappedFile.h"
 #include "LinkedData.h"
 
 #include "event/EventListener.h"
 
+#include "util/ScalarStatistics.h"
+
 #include <biovault_bfloat16/biovault_bfloat16.h>
 
 #include <QString>
@@ -21,7 +27,13 @@
 #include <QVariant>
 
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <iterator> // For size.
+#include <map>
+#include <memory> // For shared_ptr.
+#include <mutex>
+#include <stdexcept>
 #include <utility> // For tuple.
 #include <vector>
 
@@ -32,6 +44,9 @@ namespace mv
     // From "graphics/Vector2f.h"
     class Vector2f;
 
+    // From "ClusterStatistics.h"
+    struct ClusterStatistics;
+
     namespace gui {
         class GroupAction;
     }
@@ -100,6 +115,11 @@ private:
         // Specifies which vector is selected, based on its value_type.
         ElementTypeSpecifier _elementTypeSpecifier{};
 
+        // When not null, the data is not held by the selected vector, but by this memory
+        // mapped file region instead. The region holds the elements in the same order as
+        // the vector would. (The selected vector is then empty.)
+        std::shared_ptr<mv::MemoryMappedFile> _memoryMappedFile;
+
         // Tries to find the element type specifier that corresponds to ElementType.
         template <typename ElementType, typename Head, typename... Tail>
         constexpr static ElementTypeSpecifier recursiveFindElementTypeSpecifier(
@@ -126,23 +146,34 @@ private:
             return ElementTypeSpecifier{}; // Should not occur!
         }
 
-        template <typename ReturnType, typename VectorHolderType, typename FunctionObject, typename Head, typename... Tail>
+        // Passes either the selected vector or (when the data is memory mapped, and
+        // visitMemoryMappedData is true) a span of the memory mapped data to the function object.
+        template <bool visitMemoryMappedData, typename ReturnType, typename VectorHolderType, typename FunctionObject, typename Head, typename... Tail>
         static ReturnType recursiveVisit(VectorHolderType& vectorHolder, FunctionObject functionObject, const std::tuple<Head, Tail...>*)
         {
             using HeadValueType = typename Head::value_type;
 
             if (vectorHolder.template isSameElementType<HeadValueType>())
             {
+                if constexpr (visitMemoryMappedData)
+                {
+                    if (vectorHolder.isMemoryMapped())
+                    {
+                        // Passed as lvalue, as function objects typically take the vector by reference.
+                        auto span = vectorHolder.template getMemoryMappedSpan<HeadValueType>();
+                        return functionObject(span);
+                    }
+                }
                 return functionObject(vectorHolder.template getVector<HeadValueType>());
             }
             else
             {
                 constexpr const std::tuple<Tail...>* tailNullptr{nullptr};
-                return recursiveVisit<ReturnType>(vectorHolder, functionObject, tailNullptr);
+                return recursiveVisit<visitMemoryMappedData, ReturnType>(vectorHolder, functionObject, tailNullptr);
             }
         }
 
-        template <typename ReturnType, typename VectorHolderType, typename FunctionObject>
+        template <bool visitMemoryMappedData, typename ReturnType, typename VectorHolderType, typename FunctionObject>
         static ReturnType recursiveVisit(VectorHolderType&, FunctionObject&, const std::tuple<>*)
         {
             struct VisitException : std::exception
@@ -155,6 +186,14 @@ private:
             throw VisitException{};
         }
 
+        // Like visit, but always passes the selected vector, even when the data is memory mapped.
+        template <typename ReturnType = void, typename FunctionObject>
+        ReturnType visitVector(FunctionObject functionObject)
+        {
+            constexpr const TupleOfVectors* const tupleNullptr{nullptr};
+            return recursiveVisit<false, ReturnType>(*this, functionObject, tupleNullptr);
+        }
+
     public:
 
         /// Yields the n-th supported element type.
@@ -189,21 +228,29 @@ private:
         }
 
 
-        // Similar to C++17 std::visit.
+        // Similar to C++17 std::visit. Passes either the selected vector, or
+        // (when the data is memory mapped) an mv::PointDataSpan to the data.
         template <typename ReturnType = void, typename FunctionObject>
         ReturnType constVisit(FunctionObject functionObject) const
         {
             constexpr const TupleOfVectors* const tupleNullptr{nullptr};
-            return recursiveVisit<ReturnType>(*this, functionObject, tupleNullptr);
+            return recursiveVisit<true, ReturnType>(*this, functionObject, tupleNullptr);
         }
 
 
-        // Similar to C++17 std::visit.
+        // Similar to C++17 std::visit. Passes either the selected vector, or
+        // (when the data is memory mapped) an mv::PointDataSpan to the data.
+        // \note When the data is mapped read-only, it is first copied into the
+        // selected vector, as the mapped region cannot be written to.
         template <typename ReturnType = void, typename FunctionObject>
         ReturnType visit(FunctionObject functionObject)
         {
+            if (isMemoryMapped() && !_memoryMappedFile->isWritable())
+            {
+                detachFromMemoryMappedFile();
+            }
             constexpr const TupleOfVectors* const tupleNullptr{nullptr};
-            return recursiveVisit<ReturnType>(*this, functionObject, tupleNullptr);
+            return recursiveVisit<true, ReturnType>(*this, functionObject, tupleNullptr);
         }
 
         template <typename T>
@@ -240,28 +287,94 @@ private:
             return const_cast<std::vector<T>&>(getConstVector<T>());
         }
 
-        /// Just forwarding to the corresponding member function of the currently selected std::vector.
+        /// Returns a read-only span of the memory mapped data.
+        template <typename T>
+        mv::PointDataSpan<const T> getMemoryMappedSpan() const
+        {
+            // This function should only be used to access the currently selected element type.
+            assert(isSameElementType<T>());
+            assert(isMemoryMapped());
+            return { reinterpret_cast<const T*>(std::as_const(*_memoryMappedFile).getData()), _memoryMappedFile->getNumberOfBytes() / sizeof(T) };
+        }
+
+        /// Returns a writable span of the memory mapped data. Only allowed when the mapping is writable.
+        template <typename T>
+        mv::PointDataSpan<T> getMemoryMappedSpan()
+        {
+            assert(isSameElementType<T>());
+            assert(isMemoryMapped() && _memoryMappedFile->isWritable());
+            return { reinterpret_cast<T*>(_memoryMappedFile->getData()), _memoryMappedFile->getNumberOfBytes() / sizeof(T) };
+        }
+
+        bool isMemoryMapped() const
+        {
+            return _memoryMappedFile != nullptr;
+        }
+
+        /// Lets the data be held by the specified memory mapped file region,
+        /// instead of by the selected vector (which is cleared).
+        void setMemoryMappedFile(std::shared_ptr<mv::MemoryMappedFile> memoryMappedFile)
+        {
+            visitVector([](auto& vec)
+            {
+                vec.clear();
+                vec.shrink_to_fit();
+            });
+            _memoryMappedFile = std::move(memoryMappedFile);
+        }
+
+        /// Copies the memory mapped data into the selected vector, and releases the mapping.
+        void detachFromMemoryMappedFile()
+        {
+            if (!isMemoryMapped())
+            {
+                return;
+            }
+            const auto memoryMappedFile = std::move(_memoryMappedFile);
+
+            visitVector([&memoryMappedFile](auto& vec)
+            {
+                using ValueType = typename std::remove_reference_t<decltype(vec)>::value_type;
+
+                const auto* const beginOfData = reinterpret_cast<const ValueType*>(std::as_const(*memoryMappedFile).getData());
+                vec.assign(beginOfData, beginOfData + memoryMappedFile->getNumberOfBytes() / sizeof(ValueType));
+            });
+        }
+
+        /// Just forwarding to the corresponding member function of the currently selected std::vector
+        /// (or the memory mapped data).
         std::size_t size() const
         {
             return constVisit<std::size_t>([] (const auto& vec){ return vec.size(); });
         }
 
         /// Just forwarding to the corresponding member function of the currently selected std::vector.
+        /// \note Memory mapped data is only copied into the vector when its size actually changes.
         void resize(const std::size_t newSize)
         {
-            visit([newSize](auto& vec) { vec.resize(newSize); });
+            if (isMemoryMapped())
+            {
+                if (newSize == size())
+                {
+                    return;
+                }
+                detachFromMemoryMappedFile();
+            }
+            visitVector([newSize](auto& vec) { vec.resize(newSize); });
         }
  
         /// Just forwarding to the corresponding member function of the currently selected std::vector.
+        /// Releases the memory mapping, if any.
         void clear()
         {
-            visit([](auto& vec) { return vec.clear(); });
+            _memoryMappedFile = nullptr;
+            visitVector([](auto& vec) { return vec.clear(); });
         }
 
         /// Just forwarding to the corresponding member function of the currently selected std::vector.
         void shrink_to_fit()
         {
-            visit([](auto& vec) { return vec.shrink_to_fit(); });
+            visitVector([](auto& vec) { return vec.shrink_to_fit(); });
         }
 
         void setElementTypeSpecifier(const ElementTypeSpecifier elementTypeSpecifier)
@@ -281,6 +394,8 @@ private:
         template <typename T>
         void convertData(const T* const data, const std::size_t numberOfElements)
         {
+            // All elements are overwritten, so there is no need to copy memory mapped data.
+            _memoryMappedFile = nullptr;
             resize(numberOfElements);
 
             visit([data](auto& vec)
@@ -315,6 +430,13 @@ private:
 public:
     using ElementTypeSpecifier = VectorHolder::ElementTypeSpecifier;
 
+    /// Specifies the order in which the data elements are stored.
+    enum class StorageLayout
+    {
+        RowMajor,       /// Point after point: the values of a single point are contiguous (default)
+        ColumnMajor     /// Dimension after dimension: the values of a single dimension are contiguous
+    };
+
     /// Yields the n-th supported element type. Corresponds to the n-th entry
     /// in the array of type names, returned by getElementTypeNames().
     template <std::size_t N>
@@ -363,6 +485,8 @@ public:
     }
 
     // Similar to C++17 std::visit.
+    // \note The elements are visited in the order in which they are stored,
+    // as specified by getStorageLayout().
     template <typename ReturnType = void, typename FunctionObject>
     ReturnType constVisitFromBeginToEnd(FunctionObject functionObject) const
     {
@@ -373,6 +497,8 @@ public:
     }
 
     // Similar to C++17 std::visit.
+    // \note The elements are visited in the order in which they are stored,
+    // as specified by getStorageLayout().
     template <typename ReturnType = void, typename FunctionObject>
     ReturnType visitFromBeginToEnd(FunctionObject functionObject)
     {
@@ -386,6 +512,11 @@ public:
     void extractFullDataForDimensions(std::vector<mv::Vector2f>& result, const int dimensionIndex1, const int dimensionIndex2) const;
     void extractDataForDimensions(std::vector<mv::Vector2f>& result, const int dimensionIndex1, const int dimensionIndex2, const std::vector<unsigned int>& indices) const;
 
+    /// Computes the mean value of each dimension over the points at the specified indices.
+    /// The points are accumulated row by row by multiple threads, each of which handles a chunk
+    /// of the points and a tile of the dimensions.
+    void computeMeanPerDimension(std::vector<float>& means, const std::vector<std::uint32_t>& indices) const;
+
     template <typename ResultContainer, typename DimensionIndices>
     void populateFullDataForDimensions(ResultContainer& resultContainer, const DimensionIndices& dimensionIndices) const
     {
@@ -393,6 +524,26 @@ public:
         _vectorHolder.constVisit([&resultContainer, this, &dimensionIndices](const auto& vec)
             {
                 const std::ptrdiff_t numPoints{ getNumPoints() };
+
+                if (_storageLayout == StorageLayout::ColumnMajor)
+                {
+                    // Read each of the dimensions contiguously.
+                    const std::ptrdiff_t numResultDimensions{ static_cast<std::ptrdiff_t>(std::size(dimensionIndices)) };
+                    std::ptrdiff_t resultDimensionIndex{};
+
+                    for (const std::ptrdiff_t dimensionIndex : dimensionIndices)
+                    {
+                        const std::ptrdiff_t n{ dimensionIndex * numPoints };
+
+                        for (std::ptrdiff_t pointIndex{}; pointIndex < numPoints; ++pointIndex)
+                        {
+                            resultContainer[pointIndex * numResultDimensions + resultDimensionIndex] = vec[n + pointIndex];
+                        }
+                        ++resultDimensionIndex;
+                    }
+                    return;
+                }
+
                 std::ptrdiff_t resultIndex{};
 
                 for (std::ptrdiff_t pointIndex{}; pointIndex < numPoints; ++pointIndex)
@@ -416,6 +567,26 @@ public:
         _vectorHolder.constVisit([&resultContainer, this, &dimensionIndices, &indices](const auto& vec)
             {
                 const std::ptrdiff_t numPoints{ static_cast<std::uint32_t>(indices.size()) };
+
+                if (_storageLayout == StorageLayout::ColumnMajor)
+                {
+                    const std::ptrdiff_t numAllPoints{ getNumPoints() };
+                    const std::ptrdiff_t numResultDimensions{ static_cast<std::ptrdiff_t>(std::size(dimensionIndices)) };
+                    std::ptrdiff_t resultDimensionIndex{};
+
+                    for (const std::ptrdiff_t dimensionIndex : dimensionIndices)
+                    {
+                        const std::ptrdiff_t n{ dimensionIndex * numAllPoints };
+
+                        for (std::ptrdiff_t pointIndex{}; pointIndex < numPoints; ++pointIndex)
+                        {
+                            resultContainer[pointIndex * numResultDimensions + resultDimensionIndex] = vec[n + indices[pointIndex]];
+                        }
+                        ++resultDimensionIndex;
+                    }
+                    return;
+                }
+
                 std::ptrdiff_t resultIndex{};
 
                 for (std::ptrdiff_t pointIndex{}; pointIndex < numPoints; ++pointIndex)
@@ -464,33 +635,41 @@ public:
     /// Converts the specified data to the internal data, using static_cast for
     /// each data element. Sets the number of dimensions as specified. Ensures
     /// that the size of the internal data buffer corresponds to the number of
-    /// points.
+    /// points. The specified data is expected in row-major order, and stored
+    /// according to the specified storage layout.
     /// \note This function does not affect the selected internal data type.
     template <typename T>
-    void convertData(const T* const data, const std::size_t numPoints, const std::size_t numDimensions)
+    void convertData(const T* const data, const std::size_t numPoints, const std::size_t numDimensions, const StorageLayout storageLayout = StorageLayout::RowMajor)
     {
         _vectorHolder.convertData(data, numPoints * numDimensions);
         _numDimensions = static_cast<std::uint32_t>(numDimensions);
+        _storageLayout = StorageLayout::RowMajor;
+        setStorageLayout(storageLayout);
     }
 
     /// Converts the specified data to the internal data, using static_cast for each data element.
     /// Convenience overload, allowing an std::vector or an std::array as
     /// input data container.
     template <typename T>
-    void convertData(const T& inputDataContainer, const std::size_t numDimensions)
+    void convertData(const T& inputDataContainer, const std::size_t numDimensions, const StorageLayout storageLayout = StorageLayout::RowMajor)
     {
         _vectorHolder.convertData(inputDataContainer.data(), inputDataContainer.size());
         _numDimensions = static_cast<std::uint32_t>(numDimensions);
+        _storageLayout = StorageLayout::RowMajor;
+        setStorageLayout(storageLayout);
     }
 
     /// Copies the specified data into the internal data, sets the number of
     /// dimensions as specified, and sets the selected internal data type
-    /// according to the specified data type T.
+    /// according to the specified data type T. The specified data is expected
+    /// in row-major order, and stored according to the specified storage layout.
     template <typename T>
-    void setData(const T* const data, const std::size_t numPoints, const std::size_t numDimensions)
+    void setData(const T* const data, const std::size_t numPoints, const std::size_t numDimensions, const StorageLayout storageLayout = StorageLayout::RowMajor)
     {
          _vectorHolder = VectorHolder( std::vector<T>(data, data + numPoints * numDimensions) );
          _numDimensions = static_cast<std::uint32_t>(numDimensions);
+         _storageLayout = StorageLayout::RowMajor;
+         setStorageLayout(storageLayout);
     }
 
 
@@ -502,32 +681,86 @@ public:
     /// the number of dimensions as specified, and sets the selected internal
     /// data type according to the specified data type T.
     template <typename T>
-    void setData(const std::vector<T>& data, const std::size_t numDimensions)
+    void setData(const std::vector<T>& data, const std::size_t numDimensions, const StorageLayout storageLayout = StorageLayout::RowMajor)
     {
         _vectorHolder = VectorHolder(data);
         _numDimensions = static_cast<unsigned int>(numDimensions);
+        _storageLayout = StorageLayout::RowMajor;
+        setStorageLayout(storageLayout);
     }
 
     /// Efficiently "moves" the data from the specified vector into the internal
     /// data, sets the number of dimensions as specified, and sets the selected
     /// internal data type according to the specified data type T.
     template <typename T>
-    void setData(std::vector<T>&& data, const std::size_t numDimensions)
+    void setData(std::vector<T>&& data, const std::size_t numDimensions, const StorageLayout storageLayout = StorageLayout::RowMajor)
     {
         _vectorHolder = VectorHolder(std::move(data));
         _numDimensions = static_cast<unsigned int>(numDimensions);
+        _storageLayout = StorageLayout::RowMajor;
+        setStorageLayout(storageLayout);
+    }
+
+    /// Returns the order in which the data elements are stored.
+    StorageLayout getStorageLayout() const
+    {
+        return _storageLayout;
+    }
+
+    /// Rearranges the data elements according to the specified storage layout.
+    /// Does nothing when the data is already stored in this layout.
+    /// \note Memory mapped data is copied into memory when it is rearranged.
+    /// Reading or visiting the data never changes its layout.
+    void setStorageLayout(const StorageLayout storageLayout);
+
+    /// Lets the internal data be held by a region of a binary file that is mapped
+    /// into memory, instead of copying the data. The region starts at the specified
+    /// byte offset, and holds numPoints * numDimensions elements of type T, in the
+    /// storage layout as specified. Sets the number of dimensions as specified,
+    /// and sets the selected internal data type according to T.
+    /// \note The operating system only pages in the parts of the file that are
+    /// actually accessed, so the file may be larger than the physical memory.
+    /// With MemoryMappedFile::Mode::CopyOnWrite, modifications of the data are
+    /// private to the process, and never written back to the file.
+    template <typename T>
+    void setMemoryMappedData(const QString& filePath, const std::size_t numPoints, const std::size_t numDimensions, const std::uint64_t offset = 0, const mv::MemoryMappedFile::Mode mode = mv::MemoryMappedFile::Mode::CopyOnWrite, const StorageLayout storageLayout = StorageLayout::RowMajor)
+    {
+        if (offset % sizeof(T) != 0)
+            throw std::runtime_error("Unable to map point data into memory, the offset is not aligned to the element type");
+
+        auto memoryMappedFile = std::make_shared<mv::MemoryMappedFile>(filePath, offset, numPoints * numDimensions * sizeof(T), mode);
+
+        _vectorHolder = VectorHolder(std::vector<T>());
+        _vectorHolder.setMemoryMappedFile(std::move(memoryMappedFile));
+        _numDimensions = static_cast<unsigned int>(numDimensions);
+        _storageLayout = storageLayout;
+    }
+
+    /// Returns whether the internal data is held by a memory mapped file region.
+    bool isMemoryMapped() const
+    {
+        return _vectorHolder.isMemoryMapped();
+    }
+
+    /// Copies memory mapped data into memory and releases the mapping. Does
+    /// nothing when the data is not memory mapped.
+    void detachFromMemoryMappedFile()
+    {
+        _vectorHolder.detachFromMemoryMappedFile();
     }
 
     void setDimensionNames(const std::vector<QString>& dimNames);
 
     // Returns the value of the element at the specified position in the current
-    // data vector, converted to float.
+    // data vector, converted to float. The position is the row-major index of the
+    // element (pointIndex * numDimensions + dimensionIndex), regardless of the storage layout.
     // Will work fine, even when the internal data element type is not float.
     // However, may not perform well when retrieving a large number of values.
     float getValueAt(std::size_t index) const;
 
     // Sets the value of the element at the specified position in the current
-    // data vector, converted to the internal data element type. 
+    // data vector, converted to the internal data element type. The position is
+    // the row-major index of the element, regardless of the storage layout.
     // Will work fine, even when the internal data element type is not float.
     // However, may not perform well when setting a large number of values.
     void setValueAt(std::size_t index, float newValue);
@@ -545,11 +778,21 @@ public:
     virtual QVariantMap toVariantMap() const final;
 
 private:
+
+    /// Returns the position of the specified element in the internal data, according to the storage layout.
+    std::size_t getElementIndex(std::size_t pointIndex, std::size_t dimensionIndex) const;
+
+    /// Returns the position in the internal data of the element at the specified row-major index.
+    std::size_t getElementIndex(std::size_t rowMajorIndex) const;
+
     VectorHolder _vectorHolder;
 
     /** Number of features of each data point */
     unsigned int _numDimensions = 1;
 
+    /** Order in which the data elements are stored */
+    StorageLayout _storageLayout = StorageLayout::RowMajor;
+
     std::vector<QString> _dimNames;
 };
 
@@ -560,13 +803,37 @@ private:
 class POINTDATA_EXPORT Points : public mv::DatasetImpl
 {
 private:
+    /* Private helper function, which calls the specified function object with the begin and
+    * the end of the point data values. For column-major data, these are strided iterators, so
+    * that the values of each point can be viewed without rearranging the data. The end is then
+    * positioned at the total number of values, just like the end of row-major data.
+    */
+    template <typename ReturnType = void, typename PointsType, typename FunctionObject>
+    static ReturnType privateVisitValues(PointsType& points, const FunctionObject functionObject)
+    {
+        return points.template visitFromBeginToEnd<ReturnType>(
+            [&points, functionObject](const auto begin, const auto end) -> ReturnType
+            {
+                if (points.getStorageLayout() == PointData::StorageLayout::ColumnMajor)
+                {
+                    const auto numberOfValues = end - begin;
+                    const auto numberOfPoints = numberOfValues / points.getNumDimensions();
+
+                    return functionObject(mv::StridedIterator(begin, numberOfPoints), mv::StridedIterator(begin, numberOfPoints, numberOfValues));
+                }
+
+                return functionObject(begin, end);
+            });
+    }
+
+
     /* Private helper function for visitData. Helps to reduces duplicate
     * code between const and non-const overloads of visitData.
     */
-    template <typename ReturnType = void, typename FunctionObject>
-    static ReturnType privateVisitData(Points& points, const FunctionObject functionObject)
+    template <typename ReturnType = void, typename PointsType, typename FunctionObject>
+    static ReturnType privateVisitData(PointsType& points, const FunctionObject functionObject)
     {
-        return points.template visitFromBeginToEnd<ReturnType>(
+        return privateVisitValues<ReturnType>(points,
                 [&points, functionObject](const auto begin, const auto end) -> ReturnType
                 {
                     const auto numberOfDimensions = points.getNumDimensions();
@@ -601,11 +868,11 @@ private:
     /* Private helper function for visitSourceData. Helps to reduces duplicate
     * code between const and non-const overloads of visitSourceData.
     */
-    template <typename ReturnType = void, typename FunctionObject>
-    static ReturnType privateVisitSourceData(Points& points, const FunctionObject functionObject)
+    template <typename ReturnType = void, typename PointsType, typename FunctionObject>
+    static ReturnType privateVisitSourceData(PointsType& points, const FunctionObject functionObject)
     {
         // Note that PointsType may or may not be "const".
-        auto sourceData = points.getSourceDataset<Points>();
+        auto sourceData = points.template getSourceDataset<Points>();
 
         if (sourceData->getId() == points.getId() || points.isFull())
         {
@@ -619,7 +886,7 @@ private:
 
             if (sourceData->isFull())
             {
-                return sourceData->template visitFromBeginToEnd<ReturnType>(
+                return privateVisitValues<ReturnType>(*sourceData,
                     [&points, functionObject](const auto begin, const auto end) -> ReturnType
                     {
                         const auto indexFunction = [](const auto indexIterator)
@@ -643,7 +910,7 @@ private:
                     return sourceData->indices[*indexIterator];
                 };
 
-                return sourceData->template visitFromBeginToEnd<ReturnType>(
+                return privateVisitValues<ReturnType>(*sourceData,
                     [&points, functionObject, indexFunction](const auto begin, const auto end) -> ReturnType
                     {
                         return functionObject(mv::makePointDataRangeOfSubset(
@@ -721,17 +988,17 @@ public:
 
     /// Just calls the corresponding member function of its PointData.
     template <typename T>
-    void convertData(const T* const data, const std::size_t numPoints, const std::size_t numDimensions)
+    void convertData(const T* const data, const std::size_t numPoints, const std::size_t numDimensions, const PointData::StorageLayout storageLayout = PointData::StorageLayout::RowMajor)
     {
-        getRawData<PointData>().convertData(data, numPoints, numDimensions);
+        getRawData<PointData>().convertData(data, numPoints, numDimensions, storageLayout);
     }
 
 
     /// Just calls the corresponding member function of its PointData.
     template <typename T>
-    void convertData(const T& inputDataContainer, const std::size_t numDimensions)
+    void convertData(const T& inputDataContainer, const std::size_t numDimensions, const PointData::StorageLayout storageLayout = PointData::StorageLayout::RowMajor)
     {
-        getRawData<PointData>().convertData(inputDataContainer, numDimensions);
+        getRawData<PointData>().convertData(inputDataContainer, numDimensions, storageLayout);
     }
 
     template <typename T>
@@ -743,11 +1010,11 @@ public:
 
     /// Just calls the corresponding member function of its PointData.
     template <typename T>
-    void setData(const T* const data, const std::size_t numPoints, const std::size_t numDimensions)
+    void setData(const T* const data, const std::size_t numPoints, const std::size_t numDimensions, const PointData::StorageLayout storageLayout = PointData::StorageLayout::RowMajor)
     {
         const auto notifyDimensionsChanged = numDimensions != getRawData<PointData>().getNumDimensions();
 
-        getRawData<PointData>().setData(data, numPoints, numDimensions);
+        getRawData<PointData>().setData(data, numPoints, numDimensions, storageLayout);
 
         if (notifyDimensionsChanged)
             mv::events().notifyDatasetDataDimensionsChanged(this);
@@ -758,11 +1025,23 @@ public:
 
     /// Just calls the corresponding member function of its PointData.
     template <typename T>
-    void setData(const std::vector<T>& data, const std::size_t numDimensions)
+    void setData(const std::vector<T>& data, const std::size_t numDimensions, const PointData::StorageLayout storageLayout = PointData::StorageLayout::RowMajor)
+    {
+        const auto notifyDimensionsChanged = numDimensions != getRawData<PointData>().getNumDimensions();
+
+        getRawData<PointData>().setData(data, numDimensions, storageLayout);
+
+        if (notifyDimensionsChanged)
+            mv::events().notifyDatasetDataDimensionsChanged(this);
+    }
+
+    /// Just calls the corresponding member function of its PointData.
+    template <typename T>
+    void setData(std::vector<T>&& data, const std::size_t numDimensions, const PointData::StorageLayout storageLayout = PointData::StorageLayout::RowMajor)
     {
         const auto notifyDimensionsChanged = numDimensions != getRawData<PointData>().getNumDimensions();
 
-        getRawData<PointData>().setData(data, numDimensions);
+        getRawData<PointData>().setData(std::move(data), numDimensions, storageLayout);
 
         if (notifyDimensionsChanged)
             mv::events().notifyDatasetDataDimensionsChanged(this);
@@ -770,20 +1049,62 @@ public:
 
     /// Just calls the corresponding member function of its PointData.
     template <typename T>
-    void setData(std::vector<T>&& data, const std::size_t numDimensions)
+    void setMemoryMappedData(const QString& filePath, const std::size_t numPoints, const std::size_t numDimensions, const std::uint64_t offset = 0, const mv::MemoryMappedFile::Mode mode = mv::MemoryMappedFile::Mode::CopyOnWrite, const PointData::StorageLayout storageLayout = PointData::StorageLayout::RowMajor)
     {
         const auto notifyDimensionsChanged = numDimensions != getRawData<PointData>().getNumDimensions();
 
-        getRawData<PointData>().setData(std::move(data), numDimensions);
+        getRawData<PointData>().setMemoryMappedData<T>(filePath, numPoints, numDimensions, offset, mode, storageLayout);
 
         if (notifyDimensionsChanged)
             mv::events().notifyDatasetDataDimensionsChanged(this);
     }
 
+    /// Returns whether the data is held by a memory mapped file region
+    bool isMemoryMapped() const
+    {
+        return !isProxy() && getRawData<PointData>().isMemoryMapped();
+    }
+
+    /// Just calls the corresponding member function of its PointData.
+    PointData::StorageLayout getStorageLayout() const
+    {
+        return getRawData<PointData>().getStorageLayout();
+    }
+
+    /// Just calls the corresponding member function of its PointData.
+    void setStorageLayout(const PointData::StorageLayout storageLayout)
+    {
+        getRawData<PointData>().setStorageLayout(storageLayout);
+    }
+
     void extractDataForDimension(std::vector<float>& result, const int dimensionIndex) const;
 
     void extractDataForDimensions(std::vector<mv::Vector2f>& result, const int dimensionIndex1, const int dimensionIndex2) const;
 
+    /// Computes the mean value of each dimension over the points at the specified indices (local
+    /// to this set, like the indices of visitData), for example the mean image of the selected
+    /// frames of an image sequence.
+    void computeMeanPerDimension(std::vector<float>& means, const std::vector<std::uint32_t>& indices) const;
+
+    /// Returns the range, mean and histogram of the values of a dimension (over the points of
+    /// this set). The statistics are cached per dimension and number of bins until a data change
+    /// of the dataset is notified, so color map ranges and histograms are lookups after the first call.
+    mv::util::ScalarStatistics getDimensionStatistics(const std::uint32_t dimensionIndex, const std::uint32_t numberOfBins = mv::util::ADAPTIVE_NUMBER_OF_BINS) const;
+
+    /// Computes the mean, standard deviation and median of each dimension, per cluster of points of
+    /// this set, straight from the raw data and in parallel (see ClusterStatistics.h). The cluster
+    /// indices (and labels) are local to this set, like the indices of visitData. Not supported for
+    /// proxy datasets.
+    /// \param labels Cluster label per point (mv::NO_CLUSTER_LABEL for unclustered points, missing labels at the end are unclustered too), or empty when clusters overlap
+    /// \param offsets Offset of each cluster in the cluster indices, followed by the total number of cluster indices
+    /// \param clusterIndices Indices of the points of all clusters, back-to-back
+    /// \param computeMedians Whether to compute the (exact) medians as well
+    /// \param statistics Statistics per cluster and dimension (output)
+    /// \param abortRequested Stops the computation (at the next block or cluster) when set
+    /// \return Whether the computation completed (not aborted)
+    bool computeClusterStatistics(const std::vector<std::uint32_t>& labels, const std::vector<std::size_t>& offsets, const std::vector<std::uint32_t>& clusterIndices, const bool computeMedians,
+        mv::ClusterStatistics& statistics, const std::atomic<bool>& abortRequested) const;
+
     /// Populates the specified result container with the data for the
     /// dimensions specified by the dimension indices.
     /// \note This function does not do any allocation. It assumes that the
@@ -922,9 +1243,25 @@ public:
      * @param guiName Name of the subset in the GUI
      * @param parentDataSet Smart pointer to parent dataset in the data hierarchy (default is below the set)
      * @param visible Whether the subset will be visible in the UI
+     * @param materialize Whether to copy the data of the subset into a new (full) points dataset, instead of creating a subset that indexes into this data (ignored for proxy datasets)
      * @return Smart pointer to the created subset
      */
-    mv::Dataset<mv::DatasetImpl> createSubsetFromVisibleSelection(const QString& guiName, const mv::Dataset<mv::DatasetImpl>& parentDataSet = mv::Dataset<mv::DatasetImpl>(), const bool& visible = true) const;
+    mv::Dataset<mv::DatasetImpl> createSubsetFromVisibleSelection(const QString& guiName, const mv::Dataset<mv::DatasetImpl>& parentDataSet = mv::Dataset<mv::DatasetImpl>(), const bool& visible = true, const bool& materialize = false) const;
+
+private:
+
+    /**
+     * Create a full points dataset with a contiguous (row-major) copy of the points at \p rawDataIndices,
+     * so that downstream analysis does not need to go through the indices of a subset
+     * @param rawDataIndices Indices of the points in the raw data
+     * @param guiName Name of the dataset in the GUI
+     * @param parentDataSet Smart pointer to parent dataset in the data hierarchy
+     * @param visible Whether the dataset will be visible in the UI
+     * @return Smart pointer to the created dataset
+     */
+    mv::Dataset<mv::DatasetImpl> createMaterializedSubset(const std::vector<std::uint32_t>& rawDataIndices, const QString& guiName, const mv::Dataset<mv::DatasetImpl>& parentDataSet, const bool& visible) const;
+
+public:
 
     /**
      * Get set icon
@@ -943,10 +1280,21 @@ public: // Index transformation
     /**
      * Get the indices over the original source data that this dataset
      * indexes into through being a subset or derived data or a combination.
+     * The indices composed through the chain of subsets are cached, until the
+     * dataset graph revision of the data manager or the revision of the indices
+     * of one of the subsets in the chain changes.
      * @param globalIndices Resulting vector of global indices into the original raw data
      */
     void getGlobalIndices(std::vector<unsigned int>& globalIndices) const;
 
+    /**
+     * Get the revision of the global indices, which is unique among all points datasets and changes
+     * whenever the global indices of this dataset are composed anew (see getGlobalIndices()), so that
+     * data derived from the global indices can be cached until it changes.
+     * @return Revision of the global indices
+     */
+    std::uint64_t getGlobalIndicesRevision() const;
+
     /**
      * Passing a vector of global selection indices, returns a vector of booleans
      * describing which indices of this dataset are selected. A locally selected
@@ -956,6 +1304,11 @@ public: // Index transformation
      */
     void selectedLocalIndices(const std::vector<unsigned int>& selectionIndices, std::vector<bool>& selected) const;
 
+    /**
+     * Get the indices of the points of this dataset that are selected.
+     * The global selection is translated to local indices by a parallel (prefix sum based) compaction.
+     * @param localSelectionIndices Resulting vector of locally selected point indices
+     */
     void getLocalSelectionIndices(std::vector<unsigned int>& localSelectionIndices) const;
 
 
@@ -1024,12 +1377,42 @@ public: // Linked data
 
 public:
 
-    std::vector<unsigned int> indices;
+    mv::SubsetIndices indices;
 
     InfoAction*                 _infoAction;                    /** Non-owning pointer to info action */
     mv::gui::GroupAction*     _dimensionsPickerGroupAction;   /** Group action for dimensions picker action */
     DimensionsPickerAction*     _dimensionsPickerAction;        /** Non-owning pointer to dimensions picker action */
     mv::EventListener         _eventListener;                 /** Listen to HDPS events */
+
+private:
+
+    /** Global indices composed through a chain of subsets, with the state of the chain they were composed from */
+    struct GlobalIndicesCache
+    {
+        std::uint64_t               _revision;                  /** Revision of the composed global indices (unique among all points datasets) */
+        std::uint64_t               _datasetGraphRevision;      /** Dataset graph revision at the time of composition */
+        std::vector<std::uint64_t>  _subsetRevisions;           /** Revision of the indices of each subset in the chain (empty when there is no chain) */
+        std::vector<unsigned int>   _globalIndices;             /** Composed global indices */
+    };
+
+    /**
+     * Get the cached global indices, composes them anew when the chain of subsets changed
+     * @return Up-to-date cache
+     */
+    std::shared_ptr<const GlobalIndicesCache> getGlobalIndicesCache() const;
+
+    /** Statistics per dimension and number of histogram bins, with the state of the data they were computed for */
+    struct DimensionStatisticsCache
+    {
+        std::uint64_t                                                               _dataGeneration = 0;        /** Data generation at the time of computation */
+        std::uint32_t                                                               _numberOfPoints = 0;        /** Number of points at the time of computation */
+        std::uint32_t                                                               _numberOfDimensions = 0;    /** Number of dimensions at the time of computation */
+        std::map<std::pair<std::uint32_t, std::uint32_t>, mv::util::ScalarStatistics> _statistics;               /** Statistics keyed by dimension index and number of bins */
+    };
+
+    mutable std::shared_ptr<const GlobalIndicesCache>   _globalIndicesCache;            /** Cached global indices (accessed atomically) */
+    mutable std::mutex                                  _dimensionStatisticsMutex;      /** Guards the dimension statistics cache */
+    mutable DimensionStatisticsCache                    _dimensionStatisticsCache;      /** Cached dimension statistics */
 };
 
 // =============================================================================
@@ -0,0 +1,427 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "PointDataConversion.h"
+
+#include <biovault_bfloat16/biovault_bfloat16.h>
+
+#include <algorithm> // For copy_n and min.
+#include <array>
+#include <atomic>
+#include <type_traits> // For is_same_v.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MV_CONVERSION_X86_64
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h> // For __cpuid and _xgetbv.
+#endif
+#endif
+
+// GCC and Clang only allow AVX2 and AVX-512 intrinsics in functions that are compiled for those
+// instruction sets, whereas MSVC allows them anywhere.
+#if defined(__GNUC__) || defined(__clang__)
+#define MV_CONVERSION_TARGET_AVX2 __attribute__((target("avx2")))
+#define MV_CONVERSION_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define MV_CONVERSION_TARGET_AVX2
+#define MV_CONVERSION_TARGET_AVX512
+#endif
+
+namespace
+{
+    using mv::ConversionInstructionSet;
+
+    // A bfloat16 holds the upper 16 bits of a float, so it is converted by shifting its bits.
+    static_assert(sizeof(biovault::bfloat16_t) == sizeof(std::uint16_t));
+
+    // Number of elements that the gather functions copy into a local buffer, before converting them.
+    constexpr std::size_t gatherBlockSize{ 256 };
+
+    // Number of columns that accumulateRowsToFloat adds per row, before going to the next row (16 KB of floats).
+    constexpr std::size_t accumulateTileSize{ 4096 };
+
+    ConversionInstructionSet detectInstructionSet()
+    {
+#ifdef MV_CONVERSION_X86_64
+#if defined(_MSC_VER) && !defined(__clang__)
+        int cpuInfo[4]{};
+        __cpuid(cpuInfo, 0);
+
+        if (cpuInfo[0] >= 7)
+        {
+            __cpuid(cpuInfo, 1);
+
+            // AVX state is only usable when the operating system saves the YMM (and ZMM) registers.
+            const bool osxsave = (cpuInfo[2] & (1 << 27)) != 0;
+            const auto xcr0 = osxsave ? _xgetbv(0) : 0;
+
+            int extendedFeatures[4]{};
+            __cpuidex(extendedFeatures, 7, 0);
+
+            if (((xcr0 & 0xE6) == 0xE6) && ((extendedFeatures[1] & (1 << 16)) != 0))
+                return ConversionInstructionSet::AVX512;
+
+            if (((xcr0 & 0x6) == 0x6) && ((extendedFeatures[1] & (1 << 5)) != 0))
+                return ConversionInstructionSet::AVX2;
+        }
+#else
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f"))
+            return ConversionInstructionSet::AVX512;
+
+        if (__builtin_cpu_supports("avx2"))
+            return ConversionInstructionSet::AVX2;
+#endif
+        // SSE2 is part of the x86-64 baseline.
+        return ConversionInstructionSet::SSE2;
+#else
+        return ConversionInstructionSet::Scalar;
+#endif
+    }
+
+    const ConversionInstructionSet supportedInstructionSet = detectInstructionSet();
+
+    std::atomic<ConversionInstructionSet> currentInstructionSet{ supportedInstructionSet };
+
+    template <typename T>
+    void convertScalar(const T* const source, const std::size_t count, float* const target)
+    {
+        for (std::size_t i{}; i < count; ++i)
+        {
+            target[i] = static_cast<float>(source[i]);
+        }
+    }
+
+#ifdef MV_CONVERSION_X86_64
+
+    template <typename T>
+    void convertSSE2(const T* const source, const std::size_t count, float* const target)
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        std::size_t i{};
+
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i low{};
+            __m128i high{};
+
+            if constexpr (sizeof(T) == 2)
+            {
+                const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+                if constexpr (std::is_same_v<T, biovault::bfloat16_t>)
+                {
+                    // Placing the bits in the upper half of each 32-bit lane yields the float.
+                    low = _mm_unpacklo_epi16(zero, values);
+                    high = _mm_unpackhi_epi16(zero, values);
+                }
+                else if constexpr (std::is_same_v<T, std::int16_t>)
+                {
+                    low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+                    high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+                }
+                else
+                {
+                    low = _mm_unpacklo_epi16(values, zero);
+                    high = _mm_unpackhi_epi16(values, zero);
+                }
+            }
+            else
+            {
+                const __m128i values = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i));
+
+                if constexpr (std::is_same_v<T, std::int8_t>)
+                {
+                    const __m128i words = _mm_unpacklo_epi8(values, values);
+                    low = _mm_srai_epi32(_mm_unpacklo_epi16(words, words), 24);
+                    high = _mm_srai_epi32(_mm_unpackhi_epi16(words, words), 24);
+                }
+                else
+                {
+                    const __m128i words = _mm_unpacklo_epi8(values, zero);
+                    low = _mm_unpacklo_epi16(words, zero);
+                    high = _mm_unpackhi_epi16(words, zero);
+                }
+            }
+
+            if constexpr (std::is_same_v<T, biovault::bfloat16_t>)
+            {
+                _mm_storeu_ps(target + i, _mm_castsi128_ps(low));
+                _mm_storeu_ps(target + i + 4, _mm_castsi128_ps(high));
+            }
+            else
+            {
+                _mm_storeu_ps(target + i, _mm_cvtepi32_ps(low));
+                _mm_storeu_ps(target + i + 4, _mm_cvtepi32_ps(high));
+            }
+        }
+        convertScalar(source + i, count - i, target + i);
+    }
+
+    template <typename T>
+    MV_CONVERSION_TARGET_AVX2 void convertAVX2(const T* const source, const std::size_t count, float* const target)
+    {
+        std::size_t i{};
+
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i values{};
+
+            if constexpr (sizeof(T) == 2)
+            {
+                const __m128i elements = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+                if constexpr (std::is_same_v<T, std::int16_t>)
+                    values = _mm256_cvtepi16_epi32(elements);
+                else
+                    values = _mm256_cvtepu16_epi32(elements);
+            }
+            else
+            {
+                const __m128i elements = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i));
+
+                if constexpr (std::is_same_v<T, std::int8_t>)
+                    values = _mm256_cvtepi8_epi32(elements);
+                else
+                    values = _mm256_cvtepu8_epi32(elements);
+            }
+
+            if constexpr (std::is_same_v<T, biovault::bfloat16_t>)
+                _mm256_storeu_ps(target + i, _mm256_castsi256_ps(_mm256_slli_epi32(values, 16)));
+            else
+                _mm256_storeu_ps(target + i, _mm256_cvtepi32_ps(values));
+        }
+        convertScalar(source + i, count - i, target + i);
+    }
+
+    template <typename T>
+    MV_CONVERSION_TARGET_AVX512 void convertAVX512(const T* const source, const std::size_t count, float* const target)
+    {
+        std::size_t i{};
+
+        for (; i + 16 <= count; i += 16)
+        {
+            __m512i values{};
+
+            if constexpr (sizeof(T) == 2)
+            {
+                const __m256i elements = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+
+                if constexpr (std::is_same_v<T, std::int16_t>)
+                    values = _mm512_cvtepi16_epi32(elements);
+                else
+                    values = _mm512_cvtepu16_epi32(elements);
+            }
+            else
+            {
+                const __m128i elements = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+                if constexpr (std::is_same_v<T, std::int8_t>)
+                    values = _mm512_cvtepi8_epi32(elements);
+                else
+                    values = _mm512_cvtepu8_epi32(elements);
+            }
+
+            if constexpr (std::is_same_v<T, biovault::bfloat16_t>)
+                _mm512_storeu_ps(target + i, _mm512_castsi512_ps(_mm512_slli_epi32(values, 16)));
+            else
+                _mm512_storeu_ps(target + i, _mm512_cvtepi32_ps(values));
+        }
+        convertScalar(source + i, count - i, target + i);
+    }
+
+#endif
+
+    /// Gathers the elements in blocks, each of which is copied into a local buffer by the specified
+    /// function, and then converted by a (vectorized) contiguous conversion.
+    template <typename T, typename CopyFunction>
+    void gatherInBlocks(const std::size_t count, const std::size_t elementsPerItem, float* const target, CopyFunction copyFunction)
+    {
+        std::array<T, gatherBlockSize> buffer;
+
+        const std::size_t itemsPerBlock = gatherBlockSize / elementsPerItem;
+
+        for (std::size_t first{}; first < count; first += itemsPerBlock)
+        {
+            const auto numberOfItems = std::min(itemsPerBlock, count - first);
+
+            copyFunction(first, numberOfItems, buffer.data());
+            mv::convertElementsToFloat(buffer.data(), numberOfItems * elementsPerItem, target + first * elementsPerItem);
+        }
+    }
+}
+
+
+namespace mv
+{
+    ConversionInstructionSet getSupportedConversionInstructionSet()
+    {
+        return supportedInstructionSet;
+    }
+
+    ConversionInstructionSet getConversionInstructionSet()
+    {
+        return currentInstructionSet;
+    }
+
+    void setConversionInstructionSet(const ConversionInstructionSet instructionSet)
+    {
+        currentInstructionSet = std::min(instructionSet, supportedInstructionSet);
+    }
+
+    const char* getConversionInstructionSetName(const ConversionInstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+        case ConversionInstructionSet::SSE2: return "SSE2";
+        case ConversionInstructionSet::AVX2: return "AVX2";
+        case ConversionInstructionSet::AVX512: return "AVX-512";
+        default: return "Scalar";
+        }
+    }
+
+    template <typename T>
+    void convertElementsToFloat(const T* const source, const std::size_t count, float* const target)
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            std::copy_n(source, count, target);
+        }
+        else
+        {
+#ifdef MV_CONVERSION_X86_64
+            switch (currentInstructionSet.load(std::memory_order_relaxed))
+            {
+            case ConversionInstructionSet::AVX512: return convertAVX512(source, count, target);
+            case ConversionInstructionSet::AVX2: return convertAVX2(source, count, target);
+            case ConversionInstructionSet::SSE2: return convertSSE2(source, count, target);
+            default: break;
+            }
+#endif
+            convertScalar(source, count, target);
+        }
+    }
+
+    template <typename T>
+    void gatherElementsToFloat(const T* const source, const std::size_t stride, const std::size_t count, float* const target)
+    {
+        if (stride == 1)
+        {
+            convertElementsToFloat(source, count, target);
+            return;
+        }
+
+        gatherInBlocks<T>(count, 1, target, [source, stride](const std::size_t first, const std::size_t numberOfItems, T* const buffer)
+            {
+                for (std::size_t i{}; i < numberOfItems; ++i)
+                {
+                    buffer[i] = source[(first + i) * stride];
+                }
+            });
+    }
+
+    template <typename T>
+    void gatherElementsToFloat(const T* const source, const std::size_t stride, const unsigned int* const indices, const std::size_t count, float* const target)
+    {
+        gatherInBlocks<T>(count, 1, target, [source, stride, indices](const std::size_t first, const std::size_t numberOfItems, T* const buffer)
+            {
+                for (std::size_t i{}; i < numberOfItems; ++i)
+                {
+                    buffer[i] = source[indices[first + i] * stride];
+                }
+            });
+    }
+
+    template <typename T>
+    void gatherElementPairsToFloat(const T* const source1, const T* const source2, const std::size_t stride, const std::size_t count, float* const target)
+    {
+        gatherInBlocks<T>(count, 2, target, [source1, source2, stride](const std::size_t first, const std::size_t numberOfItems, T* const buffer)
+            {
+                for (std::size_t i{}; i < numberOfItems; ++i)
+                {
+                    const auto sourceIndex = (first + i) * stride;
+                    buffer[2 * i] = source1[sourceIndex];
+                    buffer[2 * i + 1] = source2[sourceIndex];
+                }
+            });
+    }
+
+    template <typename T>
+    void gatherElementPairsToFloat(const T* const source1, const T* const source2, const std::size_t stride, const unsigned int* const indices, const std::size_t count, float* const target)
+    {
+        gatherInBlocks<T>(count, 2, target, [source1, source2, stride, indices](const std::size_t first, const std::size_t numberOfItems, T* const buffer)
+            {
+                for (std::size_t i{}; i < numberOfItems; ++i)
+                {
+                    const auto sourceIndex = indices[first + i] * stride;
+                    buffer[2 * i] = source1[sourceIndex];
+                    buffer[2 * i + 1] = source2[sourceIndex];
+                }
+            });
+    }
+
+    template <typename T>
+    void accumulateElementsToFloat(const T* const source, const std::size_t count, float* const target)
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            for (std::size_t i{}; i < count; ++i)
+            {
+                target[i] += source[i];
+            }
+        }
+        else
+        {
+            // Convert a block at a time (vectorized), and then add it.
+            std::array<float, gatherBlockSize> buffer;
+
+            for (std::size_t first{}; first < count; first += gatherBlockSize)
+            {
+                const auto numberOfElements = std::min(gatherBlockSize, count - first);
+
+                convertElementsToFloat(source + first, numberOfElements, buffer.data());
+
+                for (std::size_t i{}; i < numberOfElements; ++i)
+                {
+                    target[first + i] += buffer[i];
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    void accumulateRowsToFloat(const T* const source, const std::size_t stride, const unsigned int* const indices, const std::size_t numberOfRows, const std::size_t count, float* const target)
+    {
+        for (std::size_t firstColumn{}; firstColumn < count; firstColumn += accumulateTileSize)
+        {
+            const auto numberOfColumns = std::min(accumulateTileSize, count - firstColumn);
+
+            for (std::size_t i{}; i < numberOfRows; ++i)
+            {
+                accumulateElementsToFloat(source + indices[i] * stride + firstColumn, numberOfColumns, target + firstColumn);
+            }
+        }
+    }
+
+#define MV_INSTANTIATE_CONVERSION_FUNCTIONS(T) \
+    template POINTDATA_EXPORT void convertElementsToFloat<T>(const T*, std::size_t, float*); \
+    template POINTDATA_EXPORT void gatherElementsToFloat<T>(const T*, std::size_t, std::size_t, float*); \
+    template POINTDATA_EXPORT void gatherElementsToFloat<T>(const T*, std::size_t, const unsigned int*, std::size_t, float*); \
+    template POINTDATA_EXPORT void gatherElementPairsToFloat<T>(const T*, const T*, std::size_t, std::size_t, float*); \
+    template POINTDATA_EXPORT void gatherElementPairsToFloat<T>(const T*, const T*, std::size_t, const unsigned int*, std::size_t, float*); \
+    template POINTDATA_EXPORT void accumulateElementsToFloat<T>(const T*, std::size_t, float*); \
+    template POINTDATA_EXPORT void accumulateRowsToFloat<T>(const T*, std::size_t, const unsigned int*, std::size_t, std::size_t, float*);
+
+    MV_INSTANTIATE_CONVERSION_FUNCTIONS(float)
+    MV_INSTANTIATE_CONVERSION_FUNCTIONS(biovault::bfloat16_t)
+    MV_INSTANTIATE_CONVERSION_FUNCTIONS(std::int16_t)
+    MV_INSTANTIATE_CONVERSION_FUNCTIONS(std::uint16_t)
+    MV_INSTANTIATE_CONVERSION_FUNCTIONS(std::int8_t)
+    MV_INSTANTIATE_CONVERSION_FUNCTIONS(std::uint8_t)
+
+#undef MV_INSTANTIATE_CONVERSION_FUNCTIONS
+}
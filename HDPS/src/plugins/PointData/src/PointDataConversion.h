@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#ifndef HDPS_POINTDATACONVERSION_H
+#define HDPS_POINTDATACONVERSION_H
+
+#include "pointdata_export.h"
+
+#include <cstddef> // For size_t
+#include <cstdint>
+
+/* Kernels that convert point data elements (of any of the supported element
+types) to float, while extracting or accumulating them from the point data buffer. They are
+vectorized for SSE2, AVX2 and AVX-512, and select the fastest instruction set
+supported by the CPU at runtime. Other CPUs use a scalar fallback.
+
+The kernels are implemented for float, biovault::bfloat16_t, std::int16_t,
+std::uint16_t, std::int8_t and std::uint8_t.
+*/
+
+namespace mv
+{
+    /// Instruction sets that the conversion kernels may use.
+    enum class ConversionInstructionSet
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    /// Returns the most advanced instruction set that is supported by both the CPU and the kernels.
+    POINTDATA_EXPORT ConversionInstructionSet getSupportedConversionInstructionSet();
+
+    /// Returns the instruction set that is currently used by the kernels.
+    POINTDATA_EXPORT ConversionInstructionSet getConversionInstructionSet();
+
+    /// Lets the kernels use the specified instruction set, or the supported one, when the specified
+    /// one is not supported. Intended for testing and benchmarking: by default, the kernels use the
+    /// supported instruction set.
+    POINTDATA_EXPORT void setConversionInstructionSet(ConversionInstructionSet instructionSet);
+
+    /// Returns the name of the specified instruction set, for example "AVX2".
+    POINTDATA_EXPORT const char* getConversionInstructionSetName(ConversionInstructionSet instructionSet);
+
+    /// Converts the specified number of contiguous elements: target[i] = source[i].
+    template <typename T>
+    POINTDATA_EXPORT void convertElementsToFloat(const T* source, std::size_t count, float* target);
+
+    /// Converts the elements at the specified stride: target[i] = source[i * stride].
+    template <typename T>
+    POINTDATA_EXPORT void gatherElementsToFloat(const T* source, std::size_t stride, std::size_t count, float* target);
+
+    /// Converts the elements at the specified indices: target[i] = source[indices[i] * stride].
+    template <typename T>
+    POINTDATA_EXPORT void gatherElementsToFloat(const T* source, std::size_t stride, const unsigned int* indices, std::size_t count, float* target);
+
+    /// Converts pairs of elements, and stores them interleaved:
+    /// target[2 * i] = source1[i * stride] and target[2 * i + 1] = source2[i * stride].
+    template <typename T>
+    POINTDATA_EXPORT void gatherElementPairsToFloat(const T* source1, const T* source2, std::size_t stride, std::size_t count, float* target);
+
+    /// Converts pairs of elements at the specified indices, and stores them interleaved:
+    /// target[2 * i] = source1[indices[i] * stride] and target[2 * i + 1] = source2[indices[i] * stride].
+    template <typename T>
+    POINTDATA_EXPORT void gatherElementPairsToFloat(const T* source1, const T* source2, std::size_t stride, const unsigned int* indices, std::size_t count, float* target);
+
+    /// Adds the specified number of contiguous elements: target[i] += source[i].
+    template <typename T>
+    POINTDATA_EXPORT void accumulateElementsToFloat(const T* source, std::size_t count, float* target);
+
+    /// Adds the first count elements of the rows at the specified indices, in the order of the indices:
+    /// target[j] += source[indices[i] * stride + j], for i < numberOfRows and j < count.
+    /// The rows are processed in tiles of columns, so that the target tile stays in the cache while
+    /// each row is read contiguously.
+    template <typename T>
+    POINTDATA_EXPORT void accumulateRowsToFloat(const T* source, std::size_t stride, const unsigned int* indices, std::size_t numberOfRows, std::size_t count, float* target);
+}
+
+#endif // HDPS_POINTDATACONVERSION_H
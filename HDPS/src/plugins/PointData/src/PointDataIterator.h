@@ -8,6 +8,7 @@
 #include <iterator>
 
 #include "PointView.h"
+#include "StridedIterator.h"
 
 namespace mv
 {
@@ -54,7 +55,7 @@ namespace mv
         auto operator*() const
         {
             const auto index = _indexFunction(_indexIterator);
-            const auto begin = _valueIterator + (index * _numberOfDimensions);
+            const auto begin = getBeginOfPoint(_valueIterator, index, _numberOfDimensions);
             const auto end = begin + _numberOfDimensions;
             return PointViewType(begin, end, index);
         }
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#ifndef HDPS_POINTDATASPAN_H
+#define HDPS_POINTDATASPAN_H
+
+#include <cstddef> // For size_t
+#include <cassert>
+#include <type_traits> // For remove_cv_t
+
+namespace mv
+{
+    /* Non-owning view of a contiguous sequence of point data elements, for
+    example a memory mapped region of a file. Supports the subset of the
+    std::vector interface that is needed to read (and possibly write) the
+    elements, so that it can be visited just like the std::vector that
+    normally holds the point data.
+    */
+    template <typename T>
+    class PointDataSpan
+    {
+    public:
+        using value_type = std::remove_cv_t<T>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        PointDataSpan() = default;
+
+        PointDataSpan(T* const data, const std::size_t size)
+            :
+            _data{ data },
+            _size{ size }
+        {
+            assert((data != nullptr) || (size == 0));
+        }
+
+        T* data() const
+        {
+            return _data;
+        }
+
+        std::size_t size() const
+        {
+            return _size;
+        }
+
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        iterator begin() const
+        {
+            return _data;
+        }
+
+        iterator end() const
+        {
+            return _data + _size;
+        }
+
+        const_iterator cbegin() const
+        {
+            return _data;
+        }
+
+        const_iterator cend() const
+        {
+            return _data + _size;
+        }
+
+        T& operator[](const std::size_t i) const
+        {
+            assert(i < _size);
+            return _data[i];
+        }
+
+    private:
+        T* _data{};
+        std::size_t _size{};
+    };
+}
+
+#endif // HDPS_POINTDATASPAN_H
@@ -0,0 +1,228 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#ifndef HDPS_STRIDEDITERATOR_H
+#define HDPS_STRIDEDITERATOR_H
+
+#include <cstddef> // For ptrdiff_t and size_t
+#include <iterator>
+
+namespace mv
+{
+    /* Random access iterator over the values of a single point of column-major data,
+    * which are a fixed number of elements (the number of points) apart. Allows a
+    * PointView to iterate over the values of a point, without rearranging the data.
+    * \note The iterator keeps the position of the value separately from the value
+    * iterator, so that it never points beyond the end of the data buffer.
+    */
+    template <typename ValueIteratorType>
+    class StridedIterator
+    {
+        // Its data members:
+        ValueIteratorType _valueIterator{};
+        std::ptrdiff_t _stride{ 1 };
+        std::ptrdiff_t _position{};
+
+    public:
+        // Types conforming the iterator requirements of the C++ standard library:
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename std::iterator_traits<ValueIteratorType>::value_type;
+        using reference = typename std::iterator_traits<ValueIteratorType>::reference;
+        using pointer = typename std::iterator_traits<ValueIteratorType>::pointer;
+        using iterator_category = std::random_access_iterator_tag;
+
+
+        /* Explicitly defaulted default-constructor
+        */
+        StridedIterator() = default;
+
+
+        StridedIterator(
+            const ValueIteratorType valueIterator,
+            const std::ptrdiff_t stride,
+            const std::ptrdiff_t position = 0)
+            :
+            _valueIterator{ valueIterator },
+            _stride{ stride },
+            _position{ position }
+        {
+        }
+
+
+        /** Returns a reference to the current value.
+        */
+        reference operator*() const
+        {
+            return _valueIterator[_position * _stride];
+        }
+
+
+        /** Returns a reference to the value, n positions from the current one.
+        */
+        reference operator[](const difference_type n) const
+        {
+            return _valueIterator[(_position + n) * _stride];
+        }
+
+
+        /** Prefix increment ('++it').
+        */
+        auto& operator++()
+        {
+            ++_position;
+            return *this;
+        }
+
+
+        /** Postfix increment ('it++').
+         * \note Usually prefix increment ('++it') is preferable.
+         */
+        auto operator++(int)
+        {
+            auto result = *this;
+            ++(*this);
+            return result;
+        }
+
+
+        /** Prefix decrement ('--it').
+        */
+        auto& operator--()
+        {
+            --_position;
+            return *this;
+        }
+
+
+        /** Postfix decrement ('it--').
+         * \note Usually prefix decrement ('--it') is preferable.
+         */
+        auto operator--(int)
+        {
+            auto result = *this;
+            --(*this);
+            return result;
+        }
+
+
+        /** Does (it += n) for iterator 'it' and integer value 'n'.
+        */
+        friend auto& operator+=(StridedIterator& it, const difference_type n)
+        {
+            it._position += n;
+            return it;
+        }
+
+
+        /** Does (it -= n) for iterator 'it' and integer value 'n'.
+        */
+        friend auto& operator-=(StridedIterator& it, const difference_type n)
+        {
+            it._position -= n;
+            return it;
+        }
+
+
+        /** Returns (it1 - it2) for iterators it1 and it2.
+        */
+        friend difference_type operator-(const StridedIterator& it1, const StridedIterator& it2)
+        {
+            return it1._position - it2._position;
+        }
+
+
+        /** Returns (it + n) for iterator 'it' and integer value 'n'.
+        */
+        friend auto operator+(StridedIterator it, const difference_type n)
+        {
+            return it += n;
+        }
+
+
+        /** Returns (n + it) for iterator 'it' and integer value 'n'.
+        */
+        friend auto operator+(const difference_type n, StridedIterator it)
+        {
+            return it += n;
+        }
+
+
+        /** Returns (it - n) for iterator 'it' and integer value 'n'.
+        */
+        friend auto operator-(StridedIterator it, const difference_type n)
+        {
+            return it -= n;
+        }
+
+
+        /** Returns (it1 == it2) for iterators it1 and it2.
+        */
+        friend bool operator==(const StridedIterator& it1, const StridedIterator& it2)
+        {
+            return (it1._valueIterator == it2._valueIterator) && (it1._position == it2._position);
+        }
+
+
+        /** Returns (it1 != it2) for iterators it1 and it2.
+        */
+        friend bool operator!=(const StridedIterator& it1, const StridedIterator& it2)
+        {
+            return !(it1 == it2);
+        }
+
+
+        /** Returns (it1 < it2) for iterators it1 and it2.
+        */
+        friend bool operator<(const StridedIterator& it1, const StridedIterator& it2)
+        {
+            return it1._position < it2._position;
+        }
+
+
+        /** Returns (it1 > it2) for iterators it1 and it2.
+        */
+        friend bool operator>(const StridedIterator& it1, const StridedIterator& it2)
+        {
+            return it2 < it1;
+        }
+
+
+        /** Returns (it1 <= it2) for iterators it1 and it2.
+        */
+        friend bool operator<=(const StridedIterator& it1, const StridedIterator& it2)
+        {
+            return !(it2 < it1);
+        }
+
+
+        /** Returns (it1 >= it2) for iterators it1 and it2.
+        */
+        friend bool operator>=(const StridedIterator& it1, const StridedIterator& it2)
+        {
+            return !(it1 < it2);
+        }
+
+
+        /** Returns an iterator to the first value of the point with the specified index,
+        * for an iterator to the first value of the data.
+        */
+        friend StridedIterator getBeginOfPoint(const StridedIterator& it, const std::size_t pointIndex, unsigned)
+        {
+            return StridedIterator(it._valueIterator + static_cast<std::ptrdiff_t>(pointIndex), it._stride);
+        }
+    };
+
+
+    /** Returns an iterator to the first value of the point with the specified index, for an
+    * iterator to the first value of row-major data.
+    */
+    template <typename ValueIteratorType>
+    ValueIteratorType getBeginOfPoint(const ValueIteratorType valueIterator, const std::size_t pointIndex, const unsigned numberOfDimensions)
+    {
+        return valueIterator + (pointIndex * numberOfDimensions);
+    }
+}
+
+
+#endif // HDPS_STRIDEDITERATOR_H
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#ifndef HDPS_SUBSETINDICES_H
+#define HDPS_SUBSETINDICES_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <utility> // For move.
+#include <vector>
+
+namespace mv
+{
+    /* Indices of the points of a subset, into the points of its source dataset. Behaves as
+    * an std::vector, and additionally keeps a revision, which is incremented whenever the
+    * indices are assigned, so that information derived from the indices can be cached.
+    * \note Modifying the indices in place (for example by resize() or data()) does not
+    * increment the revision, so it should be followed by a call to markModified().
+    */
+    class SubsetIndices : public std::vector<unsigned int>
+    {
+    public:
+        using std::vector<unsigned int>::vector;
+
+        SubsetIndices() = default;
+        SubsetIndices(const SubsetIndices&) = default;
+        SubsetIndices(SubsetIndices&&) noexcept = default;
+
+        ~SubsetIndices() = default;
+
+
+        SubsetIndices& operator=(const SubsetIndices& indices)
+        {
+            std::vector<unsigned int>::operator=(indices);
+            markModified();
+            return *this;
+        }
+
+
+        SubsetIndices& operator=(SubsetIndices&& indices) noexcept
+        {
+            std::vector<unsigned int>::operator=(std::move(indices));
+            markModified();
+            return *this;
+        }
+
+
+        SubsetIndices& operator=(const std::vector<unsigned int>& indices)
+        {
+            std::vector<unsigned int>::operator=(indices);
+            markModified();
+            return *this;
+        }
+
+
+        SubsetIndices& operator=(std::vector<unsigned int>&& indices) noexcept
+        {
+            std::vector<unsigned int>::operator=(std::move(indices));
+            markModified();
+            return *this;
+        }
+
+
+        SubsetIndices& operator=(const std::initializer_list<unsigned int> indices)
+        {
+            std::vector<unsigned int>::operator=(indices);
+            markModified();
+            return *this;
+        }
+
+
+        /** Increments the revision, to be called after modifying the indices in place.
+        */
+        void markModified()
+        {
+            ++_revision;
+        }
+
+
+        /** Returns the revision of the indices, which changes whenever the indices are assigned or marked modified.
+        */
+        std::uint64_t getRevision() const
+        {
+            return _revision;
+        }
+
+    private:
+        std::uint64_t _revision{};
+    };
+}
+
+
+#endif // HDPS_SUBSETINDICES_H
@@ -5,12 +5,23 @@
 #include "Archiver.h"
 
 #include <util/Exception.h>
+#include <util/Parallel.h>
 
 #include <stdexcept>
-
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QBuffer>
 #include <QDebug>
 #include <QDir>
 #include <QThread>
+#include <QTemporaryFile>
 
 #include <quazip/JlCompress.h>
 
@@ -18,6 +29,90 @@ namespace mv {
 
 namespace util {
 
+namespace {
+
+/** Files are split into chunks of this size, which are deflated concurrently */
+constexpr qint64 compressionChunkSize = 16 * 1024 * 1024;
+
+/** Maximum number of uncompressed bytes that are deflated at once, it bounds the transient memory of the chunks and their deflated data regardless of the number of threads */
+constexpr qint64 maximumCompressionBatchSize = 256 * 1024 * 1024;
+
+/** Raw deflate data of a chunk of a file */
+struct DeflatedChunk
+{
+    QByteArray      _data;              /** Raw deflate data */
+    uLong           _crc;               /** CRC-32 of the uncompressed chunk */
+    qint64          _uncompressedSize;  /** Number of uncompressed bytes */
+    bool            _last;              /** Whether this is the last chunk of the file */
+};
+
+/**
+ * Deflates \p chunk as a raw deflate stream that can be concatenated with the streams of the subsequent chunks: all but
+ * the last chunk end with a sync flush (byte aligned, without final block) and the last chunk finishes the stream
+ * @param chunk Uncompressed chunk
+ * @param compressionLevel Compression level
+ * @param last Whether this is the last chunk of the file
+ * @return Deflated chunk
+ */
+DeflatedChunk deflateChunk(const QByteArray& chunk, std::int32_t compressionLevel, bool last)
+{
+    z_stream stream{};
+
+    if (deflateInit2(&stream, compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::runtime_error("Unable to initialize deflate stream");
+
+    DeflatedChunk deflatedChunk;
+
+    // Reserve room for the flush marker as well
+    deflatedChunk._data.resize(static_cast<qsizetype>(deflateBound(&stream, static_cast<uLong>(chunk.size())) + 64));
+
+    stream.next_in      = reinterpret_cast<Bytef*>(const_cast<char*>(chunk.constData()));
+    stream.avail_in     = static_cast<uInt>(chunk.size());
+    stream.next_out     = reinterpret_cast<Bytef*>(deflatedChunk._data.data());
+    stream.avail_out    = static_cast<uInt>(deflatedChunk._data.size());
+
+    const auto result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+
+    deflatedChunk._data.resize(static_cast<qsizetype>(stream.total_out));
+
+    deflateEnd(&stream);
+
+    if (result != (last ? Z_STREAM_END : Z_OK) || stream.avail_in != 0)
+        throw std::runtime_error("Unable to deflate chunk");
+
+    deflatedChunk._crc              = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(chunk.constData()), static_cast<uInt>(chunk.size()));
+    deflatedChunk._uncompressedSize = chunk.size();
+    deflatedChunk._last             = last;
+
+    return deflatedChunk;
+}
+
+/**
+ * Reads a chunk of a file and deflates it (see deflateChunk()), so that both happen on the calling (worker) thread
+ * @param sourceFilePath Path of the source file
+ * @param offset Offset of the chunk in the file
+ * @param size Number of bytes of the chunk
+ * @param compressionLevel Compression level
+ * @param last Whether this is the last chunk of the file
+ * @return Deflated chunk
+ */
+DeflatedChunk readAndDeflateChunk(const QString& sourceFilePath, qint64 offset, qint64 size, std::int32_t compressionLevel, bool last)
+{
+    QFile inFile(sourceFilePath);
+
+    if (!inFile.open(QIODevice::ReadOnly) || !inFile.seek(offset))
+        throw std::runtime_error("Unable to open input file");
+
+    const auto chunk = inFile.read(size);
+
+    if (chunk.size() != size)
+        throw std::runtime_error("Unable to read input file");
+
+    return deflateChunk(chunk, compressionLevel, last);
+}
+
+}
+
 void Archiver::compressDirectory(const QString& sourceDirectory, const QString& compressedFilePath, bool recursive /*= true*/, std::int32_t compressionLevel /*= 0*/, const QString& password /*= ""*/, QDir::Filters filters /*= QDir::Filter::Files*/)
 {
     // Clean up and throw exception if error(s) occurred
@@ -44,8 +139,17 @@ void Archiver::compressDirectory(const QString& sourceDirectory, const QString&
     if (zip.getZipError() != 0)
         except("Zip error(s) occurred");
 
-    // Compress the sub directory
-    Archiver::compressSubDirectory(&zip, sourceDirectory, sourceDirectory, recursive, compressionLevel, password, filters);
+    // Compress the directories and files in the sub directory
+    QVector<ArchiveEntry> entries;
+
+    collectEntries(sourceDirectory, sourceDirectory, recursive, filters, entries);
+
+    // Do not compress the destination file itself
+    entries.removeIf([&zip](const ArchiveEntry& entry) -> bool {
+        return entry._sourceFilePath == zip.getZipName();
+    });
+
+    compressEntries(&zip, entries, compressionLevel, password);
 
     // Notify others that directory compression started
     emit taskStarted("Save to disk");
@@ -86,6 +190,28 @@ void Archiver::decompress(const QString& compressedFile, const QString& destinat
         if (!zip.goToFirstFile())
             throw std::runtime_error("No files found");
 
+        if (_numberOfThreads > 1) {
+            QVector<QPair<QString, QString>> entries;
+
+            do {
+                const auto currentFileName      = zip.getCurrentFileName();
+                const auto absoluteFilePath     = directory.absoluteFilePath(currentFileName);
+                const auto absoluteCleanPath    = QDir::cleanPath(absoluteFilePath);
+
+                if (absoluteCleanPath.startsWith(absoluteCleanDir))
+                    entries.push_back({ currentFileName, absoluteFilePath });
+            } while (zip.goToNextFile());
+
+            zip.close();
+
+            if (zip.getZipError() != 0)
+                throw std::runtime_error("Decompression error occurred");
+
+            decompressInParallel(compressedFile, entries, password, extracted);
+
+            return;
+        }
+
         do {
             const auto currentFileName      = zip.getCurrentFileName();
             const auto absoluteFilePath     = directory.absoluteFilePath(currentFileName);
@@ -181,70 +307,213 @@ void Archiver::extractSingleFile(const QString& compressedFilePath, const QStrin
         throw std::runtime_error("Decompression error occurred");
 }
 
-void Archiver::compressSubDirectory(QuaZip* parentZip, const QString& directory, const QString& parentDirectory, bool recursive /*= true*/, std::int32_t compressionLevel /*= 0*/, const QString& password /*= ""*/, QDir::Filters filters /*= QDir::Filter::Files*/)
+void Archiver::collectEntries(const QString& directory, const QString& parentDirectory, bool recursive, QDir::Filters filters, QVector<ArchiveEntry>& entries)
 {
-    // Except if the parent zip is invalid
-    if (!parentZip)
-        throw std::runtime_error("Invalid parent zip file");
-
-    // Except if the parent zip mode is invalid
-    if (parentZip->getMode() != QuaZip::mdCreate && parentZip->getMode() != QuaZip::mdAppend && parentZip->getMode() != QuaZip::mdAdd)
-        throw std::runtime_error("Invalid parent zip mode");
-
     // Except if the directory does not exist
     if (!QDir(directory).exists())
         throw std::runtime_error("Directory does not exist");
 
     QDir origDirectory(parentDirectory);
 
-    if (directory != parentDirectory) {
-
-        // Create directory zip file
-        QuaZipFile dirZipFile(parentZip);
-
-        std::int32_t method = Z_DEFLATED, level = 0;
-
-        // Attempt to open the directory zip file
-        if (!dirZipFile.open(QIODevice::WriteOnly, QuaZipNewInfo(origDirectory.relativeFilePath(directory) + QLatin1String("/"), directory), password.isEmpty() ? nullptr : password.toLatin1(), 0U, Z_DEFLATED, compressionLevel, compressionLevel == -1))
-            throw std::runtime_error("Unable to open directory zip file");
+    if (directory != parentDirectory)
+        entries.push_back({ directory, origDirectory.relativeFilePath(directory) + QLatin1String("/"), 0, true, false });
 
-        // Close the directory zip file
-        dirZipFile.close();
-    }
-
-    // Compress sub directories if needed
+    // Collect sub directories if needed
     if (recursive) {
 
         // Get a list of sub directories to compress
         QFileInfoList files = QDir(directory).entryInfoList(QDir::AllDirs | QDir::NoDotAndDotDot | filters);
 
-        // Compress all sub directories
+        // Collect all sub directories
         for (const auto file : files) {
 
             // Continue if not a directory
             if (!file.isDir())
                 continue;
 
-            // Compress sub directory
-            compressSubDirectory(parentZip, file.absoluteFilePath(), parentDirectory, recursive, compressionLevel, password, filters);
+            // Collect sub directory
+            collectEntries(file.absoluteFilePath(), parentDirectory, recursive, filters, entries);
         }
     }
 
     // Get a list of files to compress
     QFileInfoList files = QDir(directory).entryInfoList(QDir::Files | filters);
 
-    // Compress all files
+    // Collect all files
     for (const auto file : files) {
 
         // Sanity check
-        if (!file.isFile() || file.absoluteFilePath() == parentZip->getZipName())
+        if (!file.isFile())
+            continue;
+
+        entries.push_back({ file.absoluteFilePath(), origDirectory.relativeFilePath(file.absoluteFilePath()), file.size(), false, quazip_is_symlink(file) });
+    }
+}
+
+void Archiver::compressEntries(QuaZip* zip, const QVector<ArchiveEntry>& entries, std::int32_t compressionLevel /*= 0*/, const QString& password /*= ""*/)
+{
+    // Except if the zip is invalid
+    if (!zip)
+        throw std::runtime_error("Invalid zip file");
+
+    // Except if the zip mode is invalid
+    if (zip->getMode() != QuaZip::mdCreate && zip->getMode() != QuaZip::mdAppend && zip->getMode() != QuaZip::mdAdd)
+        throw std::runtime_error("Invalid zip mode");
+
+    // Files can only be deflated independently of the zip stream when the data is not encrypted
+    const auto isDeflatedConcurrently = [this, compressionLevel, &password](const ArchiveEntry& entry) -> bool {
+        return _numberOfThreads > 1 && compressionLevel != 0 && password.isEmpty() && !entry._isDirectory && !entry._isSymbolicLink;
+    };
+
+    // Deflated chunks of the files that are deflated concurrently, in archive order
+    std::deque<DeflatedChunk> deflatedChunks;
+
+    qsizetype scheduledEntryIndex   = 0;
+    qint64 scheduledOffset          = 0;
+
+    // Deflates the next chunks (at most two per thread, and at most maximumCompressionBatchSize bytes) concurrently, possibly of several files, so that small files are deflated concurrently as well
+    const auto deflateNextChunks = [&]() -> void {
+        struct ScheduledChunk
+        {
+            qsizetype   _entryIndex;    /** Index of the entry of the chunk */
+            qint64      _offset;        /** Offset of the chunk in the file */
+            qint64      _size;          /** Number of bytes of the chunk */
+            bool        _last;          /** Whether this is the last chunk of the file */
+        };
+
+        std::vector<ScheduledChunk> scheduledChunks;
+
+        qint64 scheduledBatchSize = 0;
+
+        while (scheduledEntryIndex < entries.size() && scheduledChunks.size() < 2 * static_cast<std::size_t>(_numberOfThreads)) {
+            const auto& entry = entries[scheduledEntryIndex];
+
+            if (!isDeflatedConcurrently(entry)) {
+                ++scheduledEntryIndex;
+                continue;
+            }
+
+            const auto chunkSize    = std::min(compressionChunkSize, entry._size - scheduledOffset);
+            const auto last         = scheduledOffset + chunkSize >= entry._size;
+
+            if (!scheduledChunks.empty() && scheduledBatchSize + chunkSize > maximumCompressionBatchSize)
+                break;
+
+            scheduledChunks.push_back({ scheduledEntryIndex, scheduledOffset, chunkSize, last });
+
+            scheduledBatchSize  += chunkSize;
+            scheduledOffset     += chunkSize;
+
+            if (last) {
+                ++scheduledEntryIndex;
+                scheduledOffset = 0;
+            }
+        }
+
+        std::vector<DeflatedChunk> nextChunks(scheduledChunks.size());
+
+        parallelForEach(scheduledChunks.size(), [&entries, &scheduledChunks, &nextChunks, compressionLevel](std::size_t chunkIndex) -> void {
+            const auto& scheduledChunk = scheduledChunks[chunkIndex];
+
+            nextChunks[chunkIndex] = readAndDeflateChunk(entries[scheduledChunk._entryIndex]._sourceFilePath, scheduledChunk._offset, scheduledChunk._size, compressionLevel, scheduledChunk._last);
+        });
+
+        for (auto& nextChunk : nextChunks)
+            deflatedChunks.push_back(std::move(nextChunk));
+    };
+
+    for (const auto& entry : entries) {
+        if (entry._isDirectory) {
+
+            // Create directory zip file
+            QuaZipFile dirZipFile(zip);
+
+            // Attempt to open the directory zip file
+            if (!dirZipFile.open(QIODevice::WriteOnly, QuaZipNewInfo(entry._name, entry._sourceFilePath), password.isEmpty() ? nullptr : password.toLatin1(), 0U, Z_DEFLATED, compressionLevel, compressionLevel == -1))
+                throw std::runtime_error("Unable to open directory zip file");
+
+            // Close the directory zip file
+            dirZipFile.close();
+
+            continue;
+        }
+
+        if (!isDeflatedConcurrently(entry)) {
+            compressFile(zip, entry._sourceFilePath, entry._name, compressionLevel, password);
             continue;
+        }
+
+        // Notify others that a task started
+        emit taskStarted(entry._name);
+
+        uLong crc                   = crc32(0L, Z_NULL, 0);
+        qint64 uncompressedSize     = 0;
+
+        // The CRC of the entry is needed before it is written, so the deflated data of a file that consists of multiple chunks is first spooled next to the destination file
+        QBuffer deflatedData;
+        QTemporaryFile spoolFile(QFileInfo(zip->getZipName()).absolutePath() + "/XXXXXX.deflate");
+
+        QIODevice* deflatedDevice = &deflatedData;
+
+        for (bool last = false; !last;) {
+            if (deflatedChunks.empty())
+                deflateNextChunks();
+
+            const auto deflatedChunk = std::move(deflatedChunks.front());
+
+            deflatedChunks.pop_front();
+
+            last = deflatedChunk._last;
+
+            crc = crc32_combine(crc, deflatedChunk._crc, deflatedChunk._uncompressedSize);
+
+            uncompressedSize += deflatedChunk._uncompressedSize;
+
+            if (last && deflatedDevice == &deflatedData) {
+                deflatedData.setData(deflatedChunk._data);
+                break;
+            }
+
+            if (deflatedDevice == &deflatedData) {
+                if (!spoolFile.open())
+                    throw std::runtime_error("Unable to create temporary file for compression");
+
+                deflatedDevice = &spoolFile;
+            }
+
+            if (spoolFile.write(deflatedChunk._data) != deflatedChunk._data.size())
+                throw std::runtime_error("Unable to write temporary file for compression");
+        }
+
+        if (!deflatedDevice->isOpen() && !deflatedDevice->open(QIODevice::ReadOnly))
+            throw std::runtime_error("Unable to read deflated data");
+
+        if (!deflatedDevice->seek(0))
+            throw std::runtime_error("Unable to read deflated data");
+
+        QuaZipNewInfo newInfo(entry._name, entry._sourceFilePath);
+
+        newInfo.uncompressedSize = uncompressedSize;
 
-        // Establish file name of the file that needs to be compressed
-        const auto filename = origDirectory.relativeFilePath(file.absoluteFilePath());
+        // Create compressed file, in raw mode because the data is deflated already
+        QuaZipFile compressedFile(zip);
 
-        // Compress the file
-        compressFile(parentZip, file.absoluteFilePath(), filename, compressionLevel, password);
+        if (!compressedFile.open(QIODevice::WriteOnly, newInfo, nullptr, static_cast<quint32>(crc), Z_DEFLATED, compressionLevel, true))
+            throw std::runtime_error("Unable to open zip file");
+
+        // Except if unable to copy data
+        if (!JlCompress::copyData(*deflatedDevice, compressedFile) || compressedFile.getZipError() != UNZ_OK)
+            throw std::runtime_error("Unable to copy data");
+
+        // Close the compressed file
+        compressedFile.close();
+
+        // Except if zipping error(s) occurred
+        if (compressedFile.getZipError() != UNZ_OK)
+            throw std::runtime_error("Zip error(s) occurred");
+
+        // Notify others that a task finished
+        emit taskFinished(entry._name);
     }
 }
 
@@ -326,6 +595,14 @@ void Archiver::extractFile(QuaZip* zip, const QString& compressedFilePath, const
     if (!compressedFilePath.isEmpty())
         zip->setCurrentFile(compressedFilePath);
 
+    extractCurrentFile(zip, targetFilePath, password);
+
+    // Notify others that a task finished
+    emit taskFinished(taskName);
+}
+
+void Archiver::extractCurrentFile(QuaZip* zip, const QString& targetFilePath, const QString& password /*= ""*/)
+{
     QuaZipFile inFile(zip);
 
     if (!inFile.open(QIODevice::ReadOnly, password.isEmpty() ? nullptr : password.toLocal8Bit().data()) || inFile.getZipError() != UNZ_OK)
@@ -389,9 +666,134 @@ void Archiver::extractFile(QuaZip* zip, const QString& compressedFilePath, const
 
     if (srcPerm != 0)
         outFile.setPermissions(srcPerm);
+}
 
-    // Notify others that a task finished
-    emit taskFinished(taskName);
+void Archiver::decompressInParallel(const QString& compressedFile, const QVector<QPair<QString, QString>>& entries, const QString& password, QStringList& extracted)
+{
+    std::mutex mutex;
+    std::condition_variable progressChanged;
+
+    // Progress of the worker threads, which is reported from this thread
+    std::deque<QPair<bool, QString>> progress;
+    std::exception_ptr exception;
+    std::atomic<std::size_t> nextEntryIndex{ 0 };
+    std::atomic<bool> stop{ false };
+
+    const auto numberOfWorkers = std::min(static_cast<std::size_t>(_numberOfThreads), static_cast<std::size_t>(entries.size()));
+
+    std::size_t numberOfActiveWorkers = numberOfWorkers;
+
+    const auto extractEntries = [&]() -> void {
+        try {
+
+            // Each worker has its own handle, as a handle has one current file
+            QuaZip zip(compressedFile);
+
+            if (!zip.open(QuaZip::mdUnzip))
+                throw std::runtime_error("Unable to open ZIP file");
+
+            for (auto entryIndex = nextEntryIndex++; entryIndex < static_cast<std::size_t>(entries.size()) && !stop; entryIndex = nextEntryIndex++) {
+                const auto& [entryName, targetFilePath] = entries[static_cast<qsizetype>(entryIndex)];
+                const auto taskName = QFileInfo(targetFilePath).fileName();
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+
+                    progress.push_back({ true, taskName });
+                    extracted.append(targetFilePath);
+                }
+
+                progressChanged.notify_one();
+
+                if (!zip.setCurrentFile(entryName))
+                    throw std::runtime_error("Unable to locate file in ZIP file");
+
+                extractCurrentFile(&zip, targetFilePath, password);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+
+                    progress.push_back({ false, taskName });
+                }
+
+                progressChanged.notify_one();
+            }
+
+            zip.close();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (!exception)
+                exception = std::current_exception();
+
+            stop = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            --numberOfActiveWorkers;
+        }
+
+        progressChanged.notify_one();
+    };
+
+    // The workers run on a thread of their own, so that this thread reports the progress in the meantime
+    std::thread extraction([numberOfWorkers, &extractEntries]() -> void {
+        parallelForEach(numberOfWorkers, [&extractEntries](std::size_t) -> void {
+            extractEntries();
+        });
+    });
+
+    try {
+        for (bool done = false; !done;) {
+            std::deque<QPair<bool, QString>> currentProgress;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                progressChanged.wait(lock, [&]() -> bool {
+                    return !progress.empty() || numberOfActiveWorkers == 0;
+                });
+
+                std::swap(currentProgress, progress);
+
+                done = numberOfActiveWorkers == 0;
+            }
+
+            for (const auto& [started, taskName] : currentProgress) {
+                if (started)
+                    emit taskStarted(taskName);
+                else
+                    emit taskFinished(taskName);
+            }
+        }
+    }
+    catch (...) {
+
+        // A receiver of the progress signals raised an exception (e.g. to abort), stop the workers first
+        stop = true;
+
+        extraction.join();
+
+        throw;
+    }
+
+    extraction.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void Archiver::setNumberOfThreads(std::uint32_t numberOfThreads)
+{
+    _numberOfThreads = std::max(1u, numberOfThreads);
+}
+
+std::uint32_t Archiver::getNumberOfThreads() const
+{
+    return _numberOfThreads;
 }
 
 void Archiver::removeFiles(const QStringList& filesToRemove)
@@ -8,6 +8,12 @@
 #include <QString>
 #include <QDir>
 #include <QCryptographicHash>
+#include <QPair>
+#include <QVector>
+
+#include <util/Parallel.h>
+
+#include <cstdint>
 
 class QuaZip;
 
@@ -18,6 +24,11 @@ namespace mv::util {
  *
  * Class for archiving files and directories (wraps QuaZip)
  *
+ * When more than one thread is available, files are deflated concurrently (large files are split
+ * into chunks that are stitched into a single zip entry), while the zip entries are written in
+ * order, and archive entries are extracted concurrently (both with util::parallelForEach()).
+ * Progress is always reported from the calling thread.
+ *
  * @author Thomas Kroes
  */
 class Archiver : public QObject
@@ -79,19 +90,49 @@ public:
      */
     void extractSingleFile(const QString& compressedFilePath, const QString& sourceFileName, const QString& targetFilePath, const QString& password = "");
 
+    /**
+     * Set the maximum number of threads used for (de)compression (one disables parallel (de)compression), it bounds the
+     * number of files that are extracted at once and the number of chunks that are deflated at once (two per thread, and at most 256 MB of chunks)
+     * @param numberOfThreads Maximum number of threads
+     */
+    void setNumberOfThreads(std::uint32_t numberOfThreads);
+
+    /**
+     * Get the maximum number of threads used for (de)compression
+     * @return Maximum number of threads
+     */
+    std::uint32_t getNumberOfThreads() const;
+
 protected:
 
+    /** Directory or file to compress */
+    struct ArchiveEntry
+    {
+        QString     _sourceFilePath;    /** Path of the source directory or file */
+        QString     _name;              /** Name of the entry in the archive (relative to the compressed directory) */
+        qint64      _size;              /** Size of the source file in bytes */
+        bool        _isDirectory;       /** Whether the entry is a directory */
+        bool        _isSymbolicLink;    /** Whether the source file is a symbolic link */
+    };
+
     /**
-     * Compresses a sub directory
-     * @param parentZip Opened zip containing the parent directory
+     * Collects the entries of a sub directory, in archive order
      * @param directory The full path to the directory to pack
      * @param parentDirectory The full path to the directory corresponding to the root of the ZIP
      * @param recursive Whether to pack sub-directories as well or only files
+     * @param filters File include filter
+     * @param entries Collected entries
+     */
+    void collectEntries(const QString& directory, const QString& parentDirectory, bool recursive, QDir::Filters filters, QVector<ArchiveEntry>& entries);
+
+    /**
+     * Compresses entries, independent files (and chunks of large files) are deflated concurrently and then written as raw zip entries in order
+     * @param zip Opened zip
+     * @param entries Directories and files to compress
      * @param compressionLevel Compression level (zero means no compression)
      * @param password Password string if files need to be secured
-     * @param filters File include filter
      */
-    void compressSubDirectory(QuaZip* parentZip, const QString& directory, const QString& parentDirectory, bool recursive = true, std::int32_t compressionLevel = 0, const QString& password = "", QDir::Filters filters = QDir::Filter::Files);
+    void compressEntries(QuaZip* zip, const QVector<ArchiveEntry>& entries, std::int32_t compressionLevel = 0, const QString& password = "");
 
     /**
      * Compresses a file
@@ -112,6 +153,23 @@ protected:
      */
     void extractFile(QuaZip* zip, const QString& compressedFilePath, const QString& targetFilePath, const QString& password = "");
 
+    /**
+     * Extracts the current file of \p zip (does not emit signals, so that it can be called from worker threads)
+     * @param zip Pointer to quazip instance
+     * @param targetFilePath Path of the extracted target file
+     * @param password Password string if the compressed file is encrypted with a password
+     */
+    void extractCurrentFile(QuaZip* zip, const QString& targetFilePath, const QString& password = "");
+
+    /**
+     * Extracts \p entries of \p compressedFile concurrently, each worker thread reads the archive through its own handle
+     * @param compressedFile Path of the compressed source file
+     * @param entries Pairs of archive entry name and absolute target file path
+     * @param password Password string if files need to be secured
+     * @param extracted Files that were extracted (also when an exception is thrown)
+     */
+    void decompressInParallel(const QString& compressedFile, const QVector<QPair<QString, QString>>& entries, const QString& password, QStringList& extracted);
+
     /**
      * Removes a file
      * @param filesToRemove Files to remove
@@ -131,6 +189,9 @@ signals:
      * @param taskName Name of the task that finished
      */
     void taskFinished(const QString& taskName);
+
+private:
+    std::uint32_t   _numberOfThreads = static_cast<std::uint32_t>(getNumberOfHardwareThreads());    /** Maximum number of threads used for (de)compression */
 };
 
 }
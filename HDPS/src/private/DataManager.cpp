@@ -8,6 +8,8 @@
 
 #include "util/Exception.h"
 
+#include <QSet>
+
 #include <cassert>
 #include <iostream>
 #include <stdexcept>
@@ -22,7 +24,8 @@ namespace mv
 {
 
 DataManager::DataManager() :
-	AbstractDataManager()
+	AbstractDataManager(),
+    _datasetGraphRevision(0)
 {
 	setObjectName("Datasets");
 }
@@ -41,6 +44,10 @@ void DataManager::addSet(const Dataset<DatasetImpl>& dataset)
 
         _datasets.push_back(dataset);
 
+        indexDataset(dataset);
+
+        ++_datasetGraphRevision;
+
         emit dataChanged();
     }
     catch (std::exception& e)
@@ -71,16 +78,21 @@ void DataManager::removeDataset(Dataset<DatasetImpl> dataset)
 
         events().notifyDatasetAboutToBeRemoved(dataset);
         {
-            for (auto& underiveDataset : _datasets) {
-                if (underiveDataset->isDerivedData() && underiveDataset->getSourceDataset<DatasetImpl>()->getId() == dataset->getId()) {
-                    qDebug() << "Un-derive" << underiveDataset->text();
+            for (auto& underiveDataset : getDerivedDatasets(dataset)) {
+                qDebug() << "Un-derive" << underiveDataset->text();
 
-                    underiveDataset->_derived = false;
-                    underiveDataset->setSourceDataSet(Dataset<DatasetImpl>());
-                }
+                // Not through setSourceDataSet(), which marks the dataset as derived and updates its relations as well
+                underiveDataset->_sourceDataset = Dataset<DatasetImpl>();
+                underiveDataset->_derived       = false;
+
+                updateDatasetRelations(underiveDataset);
             }
 
+            unindexDataset(guid);
+
             _datasets.removeOne(dataset);
+
+            ++_datasetGraphRevision;
         }
         events().notifyDatasetRemoved(guid, type);
 
@@ -123,14 +135,7 @@ Dataset<DatasetImpl> DataManager::getSet(const QString& datasetGuid)
         if (datasetGuid.isEmpty())
             throw std::runtime_error("Dataset GUID is invalid");
 
-        const auto it = std::find_if(_datasets.begin(), _datasets.end(), [datasetGuid](Dataset<DatasetImpl> dataset) -> bool {
-            return datasetGuid == dataset->getId();
-        });
-
-        if (it == _datasets.end())
-            return Dataset<DatasetImpl>();
-
-        return *it;
+        return _datasetsById.value(datasetGuid);
     }
     catch (std::exception& e)
     {
@@ -171,6 +176,134 @@ const QVector<Dataset<DatasetImpl>>& DataManager::allSets() const
     return _datasets;
 }
 
+void DataManager::updateDatasetRelations(const Dataset<DatasetImpl>& dataset)
+{
+    if (!dataset.isValid() || !_datasetsById.contains(dataset.getDatasetId()))
+        return;
+
+    // The (ultimate) source of the derived datasets downstream might have changed as well
+    Datasets datasetsToUpdate{ dataset };
+    QSet<QString> updatedDatasetIds;
+
+    while (!datasetsToUpdate.isEmpty()) {
+        const auto datasetToUpdate = datasetsToUpdate.takeFirst();
+
+        if (updatedDatasetIds.contains(datasetToUpdate.getDatasetId()))
+            continue;
+
+        updatedDatasetIds << datasetToUpdate.getDatasetId();
+
+        unindexDataset(datasetToUpdate.getDatasetId());
+        indexDataset(datasetToUpdate);
+
+        datasetsToUpdate << _derivedDatasetsBySourceId.value(datasetToUpdate.getDatasetId());
+    }
+
+    ++_datasetGraphRevision;
+}
+
+Datasets DataManager::getDatasetsByRawDataName(const QString& rawDataName) const
+{
+    return _datasetsByRawDataName.value(rawDataName);
+}
+
+Datasets DataManager::getDerivedDatasets(const QString& sourceRawDataName) const
+{
+    return _derivedDatasetsBySourceRawDataName.value(sourceRawDataName);
+}
+
+Datasets DataManager::getDerivedDatasets(const Dataset<DatasetImpl>& sourceDataset) const
+{
+    if (!sourceDataset.isValid())
+        return {};
+
+    return _derivedDatasetsBySourceId.value(sourceDataset.getDatasetId());
+}
+
+Datasets DataManager::getProxyDatasets(const Dataset<DatasetImpl>& memberDataset) const
+{
+    if (!memberDataset.isValid())
+        return {};
+
+    return _proxyDatasetsByMemberId.value(memberDataset.getDatasetId());
+}
+
+std::uint64_t DataManager::getDatasetGraphRevision() const
+{
+    return _datasetGraphRevision;
+}
+
+void DataManager::indexDataset(const Dataset<DatasetImpl>& dataset)
+{
+    const auto datasetId = dataset.getDatasetId();
+
+    DatasetRelations datasetRelations;
+
+    datasetRelations._rawDataName = dataset->getRawDataName();
+
+    _datasetsByRawDataName[datasetRelations._rawDataName] << dataset;
+
+    if (dataset->isDerivedData()) {
+        datasetRelations._sourceRawDataName = dataset->getSourceDataset<DatasetImpl>()->getRawDataName();
+
+        _derivedDatasetsBySourceRawDataName[datasetRelations._sourceRawDataName] << dataset;
+
+        const auto nextSourceDataset = dataset->getNextSourceDataset<DatasetImpl>();
+
+        if (nextSourceDataset.getDatasetId() != datasetId) {
+            datasetRelations._sourceDatasetId = nextSourceDataset.getDatasetId();
+
+            _derivedDatasetsBySourceId[datasetRelations._sourceDatasetId] << dataset;
+        }
+    }
+
+    if (dataset->isProxy()) {
+        for (const auto& proxyMember : dataset->getProxyMembers()) {
+            datasetRelations._proxyMemberIds << proxyMember.getDatasetId();
+
+            _proxyDatasetsByMemberId[proxyMember.getDatasetId()] << dataset;
+        }
+    }
+
+    _datasetsById[datasetId] = dataset;
+    _datasetRelations[datasetId] = datasetRelations;
+}
+
+void DataManager::unindexDataset(const QString& datasetId)
+{
+    if (!_datasetRelations.contains(datasetId))
+        return;
+
+    const auto datasetRelations = _datasetRelations.take(datasetId);
+
+    const auto removeFromIndex = [&datasetId](QHash<QString, Datasets>& index, const QString& key) -> void {
+        auto it = index.find(key);
+
+        if (it == index.end())
+            return;
+
+        it->removeIf([&datasetId](const Dataset<DatasetImpl>& dataset) -> bool {
+            return dataset.getDatasetId() == datasetId;
+        });
+
+        if (it->isEmpty())
+            index.erase(it);
+    };
+
+    removeFromIndex(_datasetsByRawDataName, datasetRelations._rawDataName);
+
+    if (!datasetRelations._sourceRawDataName.isEmpty())
+        removeFromIndex(_derivedDatasetsBySourceRawDataName, datasetRelations._sourceRawDataName);
+
+    if (!datasetRelations._sourceDatasetId.isEmpty())
+        removeFromIndex(_derivedDatasetsBySourceId, datasetRelations._sourceDatasetId);
+
+    for (const auto& proxyMemberId : datasetRelations._proxyMemberIds)
+        removeFromIndex(_proxyDatasetsByMemberId, proxyMemberId);
+
+    _datasetsById.remove(datasetId);
+}
+
 void DataManager::fromVariantMap(const QVariantMap& variantMap)
 {
 }
@@ -198,7 +331,10 @@ void DataManager::reset()
         }
             
 
-        for (auto& dataset : _datasets)
+        // Iterate over a copy, as removing a dataset modifies the list of datasets
+        const auto datasets = _datasets;
+
+        for (const auto& dataset : datasets)
             removeDataset(dataset);
 
         _rawDataMap.clear();
@@ -10,6 +10,7 @@
 
 #include <QObject> // To support signals
 #include <QString>
+#include <QHash>
 
 #include <string>
 #include <unordered_map>    // Data is stored in maps
@@ -105,6 +106,50 @@ public:
     /** Get all sets from the data manager */
     const QVector<Dataset<DatasetImpl>>& allSets() const override;
 
+public: // Dataset graph
+
+    /**
+     * Updates the dataset graph index for \p dataset (and the datasets that are derived from it), to be called when
+     * the source dataset or the proxy members of a dataset that was already added to the data manager changed
+     * @param dataset Smart pointer to the dataset of which the relations changed
+     */
+    void updateDatasetRelations(const Dataset<DatasetImpl>& dataset) override;
+
+    /**
+     * Get datasets that reference the raw data with \p rawDataName
+     * @param rawDataName Name of the raw data
+     * @return Datasets (full datasets and subsets) of the raw data
+     */
+    Datasets getDatasetsByRawDataName(const QString& rawDataName) const override;
+
+    /**
+     * Get derived datasets of which the (ultimate) source dataset references the raw data with \p sourceRawDataName
+     * @param sourceRawDataName Name of the raw data of the source dataset
+     * @return Derived datasets
+     */
+    Datasets getDerivedDatasets(const QString& sourceRawDataName) const override;
+
+    /**
+     * Get datasets that are directly derived from \p sourceDataset
+     * @param sourceDataset Smart pointer to the source dataset
+     * @return Derived datasets
+     */
+    Datasets getDerivedDatasets(const Dataset<DatasetImpl>& sourceDataset) const override;
+
+    /**
+     * Get proxy datasets that contain \p memberDataset
+     * @param memberDataset Smart pointer to the proxy member dataset
+     * @return Proxy datasets
+     */
+    Datasets getProxyDatasets(const Dataset<DatasetImpl>& memberDataset) const override;
+
+    /**
+     * Get the revision of the dataset graph, which increases whenever a dataset is added, removed or changes
+     * relations, so that information derived from the graph (like global indices) can be cached
+     * @return Dataset graph revision
+     */
+    std::uint64_t getDatasetGraphRevision() const override;
+
 public: // Serialization
 
     /**
@@ -124,6 +169,28 @@ signals:
 
 private:
 
+    /** Relations of a dataset, as they were when the dataset was indexed (so that it can be removed from the index) */
+    struct DatasetRelations
+    {
+        QString         _rawDataName;           /** Name of the raw data of the dataset */
+        QString         _sourceRawDataName;     /** Name of the raw data of the (ultimate) source dataset (empty if not derived) */
+        QString         _sourceDatasetId;       /** Globally unique identifier of the direct source dataset (empty if not derived) */
+        QStringList     _proxyMemberIds;        /** Globally unique identifiers of the proxy members */
+    };
+
+    /**
+     * Adds \p dataset to the dataset graph index
+     * @param dataset Smart pointer to the dataset
+     */
+    void indexDataset(const Dataset<DatasetImpl>& dataset);
+
+    /**
+     * Removes the dataset with \p datasetId from the dataset graph index
+     * @param datasetId Globally unique identifier of the dataset
+     */
+    void unindexDataset(const QString& datasetId);
+
+
     /**
      * Stores all raw data in the system. Raw data is stored by the name
      * retrieved from their Plugin::getName() function.
@@ -140,6 +207,15 @@ private:
     * NOTE: Can't be a QMap because it doesn't support move semantics of unique_ptr
     */
     std::unordered_map<QString, Dataset<DatasetImpl>> _selections;
+
+    /** Dataset graph index, maintained incrementally when datasets are added, removed or change relations */
+    QHash<QString, Dataset<DatasetImpl>>    _datasetsById;                          /** Datasets by globally unique identifier */
+    QHash<QString, DatasetRelations>        _datasetRelations;                      /** Indexed relations by dataset globally unique identifier */
+    QHash<QString, Datasets>                _datasetsByRawDataName;                 /** Datasets by raw data name */
+    QHash<QString, Datasets>                _derivedDatasetsBySourceRawDataName;    /** Derived datasets by raw data name of their (ultimate) source dataset */
+    QHash<QString, Datasets>                _derivedDatasetsBySourceId;             /** Derived datasets by globally unique identifier of their direct source dataset */
+    QHash<QString, Datasets>                _proxyDatasetsByMemberId;               /** Proxy datasets by globally unique identifier of their members */
+    std::uint64_t                           _datasetGraphRevision;                  /** Revision of the dataset graph */
 };
 
 } // namespace mv
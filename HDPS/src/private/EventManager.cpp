@@ -9,6 +9,9 @@
 #include <Set.h>
 #include <LinkedData.h>
 
+#include <QQueue>
+#include <QSet>
+
 using namespace mv::gui;
 using namespace mv::util;
 
@@ -20,18 +23,122 @@ namespace mv
 {
 
 EventManager::EventManager() :
-    AbstractEventManager()
+    AbstractEventManager(),
+    _dispatchDepth(0),
+    _selectionPropagationRate(DEFAULT_SELECTION_PROPAGATION_RATE)
 {
+    _selectionPropagationTimer.setSingleShot(true);
+
+    connect(&_selectionPropagationTimer, &QTimer::timeout, this, &EventManager::flushSelectionChanges);
+
+    _lastSelectionPropagation.start();
 }
 
 void EventManager::registerEventListener(EventListener* eventListener)
 {
-    _eventListeners.push_back(eventListener);
+    auto& handle = getEventListenerHandle(eventListener);
+
+    if (!eventListener->isDatasetSpecific()) {
+        handle = _eventListeners.insert(eventListener, eventListener->getSupportedEventTypes());
+        return;
+    }
+
+    if (!eventListener->getDatasetId().isEmpty())
+        handle = _datasetEventListeners[eventListener->getDatasetId()].insert(eventListener, eventListener->getSupportedEventTypes());
 }
 
 void EventManager::unregisterEventListener(EventListener* eventListener)
 {
-    _eventListeners.erase(std::remove(_eventListeners.begin(), _eventListeners.end(), eventListener), _eventListeners.end());
+    auto& handle = getEventListenerHandle(eventListener);
+
+    if (!handle.isValid())
+        return;
+
+    if (!eventListener->isDatasetSpecific()) {
+        _eventListeners.erase(handle);
+    }
+    else {
+        const auto it = _datasetEventListeners.find(eventListener->getDatasetId());
+
+        if (it != _datasetEventListeners.end()) {
+            it->second.erase(handle);
+
+            // The listeners of a dataset are not removed while they might be dispatching
+            if (it->second.isEmpty()) {
+                if (_dispatchDepth == 0)
+                    _datasetEventListeners.erase(it);
+                else
+                    _emptiedDatasetIds << eventListener->getDatasetId();
+            }
+        }
+    }
+
+    handle = {};
+}
+
+void EventManager::updateEventListener(EventListener* eventListener, const QSet<std::uint32_t>& previousEventTypes)
+{
+    const auto& handle = getEventListenerHandle(eventListener);
+
+    if (!handle.isValid())
+        return;
+
+    EventListeners* eventListeners = &_eventListeners;
+
+    if (eventListener->isDatasetSpecific()) {
+        const auto it = _datasetEventListeners.find(eventListener->getDatasetId());
+
+        if (it == _datasetEventListeners.end())
+            return;
+
+        eventListeners = &it->second;
+    }
+
+    const auto& eventTypes = eventListener->getSupportedEventTypes();
+
+    eventListeners->removeEventTypes(handle, QSet<std::uint32_t>(previousEventTypes).subtract(eventTypes));
+    eventListeners->addEventTypes(handle, QSet<std::uint32_t>(eventTypes).subtract(previousEventTypes));
+}
+
+void EventManager::notifyEventListeners(DatasetEvent* dataEvent, const QString& datasetId)
+{
+    const auto eventType = static_cast<std::uint32_t>(dataEvent->getType());
+
+    const auto callListener = [this, dataEvent](EventListener* eventListener) -> void {
+        callListenerDataEvent(eventListener, dataEvent);
+    };
+
+    ++_dispatchDepth;
+
+    try {
+        _eventListeners.dispatch(eventType, callListener);
+
+        if (!datasetId.isEmpty()) {
+            const auto it = _datasetEventListeners.find(datasetId);
+
+            // References to the elements of an unordered map remain valid when listeners of other datasets are added
+            if (it != _datasetEventListeners.end())
+                it->second.dispatch(eventType, callListener);
+        }
+    }
+    catch (...) {
+        --_dispatchDepth;
+        throw;
+    }
+
+    --_dispatchDepth;
+
+    if (_dispatchDepth > 0 || _emptiedDatasetIds.isEmpty())
+        return;
+
+    for (const auto& emptiedDatasetId : _emptiedDatasetIds) {
+        const auto it = _datasetEventListeners.find(emptiedDatasetId);
+
+        if (it != _datasetEventListeners.end() && it->second.isEmpty())
+            _datasetEventListeners.erase(it);
+    }
+
+    _emptiedDatasetIds.clear();
 }
 
 void EventManager::notifyDatasetAdded(const Dataset<DatasetImpl>& dataset)
@@ -39,11 +146,7 @@ void EventManager::notifyDatasetAdded(const Dataset<DatasetImpl>& dataset)
     try {
         DatasetAddedEvent dataEvent(dataset);
 
-        const auto eventListeners = _eventListeners;
-
-        for (auto listener : eventListeners)
-            if (std::find(_eventListeners.begin(), _eventListeners.end(), listener) != _eventListeners.end())
-                callListenerDataEvent(listener, &dataEvent);
+        notifyEventListeners(&dataEvent, dataset.getDatasetId());
     }
     catch (std::exception& e)
     {
@@ -57,13 +160,11 @@ void EventManager::notifyDatasetAdded(const Dataset<DatasetImpl>& dataset)
 void EventManager::notifyDatasetAboutToBeRemoved(const Dataset<DatasetImpl>& dataset)
 {
     try {
-        DatasetAboutToBeRemovedEvent dataAboutToBeRemovedEvent(dataset);
+        _pendingSelectionChanges.removeAll(dataset);
 
-        const auto eventListeners = _eventListeners;
+        DatasetAboutToBeRemovedEvent dataAboutToBeRemovedEvent(dataset);
 
-        for (auto listener : eventListeners)
-            if (std::find(_eventListeners.begin(), _eventListeners.end(), listener) != _eventListeners.end())
-                callListenerDataEvent(listener, &dataAboutToBeRemovedEvent);
+        notifyEventListeners(&dataAboutToBeRemovedEvent, dataset.getDatasetId());
     }
     catch (std::exception& e)
     {
@@ -79,11 +180,7 @@ void EventManager::notifyDatasetRemoved(const QString& datasetId, const DataType
     try {
         DatasetRemovedEvent dataRemovedEvent(nullptr, datasetId, dataType);
 
-        const auto eventListeners = _eventListeners;
-
-        for (auto listener : eventListeners)
-            if (std::find(_eventListeners.begin(), _eventListeners.end(), listener) != _eventListeners.end())
-                callListenerDataEvent(listener, &dataRemovedEvent);
+        notifyEventListeners(&dataRemovedEvent, datasetId);
     }
     catch (std::exception& e)
     {
@@ -97,13 +194,13 @@ void EventManager::notifyDatasetRemoved(const QString& datasetId, const DataType
 void EventManager::notifyDatasetDataChanged(const Dataset<DatasetImpl>& dataset)
 {
     try {
-        DatasetDataChangedEvent dataEvent(dataset);
+        // Invalidate cached data that is derived from the values
+        if (dataset.isValid())
+            dataset->incrementDataGeneration();
 
-        const auto eventListeners = _eventListeners;
+        DatasetDataChangedEvent dataEvent(dataset);
 
-        for (auto listener : eventListeners)
-            if (std::find(_eventListeners.begin(), _eventListeners.end(), listener) != _eventListeners.end())
-                callListenerDataEvent(listener, &dataEvent);
+        notifyEventListeners(&dataEvent, dataset.getDatasetId());
     }
     catch (std::exception& e)
     {
@@ -117,13 +214,13 @@ void EventManager::notifyDatasetDataChanged(const Dataset<DatasetImpl>& dataset)
 void EventManager::notifyDatasetDataDimensionsChanged(const Dataset<DatasetImpl>& dataset)
 {
     try {
-        DatasetDataDimensionsChangedEvent dataEvent(dataset);
+        // Invalidate cached data that is derived from the values
+        if (dataset.isValid())
+            dataset->incrementDataGeneration();
 
-        const auto eventListeners = _eventListeners;
+        DatasetDataDimensionsChangedEvent dataEvent(dataset);
 
-        for (auto listener : eventListeners)
-            if (std::find(_eventListeners.begin(), _eventListeners.end(), listener) != _eventListeners.end())
-                callListenerDataEvent(listener, &dataEvent);
+        notifyEventListeners(&dataEvent, dataset.getDatasetId());
     }
     catch (std::exception& e)
     {
@@ -137,69 +234,77 @@ void EventManager::notifyDatasetDataDimensionsChanged(const Dataset<DatasetImpl>
 void EventManager::notifyDatasetDataSelectionChanged(const Dataset<DatasetImpl>& dataset, Datasets* ignoreDatasets /*= nullptr*/)
 {
     try {
-        if (ignoreDatasets != nullptr && ignoreDatasets->contains(dataset))
-            return;
-
-        if (ignoreDatasets != nullptr)
-            *ignoreDatasets << dataset;
-
-        QStringList datasetNotifiedString;
+        if (!dataset.isValid())
+            throw std::runtime_error("Dataset is invalid");
 
 #ifdef EVENT_MANAGER_VERBOSE
-        if (ignoreDatasets != nullptr)
-            for (auto datasetNotified : *ignoreDatasets)
-                datasetNotifiedString << datasetNotified->getGuiName();
-
-        qDebug() << __FUNCTION__ << dataset->getGuiName() << datasetNotifiedString;
+        qDebug() << __FUNCTION__ << dataset->getGuiName();
 #endif
 
-        Datasets notified{ dataset };
+        // Invalidate cached selection data right away, also when the propagation is deferred
+        dataset->incrementSelectionGeneration();
 
-        if (ignoreDatasets == nullptr)
-            ignoreDatasets = &notified;
+        // Callers that pass datasets to ignore expect the notification to be complete upon return
+        if (_selectionPropagationRate == 0 || ignoreDatasets != nullptr) {
+            propagateSelectionChanges({ dataset }, ignoreDatasets);
+            return;
+        }
 
-        const auto callNotifyDatasetSelectionChanged = [this, dataset, ignoreDatasets](Dataset<DatasetImpl> notifyDataset) -> void {
-            if (ignoreDatasets != nullptr && ignoreDatasets->contains(notifyDataset))
-                return;
+        if (!_pendingSelectionChanges.contains(dataset))
+            _pendingSelectionChanges << dataset;
 
-            notifyDatasetDataSelectionChanged(notifyDataset, ignoreDatasets);
-        };
+        if (_selectionPropagationTimer.isActive())
+            return;
 
-        DatasetDataSelectionChangedEvent dataSelectionChangedEvent(dataset);
+        const auto minimumInterval  = static_cast<qint64>(1000 / _selectionPropagationRate);
+        const auto remainingTime    = std::max(minimumInterval - _lastSelectionPropagation.elapsed(), static_cast<qint64>(0));
 
-        const auto eventListeners = _eventListeners;
+        _selectionPropagationTimer.start(static_cast<int>(remainingTime));
+    }
+    catch (std::exception& e)
+    {
+        exceptionMessageBox("Unable to notify that data selection has changed", e);
+    }
+    catch (...) {
+        exceptionMessageBox("Unable to notify that data selection has changed");
+    }
+}
 
-        for (auto listener : eventListeners)
-            if (std::find(_eventListeners.begin(), _eventListeners.end(), listener) != _eventListeners.end())
-                callListenerDataEvent(listener, &dataSelectionChangedEvent);
+void EventManager::setSelectionPropagationRate(std::uint32_t selectionPropagationRate)
+{
+    if (selectionPropagationRate == _selectionPropagationRate)
+        return;
 
-        if (!dataset->isFull())
-            callNotifyDatasetSelectionChanged(dataset->getFullDataset<DatasetImpl>());
+    _selectionPropagationRate = selectionPropagationRate;
 
-        if (dataset->isProxy())
-            for (auto proxyMember : dataset->getProxyMembers())
-                callNotifyDatasetSelectionChanged(proxyMember->getSourceDataset<DatasetImpl>());
+    if (_selectionPropagationRate == 0)
+        flushSelectionChanges();
+}
+
+std::uint32_t EventManager::getSelectionPropagationRate() const
+{
+    return _selectionPropagationRate;
+}
 
-        for (auto candidateDataset : core()->requestAllDataSets()) {
+void EventManager::flushSelectionChanges()
+{
+    _selectionPropagationTimer.stop();
 
-            if (ignoreDatasets != nullptr && ignoreDatasets->contains(candidateDataset))
-                continue;
+    Datasets pendingSelectionChanges;
 
-            if (candidateDataset == dataset)
-                continue;
+    std::swap(pendingSelectionChanges, _pendingSelectionChanges);
 
-            if (candidateDataset->isDerivedData() && candidateDataset->getSourceDataset<DatasetImpl>()->getRawDataName() == dataset->getSourceDataset<DatasetImpl>()->getRawDataName())
-                callNotifyDatasetSelectionChanged(candidateDataset);
+    pendingSelectionChanges.removeIf([](const Dataset<DatasetImpl>& dataset) -> bool {
+        return !dataset.isValid();
+    });
 
-            if (candidateDataset->getRawDataName() == dataset->getRawDataName())
-                callNotifyDatasetSelectionChanged(candidateDataset);
+    _lastSelectionPropagation.restart();
 
-            if (candidateDataset->isProxy() && candidateDataset->getProxyMembers().contains(dataset))
-                callNotifyDatasetSelectionChanged(candidateDataset);
-        }
+    if (pendingSelectionChanges.isEmpty())
+        return;
 
-        for (const LinkedData& ld : dataset->getLinkedData())
-            callNotifyDatasetSelectionChanged(ld.getTargetDataset());
+    try {
+        propagateSelectionChanges(pendingSelectionChanges, nullptr);
     }
     catch (std::exception& e)
     {
@@ -210,6 +315,80 @@ void EventManager::notifyDatasetDataSelectionChanged(const Dataset<DatasetImpl>&
     }
 }
 
+void EventManager::propagateSelectionChanges(const Datasets& datasets, Datasets* ignoreDatasets)
+{
+    const auto notifyDatasets = getSelectionAffectedDatasets(datasets, ignoreDatasets);
+
+    if (ignoreDatasets != nullptr)
+        *ignoreDatasets << notifyDatasets;
+
+#ifdef EVENT_MANAGER_VERBOSE
+    QStringList notifyDatasetsString;
+
+    for (const auto& notifyDataset : notifyDatasets)
+        notifyDatasetsString << notifyDataset->getGuiName();
+
+    qDebug() << __FUNCTION__ << notifyDatasetsString;
+#endif
+
+    for (const auto& notifyDataset : notifyDatasets) {
+        notifyDataset->incrementSelectionGeneration();
+
+        DatasetDataSelectionChangedEvent dataSelectionChangedEvent(notifyDataset);
+
+        notifyEventListeners(&dataSelectionChangedEvent, notifyDataset.getDatasetId());
+    }
+}
+
+Datasets EventManager::getSelectionAffectedDatasets(const Datasets& datasets, const Datasets* ignoreDatasets) const
+{
+    Datasets affectedDatasets;
+    QSet<QString> visitedDatasetIds;
+
+    if (ignoreDatasets != nullptr)
+        for (const auto& ignoreDataset : *ignoreDatasets)
+            visitedDatasetIds << ignoreDataset.getDatasetId();
+
+    QQueue<Dataset<DatasetImpl>> queue;
+
+    const auto visit = [&affectedDatasets, &visitedDatasetIds, &queue](const Dataset<DatasetImpl>& dataset) -> void {
+        if (!dataset.isValid() || visitedDatasetIds.contains(dataset.getDatasetId()))
+            return;
+
+        visitedDatasetIds << dataset.getDatasetId();
+        affectedDatasets << dataset;
+        queue.enqueue(dataset);
+    };
+
+    const auto visitAll = [&visit](const Datasets& neighbours) -> void {
+        for (const auto& neighbour : neighbours)
+            visit(neighbour);
+    };
+
+    for (const auto& dataset : datasets)
+        visit(dataset);
+
+    while (!queue.isEmpty()) {
+        const auto dataset = queue.dequeue();
+
+        if (!dataset->isFull())
+            visit(dataset->getFullDataset<DatasetImpl>());
+
+        if (dataset->isProxy())
+            for (const auto& proxyMember : dataset->getProxyMembers())
+                visit(proxyMember->getSourceDataset<DatasetImpl>());
+
+        visitAll(mv::data().getDerivedDatasets(dataset->getSourceDataset<DatasetImpl>()->getRawDataName()));
+        visitAll(mv::data().getDatasetsByRawDataName(dataset->getRawDataName()));
+        visitAll(mv::data().getProxyDatasets(dataset));
+
+        for (const LinkedData& ld : dataset->getLinkedData())
+            visit(ld.getTargetDataset());
+    }
+
+    return affectedDatasets;
+}
+
 void EventManager::notifyDatasetLocked(const Dataset<DatasetImpl>& dataset)
 {
     try {
@@ -219,11 +398,7 @@ void EventManager::notifyDatasetLocked(const Dataset<DatasetImpl>& dataset)
 
         DatasetLockedEvent dataLockedEvent(dataset);
 
-        const auto eventListeners = _eventListeners;
-
-        for (auto listener : eventListeners)
-            if (std::find(_eventListeners.begin(), _eventListeners.end(), listener) != _eventListeners.end())
-                callListenerDataEvent(listener, &dataLockedEvent);
+        notifyEventListeners(&dataLockedEvent, dataset.getDatasetId());
     }
     catch (std::exception& e)
     {
@@ -243,11 +418,7 @@ void EventManager::notifyDatasetUnlocked(const Dataset<DatasetImpl>& dataset)
 
         DatasetUnlockedEvent dataUnlockedEvent(dataset);
 
-        const auto eventListeners = _eventListeners;
-
-        for (auto listener : eventListeners)
-            if (std::find(_eventListeners.begin(), _eventListeners.end(), listener) != _eventListeners.end())
-                callListenerDataEvent(listener, &dataUnlockedEvent);
+        notifyEventListeners(&dataUnlockedEvent, dataset.getDatasetId());
     }
     catch (std::exception& e)
     {
@@ -275,7 +446,15 @@ void EventManager::initialize()
 
 void EventManager::reset()
 {
+    _selectionPropagationTimer.stop();
+    _pendingSelectionChanges.clear();
     _eventListeners.clear();
+
+    if (_dispatchDepth == 0)
+        _datasetEventListeners.clear();
+    else
+        for (auto& datasetEventListeners : _datasetEventListeners)
+            datasetEventListeners.second.clear();
 }
 
 }
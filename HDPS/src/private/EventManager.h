@@ -7,6 +7,13 @@
 #include "AbstractEventManager.h"
 
 #include <event/EventListener.h>
+#include <util/ListenerSlotMap.h>
+
+#include <QElapsedTimer>
+#include <QSet>
+#include <QTimer>
+
+#include <unordered_map>
 
 namespace mv
 {
@@ -58,12 +65,29 @@ public:
     void notifyDatasetDataDimensionsChanged(const Dataset<DatasetImpl>& dataset) override;
 
     /**
-     * Notify listeners that dataset data selection has changed
+     * Notify listeners that dataset data selection has changed (the notification is postponed and coalesced with
+     * other selection changes, unless the selection propagation rate is zero or \p ignoreDatasets is specified)
      * @param dataset Smart pointer to the dataset of which the data selection changed
      * @param ignoreDatasets Pointer to datasets that should be ignored during notification
      */
     void notifyDatasetDataSelectionChanged(const Dataset<DatasetImpl>& dataset, Datasets* ignoreDatasets = nullptr) override;
 
+    /**
+     * Set the maximum rate at which dataset data selection changes are propagated to the listeners. Selection changes
+     * that occur in between two propagations are coalesced, so that each affected dataset gets one event per propagation.
+     * @param selectionPropagationRate Maximum number of propagations per second (zero propagates each selection change immediately)
+     */
+    void setSelectionPropagationRate(std::uint32_t selectionPropagationRate) override;
+
+    /**
+     * Get the maximum rate at which dataset data selection changes are propagated to the listeners
+     * @return Maximum number of propagations per second (zero when each selection change is propagated immediately)
+     */
+    std::uint32_t getSelectionPropagationRate() const override;
+
+    /** Propagates the pending (coalesced) dataset data selection changes immediately */
+    void flushSelectionChanges() override;
+
     /**
      * Notify all listeners that a dataset is locked
      * @param dataset Smart pointer to the dataset
@@ -77,19 +101,65 @@ public:
     void notifyDatasetUnlocked(const Dataset<DatasetImpl>& dataset) override;
 
     /**
-     * Register an event listener
+     * Register an event listener (in O(1), under each of its supported event types, and listeners that are
+     * restricted to a single dataset are indexed by dataset identifier)
      * @param eventListener Pointer to event listener to register
      */
     void registerEventListener(EventListener* eventListener) override;
 
     /**
-     * Unregister an event listener
+     * Unregister an event listener (in O(1), also while events are dispatched)
      * @param eventListener Pointer to event listener to unregister
      */
     void unregisterEventListener(EventListener* eventListener) override;
 
+    /**
+     * Updates the event type buckets of an event listener in place, so that it keeps its handle (and its place in a dispatch in progress)
+     * @param eventListener Pointer to event listener to update
+     * @param previousEventTypes Event types the listener supported before the change
+     */
+    void updateEventListener(EventListener* eventListener, const QSet<std::uint32_t>& previousEventTypes) override;
+
+private:
+
+    /** Registry of event listeners, bucketed by event type */
+    using EventListeners = util::ListenerSlotMap<EventListener>;
+
+    /**
+     * Calls the listeners that listen to all datasets and the listeners that are restricted to the dataset with \p datasetId,
+     * in as far as they support the type of \p dataEvent
+     * @param dataEvent Pointer to data event
+     * @param datasetId Globally unique identifier of the dataset the event is about (may be empty)
+     */
+    void notifyEventListeners(DatasetEvent* dataEvent, const QString& datasetId);
+
+    /**
+     * Notifies listeners of the selection change of \p datasets and of all datasets that share their selection
+     * @param datasets Datasets of which the data selection changed
+     * @param ignoreDatasets Pointer to datasets that should be ignored during notification (notified datasets are added)
+     */
+    void propagateSelectionChanges(const Datasets& datasets, Datasets* ignoreDatasets);
+
+    /**
+     * Get the datasets of which the selection is affected by the selection of \p datasets, computed in one pass over
+     * the dataset graph index of the data manager (full/subset, proxy, derived, raw data and linked data relations)
+     * @param datasets Datasets of which the data selection changed
+     * @param ignoreDatasets Pointer to datasets that are excluded (and not traversed), may be nullptr
+     * @return Affected datasets, including \p datasets, in breadth-first order
+     */
+    Datasets getSelectionAffectedDatasets(const Datasets& datasets, const Datasets* ignoreDatasets) const;
+
 private:
-    std::vector<EventListener*>     _eventListeners;        /** List of classes listening for core events */
+    static constexpr std::uint32_t DEFAULT_SELECTION_PROPAGATION_RATE = 0;      /** Propagate selection changes immediately by default, throttling is opt-in through setSelectionPropagationRate() */
+
+    EventListeners                                  _eventListeners;                /** Classes listening for core events */
+    std::unordered_map<QString, EventListeners>     _datasetEventListeners;         /** Listeners that are restricted to a single dataset, by dataset identifier */
+    QSet<QString>                                   _emptiedDatasetIds;             /** Datasets of which all listeners were unregistered during dispatch */
+    std::uint32_t                                   _dispatchDepth;                 /** Number of event notifications in progress */
+    std::uint32_t                                   _selectionPropagationRate;      /** Maximum number of selection propagations per second (zero for immediate propagation) */
+    Datasets                                        _pendingSelectionChanges;       /** Datasets of which the selection changed since the last propagation */
+    QTimer                                          _selectionPropagationTimer;     /** Timer that triggers the propagation of the pending selection changes */
+    QElapsedTimer                                   _lastSelectionPropagation;      /** Time since the last selection propagation */
 };
 
 }
@@ -16,6 +16,7 @@
 
 #include <util/Exception.h>
 #include <util/Serialization.h>
+#include <util/RawDataCodec.h>
 
 #include <Set.h>
 
@@ -667,6 +668,10 @@ void ProjectManager::saveProject(QString filePath /*= ""*/, const QString& passw
             QFileInfo projectJsonFileInfo(temporaryDirectoryPath, "project.json"), projectMetaJsonFileInfo(temporaryDirectoryPath, "meta.json");
 
             Application::setSerializationTemporaryDirectory(temporaryDirectoryPath);
+
+            // Only raw data that is saved as part of this project is encoded with the codec of the project
+            const Application::ScopedSerializationRawDataCodec scopedSerializationRawDataCodec(getRawDataCodec(_project->getCompressionAction().getRawDataCodecAction().getCurrentText()));
+
             Application::setSerializationAborted(false);
 
             projects().toJsonFile(projectJsonFileInfo.absoluteFilePath());
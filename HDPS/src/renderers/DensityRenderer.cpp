@@ -44,6 +44,16 @@ namespace mv
             _densityComputation.setSigma(sigma);
         }
 
+        void DensityRenderer::setResolution(std::uint32_t resolution)
+        {
+            _densityComputation.setResolution(resolution);
+        }
+
+        void DensityRenderer::setKernelSupport(float kernelSupport)
+        {
+            _densityComputation.setKernelSupport(kernelSupport);
+        }
+
         void DensityRenderer::computeDensity()
         {
             _densityComputation.compute();
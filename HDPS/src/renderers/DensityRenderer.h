@@ -36,6 +36,18 @@ namespace mv
             void setData(const std::vector<Vector2f>* data);
             void setBounds(const Bounds& bounds);
             void setSigma(const float sigma);
+
+            /**
+             * Sets the number of grid cells of the density map along each axis
+             * @param resolution Resolution of the density map
+             */
+            void setResolution(std::uint32_t resolution);
+
+            /**
+             * Sets half the width of the density kernel in standard deviations
+             * @param kernelSupport Kernel support
+             */
+            void setKernelSupport(float kernelSupport);
             void computeDensity();
             float getMaxDensity() const;
             Vector3f getColorMapRange() const;
@@ -4,7 +4,11 @@
 
 #include "PointRenderer.h"
 
+#include "../util/ScalarStatistics.h"
+
+#include <algorithm>
 #include <limits>
+#include <utility>
 
 #include <QDebug>
 
@@ -107,6 +111,17 @@ namespace mv
             _positions = positions;
 
             _dirtyPositions = true;
+
+            updateSpatialIndex();
+        }
+
+        void PointArrayObject::setPositions(std::vector<Vector2f>&& positions)
+        {
+            _positions = std::move(positions);
+
+            _dirtyPositions = true;
+
+            updateSpatialIndex();
         }
 
         void PointArrayObject::setHighlights(const std::vector<char>& highlights)
@@ -116,37 +131,74 @@ namespace mv
             _dirtyHighlights = true;
         }
 
-        void PointArrayObject::setScalars(const std::vector<float>& scalars, bool adjustColorMapRange)
+        void PointArrayObject::setHighlights(std::vector<char>&& highlights)
         {
-            if (adjustColorMapRange)
-            {
-                _colorScalarsRange.x = std::numeric_limits<float>::max();
-                _colorScalarsRange.y = -std::numeric_limits<float>::max();
+            _highlights = std::move(highlights);
 
-                // Determine scalar range
-                for (const float& scalar : scalars)
-                {
-                    if (scalar < _colorScalarsRange.x)
-                        _colorScalarsRange.x = scalar;
+            _dirtyHighlights = true;
+        }
 
-                    if (scalar > _colorScalarsRange.y)
-                        _colorScalarsRange.y = scalar;
-                }
+        void PointArrayObject::updateHighlights(const std::vector<std::uint32_t>& indices, char highlight)
+        {
+            // Without highlights there is nothing to update partially
+            if (_highlights.size() != _positions.size()) {
+                _highlights.resize(_positions.size(), 0);
+
+                _dirtyHighlights = true;
+            }
+
+            for (const auto& index : indices) {
+                Q_ASSERT(index < _highlights.size());
 
-                _colorScalarsRange.z = _colorScalarsRange.y - _colorScalarsRange.x;
+                _highlights[index] = highlight;
+            }
+
+            // A full upload is pending already
+            if (_dirtyHighlights)
+                return;
 
-                if (_colorScalarsRange.z < 1e-07)
-                    _colorScalarsRange.z = static_cast<float>(1e-07);
+            _dirtyHighlightIndices.insert(_dirtyHighlightIndices.end(), indices.begin(), indices.end());
+
+            // Re-upload everything when most of the highlights changed
+            if (_dirtyHighlightIndices.size() >= _highlights.size() / 2) {
+                _dirtyHighlightIndices.clear();
+
+                _dirtyHighlights = true;
             }
+        }
 
+        void PointArrayObject::setScalars(const std::vector<float>& scalars, bool adjustColorMapRange)
+        {
             _colorScalars = scalars;
 
+            if (adjustColorMapRange)
+                updateColorScalarsRange();
+
+            _dirtyColorScalars = true;
+        }
+
+        void PointArrayObject::setScalars(std::vector<float>&& scalars, bool adjustColorMapRange)
+        {
+            _colorScalars = std::move(scalars);
+
+            if (adjustColorMapRange)
+                updateColorScalarsRange();
+
             _dirtyColorScalars = true;
         }
 
         void PointArrayObject::setSizeScalars(const std::vector<float>& scalars)
         {
             _sizeScalars = scalars;
+            _maximumSizeScalar = _sizeScalars.empty() ? 0.0f : *std::max_element(_sizeScalars.begin(), _sizeScalars.end());
+
+            _dirtySizeScalars = true;
+        }
+
+        void PointArrayObject::setSizeScalars(std::vector<float>&& scalars)
+        {
+            _sizeScalars = std::move(scalars);
+            _maximumSizeScalar = _sizeScalars.empty() ? 0.0f : *std::max_element(_sizeScalars.begin(), _sizeScalars.end());
 
             _dirtySizeScalars = true;
         }
@@ -158,6 +210,13 @@ namespace mv
             _dirtyOpacityScalars = true;
         }
 
+        void PointArrayObject::setOpacityScalars(std::vector<float>&& scalars)
+        {
+            _opacityScalars = std::move(scalars);
+
+            _dirtyOpacityScalars = true;
+        }
+
         void PointArrayObject::setColors(const std::vector<Vector3f>& colors)
         {
             _colors = colors;
@@ -165,6 +224,175 @@ namespace mv
             _dirtyColors = true;
         }
 
+        void PointArrayObject::setColors(std::vector<Vector3f>&& colors)
+        {
+            _colors = std::move(colors);
+
+            _dirtyColors = true;
+        }
+
+        void PointArrayObject::setLevelOfDetailEnabled(bool levelOfDetailEnabled)
+        {
+            if (levelOfDetailEnabled == _levelOfDetailEnabled)
+                return;
+
+            _levelOfDetailEnabled = levelOfDetailEnabled;
+
+            updateSpatialIndex();
+        }
+
+        void PointArrayObject::updateVisibility(const Bounds& visibleBounds, std::uint64_t maximumNumberOfPoints)
+        {
+            _visibleRanges.clear();
+
+            if (!isLevelOfDetailActive())
+                return;
+
+            const auto numberOfPointsPerLevel = _spatialIndex.getNumberOfPointsPerLevel(visibleBounds);
+
+            // Add levels of detail as long as the points fit in the budget
+            std::uint32_t maximumLevel      = 0;
+            std::uint64_t numberOfPoints    = numberOfPointsPerLevel[0];
+
+            while (maximumLevel + 1 < _spatialIndex.getNumberOfLevels() && numberOfPoints + numberOfPointsPerLevel[maximumLevel + 1] <= maximumNumberOfPoints)
+                numberOfPoints += numberOfPointsPerLevel[++maximumLevel];
+
+            _visibleRanges = _spatialIndex.getRanges(visibleBounds, maximumLevel);
+        }
+
+        std::uint64_t PointArrayObject::getNumberOfDrawnPoints() const
+        {
+            if (!isLevelOfDetailActive())
+                return _positions.size();
+
+            std::uint64_t numberOfDrawnPoints = 0;
+
+            for (const auto& [begin, end] : _visibleRanges)
+                numberOfDrawnPoints += end - begin;
+
+            return numberOfDrawnPoints;
+        }
+
+        void PointArrayObject::updateSpatialIndex()
+        {
+            if (!_levelOfDetailEnabled && !_spatialIndex.isValid())
+                return;
+
+            if (_levelOfDetailEnabled)
+                _spatialIndex.build(_positions);
+            else
+                _spatialIndex.clear();
+
+            _visibleRanges.clear();
+
+            // The order of the points in the buffers changed, so upload all point attributes again
+            _dirtyPositions         = true;
+            _dirtyHighlights        = _dirtyHighlights || !_highlights.empty();
+            _dirtyColorScalars      = _dirtyColorScalars || !_colorScalars.empty();
+            _dirtySizeScalars       = _dirtySizeScalars || !_sizeScalars.empty();
+            _dirtyOpacityScalars    = _dirtyOpacityScalars || !_opacityScalars.empty();
+            _dirtyColors            = _dirtyColors || !_colors.empty();
+
+            _dirtyHighlightIndices.clear();
+        }
+
+        template<typename T>
+        void PointArrayObject::uploadAttribute(BufferObject& buffer, const std::vector<T>& values, GLenum usage /*= GL_STATIC_DRAW*/)
+        {
+            buffer.bind();
+
+            if (isLevelOfDetailActive() && values.size() == _positions.size())
+                buffer.setData(_spatialIndex.reorder(values), usage);
+            else
+                buffer.setData(values, usage);
+        }
+
+        void PointArrayObject::setFirstInstance(std::uint32_t firstInstance)
+        {
+            const auto getOffset = [firstInstance](std::size_t elementSize) -> const void* {
+                return reinterpret_cast<const void*>(firstInstance * elementSize);
+            };
+
+            _positionBuffer.bind();
+            glVertexAttribPointer(ATTRIBUTE_POSITIONS, 2, GL_FLOAT, GL_FALSE, 0, getOffset(2 * sizeof(float)));
+
+            _highlightBuffer.bind();
+            glVertexAttribIPointer(ATTRIBUTE_HIGHLIGHTS, 1, GL_BYTE, 0, getOffset(sizeof(char)));
+
+            _colorBuffer.bind();
+            glVertexAttribPointer(ATTRIBUTE_COLORS, 3, GL_FLOAT, GL_FALSE, 0, getOffset(3 * sizeof(float)));
+
+            _colorScalarBuffer.bind();
+            glVertexAttribPointer(ATTRIBUTE_SCALARS_COLOR, 1, GL_FLOAT, GL_FALSE, 0, getOffset(sizeof(float)));
+
+            _sizeScalarBuffer.bind();
+            glVertexAttribPointer(ATTRIBUTE_SCALARS_SIZE, 1, GL_FLOAT, GL_FALSE, 0, getOffset(sizeof(float)));
+
+            _opacityScalarBuffer.bind();
+            glVertexAttribPointer(ATTRIBUTE_SCALARS_OPACITY, 1, GL_FLOAT, GL_FALSE, 0, getOffset(sizeof(float)));
+        }
+
+        void PointArrayObject::updateColorScalarsRange()
+        {
+            // Determine scalar range (vectorized and multithreaded)
+            const auto statistics = util::computeScalarStatistics(_colorScalars.data(), _colorScalars.size());
+
+            _colorScalarsRange.x = statistics.minimum;
+            _colorScalarsRange.y = statistics.maximum;
+            _colorScalarsRange.z = _colorScalarsRange.y - _colorScalarsRange.x;
+
+            if (_colorScalarsRange.z < 1e-07)
+                _colorScalarsRange.z = static_cast<float>(1e-07);
+        }
+
+        void PointArrayObject::uploadDirtyHighlights()
+        {
+            if (_dirtyHighlightIndices.empty())
+                return;
+
+            const auto levelOfDetailActive = isLevelOfDetailActive();
+
+            // The highlight buffer is in spatial index order in level-of-detail mode
+            if (levelOfDetailActive)
+                for (auto& index : _dirtyHighlightIndices)
+                    index = _spatialIndex.getInverseOrder()[index];
+
+            std::sort(_dirtyHighlightIndices.begin(), _dirtyHighlightIndices.end());
+
+            // Merge the dirty indices into half-open ranges, bridging small gaps
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> dirtyRanges;
+
+            for (const auto& index : _dirtyHighlightIndices) {
+                if (!dirtyRanges.empty() && index <= dirtyRanges.back().second + MAXIMUM_DIRTY_RANGE_GAP)
+                    dirtyRanges.back().second = std::max(dirtyRanges.back().second, index + 1);
+                else
+                    dirtyRanges.emplace_back(index, index + 1);
+            }
+
+            if (dirtyRanges.size() > MAXIMUM_NUMBER_OF_DIRTY_RANGES)
+                dirtyRanges = { { dirtyRanges.front().first, dirtyRanges.back().second } };
+
+            _highlightBuffer.bind();
+
+            std::vector<char> reorderedHighlights;
+
+            for (const auto& [begin, end] : dirtyRanges) {
+                if (levelOfDetailActive) {
+                    reorderedHighlights.resize(end - begin);
+
+                    for (auto position = begin; position < end; ++position)
+                        reorderedHighlights[position - begin] = _highlights[_spatialIndex.getOrder()[position]];
+
+                    _highlightBuffer.setSubData(reorderedHighlights.data(), begin, end - begin);
+                }
+                else {
+                    _highlightBuffer.setSubData(_highlights, begin, end - begin);
+                }
+            }
+
+            _dirtyHighlightIndices.clear();
+        }
+
         void PointArrayObject::enableAttribute(uint index, bool enable)
         {
             glBindVertexArray(_handle);
@@ -180,26 +408,29 @@ namespace mv
 
             if (_dirtyPositions)
             {
-                _positionBuffer.bind();
-                _positionBuffer.setData(_positions);
+                uploadAttribute(_positionBuffer, _positions);
 
                 _dirtyPositions = false;
             }
 
             if (_dirtyHighlights)
             {
-                _highlightBuffer.bind();
-                _highlightBuffer.setData(_highlights);
+                uploadAttribute(_highlightBuffer, _highlights, GL_DYNAMIC_DRAW);
 
                 enableAttribute(ATTRIBUTE_HIGHLIGHTS, true);
 
                 _dirtyHighlights = false;
+
+                _dirtyHighlightIndices.clear();
+            }
+            else
+            {
+                uploadDirtyHighlights();
             }
 
             if (_dirtyColors)
             {
-                _colorBuffer.bind();
-                _colorBuffer.setData(_colors);
+                uploadAttribute(_colorBuffer, _colors);
                 enableAttribute(ATTRIBUTE_COLORS, true);
 
                 _dirtyColors = false;
@@ -207,8 +438,7 @@ namespace mv
 
             if (_dirtyColorScalars)
             {
-                _colorScalarBuffer.bind();
-                _colorScalarBuffer.setData(_colorScalars);
+                uploadAttribute(_colorScalarBuffer, _colorScalars);
 
                 enableAttribute(ATTRIBUTE_SCALARS_COLOR, true);
 
@@ -218,8 +448,7 @@ namespace mv
             
             if (_dirtySizeScalars)
             {
-                _sizeScalarBuffer.bind();
-                _sizeScalarBuffer.setData(_sizeScalars);
+                uploadAttribute(_sizeScalarBuffer, _sizeScalars);
 
                 enableAttribute(ATTRIBUTE_SCALARS_SIZE, true);
 
@@ -228,8 +457,7 @@ namespace mv
 
             if (_dirtyOpacityScalars)
             {
-                _opacityScalarBuffer.bind();
-                _opacityScalarBuffer.setData(_opacityScalars);
+                uploadAttribute(_opacityScalarBuffer, _opacityScalars);
 
                 enableAttribute(ATTRIBUTE_SCALARS_OPACITY, true);
 
@@ -241,7 +469,21 @@ namespace mv
             // "Fix issue #34: Crash when opening scatterplot plugin", March 2020.
             if (!_positions.empty())
             {
-                glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei) _positions.size());
+                if (isLevelOfDetailActive())
+                {
+                    for (const auto& [begin, end] : _visibleRanges)
+                    {
+                        setFirstInstance(begin);
+                        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei) (end - begin));
+                    }
+
+                    if (!_visibleRanges.empty())
+                        setFirstInstance(0);
+                }
+                else
+                {
+                    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei) _positions.size());
+                }
             }
             glBindVertexArray(0);
         }
@@ -257,6 +499,11 @@ namespace mv
             _gpuPoints.setPositions(positions);
         }
 
+        void PointRenderer::setData(std::vector<Vector2f>&& positions)
+        {
+            _gpuPoints.setPositions(std::move(positions));
+        }
+
         void PointRenderer::setHighlights(const std::vector<char>& highlights, const std::int32_t& numSelectedPoints)
         {
             _gpuPoints.setHighlights(highlights);
@@ -264,26 +511,60 @@ namespace mv
             _numSelectedPoints = numSelectedPoints;
         }
 
+        void PointRenderer::setHighlights(std::vector<char>&& highlights, const std::int32_t& numSelectedPoints)
+        {
+            _gpuPoints.setHighlights(std::move(highlights));
+
+            _numSelectedPoints = numSelectedPoints;
+        }
+
+        void PointRenderer::updateHighlights(const std::vector<std::uint32_t>& indices, char highlight, const std::int32_t& numSelectedPoints)
+        {
+            _gpuPoints.updateHighlights(indices, highlight);
+
+            _numSelectedPoints = numSelectedPoints;
+        }
+
         void PointRenderer::setColorChannelScalars(const std::vector<float>& scalars, bool adjustColorMapRange)
         {
             _gpuPoints.setScalars(scalars, adjustColorMapRange);
         }
 
+        void PointRenderer::setColorChannelScalars(std::vector<float>&& scalars, bool adjustColorMapRange)
+        {
+            _gpuPoints.setScalars(std::move(scalars), adjustColorMapRange);
+        }
+
         void PointRenderer::setSizeChannelScalars(const std::vector<float>& scalars)
         {
             _gpuPoints.setSizeScalars(scalars);
         }
 
+        void PointRenderer::setSizeChannelScalars(std::vector<float>&& scalars)
+        {
+            _gpuPoints.setSizeScalars(std::move(scalars));
+        }
+
         void PointRenderer::setOpacityChannelScalars(const std::vector<float>& scalars)
         {
             _gpuPoints.setOpacityScalars(scalars);
         }
 
+        void PointRenderer::setOpacityChannelScalars(std::vector<float>&& scalars)
+        {
+            _gpuPoints.setOpacityScalars(std::move(scalars));
+        }
+
         void PointRenderer::setColors(const std::vector<Vector3f>& colors)
         {
             _gpuPoints.setColors(colors);
         }
 
+        void PointRenderer::setColors(std::vector<Vector3f>&& colors)
+        {
+            _gpuPoints.setColors(std::move(colors));
+        }
+
         void PointRenderer::setScalarEffect(const PointEffect effect)
         {
             _pointEffect = effect;
@@ -376,12 +657,34 @@ namespace mv
             _selectionHaloEnabled = selectionHaloEnabled;
         }
 
+        bool PointRenderer::isLevelOfDetailEnabled() const
+        {
+            return _gpuPoints.isLevelOfDetailEnabled();
+        }
+
+        void PointRenderer::setLevelOfDetailEnabled(bool levelOfDetailEnabled)
+        {
+            _gpuPoints.setLevelOfDetailEnabled(levelOfDetailEnabled);
+        }
+
+        float PointRenderer::getFrameTimeBudget() const
+        {
+            return _frameTimeBudget;
+        }
+
+        void PointRenderer::setFrameTimeBudget(float frameTimeBudget)
+        {
+            _frameTimeBudget = std::max(frameTimeBudget, 0.0f);
+        }
+
         void PointRenderer::init()
         {
             initializeOpenGLFunctions();
 
             _gpuPoints.init();
 
+            glGenQueries(1, &_timerQuery);
+
             bool loaded = true;
             loaded &= _shader.loadShaderFromFile(":shaders/PointPlot.vert", ":shaders/PointPlot.frag");
 
@@ -445,12 +748,62 @@ namespace mv
                 _shader.uniform1i("colormap", 0);
             }
 
+            // Update the point drawing throughput once the GPU time of an earlier frame is available
+            if (_timerQueryPending)
+            {
+                GLint resultAvailable = 0;
+
+                glGetQueryObjectiv(_timerQuery, GL_QUERY_RESULT_AVAILABLE, &resultAvailable);
+
+                if (resultAvailable)
+                {
+                    GLuint64 elapsedNanoseconds = 0;
+
+                    glGetQueryObjectui64v(_timerQuery, GL_QUERY_RESULT, &elapsedNanoseconds);
+
+                    if (elapsedNanoseconds > 0 && _numberOfTimedPoints > 0)
+                        _pointsPerMillisecond = 0.8 * _pointsPerMillisecond + 0.2 * (_numberOfTimedPoints / (elapsedNanoseconds / 1e6));
+
+                    _timerQueryPending = false;
+                }
+            }
+
+            const auto useFrameTimeBudget = _gpuPoints.isLevelOfDetailEnabled() && _frameTimeBudget > 0;
+
+            if (_gpuPoints.isLevelOfDetailEnabled())
+            {
+                // Include the points of which the quads overlap with the bounds
+                const auto maximumPointSize = (_gpuPoints.hasSizeScalars() ? _gpuPoints.getMaximumSizeScalar() : _pointSettings._pointSize) * std::max(_selectionOutlineScale, 1.0f);
+                const auto margin           = maximumPointSize / size * std::max(_bounds.getWidth(), _bounds.getHeight()) / 2.0f;
+
+                const Bounds visibleBounds(_bounds.getLeft() - margin, _bounds.getRight() + margin, _bounds.getBottom() - margin, _bounds.getTop() + margin);
+
+                _gpuPoints.updateVisibility(visibleBounds, useFrameTimeBudget ? static_cast<std::uint64_t>(_frameTimeBudget * _pointsPerMillisecond) : std::numeric_limits<std::uint64_t>::max());
+            }
+
+            const auto timeDrawing = useFrameTimeBudget && !_timerQueryPending;
+
+            if (timeDrawing)
+                glBeginQuery(GL_TIME_ELAPSED, _timerQuery);
+
             _gpuPoints.draw();
+
+            if (timeDrawing)
+            {
+                glEndQuery(GL_TIME_ELAPSED);
+
+                _timerQueryPending      = true;
+                _numberOfTimedPoints    = _gpuPoints.getNumberOfDrawnPoints();
+            }
         }
 
         void PointRenderer::destroy()
         {
             _gpuPoints.destroy();
+
+            glDeleteQueries(1, &_timerQuery);
+
+            _timerQueryPending = false;
         }
 
         mv::Vector3f PointRenderer::getColorMapRange() const
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Renderer.h"
+#include "PointSpatialIndex.h"
 
 #include "../graphics/BufferObject.h"
 #include "../graphics/Vector2f.h"
@@ -15,6 +16,9 @@
 
 #include <QRectF>
 
+#include <cstdint>
+#include <vector>
+
 namespace mv
 {
     namespace gui
@@ -46,11 +50,45 @@ namespace mv
             PointArrayObject() : _handle(0), _colorScalarsRange(0, 1, 1) {}
             void init();
             void setPositions(const std::vector<Vector2f>& positions);
+            void setPositions(std::vector<Vector2f>&& positions);
             void setHighlights(const std::vector<char>& highlights);
+            void setHighlights(std::vector<char>&& highlights);
             void setScalars(const std::vector<float>& scalars, bool adjustColorMapRange);
+            void setScalars(std::vector<float>&& scalars, bool adjustColorMapRange);
             void setSizeScalars(const std::vector<float>& scalars);
+            void setSizeScalars(std::vector<float>&& scalars);
             void setOpacityScalars(const std::vector<float>& scalars);
+            void setOpacityScalars(std::vector<float>&& scalars);
             void setColors(const std::vector<Vector3f>& colors);
+            void setColors(std::vector<Vector3f>&& colors);
+
+            /**
+             * Sets the highlight of the points with \p indices to \p highlight, only the changed
+             * ranges of the highlight buffer are uploaded on the next draw
+             * @param indices Indices of the points of which the highlight changed
+             * @param highlight Highlight value (zero for not highlighted)
+             */
+            void updateHighlights(const std::vector<std::uint32_t>& indices, char highlight);
+
+            /**
+             * Sets whether to draw the points through a level-of-detail spatial index, which culls the
+             * points outside the visible bounds and thins out the points when there are too many to draw
+             * @param levelOfDetailEnabled Boolean determining whether level-of-detail drawing is enabled
+             */
+            void setLevelOfDetailEnabled(bool levelOfDetailEnabled);
+
+            bool isLevelOfDetailEnabled() const { return _levelOfDetailEnabled; }
+
+            /**
+             * Selects the points that are drawn next in level-of-detail mode: all points of the levels of
+             * detail inside \p visibleBounds, up to the most detailed level with at most \p maximumNumberOfPoints
+             * @param visibleBounds Bounds of the visible data space (including a margin for the point size)
+             * @param maximumNumberOfPoints Point budget (at least the coarsest level of detail is drawn)
+             */
+            void updateVisibility(const Bounds& visibleBounds, std::uint64_t maximumNumberOfPoints);
+
+            /** Get the number of points that are drawn */
+            std::uint64_t getNumberOfDrawnPoints() const;
 
             void enableAttribute(uint index, bool enable);
 
@@ -60,6 +98,9 @@ namespace mv
             bool hasOpacityScalars() const { return !_opacityScalars.empty(); }
             bool hasColors() const { return !_colors.empty(); }
 
+            /** Get the largest point size scalar (zero when there are no size scalars) */
+            float getMaximumSizeScalar() const { return _maximumSizeScalar; }
+
             Vector3f getColorMapRange() const {
                 return _colorScalarsRange;
             }
@@ -73,6 +114,35 @@ namespace mv
 
         private:
 
+            /** Computes the range of the point color scalars */
+            void updateColorScalarsRange();
+
+            /** Uploads the changed ranges of the highlight buffer and clears the dirty highlight indices */
+            void uploadDirtyHighlights();
+
+            /** Get whether the points are drawn through the spatial index */
+            bool isLevelOfDetailActive() const {
+                return _levelOfDetailEnabled && _spatialIndex.isValid() && _spatialIndex.getNumberOfPoints() == _positions.size();
+            }
+
+            /** (Re)builds the spatial index when level-of-detail drawing is enabled, and marks the point attributes for upload in the new order */
+            void updateSpatialIndex();
+
+            /**
+             * Uploads \p values to \p buffer, in spatial index order when level-of-detail drawing is active
+             * @param buffer Buffer object
+             * @param values Point attribute values
+             * @param usage Usage hint
+             */
+            template<typename T>
+            void uploadAttribute(BufferObject& buffer, const std::vector<T>& values, GLenum usage = GL_STATIC_DRAW);
+
+            /**
+             * Makes the instanced attributes start at instance \p firstInstance (OpenGL 3.3 has no base instance)
+             * @param firstInstance Index of the first instance in the attribute buffers
+             */
+            void setFirstInstance(std::uint32_t firstInstance);
+
             /** Vertex array indices */
             const uint ATTRIBUTE_VERTICES           = 0;
             const uint ATTRIBUTE_POSITIONS          = 1;
@@ -91,6 +161,7 @@ namespace mv
             std::vector<float>  _colorScalars;      /** Point color scalar channel */
             std::vector<float>  _sizeScalars;       /** Point size scalar channel */
             std::vector<float>  _opacityScalars;    /** Point opacity scalar channel */
+            float               _maximumSizeScalar = 0.0f;  /** Largest point size scalar */
 
             /** Scalar ranges */
             Vector3f    _colorScalarsRange;     /** Scalar range of the point color scalars */
@@ -101,6 +172,17 @@ namespace mv
             bool _dirtySizeScalars      = false;
             bool _dirtyOpacityScalars   = false;
             bool _dirtyColors           = false;
+
+            bool                                    _levelOfDetailEnabled = false;  /** Whether points are drawn through the spatial index */
+            PointSpatialIndex                       _spatialIndex;                  /** Level-of-detail spatial index of the positions */
+            std::vector<PointSpatialIndex::Range>   _visibleRanges;                 /** Ranges of the spatial index order that are drawn in level-of-detail mode */
+            std::vector<std::uint32_t>              _dirtyHighlightIndices;         /** Indices of highlights that changed since the last upload (only used when the highlights are not entirely dirty) */
+
+            /** Dirty highlights that are less than this number of elements apart are uploaded as one range */
+            static constexpr std::uint32_t MAXIMUM_DIRTY_RANGE_GAP = 4096;
+
+            /** The dirty highlight ranges are merged into a single range when there are more than this number of them */
+            static constexpr std::uint32_t MAXIMUM_NUMBER_OF_DIRTY_RANGES = 64;
         };
 
         struct PointSettings
@@ -119,11 +201,18 @@ namespace mv
         {
         public:
             void setData(const std::vector<Vector2f>& points);
+            void setData(std::vector<Vector2f>&& points);
             void setHighlights(const std::vector<char>& highlights, const std::int32_t& numSelectedPoints);
+            void setHighlights(std::vector<char>&& highlights, const std::int32_t& numSelectedPoints);
+            void updateHighlights(const std::vector<std::uint32_t>& indices, char highlight, const std::int32_t& numSelectedPoints);
             void setColorChannelScalars(const std::vector<float>& scalars, bool adjustColorMapRange = true);
+            void setColorChannelScalars(std::vector<float>&& scalars, bool adjustColorMapRange = true);
             void setSizeChannelScalars(const std::vector<float>& scalars);
+            void setSizeChannelScalars(std::vector<float>&& scalars);
             void setOpacityChannelScalars(const std::vector<float>& scalars);
+            void setOpacityChannelScalars(std::vector<float>&& scalars);
             void setColors(const std::vector<Vector3f>& colors);
+            void setColors(std::vector<Vector3f>&& colors);
 
             void setScalarEffect(const PointEffect effect);
             void setColormap(const QImage& image);
@@ -146,6 +235,22 @@ namespace mv
             bool getSelectionHaloEnabled() const;
             void setSelectionHaloEnabled(float selectionHaloEnabled);
 
+            bool isLevelOfDetailEnabled() const;
+            void setLevelOfDetailEnabled(bool levelOfDetailEnabled);
+
+            /**
+             * Get the frame time budget in level-of-detail mode
+             * @return Frame time budget in milliseconds (zero when the points are never thinned out)
+             */
+            float getFrameTimeBudget() const;
+
+            /**
+             * Sets the frame time budget in level-of-detail mode: the number of drawn points is limited
+             * to the number the GPU can draw within \p frameTimeBudget (as measured in previous frames)
+             * @param frameTimeBudget Frame time budget in milliseconds (zero to never thin out the points)
+             */
+            void setFrameTimeBudget(float frameTimeBudget);
+
             void init() override;
             void resize(QSize renderSize) override;
             void render() override;
@@ -179,6 +284,16 @@ namespace mv
             Bounds                      _bounds                             = Bounds(-1, 1, -1, 1);
 
             std::int32_t                _numSelectedPoints                  = 0;     /** Number of selected (highlighted points) */
+
+            /* Level-of-detail */
+            float                       _frameTimeBudget                    = 0.0f;     /** Frame time budget in milliseconds (zero for no budget) */
+            double                      _pointsPerMillisecond               = DEFAULT_POINTS_PER_MILLISECOND;   /** Measured point drawing throughput */
+            GLuint                      _timerQuery                         = 0;        /** Query for the GPU time of drawing the points */
+            bool                        _timerQueryPending                  = false;    /** Whether the result of the timer query is pending */
+            std::uint64_t               _numberOfTimedPoints                = 0;        /** Number of points drawn in the pending timer query */
+
+        public:
+            static constexpr double     DEFAULT_POINTS_PER_MILLISECOND      = 100000.0; /** Point drawing throughput that is assumed until it is measured */
         };
 
     } // namespace gui
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "PointSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mv
+{
+    namespace gui
+    {
+        namespace
+        {
+            /**
+             * Get the level of detail of the point with \p rank within its grid cell: the first point
+             * of a cell is at level 0 and level l > 0 holds the points with rank in [4^(l-1), 4^l)
+             */
+            std::uint32_t getLevel(std::uint32_t rank)
+            {
+                if (rank == 0)
+                    return 0;
+
+                std::uint32_t log2Rank = 0;
+
+                while (rank >>= 1)
+                    ++log2Rank;
+
+                return std::min(log2Rank / 2 + 1, PointSpatialIndex::NUMBER_OF_LEVELS - 1);
+            }
+
+            /** Get the grid cell coordinate of \p value in [minimum, minimum + extent) on a grid of \p gridSize cells */
+            std::uint32_t getCellCoordinate(float value, float minimum, float extent, std::uint32_t gridSize)
+            {
+                const auto cellCoordinate = std::floor((value - minimum) / extent * gridSize);
+
+                if (!(cellCoordinate > 0))
+                    return 0;
+
+                return static_cast<std::uint32_t>(std::min(cellCoordinate, static_cast<float>(gridSize - 1)));
+            }
+        }
+
+        void PointSpatialIndex::build(const std::vector<Vector2f>& positions)
+        {
+            clear();
+
+            if (positions.empty())
+                return;
+
+            const auto numberOfPoints = static_cast<std::uint32_t>(positions.size());
+
+            // Determine the bounds of the finite positions (the others are not drawn anyway and end up in the first cell)
+            auto left   = std::numeric_limits<float>::max();
+            auto right  = -std::numeric_limits<float>::max();
+            auto bottom = std::numeric_limits<float>::max();
+            auto top    = -std::numeric_limits<float>::max();
+
+            for (const auto& position : positions) {
+                if (!std::isfinite(position.x) || !std::isfinite(position.y))
+                    continue;
+
+                left    = std::min(left, position.x);
+                right   = std::max(right, position.x);
+                bottom  = std::min(bottom, position.y);
+                top     = std::max(top, position.y);
+            }
+
+            if (left > right)
+                left = right = bottom = top = 0;
+
+            _bounds     = Bounds(left, right, bottom, top);
+            _gridSize   = std::clamp(static_cast<std::uint32_t>(std::ceil(std::sqrt(numberOfPoints / static_cast<double>(TARGET_POINTS_PER_CELL)))), 1u, MAXIMUM_GRID_SIZE);
+
+            const auto numberOfCells    = static_cast<std::size_t>(_gridSize) * _gridSize;
+            const auto width            = std::max(_bounds.getWidth(), std::numeric_limits<float>::min());
+            const auto height           = std::max(_bounds.getHeight(), std::numeric_limits<float>::min());
+
+            // Compute the key (level, row, column) of each point and count the points per key
+            std::vector<std::uint32_t> keys(numberOfPoints), numberOfPointsPerCell(numberOfCells, 0);
+
+            _offsets.assign(NUMBER_OF_LEVELS * numberOfCells + 1, 0);
+
+            for (std::uint32_t pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex) {
+                const auto& position    = positions[pointIndex];
+                const auto column       = getCellCoordinate(position.x, left, width, _gridSize);
+                const auto row          = getCellCoordinate(position.y, bottom, height, _gridSize);
+                const auto cell         = static_cast<std::size_t>(row) * _gridSize + column;
+                const auto key          = static_cast<std::uint32_t>(getLevel(numberOfPointsPerCell[cell]++) * numberOfCells + cell);
+
+                keys[pointIndex] = key;
+
+                ++_offsets[key + 1];
+            }
+
+            for (std::size_t key = 1; key < _offsets.size(); ++key)
+                _offsets[key] += _offsets[key - 1];
+
+            // Counting sort of the points by key (stable, so points keep their relative order within a cell)
+            _order.resize(numberOfPoints);
+            _inverseOrder.resize(numberOfPoints);
+
+            auto nextPositions = std::vector<std::uint32_t>(_offsets.begin(), _offsets.end() - 1);
+
+            for (std::uint32_t pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex) {
+                const auto position = nextPositions[keys[pointIndex]]++;
+
+                _order[position]            = pointIndex;
+                _inverseOrder[pointIndex]   = position;
+            }
+        }
+
+        void PointSpatialIndex::clear()
+        {
+            _gridSize = 0;
+
+            _order.clear();
+            _inverseOrder.clear();
+            _offsets.clear();
+        }
+
+        std::vector<std::uint64_t> PointSpatialIndex::getNumberOfPointsPerLevel(const Bounds& bounds) const
+        {
+            std::vector<std::uint64_t> numberOfPointsPerLevel(NUMBER_OF_LEVELS, 0);
+
+            CellRange columns, rows;
+
+            if (!getCellRanges(bounds, columns, rows))
+                return numberOfPointsPerLevel;
+
+            for (std::uint32_t level = 0; level < NUMBER_OF_LEVELS; ++level)
+                for (auto row = rows.first; row <= rows.second; ++row)
+                    numberOfPointsPerLevel[level] += getOffset(level, row, columns.second + 1) - getOffset(level, row, columns.first);
+
+            return numberOfPointsPerLevel;
+        }
+
+        std::vector<PointSpatialIndex::Range> PointSpatialIndex::getRanges(const Bounds& bounds, std::uint32_t maximumLevel) const
+        {
+            std::vector<Range> ranges;
+
+            CellRange columns, rows;
+
+            if (!getCellRanges(bounds, columns, rows))
+                return ranges;
+
+            for (std::uint32_t level = 0; level <= std::min(maximumLevel, NUMBER_OF_LEVELS - 1); ++level) {
+                for (auto row = rows.first; row <= rows.second; ++row) {
+                    const auto begin    = getOffset(level, row, columns.first);
+                    const auto end      = getOffset(level, row, columns.second + 1);
+
+                    if (begin == end)
+                        continue;
+
+                    // Ranges of consecutive rows (and levels) are adjacent when all columns are inside the bounds
+                    if (!ranges.empty() && ranges.back().second == begin)
+                        ranges.back().second = end;
+                    else
+                        ranges.emplace_back(begin, end);
+                }
+            }
+
+            return ranges;
+        }
+
+        bool PointSpatialIndex::getCellRanges(const Bounds& bounds, CellRange& columns, CellRange& rows) const
+        {
+            if (!isValid())
+                return false;
+
+            if (bounds.getRight() < _bounds.getLeft() || bounds.getLeft() > _bounds.getRight() || bounds.getTop() < _bounds.getBottom() || bounds.getBottom() > _bounds.getTop())
+                return false;
+
+            const auto width    = std::max(_bounds.getWidth(), std::numeric_limits<float>::min());
+            const auto height   = std::max(_bounds.getHeight(), std::numeric_limits<float>::min());
+
+            columns = { getCellCoordinate(bounds.getLeft(), _bounds.getLeft(), width, _gridSize), getCellCoordinate(bounds.getRight(), _bounds.getLeft(), width, _gridSize) };
+            rows    = { getCellCoordinate(bounds.getBottom(), _bounds.getBottom(), height, _gridSize), getCellCoordinate(bounds.getTop(), _bounds.getBottom(), height, _gridSize) };
+
+            return true;
+        }
+
+    } // namespace gui
+
+} // namespace mv
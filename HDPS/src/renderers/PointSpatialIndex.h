@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#pragma once
+
+#include "../graphics/Bounds.h"
+#include "../graphics/Vector2f.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mv
+{
+    namespace gui
+    {
+        /**
+         * Point spatial index class
+         *
+         * Level-of-detail index of 2D points for the point renderer. The points are binned in a
+         * uniform grid over their bounds, and the points of each cell are distributed over levels
+         * of detail: level 0 holds one point per cell, and each next level holds (up to) four times
+         * as many points per cell as all previous levels together, like the nodes of a quadtree.
+         * The last level holds the remaining points.
+         *
+         * The points are ordered by level, then by grid row and then by grid column, so that the
+         * points of a level inside a rectangle of cells form one contiguous range per grid row.
+         * The renderer uploads the point attributes in this order and draws only those ranges.
+         */
+        class PointSpatialIndex
+        {
+        public:
+
+            /** Half-open range [first, second) of positions in the point order */
+            using Range = std::pair<std::uint32_t, std::uint32_t>;
+
+            /**
+             * Builds the index for \p positions
+             * @param positions Point positions
+             */
+            void build(const std::vector<Vector2f>& positions);
+
+            /** Removes all points from the index */
+            void clear();
+
+            /** Get whether the index was built for a non-empty set of points */
+            bool isValid() const {
+                return !_order.empty();
+            }
+
+            /** Get the number of indexed points */
+            std::uint32_t getNumberOfPoints() const {
+                return static_cast<std::uint32_t>(_order.size());
+            }
+
+            /** Get the number of levels of detail */
+            std::uint32_t getNumberOfLevels() const {
+                return NUMBER_OF_LEVELS;
+            }
+
+            /** Get the point indices in index order */
+            const std::vector<std::uint32_t>& getOrder() const {
+                return _order;
+            }
+
+            /** Get the position in the index order for each point index */
+            const std::vector<std::uint32_t>& getInverseOrder() const {
+                return _inverseOrder;
+            }
+
+            /**
+             * Get the number of points inside \p bounds per level of detail
+             * @param bounds Bounds (in data space)
+             * @return Number of points for each level of detail
+             */
+            std::vector<std::uint64_t> getNumberOfPointsPerLevel(const Bounds& bounds) const;
+
+            /**
+             * Get the (merged) ranges of the points of level zero up to and including \p maximumLevel inside \p bounds
+             * @param bounds Bounds (in data space)
+             * @param maximumLevel Maximum level of detail
+             * @return Sorted, non-adjacent ranges in the index order
+             */
+            std::vector<Range> getRanges(const Bounds& bounds, std::uint32_t maximumLevel) const;
+
+            /**
+             * Get \p values (one per point) in index order
+             * @param values Values in point index order
+             * @return Values in index order
+             */
+            template<typename T>
+            std::vector<T> reorder(const std::vector<T>& values) const
+            {
+                std::vector<T> reorderedValues(_order.size());
+
+                for (std::size_t position = 0; position < _order.size(); ++position)
+                    reorderedValues[position] = values[_order[position]];
+
+                return reorderedValues;
+            }
+
+        private:
+
+            /** Inclusive range of grid cells along one axis */
+            using CellRange = std::pair<std::uint32_t, std::uint32_t>;
+
+            /**
+             * Get the inclusive ranges of grid columns and rows that overlap with \p bounds
+             * @param bounds Bounds (in data space)
+             * @param columns Range of columns (output)
+             * @param rows Range of rows (output)
+             * @return Whether any cell overlaps with the bounds
+             */
+            bool getCellRanges(const Bounds& bounds, CellRange& columns, CellRange& rows) const;
+
+            /** Get the offset of the first point of \p level in grid \p row and \p column */
+            std::uint32_t getOffset(std::uint32_t level, std::uint32_t row, std::uint32_t column) const {
+                return _offsets[(static_cast<std::size_t>(level) * _gridSize + row) * _gridSize + column];
+            }
+
+        public:
+            static constexpr std::uint32_t NUMBER_OF_LEVELS             = 8;        /** Number of levels of detail */
+            static constexpr std::uint32_t TARGET_POINTS_PER_CELL       = 64;       /** Average number of points per grid cell the grid size is chosen for */
+            static constexpr std::uint32_t MAXIMUM_GRID_SIZE            = 256;      /** Maximum number of grid cells along each axis */
+
+        private:
+            Bounds                      _bounds;            /** Bounds of the (finite) positions */
+            std::uint32_t               _gridSize = 0;      /** Number of grid cells along each axis */
+            std::vector<std::uint32_t>  _order;             /** Point indices in index order */
+            std::vector<std::uint32_t>  _inverseOrder;      /** Position in the index order per point index */
+            std::vector<std::uint32_t>  _offsets;           /** Offset of the first point per level, grid row and grid column (plus the total number of points) */
+        };
+
+    } // namespace gui
+
+} // namespace mv
@@ -3,10 +3,14 @@
 // Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
 
 #include "DensityComputation.h"
+#include "Parallel.h"
 
 #include "../graphics/Matrix3f.h"
 #include "../graphics/Bounds.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include <math.h>
 
 namespace mv
@@ -36,9 +40,13 @@ namespace
         m[7] = -((bounds.getTop() + bounds.getBottom()) / (bounds.getTop() - bounds.getBottom()));
         return m;
     }
+
+    /** Peak value of the Gaussian splat (the value at the center of a single point) */
+    constexpr double SPLAT_PEAK_VALUE = 1000.0 / (2.0 * 3.1415926535 * (32.0 / 6.0) * (32.0 / 6.0));
+
 }
 
-void GaussianTexture::generate()
+void GaussianTexture::generate(float kernelSupport /*= 3.0f*/)
 {
     create();
 
@@ -47,7 +55,8 @@ void GaussianTexture::generate()
 
     float* data = new float[w * h];
 
-    double sigma = w / 6.0;
+    // The texture spans the kernel support on either side of the center
+    double sigma = w / (2.0 * kernelSupport);
     double i_c = w / 2.0;
     double j_c = h / 2.0;
 
@@ -55,9 +64,9 @@ void GaussianTexture::generate()
         for (int i = 0; i < w; i++){
 
             const double sqrt_dist = (i - i_c)*(i - i_c) + (j - j_c)*(j - j_c);
-            const double val = exp(sqrt_dist / (-2.0 * sigma * sigma)) / (2.0 * 3.1415926535 * sigma * sigma);
+            const double val = exp(sqrt_dist / (-2.0 * sigma * sigma)) * SPLAT_PEAK_VALUE;
 
-            data[j*w + i] = val*1000.0;// texture_multiplier;
+            data[j*w + i] = val;
         }
     }
 
@@ -73,6 +82,7 @@ DensityComputation::DensityComputation()
     :
     _initialized(false),
     _needsDensityMapUpdate(true),
+    _needsTextureUpdate(true),
     _ctx(nullptr),
     _points(nullptr)
 {
@@ -90,7 +100,7 @@ void DensityComputation::init(QOpenGLContext* ctx)
     initializeOpenGLFunctions();
 
     // Generate the gaussian rendering splat
-    _gaussTexture.generate();
+    _gaussTexture.generate(_kernelSupport);
 
     // Build a VAO containing a quad and the instance-positions
     glGenVertexArrays(1, &_vao);
@@ -130,6 +140,15 @@ void DensityComputation::init(QOpenGLContext* ctx)
         qDebug() << "Failed to load DensityCompute shader";
     }
 
+    // Load the shader that reduces the density map to its maximum
+    loaded = _shaderDensityMaximum.loadShaderFromFile(":shaders/Quad.vert", ":shaders/DensityMaximum.frag");
+    if (!loaded) {
+        qDebug() << "Failed to load DensityMaximum shader";
+    }
+
+    // Empty VAO for the full-screen triangle of the reduction passes
+    glGenVertexArrays(1, &_reductionVao);
+
     // Create the off-screen density framebuffer
     _densityBuffer.create();
     _densityBuffer.bind();
@@ -142,15 +161,50 @@ void DensityComputation::init(QOpenGLContext* ctx)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, RESOLUTION, RESOLUTION, 0, GL_RGB, GL_FLOAT, nullptr);
+
+    // Create the (ping-pong) textures of the maximum reduction
+    for (auto& reductionTexture : _reductionTextures) {
+        reductionTexture.create();
+        reductionTexture.bind();
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+
+    allocateTextures();
 
     // Add the texture to the framebuffer and validate it
+    _densityBuffer.bind();
     _densityBuffer.addColorTexture(0, &_densityTexture);
     _densityBuffer.validate();
 
+    // Create the off-screen framebuffer of the maximum reduction
+    _reductionBuffer.create();
+    _reductionBuffer.bind();
+    _reductionBuffer.addColorTexture(0, &_reductionTextures[0]);
+    _reductionBuffer.validate();
+
     _initialized = true;
 }
 
+void DensityComputation::allocateTextures()
+{
+    _densityTexture.bind();
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, _resolution, _resolution, 0, GL_RED, GL_FLOAT, nullptr);
+
+    // The first reduction pass halves the resolution
+    const auto reductionResolution = (_resolution + 1) / 2;
+
+    for (auto& reductionTexture : _reductionTextures) {
+        reductionTexture.bind();
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, reductionResolution, reductionResolution, 0, GL_RED, GL_FLOAT, nullptr);
+    }
+
+    _needsTextureUpdate = false;
+}
+
 void DensityComputation::cleanup()
 {
     _initialized = false;
@@ -161,6 +215,13 @@ void DensityComputation::cleanup()
     // Destroy the off-screen framebuffer
     _densityTexture.destroy();
     _densityBuffer.destroy();
+
+    // Destroy the maximum reduction
+    _shaderDensityMaximum.destroy();
+    _reductionTextures[0].destroy();
+    _reductionTextures[1].destroy();
+    _reductionBuffer.destroy();
+    glDeleteVertexArrays(1, &_reductionVao);
     
     // Destroy the splat texture
     _gaussTexture.destroy();
@@ -191,6 +252,31 @@ void DensityComputation::setSigma(float sigma)
     compute();
 }
 
+void DensityComputation::setResolution(std::uint32_t resolution)
+{
+    resolution = std::clamp(resolution, 1u, MAXIMUM_RESOLUTION);
+
+    if (resolution == _resolution)
+        return;
+
+    _resolution = resolution;
+    _needsTextureUpdate = true;
+}
+
+void DensityComputation::setKernelSupport(float kernelSupport)
+{
+    kernelSupport = std::max(kernelSupport, 1.0f);
+
+    if (kernelSupport == _kernelSupport)
+        return;
+
+    _kernelSupport = kernelSupport;
+
+    // The splat texture is regenerated on the next GPU computation
+    if (_initialized)
+        _needsTextureUpdate = true;
+}
+
 void DensityComputation::compute()
 {
     if (!_initialized) return;
@@ -204,6 +290,15 @@ void DensityComputation::compute()
 
     _numPoints = static_cast<std::uint32_t>(_points->size());
 
+    _densityMap.clear();
+
+    if (_needsTextureUpdate) {
+        _gaussTexture.destroy();
+        _gaussTexture.generate(_kernelSupport);
+
+        allocateTextures();
+    }
+
     // Upload the points to the GPU
     _pointBuffer.bind();
     _pointBuffer.setData(*_points);
@@ -211,7 +306,7 @@ void DensityComputation::compute()
     // Bind the off-screen framebuffer
     _densityBuffer.bind();
     glDrawBuffer(GL_COLOR_ATTACHMENT0);
-    glViewport(0, 0, RESOLUTION, RESOLUTION);
+    glViewport(0, 0, _resolution, _resolution);
 
     // Set background color and clear framebuffer
     glClearColor(0, 0, 0, 1);
@@ -225,7 +320,7 @@ void DensityComputation::compute()
     _shaderDensityCompute.bind();
 
     // Set shader uniforms
-    _shaderDensityCompute.uniform1f("sigma", _sigma);
+    _shaderDensityCompute.uniform1f("sigma", _sigma * _kernelSupport / DEFAULT_KERNEL_SUPPORT);
 
     _gaussTexture.bind(0);
     _shaderDensityCompute.uniform1i("gaussSampler", 0);
@@ -254,20 +349,159 @@ bool DensityComputation::hasData()
 
 float DensityComputation::calculateMaxKDE()
 {
-    // Read back output pixels from the framebuffer
-    std::vector<float> kde(RESOLUTION * RESOLUTION * 3);
+    // Reduce the density map to its maximum on the GPU, each pass takes the maximum of 2x2 texels
+    glDisable(GL_BLEND);
+
+    _reductionBuffer.bind();
+    _shaderDensityMaximum.bind();
+    _shaderDensityMaximum.uniform1i("densityTexture", 0);
+
+    glBindVertexArray(_reductionVao);
+
+    Texture2D* sourceTexture    = &_densityTexture;
+    auto sourceResolution       = _resolution;
+    auto targetIndex            = 0;
+
+    do {
+        const auto targetResolution = (sourceResolution + 1) / 2;
+
+        _reductionBuffer.setTexture(GL_COLOR_ATTACHMENT0, _reductionTextures[targetIndex]);
+
+        glViewport(0, 0, targetResolution, targetResolution);
+
+        sourceTexture->bind(0);
+        _shaderDensityMaximum.uniform2i("sourceSize", sourceResolution, sourceResolution);
+
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        sourceTexture       = &_reductionTextures[targetIndex];
+        sourceResolution    = targetResolution;
+        targetIndex         = 1 - targetIndex;
+    } while (sourceResolution > 1);
+
+    glBindVertexArray(0);
+
+    // Only the single remaining texel is read back
+    float maxKDE = 0.0f;
 
     glReadBuffer(GL_COLOR_ATTACHMENT0);
-    glReadPixels(0, 0, RESOLUTION, RESOLUTION, GL_RGB, GL_FLOAT, kde.data());
+    glReadPixels(0, 0, 1, 1, GL_RED, GL_FLOAT, &maxKDE);
 
-    // Calculate max value for normalization
-    float maxKDE = -99999999.9f;
-    for (int i = 0; i < kde.size(); i += 3) // only lookup red channel
-    {
-        maxKDE = std::max(maxKDE, kde[i]);
-    }
+    // Restore the additive blending of the density computation
+    glEnable(GL_BLEND);
 
     return maxKDE;
 }
 
+void DensityComputation::computeOnCpu()
+{
+    if (!hasData()) return;
+
+    _numPoints  = static_cast<std::uint32_t>(_points->size());
+    _densityMap = computeDensityMap(*_points, _bounds, _resolution, _sigma, _kernelSupport);
+    _maxKDE     = _densityMap.empty() ? 0.0f : *std::max_element(_densityMap.begin(), _densityMap.end());
+}
+
+std::vector<float> DensityComputation::computeDensityMap(const std::vector<Vector2f>& points, const Bounds& bounds, std::uint32_t resolution, float sigma, float kernelSupport)
+{
+    if (resolution == 0)
+        return {};
+
+    // Standard deviation of the kernel in grid cells (the splat quad spans sigma in clip space on either side of the point)
+    const auto standardDeviation    = std::max(static_cast<double>(sigma) / DEFAULT_KERNEL_SUPPORT * resolution / 2.0, 1e-3);
+    const auto radius               = static_cast<std::int64_t>(std::ceil(kernelSupport * standardDeviation));
+    const auto paddedResolution     = static_cast<std::size_t>(resolution + 2 * radius);
+    const auto numberOfThreads      = util::getNumberOfHardwareThreads();
+
+    // Kernel weights at integer offsets [-radius, radius]
+    std::vector<float> kernel(2 * radius + 1);
+
+    for (std::int64_t offset = -radius; offset <= radius; ++offset)
+        kernel[offset + radius] = static_cast<float>(std::exp(-(offset * offset) / (2.0 * standardDeviation * standardDeviation)));
+
+    // Linearly bin the points in a grid that is padded by the kernel radius, so that points just
+    // outside the bounds contribute to the border cells. Each thread bins into its own grid.
+    const auto gridSize                 = paddedResolution * paddedResolution;
+    const auto numberOfBinningThreads   = std::clamp<std::size_t>((std::size_t(64) << 20) / (gridSize * sizeof(float)), 1, std::min(numberOfThreads, points.size() / 65536 + 1));
+
+    std::vector<std::vector<float>> grids(numberOfBinningThreads);
+
+    const auto scaleX   = resolution / (bounds.getRight() - bounds.getLeft());
+    const auto scaleY   = resolution / (bounds.getTop() - bounds.getBottom());
+
+    util::parallelFor(numberOfBinningThreads, numberOfBinningThreads, [&](std::size_t firstGrid, std::size_t) -> void {
+        auto& grid = grids[firstGrid];
+
+        grid.assign(gridSize, 0.0f);
+
+        const auto beginPoint   = points.size() * firstGrid / numberOfBinningThreads;
+        const auto endPoint     = points.size() * (firstGrid + 1) / numberOfBinningThreads;
+
+        for (auto pointIndex = beginPoint; pointIndex < endPoint; ++pointIndex) {
+
+            // Grid coordinates, with the cell centers at integer coordinates
+            const auto x = (points[pointIndex].x - bounds.getLeft()) * scaleX - 0.5f + radius;
+            const auto y = (points[pointIndex].y - bounds.getBottom()) * scaleY - 0.5f + radius;
+
+            if (!(x >= 0.0f && y >= 0.0f && x < paddedResolution - 1 && y < paddedResolution - 1))
+                continue;
+
+            const auto column   = static_cast<std::size_t>(x);
+            const auto row      = static_cast<std::size_t>(y);
+            const auto u        = x - column;
+            const auto v        = y - row;
+            const auto cell     = row * paddedResolution + column;
+
+            grid[cell]                          += (1.0f - u) * (1.0f - v);
+            grid[cell + 1]                      += u * (1.0f - v);
+            grid[cell + paddedResolution]       += (1.0f - u) * v;
+            grid[cell + paddedResolution + 1]   += u * v;
+        }
+    });
+
+    auto& bins = grids.front();
+
+    util::parallelFor(gridSize, numberOfThreads, [&](std::size_t begin, std::size_t end) -> void {
+        for (std::size_t gridIndex = 1; gridIndex < grids.size(); ++gridIndex)
+            for (auto cell = begin; cell < end; ++cell)
+                bins[cell] += grids[gridIndex][cell];
+    });
+
+    // Separable convolution, first along the rows (of all padded rows) and then along the columns
+    std::vector<float> rowConvolved(paddedResolution * resolution, 0.0f), densityMap(static_cast<std::size_t>(resolution) * resolution, 0.0f);
+
+    util::parallelFor(paddedResolution, numberOfThreads, [&](std::size_t beginRow, std::size_t endRow) -> void {
+        for (auto row = beginRow; row < endRow; ++row) {
+            const auto* binRow  = bins.data() + row * paddedResolution;
+            auto* outputRow     = rowConvolved.data() + row * resolution;
+
+            for (std::size_t column = 0; column < resolution; ++column) {
+                float sum = 0.0f;
+
+                for (std::size_t offset = 0; offset < kernel.size(); ++offset)
+                    sum += kernel[offset] * binRow[column + offset];
+
+                outputRow[column] = sum;
+            }
+        }
+    });
+
+    util::parallelFor(resolution, numberOfThreads, [&](std::size_t beginRow, std::size_t endRow) -> void {
+        for (auto row = beginRow; row < endRow; ++row) {
+            auto* outputRow = densityMap.data() + row * resolution;
+
+            // Accumulate whole rows, so that the inner loop runs over contiguous memory
+            for (std::size_t offset = 0; offset < kernel.size(); ++offset) {
+                const auto* inputRow    = rowConvolved.data() + (row + offset) * resolution;
+                const auto weight       = kernel[offset] * static_cast<float>(SPLAT_PEAK_VALUE);
+
+                for (std::size_t column = 0; column < resolution; ++column)
+                    outputRow[column] += weight * inputRow[column];
+            }
+        }
+    });
+
+    return densityMap;
+}
+
 }
@@ -14,15 +14,33 @@
 
 #include <QOffscreenSurface>
 
+#include <cstdint>
+#include <vector>
+
 namespace mv
 {
 
 class GaussianTexture : public Texture2D
 {
 public:
-    void generate();
+
+    /**
+     * Generates the Gaussian splat texture
+     * @param kernelSupport Half the width of the splat in standard deviations
+     */
+    void generate(float kernelSupport = 3.0f);
 };
 
+/**
+ * Density computation class
+ *
+ * Computes a kernel density estimate (KDE) of 2D points on a square grid. With an OpenGL
+ * context, Gaussian splats are accumulated in a floating point texture and the maximum density
+ * is found by a reduction on the GPU (compute()). Without an OpenGL context (headless or offscreen
+ * use), computeOnCpu() linearly bins the points in a grid which is convolved with a separable
+ * Gaussian kernel on the CPU, using multiple threads. Both yield the same density values (up to
+ * the binning error).
+ */
 class DensityComputation : protected QOpenGLFunctions_3_3_Core
 {
 public:
@@ -36,31 +54,84 @@ public:
     void setBounds(float left, float right, float bottom, float top);
     void setSigma(float sigma);
 
+    /** Get the number of grid cells of the density map along each axis */
+    std::uint32_t getResolution() const { return _resolution; }
+
+    /**
+     * Sets the number of grid cells of the density map along each axis (the density is recomputed on the next compute())
+     * @param resolution Resolution in [1, MAXIMUM_RESOLUTION]
+     */
+    void setResolution(std::uint32_t resolution);
+
+    /** Get half the width of the kernel in standard deviations */
+    float getKernelSupport() const { return _kernelSupport; }
+
+    /**
+     * Sets half the width of the (truncated) Gaussian kernel in standard deviations (the density is recomputed on the next compute())
+     * @param kernelSupport Kernel support (at least one standard deviation)
+     */
+    void setKernelSupport(float kernelSupport);
+
     Texture2D& getDensityTexture() { return _densityTexture; }
     float getMaxDensity() const { return _maxKDE; }
     unsigned int getNumPoints() { return _numPoints; }
 
+    /**
+     * Get the density map of the last CPU computation (empty when the density was computed on the GPU)
+     * @return Densities of the grid cells, row by row, starting at the bottom row (like the density texture)
+     */
+    const std::vector<float>& getDensityMap() const { return _densityMap; }
+
+    /** Computes the density on the GPU (does nothing before init(...)) */
     void compute();
 
+    /** Computes the density on the CPU, regardless of whether there is an OpenGL context */
+    void computeOnCpu();
+
+    /**
+     * Computes the density map of \p points on the CPU
+     * @param points Points
+     * @param bounds Bounds of the density map
+     * @param resolution Number of grid cells along each axis
+     * @param sigma Kernel width (as used by setSigma(...))
+     * @param kernelSupport Half the width of the kernel in standard deviations
+     * @return Densities of the grid cells, row by row, starting at the bottom row
+     */
+    static std::vector<float> computeDensityMap(const std::vector<Vector2f>& points, const Bounds& bounds, std::uint32_t resolution, float sigma, float kernelSupport);
+
 private:
     bool hasData();
     float calculateMaxKDE();
 
+    /** (Re)allocates the density texture and the reduction textures at the current resolution */
+    void allocateTextures();
+
+public:
+    static constexpr std::uint32_t  DEFAULT_RESOLUTION      = 128;      /** Default number of grid cells along each axis */
+    static constexpr std::uint32_t  MAXIMUM_RESOLUTION      = 4096;     /** Maximum number of grid cells along each axis */
+    static constexpr float          DEFAULT_KERNEL_SUPPORT  = 3.0f;     /** Default half width of the kernel in standard deviations */
+
 private:
-    const unsigned int RESOLUTION = 128;
     const float DEFAULT_SIGMA = 0.15f;
 
+    std::uint32_t _resolution = DEFAULT_RESOLUTION;
+    float _kernelSupport = DEFAULT_KERNEL_SUPPORT;
     float _sigma = DEFAULT_SIGMA;
     float _maxKDE = -1;
     unsigned int _numPoints = 0;
     Bounds _bounds = Bounds(-1, 1, 2, 2);
 
     ShaderProgram _shaderDensityCompute;
+    ShaderProgram _shaderDensityMaximum;
     Framebuffer _densityBuffer;
+    Framebuffer _reductionBuffer;
     Texture2D _densityTexture;
+    Texture2D _reductionTextures[2];
     GaussianTexture _gaussTexture;
+    std::vector<float> _densityMap;
 
     GLuint _vao;
+    GLuint _reductionVao;
     BufferObject _pointBuffer;
     const std::vector<Vector2f>* _points;
 
@@ -69,6 +140,7 @@ private:
 
     bool _initialized;
     bool _needsDensityMapUpdate;
+    bool _needsTextureUpdate;
 };
 
 } // namespace mv
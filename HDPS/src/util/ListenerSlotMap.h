@@ -0,0 +1,333 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace mv::util {
+
+/**
+ * Listener slot map class
+ *
+ * Registry of listeners with O(1) insertion and removal, and dispatch that only visits the
+ * listeners that are interested in the dispatched event type. The event types of a listener can be
+ * changed in place, without invalidating its handle.
+ *
+ * Each listener occupies a slot, and is identified by a handle that combines the slot index with
+ * the generation of the slot. Removal increments the generation, so that stale handles (also the
+ * ones in the event type buckets) are recognized without searching. The bucket entries of removed
+ * listeners are left behind as tombstones, which makes removal during dispatch safe, and they are
+ * compacted once they outnumber the live entries (and no dispatch is in progress).
+ *
+ * @param Listener Type of listener
+ */
+template<typename Listener>
+class ListenerSlotMap
+{
+public:
+
+    /** Generation-stamped reference to a slot */
+    struct Handle
+    {
+        std::uint32_t   _index      = std::numeric_limits<std::uint32_t>::max();    /** Slot index */
+        std::uint32_t   _generation = 0;                                            /** Generation of the slot at insertion */
+
+        /** Get whether the handle refers to a slot at all */
+        bool isValid() const {
+            return _index != std::numeric_limits<std::uint32_t>::max();
+        }
+    };
+
+public: // Registration
+
+    /**
+     * Inserts \p listener and adds it to the buckets of \p eventTypes
+     * @param listener Pointer to the listener
+     * @param eventTypes Types of events the listener is interested in
+     * @return Handle of the listener
+     */
+    template<typename EventTypes>
+    Handle insert(Listener* listener, const EventTypes& eventTypes)
+    {
+        Handle handle;
+
+        if (_freeSlots.empty()) {
+            handle._index = static_cast<std::uint32_t>(_slots.size());
+
+            _slots.push_back({});
+        }
+        else {
+            handle._index = _freeSlots.back();
+
+            _freeSlots.pop_back();
+        }
+
+        auto& slot = _slots[handle._index];
+
+        slot._listener          = listener;
+        slot._numberOfEntries   = 0;
+        handle._generation      = slot._generation;
+
+        for (const auto eventType : eventTypes) {
+            const auto bucketIndex = static_cast<std::size_t>(eventType);
+
+            if (bucketIndex >= _buckets.size())
+                _buckets.resize(bucketIndex + 1);
+
+            _buckets[bucketIndex].push_back(handle);
+
+            ++slot._numberOfEntries;
+        }
+
+        _numberOfEntries += slot._numberOfEntries;
+
+        ++_numberOfListeners;
+
+        return handle;
+    }
+
+    /**
+     * Removes the listener with \p handle (stale handles are ignored)
+     * @param handle Handle of the listener
+     */
+    void erase(const Handle& handle)
+    {
+        auto slot = getSlot(handle);
+
+        if (slot == nullptr)
+            return;
+
+        slot->_listener = nullptr;
+
+        ++slot->_generation;
+
+        _numberOfTombstones += slot->_numberOfEntries;
+        _numberOfEntries    -= slot->_numberOfEntries;
+
+        --_numberOfListeners;
+
+        _freeSlots.push_back(handle._index);
+
+        compactIfNeeded();
+    }
+
+    /**
+     * Adds the listener with \p handle to the buckets of \p eventTypes (the handle stays valid, so this is safe during dispatch)
+     * @param handle Handle of the listener
+     * @param eventTypes Types of events the listener becomes interested in (and which it is not interested in yet)
+     */
+    template<typename EventTypes>
+    void addEventTypes(const Handle& handle, const EventTypes& eventTypes)
+    {
+        auto slot = getSlot(handle);
+
+        if (slot == nullptr)
+            return;
+
+        for (const auto eventType : eventTypes) {
+            const auto bucketIndex = static_cast<std::size_t>(eventType);
+
+            if (bucketIndex >= _buckets.size())
+                _buckets.resize(bucketIndex + 1);
+
+            _buckets[bucketIndex].push_back(handle);
+
+            ++slot->_numberOfEntries;
+            ++_numberOfEntries;
+        }
+    }
+
+    /**
+     * Removes the listener with \p handle from the buckets of \p eventTypes (the handle stays valid, so this is safe during dispatch)
+     * @param handle Handle of the listener
+     * @param eventTypes Types of events the listener is no longer interested in
+     */
+    template<typename EventTypes>
+    void removeEventTypes(const Handle& handle, const EventTypes& eventTypes)
+    {
+        auto slot = getSlot(handle);
+
+        if (slot == nullptr)
+            return;
+
+        for (const auto eventType : eventTypes) {
+            const auto bucketIndex = static_cast<std::size_t>(eventType);
+
+            if (bucketIndex >= _buckets.size())
+                continue;
+
+            // The entry is replaced by an invalid handle (a tombstone), so that the entries of a dispatch in progress keep their position
+            for (auto& entry : _buckets[bucketIndex]) {
+                if (entry._index != handle._index || entry._generation != handle._generation)
+                    continue;
+
+                entry = {};
+
+                --slot->_numberOfEntries;
+                --_numberOfEntries;
+                ++_numberOfTombstones;
+
+                break;
+            }
+        }
+
+        compactIfNeeded();
+    }
+
+    /**
+     * Get the listener with \p handle
+     * @param handle Handle of the listener
+     * @return Pointer to the listener (nullptr if the handle is stale)
+     */
+    Listener* get(const Handle& handle) const
+    {
+        const auto slot = getSlot(handle);
+
+        return slot == nullptr ? nullptr : slot->_listener;
+    }
+
+    /** Get the number of listeners */
+    std::size_t size() const {
+        return _numberOfListeners;
+    }
+
+    /** Get whether there are no listeners */
+    bool isEmpty() const {
+        return _numberOfListeners == 0;
+    }
+
+    /** Removes all listeners (all handles become stale) */
+    void clear()
+    {
+        for (std::uint32_t slotIndex = 0; slotIndex < _slots.size(); ++slotIndex) {
+            auto& slot = _slots[slotIndex];
+
+            if (slot._listener == nullptr)
+                continue;
+
+            slot._listener = nullptr;
+
+            ++slot._generation;
+
+            _freeSlots.push_back(slotIndex);
+        }
+
+        for (auto& bucket : _buckets)
+            bucket.clear();
+
+        _numberOfListeners  = 0;
+        _numberOfEntries    = 0;
+        _numberOfTombstones = 0;
+    }
+
+public: // Dispatch
+
+    /**
+     * Calls \p function for each listener that is interested in \p eventType. Listeners may be inserted and
+     * removed by \p function: removed listeners are skipped, listeners that are inserted during dispatch are not called.
+     * @param eventType Type of event
+     * @param function Function that takes a pointer to a listener
+     */
+    template<typename Function>
+    void dispatch(std::uint32_t eventType, Function function)
+    {
+        if (eventType >= _buckets.size())
+            return;
+
+        const DispatchScope dispatchScope(*this);
+
+        const auto numberOfEntries = _buckets[eventType].size();
+
+        // Index based, as insertions during dispatch may reallocate the bucket (and clear() may empty it)
+        for (std::size_t entryIndex = 0; entryIndex < numberOfEntries && entryIndex < _buckets[eventType].size(); ++entryIndex) {
+            const auto listener = get(_buckets[eventType][entryIndex]);
+
+            if (listener != nullptr)
+                function(listener);
+        }
+    }
+
+private:
+
+    /** Listener slot */
+    struct Slot
+    {
+        Listener*       _listener           = nullptr;  /** Pointer to the listener (nullptr when the slot is free) */
+        std::uint32_t   _generation         = 0;        /** Incremented each time the slot is freed */
+        std::uint32_t   _numberOfEntries    = 0;        /** Number of bucket entries of the listener */
+    };
+
+    /** Keeps track of (nested) dispatches, and compacts the buckets when the outermost dispatch ends */
+    struct DispatchScope
+    {
+        explicit DispatchScope(ListenerSlotMap& listenerSlotMap) :
+            _listenerSlotMap(listenerSlotMap)
+        {
+            ++_listenerSlotMap._dispatchDepth;
+        }
+
+        ~DispatchScope()
+        {
+            --_listenerSlotMap._dispatchDepth;
+
+            _listenerSlotMap.compactIfNeeded();
+        }
+
+        ListenerSlotMap& _listenerSlotMap;
+    };
+
+    /** Get the slot with \p handle (nullptr if the handle is stale) */
+    const Slot* getSlot(const Handle& handle) const
+    {
+        if (handle._index >= _slots.size())
+            return nullptr;
+
+        const auto& slot = _slots[handle._index];
+
+        if (slot._generation != handle._generation || slot._listener == nullptr)
+            return nullptr;
+
+        return &slot;
+    }
+
+    /** Get the slot with \p handle (nullptr if the handle is stale) */
+    Slot* getSlot(const Handle& handle)
+    {
+        return const_cast<Slot*>(static_cast<const ListenerSlotMap&>(*this).getSlot(handle));
+    }
+
+    /** Removes the tombstones from the buckets when they outnumber the live entries (amortized O(1) per removal) */
+    void compactIfNeeded()
+    {
+        if (_dispatchDepth > 0 || _numberOfTombstones <= _numberOfEntries)
+            return;
+
+        for (auto& bucket : _buckets) {
+            std::size_t numberOfLiveEntries = 0;
+
+            for (const auto& handle : bucket)
+                if (getSlot(handle) != nullptr)
+                    bucket[numberOfLiveEntries++] = handle;
+
+            bucket.resize(numberOfLiveEntries);
+        }
+
+        _numberOfTombstones = 0;
+    }
+
+private:
+    std::vector<Slot>                   _slots;                     /** Listener slots */
+    std::vector<std::uint32_t>          _freeSlots;                 /** Indices of the free slots */
+    std::vector<std::vector<Handle>>    _buckets;                   /** Handles of the interested listeners, per event type */
+    std::size_t                         _numberOfListeners  = 0;    /** Number of listeners */
+    std::size_t                         _numberOfEntries    = 0;    /** Number of live bucket entries */
+    std::size_t                         _numberOfTombstones = 0;    /** Number of bucket entries of removed listeners */
+    std::uint32_t                       _dispatchDepth      = 0;    /** Number of dispatches in progress */
+};
+
+}
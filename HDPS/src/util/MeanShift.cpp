@@ -3,10 +3,14 @@
 // Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
 
 #include "MeanShift.h"
+#include "Parallel.h"
 
 #include "../graphics/Matrix3f.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
 
 #include <QImage>
 #include <QDebug>
@@ -17,6 +21,16 @@
 namespace mv
 {
 
+namespace
+{
+    constexpr float         MINIMUM_DENSITY             = 1.0f / 100000;    /** Pixels with a lower density have no gradient (as in GradientCompute.frag) */
+    constexpr float         GRADIENT_EPSILON            = 0.001f;           /** Gradient length below which a peak is reached (as in MeanshiftCompute.frag) */
+    constexpr float         STEP_SIZE                   = 0.25f;            /** Mean shift step size in pixels */
+    constexpr std::uint32_t MAXIMUM_NUMBER_OF_STEPS     = 10000;            /** Maximum number of mean shift steps per pixel */
+    constexpr std::uint32_t CONVERGENCE_CHECK_INTERVAL  = 64;               /** Number of steps between convergence checks */
+    constexpr float         CONVERGENCE_DISTANCE        = 0.5f;             /** Distance (per axis, in pixels) within which a position counts as converged between checks */
+}
+
 Matrix3f createProjectionMatrix(QRectF bounds)
 {
     Matrix3f m;
@@ -35,6 +49,8 @@ void MeanShift::init()
     
     densityComputation.init(QOpenGLContext::currentContext());
 
+    _initialized = true;
+
     glGenVertexArrays(1, &_quad);
 
     glEnable(GL_BLEND);
@@ -80,6 +96,7 @@ void MeanShift::init()
 
 void MeanShift::cleanup()
 {
+    _initialized = false;
 
 }
 
@@ -259,58 +276,218 @@ void MeanShift::cluster(const std::vector<Vector2f>& points, std::vector<std::ve
 {
     if (points.size() == 0) return;
 
+    // Without OpenGL context the whole pipeline runs on the CPU
+    if (!_initialized) {
+        clusterOnCpu(points, clusters);
+        return;
+    }
+
     densityComputation.setSigma(_sigma);
     densityComputation.compute();
     computeGradient();
     computeMeanShift();
 
-    // Resize clusterID arrays to equal number of pixels
-    _clusterIds.resize(RESOLUTION * RESOLUTION);
-    _clusterIdsOriginal.resize(RESOLUTION * RESOLUTION);
-    // Stores centers of all clusters that are found in meanshift segmentation
-    std::vector<Vector2f> clusterCenters;
+    assignClusters(clusters);
+}
 
-    // we take a distance of 2 pixels as maximum to assume points ended in the same peak
-    float epsilon = 2.0f/RESOLUTION;// 0.05f;
-    // For every pixel in Mean Shift Map
-    for (int i = 0; i < _meanshiftPixels.size(); i++) {
-        // Set center to red and green component of pixel
-        Vector2f center = _meanshiftPixels[i];
+void MeanShift::clusterOnCpu(const std::vector<Vector2f>& points, std::vector<std::vector<unsigned int>>& clusters)
+{
+    if (points.size() == 0 || _points == nullptr) return;
 
-        // If center equals 0, set clusterID for this pixel to -1
-        if (center.sqrMagnitude() < 0.0001)
-        {
-            _clusterIdsOriginal[i] = -1;
-            continue;
+    computeMeanShiftOnCpu();
+    assignClusters(clusters);
+}
+
+void MeanShift::computeMeanShiftOnCpu()
+{
+    const auto bounds       = Bounds(_bounds.left(), _bounds.right(), _bounds.bottom(), _bounds.top());
+    const auto densityMap   = DensityComputation::computeDensityMap(*_points, bounds, RESOLUTION, _sigma, densityComputation.getKernelSupport());
+
+    _meanshiftPixels = computeMeanShiftMap(densityMap, RESOLUTION);
+}
+
+std::vector<Vector2f> MeanShift::computeMeanShiftMap(const std::vector<float>& densityMap, std::uint32_t resolution)
+{
+    const auto numberOfPixels = static_cast<std::size_t>(resolution) * resolution;
+
+    if (resolution == 0 || densityMap.size() != numberOfPixels)
+        return {};
+
+    const auto maximumDensity   = *std::max_element(densityMap.begin(), densityMap.end());
+    const auto numberOfThreads  = util::getNumberOfHardwareThreads();
+
+    if (!(maximumDensity > 0.0f))
+        return std::vector<Vector2f>(numberOfPixels, Vector2f(0.0f, 0.0f));
+
+    // Gradient of the normalized density by central differences (clamped at the border), like GradientCompute.frag
+    std::vector<float> gradientX(numberOfPixels, 0.0f), gradientY(numberOfPixels, 0.0f);
+
+    const auto densityScale = 1.0f / maximumDensity;
+    const auto lastIndex    = static_cast<std::size_t>(resolution - 1);
+
+    util::parallelFor(resolution, numberOfThreads, [&](std::size_t beginRow, std::size_t endRow) -> void {
+        for (auto row = beginRow; row < endRow; ++row) {
+            const auto* densityRow  = densityMap.data() + row * resolution;
+            const auto* rowBelow    = densityMap.data() + (row == 0 ? 0 : row - 1) * resolution;
+            const auto* rowAbove    = densityMap.data() + std::min(row + 1, lastIndex) * resolution;
+
+            auto* gradientRowX = gradientX.data() + row * resolution;
+            auto* gradientRowY = gradientY.data() + row * resolution;
+
+            // Branch-free over contiguous rows, so that the compiler can vectorize it
+            for (std::size_t column = 0; column < resolution; ++column) {
+                const auto mask = densityRow[column] < MINIMUM_DENSITY ? 0.0f : densityScale;
+
+                gradientRowY[column] = (rowAbove[column] - rowBelow[column]) * mask;
+            }
+
+            for (std::size_t column = 0; column < resolution; ++column) {
+                const auto mask = densityRow[column] < MINIMUM_DENSITY ? 0.0f : densityScale;
+
+                gradientRowX[column] = (densityRow[std::min(column + 1, lastIndex)] - densityRow[column == 0 ? 0 : column - 1]) * mask;
+            }
+        }
+    });
+
+    // Bilinear interpolation of the gradient at pixel coordinates (x, y), with the pixel centers at integer coordinates
+    const auto sampleGradient = [&](float x, float y) -> Vector2f {
+        x = std::clamp(x, 0.0f, static_cast<float>(lastIndex));
+        y = std::clamp(y, 0.0f, static_cast<float>(lastIndex));
+
+        const auto column   = std::min(static_cast<std::size_t>(x), lastIndex == 0 ? 0 : lastIndex - 1);
+        const auto row      = std::min(static_cast<std::size_t>(y), lastIndex == 0 ? 0 : lastIndex - 1);
+        const auto u        = x - column;
+        const auto v        = y - row;
+        const auto index    = row * resolution + column;
+        const auto right    = lastIndex == 0 ? 0 : 1;
+        const auto up       = lastIndex == 0 ? 0 : resolution;
+
+        const auto interpolate = [&](const std::vector<float>& values) -> float {
+            const auto bottom   = values[index] + u * (values[index + right] - values[index]);
+            const auto top      = values[index + up] + u * (values[index + up + right] - values[index + up]);
+
+            return bottom + v * (top - bottom);
+        };
+
+        return Vector2f(interpolate(gradientX), interpolate(gradientY));
+    };
+
+    // Climb the gradient from every pixel in steps of a quarter pixel, like MeanshiftCompute.frag
+    std::vector<Vector2f> meanShiftMap(numberOfPixels, Vector2f(0.0f, 0.0f));
+
+    util::parallelFor(numberOfPixels, numberOfThreads, [&](std::size_t beginPixel, std::size_t endPixel) -> void {
+        for (auto pixelIndex = beginPixel; pixelIndex < endPixel; ++pixelIndex) {
+            if (gradientX[pixelIndex] == 0.0f && gradientY[pixelIndex] == 0.0f)
+                continue;
+
+            auto x = static_cast<float>(pixelIndex % resolution);
+            auto y = static_cast<float>(pixelIndex / resolution);
+
+            auto checkpointX = x;
+            auto checkpointY = y;
+
+            for (std::uint32_t step = 1; step <= MAXIMUM_NUMBER_OF_STEPS; ++step) {
+                const auto gradient = sampleGradient(x, y);
+                const auto length   = gradient.length();
+
+                if (length < GRADIENT_EPSILON)
+                    break;
+
+                x += gradient.x / length * STEP_SIZE;
+                y += gradient.y / length * STEP_SIZE;
+
+                // Near a peak the steps oscillate around it instead of converging, so stop when the position hardly moved since the last checkpoint
+                if (step % CONVERGENCE_CHECK_INTERVAL == 0) {
+                    if (std::abs(x - checkpointX) < CONVERGENCE_DISTANCE && std::abs(y - checkpointY) < CONVERGENCE_DISTANCE)
+                        break;
+
+                    checkpointX = x;
+                    checkpointY = y;
+                }
+            }
+
+            x = std::clamp(x, 0.0f, static_cast<float>(lastIndex));
+            y = std::clamp(y, 0.0f, static_cast<float>(lastIndex));
+
+            meanShiftMap[pixelIndex] = Vector2f((x + 0.5f) / resolution, (y + 0.5f) / resolution);
         }
+    });
 
-        // If the center already exist in clusterCenters set clusterID to that cluster
-        bool clusterFound = false;
+    return meanShiftMap;
+}
+
+std::vector<int> MeanShift::mergeClusterCenters(const std::vector<Vector2f>& meanShiftMap, float epsilon, std::vector<Vector2f>& clusterCenters)
+{
+    std::vector<int> clusterIds(meanShiftMap.size(), -1);
+
+    clusterCenters.clear();
+
+    // Spatial hash of the cluster centers with cells of epsilon, so that a matching center is in one of the 3x3 cells around the peak
+    std::unordered_map<std::uint64_t, std::vector<int>> centersPerCell;
+
+    const auto getCellCoordinate = [epsilon](float value) -> std::int32_t {
+        return static_cast<std::int32_t>(std::floor(value / epsilon));
+    };
+
+    const auto getCellKey = [](std::int32_t column, std::int32_t row) -> std::uint64_t {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(row)) << 32) | static_cast<std::uint32_t>(column);
+    };
+
+    for (std::size_t pixelIndex = 0; pixelIndex < meanShiftMap.size(); ++pixelIndex) {
+        const auto& center = meanShiftMap[pixelIndex];
+
+        // Pixels without gradient do not belong to a cluster
+        if (center.sqrMagnitude() < 0.0001f)
+            continue;
+
+        const auto column   = getCellCoordinate(center.x);
+        const auto row      = getCellCoordinate(center.y);
+
+        // Find the first cluster center (in order of creation) that is within epsilon
         int clusterId = -1;
-        for (int c = 0; c < clusterCenters.size(); c++)
-        {
-            if (equal(center, clusterCenters[c], epsilon))
-            {
-                clusterFound = true;
-                clusterId = c;
-                break;
+
+        for (auto neighborRow = row - 1; neighborRow <= row + 1; ++neighborRow) {
+            for (auto neighborColumn = column - 1; neighborColumn <= column + 1; ++neighborColumn) {
+                const auto it = centersPerCell.find(getCellKey(neighborColumn, neighborRow));
+
+                if (it == centersPerCell.end())
+                    continue;
+
+                for (const auto candidateId : it->second) {
+                    if ((clusterId < 0 || candidateId < clusterId) && std::abs(center.x - clusterCenters[candidateId].x) < epsilon && std::abs(center.y - clusterCenters[candidateId].y) < epsilon) {
+                        clusterId = candidateId;
+                        break;
+                    }
+                }
             }
         }
-        
-        // If clusterID was not found already, push the new center into clusterCenters
-        if (!clusterFound)
-        {
+
+        if (clusterId < 0) {
+            clusterId = static_cast<int>(clusterCenters.size());
+
             clusterCenters.push_back(center);
-            // Set the current pixel in clusterIdsOriginal to the latest cluster index
-            _clusterIdsOriginal[i] = static_cast<int>(clusterCenters.size() - 1);
-        }
-        else
-        {
-            // Set the current pixel in clusterIdsOriginal to the previously found clusterID
-            _clusterIdsOriginal[i] = clusterId;
+            centersPerCell[getCellKey(column, row)].push_back(clusterId);
         }
+
+        clusterIds[pixelIndex] = clusterId;
     }
 
+    return clusterIds;
+}
+
+void MeanShift::assignClusters(std::vector<std::vector<unsigned int>>& clusters)
+{
+    // Resize clusterID arrays to equal number of pixels
+    _clusterIds.resize(RESOLUTION * RESOLUTION);
+
+    // Stores centers of all clusters that are found in meanshift segmentation
+    std::vector<Vector2f> clusterCenters;
+
+    // we take a distance of 2 pixels as maximum to assume points ended in the same peak
+    float epsilon = 2.0f/RESOLUTION;// 0.05f;
+
+    _clusterIdsOriginal = mergeClusterCenters(_meanshiftPixels, epsilon, clusterCenters);
+
 #ifdef MEANSHIFT_IMAGE_DEBUG
     for (int i = 0; i < clusterCenters.size(); i++) {
         qDebug() << "Cluster center: " << clusterCenters[i].x << " " << clusterCenters[i].y;
@@ -415,7 +592,7 @@ void MeanShift::cluster(const std::vector<Vector2f>& points, std::vector<std::ve
 
 bool MeanShift::equal(const Vector2f& p1, const Vector2f& p2, float epsilon)
 {
-    return fabs(p1.x - p2.x) < epsilon && fabs(p1.y - p2.y < epsilon);
+    return fabs(p1.x - p2.x) < epsilon && fabs(p1.y - p2.y) < epsilon;
 }
 
 Texture2D& MeanShift::getGradientTexture()
@@ -13,9 +13,21 @@
 
 #include "../graphics/Vector2f.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace mv
 {
 
+/**
+ * Mean shift class
+ *
+ * Clusters 2D points by mean shift on their density map: every pixel of the density map climbs
+ * the density gradient to a peak, and the pixels that end up at the same peak form a cluster.
+ * With an OpenGL context (after init()), the gradient and mean shift passes run in shaders. Without
+ * one (headless, batch or background use), the density map is computed on the CPU and the passes
+ * run on multiple threads. Both paths merge the peaks with a spatial hash.
+ */
 class MeanShift : protected QOpenGLFunctions_3_3_Core
 {
 public:
@@ -28,9 +40,40 @@ public:
 
     void drawFullscreenQuad();
 
+    /**
+     * Clusters the points that were set with setData(...), on the GPU after init() and otherwise on the CPU
+     * @param points Points (only used to check whether there are any)
+     * @param clusters Point indices per cluster (output)
+     */
     void cluster(const std::vector<Vector2f>& points, std::vector<std::vector<unsigned int>>& clusters);
+
+    /**
+     * Clusters the points that were set with setData(...) on the CPU, regardless of whether there is an OpenGL context
+     * @param points Points (only used to check whether there are any)
+     * @param clusters Point indices per cluster (output)
+     */
+    void clusterOnCpu(const std::vector<Vector2f>& points, std::vector<std::vector<unsigned int>>& clusters);
+
     bool equal(const Vector2f& p1, const Vector2f& p2, float epsilon);
 
+    /**
+     * Computes the mean shift map of \p densityMap on the CPU: for each pixel the position of the
+     * density peak it climbs to, like the gradient and mean shift shaders
+     * @param densityMap Densities of the pixels, row by row, starting at the bottom row
+     * @param resolution Number of pixels along each axis
+     * @return Peak position per pixel in texture coordinates ([0, 1]), or (0, 0) for pixels without density gradient
+     */
+    static std::vector<Vector2f> computeMeanShiftMap(const std::vector<float>& densityMap, std::uint32_t resolution);
+
+    /**
+     * Merges the peak positions of \p meanShiftMap that are less than \p epsilon apart, in pixel order
+     * @param meanShiftMap Peak position per pixel (pixels at (0, 0) are not assigned to a cluster)
+     * @param epsilon Maximum distance (per axis) between the peaks of a cluster
+     * @param clusterCenters Peak position per cluster (output)
+     * @return Cluster index per pixel, or -1 for unassigned pixels
+     */
+    static std::vector<int> mergeClusterCenters(const std::vector<Vector2f>& meanShiftMap, float epsilon, std::vector<Vector2f>& clusterCenters);
+
     Texture2D& getGradientTexture();
     Texture2D& getMeanShiftTexture();
 
@@ -42,6 +85,12 @@ private:
     void computeGradient();
     void computeMeanShift();
 
+    /** Computes the density, gradient and mean shift maps on the CPU */
+    void computeMeanShiftOnCpu();
+
+    /** Assigns the points to the clusters of the mean shift map */
+    void assignClusters(std::vector<std::vector<unsigned int>>& clusters);
+
     ShaderProgram _shaderGradientCompute;
     ShaderProgram _shaderMeanshiftCompute;
 
@@ -49,10 +98,11 @@ private:
     Texture2D _gradientTexture;
     Texture2D _meanshiftTexture;
 
-    const std::vector<Vector2f>* _points;
+    const std::vector<Vector2f>* _points = nullptr;
     QRectF _bounds = QRectF(-1, 1, 2, 2);
     GLuint _quad;
 
+    bool _initialized = false;
     bool _needsDensityMapUpdate;
     float _sigma;
 
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef __APPLE__
+    #include <execution>
+    #include <numeric>
+#endif
+
+namespace mv::util {
+
+std::size_t getNumberOfHardwareThreads()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::size_t getNumberOfParallelRanges(std::size_t count, std::size_t minimumRangeSize)
+{
+    if (count == 0)
+        return 0;
+
+    return std::clamp<std::size_t>(count / std::max<std::size_t>(minimumRangeSize, 1), 1, getNumberOfHardwareThreads());
+}
+
+void parallelFor(std::size_t count, std::size_t numberOfRanges, const std::function<void(std::size_t begin, std::size_t end)>& function)
+{
+    if (count == 0)
+        return;
+
+    numberOfRanges = std::clamp<std::size_t>(numberOfRanges, 1, count);
+
+    if (numberOfRanges == 1) {
+        function(0, count);
+        return;
+    }
+
+    // An exception that escapes an execution policy algorithm terminates the application, so exceptions are caught per range
+    std::exception_ptr  exception;
+    std::mutex          exceptionMutex;
+
+    const auto processRange = [&](std::size_t rangeIndex) -> void {
+        try {
+            function(count * rangeIndex / numberOfRanges, count * (rangeIndex + 1) / numberOfRanges);
+        }
+        catch (...) {
+            const std::lock_guard<std::mutex> lock(exceptionMutex);
+
+            if (!exception)
+                exception = std::current_exception();
+        }
+    };
+
+#ifndef __APPLE__
+    // Parallel (and not unsequenced) policy, the ranges may synchronize (the exception capture above locks a mutex)
+    std::vector<std::size_t> rangeIndices(numberOfRanges);
+
+    std::iota(rangeIndices.begin(), rangeIndices.end(), std::size_t(0));
+    std::for_each(std::execution::par, rangeIndices.cbegin(), rangeIndices.cend(), processRange);
+#else
+    // The execution policies are not available on macOS, so at most one thread per hardware thread takes the ranges one by one
+    std::atomic<std::size_t> nextRangeIndex{ 0 };
+
+    const auto processRanges = [&]() -> void {
+        for (auto rangeIndex = nextRangeIndex++; rangeIndex < numberOfRanges; rangeIndex = nextRangeIndex++)
+            processRange(rangeIndex);
+    };
+
+    const auto numberOfThreads = std::min(numberOfRanges, getNumberOfHardwareThreads());
+
+    std::vector<std::thread> threads;
+
+    threads.reserve(numberOfThreads - 1);
+
+    for (std::size_t threadIndex = 1; threadIndex < numberOfThreads; ++threadIndex)
+        threads.emplace_back(processRanges);
+
+    processRanges();
+
+    for (auto& thread : threads)
+        thread.join();
+#endif
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void parallelForEach(std::size_t count, const std::function<void(std::size_t index)>& function)
+{
+    // Consecutive indices are grouped into (at most) one range per hardware thread
+    parallelFor(count, getNumberOfParallelRanges(count, 1), [&function](std::size_t begin, std::size_t end) -> void {
+        std::exception_ptr exception;
+
+        // The remaining indices of the range are processed as well, and the first exception of the range is passed on
+        for (auto index = begin; index < end; ++index) {
+            try {
+                function(index);
+            }
+            catch (...) {
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+
+        if (exception)
+            std::rethrow_exception(exception);
+    });
+}
+
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace mv::util {
+
+/**
+ * Get the number of concurrent threads supported by the hardware
+ * @return Number of hardware threads (at least one)
+ */
+std::size_t getNumberOfHardwareThreads();
+
+/**
+ * Get the number of ranges in which \p count items are processed concurrently, such that each range holds
+ * at least \p minimumRangeSize items (smaller ranges do not pay off the scheduling) and there are no more
+ * ranges than hardware threads
+ * @param count Number of items
+ * @param minimumRangeSize Minimum number of items per range
+ * @return Number of ranges (zero when there are no items)
+ */
+std::size_t getNumberOfParallelRanges(std::size_t count, std::size_t minimumRangeSize);
+
+/**
+ * Calls \p function(begin, end) for \p numberOfRanges consecutive ranges that together cover [0, \p count), concurrently
+ *
+ * The ranges differ at most one item in size, and range i starts at count * i / numberOfRanges. The ranges are processed
+ * by at most one thread per hardware thread, so more ranges than hardware threads only refine the load balancing. When
+ * \p function throws, the remaining ranges are still processed and the first exception is rethrown on the calling thread.
+ * @param count Number of items
+ * @param numberOfRanges Number of ranges (clamped to [1, count])
+ * @param function Function that processes the items in [begin, end)
+ */
+void parallelFor(std::size_t count, std::size_t numberOfRanges, const std::function<void(std::size_t begin, std::size_t end)>& function);
+
+/**
+ * Calls \p function(index) for each index in [0, \p count), concurrently (consecutive indices are grouped into at most one range per hardware thread)
+ *
+ * When \p function throws, the remaining indices are still processed and the first exception is rethrown on the calling thread.
+ * @param count Number of indices
+ * @param function Function that processes an index
+ */
+void parallelForEach(std::size_t count, const std::function<void(std::size_t index)>& function);
+
+}
@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "RawDataCodec.h"
+#include "Parallel.h"
+
+#include <lz4.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace mv::util {
+
+namespace {
+
+/** Raw data is encoded in independent frames of this size (a multiple of all element sizes) */
+constexpr std::uint64_t frameSize = 4 * 1024 * 1024;
+
+/** Flag in the frame header that indicates that the frame is stored uncompressed */
+constexpr std::uint32_t storedFrameFlag = 0x80000000u;
+
+/** Groups the bytes of the elements in \p input by significance (the trailing partial element is copied as is) */
+void shuffleBytes(const std::uint8_t* input, std::uint64_t numberOfBytes, std::uint32_t elementSize, std::uint8_t* output)
+{
+    const auto numberOfElements = numberOfBytes / elementSize;
+
+    for (std::uint32_t byteIndex = 0; byteIndex < elementSize; ++byteIndex)
+        for (std::uint64_t elementIndex = 0; elementIndex < numberOfElements; ++elementIndex)
+            output[byteIndex * numberOfElements + elementIndex] = input[elementIndex * elementSize + byteIndex];
+
+    const auto numberOfShuffledBytes = numberOfElements * elementSize;
+
+    std::memcpy(output + numberOfShuffledBytes, input + numberOfShuffledBytes, numberOfBytes - numberOfShuffledBytes);
+}
+
+/** Reverts shuffleBytes() */
+void unshuffleBytes(const std::uint8_t* input, std::uint64_t numberOfBytes, std::uint32_t elementSize, std::uint8_t* output)
+{
+    const auto numberOfElements = numberOfBytes / elementSize;
+
+    for (std::uint32_t byteIndex = 0; byteIndex < elementSize; ++byteIndex)
+        for (std::uint64_t elementIndex = 0; elementIndex < numberOfElements; ++elementIndex)
+            output[elementIndex * elementSize + byteIndex] = input[byteIndex * numberOfElements + elementIndex];
+
+    const auto numberOfShuffledBytes = numberOfElements * elementSize;
+
+    std::memcpy(output + numberOfShuffledBytes, input + numberOfShuffledBytes, numberOfBytes - numberOfShuffledBytes);
+}
+
+}
+
+QString getRawDataCodecName(RawDataCodec rawDataCodec)
+{
+    switch (rawDataCodec)
+    {
+        case RawDataCodec::None:
+            return "None";
+
+        case RawDataCodec::ShuffleLz4:
+            return "ShuffleLZ4";
+    }
+
+    return "";
+}
+
+RawDataCodec getRawDataCodec(const QString& name)
+{
+    for (const auto rawDataCodec : { RawDataCodec::None, RawDataCodec::ShuffleLz4 })
+        if (getRawDataCodecName(rawDataCodec) == name)
+            return rawDataCodec;
+
+    throw std::runtime_error(QString("Unknown raw data codec: %1").arg(name).toStdString());
+}
+
+QStringList getRawDataCodecNames()
+{
+    return { getRawDataCodecName(RawDataCodec::None), getRawDataCodecName(RawDataCodec::ShuffleLz4) };
+}
+
+std::vector<char> encodeRawData(RawDataCodec rawDataCodec, const char* bytes, std::uint64_t numberOfBytes, std::uint32_t elementSize)
+{
+    if (rawDataCodec == RawDataCodec::None)
+        return { bytes, bytes + numberOfBytes };
+
+    elementSize = std::max(1u, elementSize);
+
+    const auto numberOfFrames = (numberOfBytes + frameSize - 1) / frameSize;
+
+    if (numberOfFrames == 0)
+        return {};
+
+    // The frames are encoded concurrently into slots of one buffer, which are large enough for the worst case of a frame
+    const auto frameSlotSize                = sizeof(std::uint32_t) + static_cast<std::uint64_t>(LZ4_compressBound(static_cast<int>(frameSize)));
+    const auto numberOfLastFrameBytes       = numberOfBytes - (numberOfFrames - 1) * frameSize;
+    const auto numberOfSlotBytes            = (numberOfFrames - 1) * frameSlotSize + sizeof(std::uint32_t) + static_cast<std::uint64_t>(LZ4_compressBound(static_cast<int>(numberOfLastFrameBytes)));
+
+    std::vector<char> encodedBytes(numberOfSlotBytes);
+    std::vector<std::uint64_t> numberOfEncodedFrameBytes(numberOfFrames);
+
+    parallelForEach(numberOfFrames, [&](std::uint64_t frameIndex) -> void {
+        const auto frameOffset          = frameIndex * frameSize;
+        const auto numberOfFrameBytes   = std::min(frameSize, numberOfBytes - frameOffset);
+        const auto frameBytes           = reinterpret_cast<const std::uint8_t*>(bytes) + frameOffset;
+        const auto encodedFrame         = encodedBytes.data() + frameIndex * frameSlotSize;
+
+        std::vector<std::uint8_t> shuffled(numberOfFrameBytes);
+
+        shuffleBytes(frameBytes, numberOfFrameBytes, elementSize, shuffled.data());
+
+        const auto frameCapacity = LZ4_compressBound(static_cast<int>(numberOfFrameBytes));
+
+        std::uint64_t numberOfEncodedBytes = static_cast<std::uint64_t>(LZ4_compress_default(reinterpret_cast<const char*>(shuffled.data()), encodedFrame + sizeof(std::uint32_t), static_cast<int>(numberOfFrameBytes), frameCapacity));
+
+        std::uint32_t header = static_cast<std::uint32_t>(numberOfEncodedBytes);
+
+        // Frames that do not compress are stored as is (LZ4 returns zero when it fails)
+        if (numberOfEncodedBytes == 0 || numberOfEncodedBytes >= numberOfFrameBytes) {
+            std::memcpy(encodedFrame + sizeof(std::uint32_t), frameBytes, numberOfFrameBytes);
+
+            numberOfEncodedBytes    = numberOfFrameBytes;
+            header                  = static_cast<std::uint32_t>(numberOfFrameBytes) | storedFrameFlag;
+        }
+
+        std::memcpy(encodedFrame, &header, sizeof(header));
+
+        numberOfEncodedFrameBytes[frameIndex] = sizeof(std::uint32_t) + numberOfEncodedBytes;
+    });
+
+    // Compact the frames in place (frames only move towards the front, so a frame never overwrites one that still has to move)
+    std::uint64_t numberOfEncodedBytes = 0;
+
+    for (std::uint64_t frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex) {
+        const auto frameSlotOffset = frameIndex * frameSlotSize;
+
+        if (frameSlotOffset != numberOfEncodedBytes)
+            std::memmove(encodedBytes.data() + numberOfEncodedBytes, encodedBytes.data() + frameSlotOffset, numberOfEncodedFrameBytes[frameIndex]);
+
+        numberOfEncodedBytes += numberOfEncodedFrameBytes[frameIndex];
+    }
+
+    // Not shrunk to fit, as that would copy the encoded bytes once more
+    encodedBytes.resize(numberOfEncodedBytes);
+
+    return encodedBytes;
+}
+
+void decodeRawData(RawDataCodec rawDataCodec, const char* encodedBytes, std::uint64_t numberOfEncodedBytes, char* bytes, std::uint64_t numberOfBytes, std::uint32_t elementSize)
+{
+    if (rawDataCodec == RawDataCodec::None) {
+        if (numberOfEncodedBytes != numberOfBytes)
+            throw std::runtime_error("Unable to decode raw data, the number of bytes is incorrect");
+
+        std::memcpy(bytes, encodedBytes, numberOfBytes);
+
+        return;
+    }
+
+    elementSize = std::max(1u, elementSize);
+
+    const auto numberOfFrames = (numberOfBytes + frameSize - 1) / frameSize;
+
+    // Locate the frames first, so that they can be decoded concurrently
+    std::vector<std::uint64_t> frameOffsets(numberOfFrames);
+    std::vector<std::uint32_t> frameHeaders(numberOfFrames);
+
+    std::uint64_t encodedOffset = 0;
+
+    for (std::uint64_t frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex) {
+        if (numberOfEncodedBytes - encodedOffset < sizeof(std::uint32_t))
+            throw std::runtime_error("Unable to decode raw data, frame header exceeds the data");
+
+        std::memcpy(&frameHeaders[frameIndex], encodedBytes + encodedOffset, sizeof(std::uint32_t));
+
+        frameOffsets[frameIndex] = encodedOffset + sizeof(std::uint32_t);
+
+        encodedOffset = frameOffsets[frameIndex] + (frameHeaders[frameIndex] & ~storedFrameFlag);
+
+        if (encodedOffset > numberOfEncodedBytes)
+            throw std::runtime_error("Unable to decode raw data, frame exceeds the data");
+    }
+
+    if (encodedOffset != numberOfEncodedBytes)
+        throw std::runtime_error("Unable to decode raw data, the number of encoded bytes is incorrect");
+
+    parallelForEach(numberOfFrames, [&](std::uint64_t frameIndex) -> void {
+        const auto frameOffset              = frameIndex * frameSize;
+        const auto numberOfFrameBytes       = std::min(frameSize, numberOfBytes - frameOffset);
+        const auto numberOfEncodedFrameBytes = static_cast<std::uint64_t>(frameHeaders[frameIndex] & ~storedFrameFlag);
+        const auto encodedFrame             = reinterpret_cast<const std::uint8_t*>(encodedBytes) + frameOffsets[frameIndex];
+        const auto frameBytes               = reinterpret_cast<std::uint8_t*>(bytes) + frameOffset;
+
+        if (frameHeaders[frameIndex] & storedFrameFlag) {
+            if (numberOfEncodedFrameBytes != numberOfFrameBytes)
+                throw std::runtime_error("Unable to decode raw data, the size of a stored frame is incorrect");
+
+            std::memcpy(frameBytes, encodedFrame, numberOfFrameBytes);
+
+            return;
+        }
+
+        std::vector<std::uint8_t> shuffled(numberOfFrameBytes);
+
+        const auto numberOfDecodedBytes = LZ4_decompress_safe(reinterpret_cast<const char*>(encodedFrame), reinterpret_cast<char*>(shuffled.data()), static_cast<int>(numberOfEncodedFrameBytes), static_cast<int>(numberOfFrameBytes));
+
+        if (numberOfDecodedBytes < 0 || static_cast<std::uint64_t>(numberOfDecodedBytes) != numberOfFrameBytes)
+            throw std::runtime_error("Unable to decode LZ4 block, the encoded data is corrupt");
+
+        unshuffleBytes(shuffled.data(), numberOfFrameBytes, elementSize, frameBytes);
+    });
+}
+
+}
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+#include <vector>
+
+namespace mv::util {
+
+/**
+ * Codecs for raw data blocks of a project
+ *
+ * ShuffleLz4 first regroups the bytes of the elements by significance (all first bytes, then all
+ * second bytes, etc.), so that the slowly varying sign/exponent bytes of float32 and bfloat16 data
+ * become long runs, and then compresses them in the LZ4 block format. The data is divided into
+ * frames that are encoded and decoded concurrently.
+ */
+enum class RawDataCodec
+{
+    None,           /** Raw data is stored as is */
+    ShuffleLz4      /** Byte shuffle followed by LZ4 block compression */
+};
+
+/**
+ * Get the name of \p rawDataCodec (as stored in the block metadata)
+ * @param rawDataCodec Raw data codec
+ * @return Name of the codec
+ */
+QString getRawDataCodecName(RawDataCodec rawDataCodec);
+
+/**
+ * Get the raw data codec with \p name, throws a std::runtime_error when the codec is unknown
+ * @param name Name of the codec
+ * @return Raw data codec
+ */
+RawDataCodec getRawDataCodec(const QString& name);
+
+/** Get the names of all raw data codecs, in the order of the enumeration */
+QStringList getRawDataCodecNames();
+
+/**
+ * Encodes \p numberOfBytes of raw data with \p rawDataCodec (the frames are encoded into, and compacted within, a single buffer)
+ * @param rawDataCodec Raw data codec
+ * @param bytes Pointer to input buffer
+ * @param numberOfBytes Number of input bytes
+ * @param elementSize Size of the data elements in bytes (used for the byte shuffle)
+ * @return Encoded bytes
+ */
+std::vector<char> encodeRawData(RawDataCodec rawDataCodec, const char* bytes, std::uint64_t numberOfBytes, std::uint32_t elementSize);
+
+/**
+ * Decodes raw data that was encoded with \p rawDataCodec, throws a std::runtime_error when the encoded data is corrupt
+ * @param rawDataCodec Raw data codec
+ * @param encodedBytes Pointer to the encoded bytes
+ * @param numberOfEncodedBytes Number of encoded bytes
+ * @param bytes Pointer to output buffer
+ * @param numberOfBytes Number of output bytes
+ * @param elementSize Size of the data elements in bytes (as used for encoding)
+ */
+void decodeRawData(RawDataCodec rawDataCodec, const char* encodedBytes, std::uint64_t numberOfEncodedBytes, char* bytes, std::uint64_t numberOfBytes, std::uint32_t elementSize);
+
+}
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "ScalarStatistics.h"
+
+#include <cmath>
+
+namespace mv::util {
+
+namespace
+{
+    constexpr std::size_t   MINIMUM_CHUNK_SIZE      = 1 << 16;  /** Minimum number of scalars per chunk (smaller chunks do not pay off the scheduling) */
+    constexpr std::uint32_t MAXIMUM_NUMBER_OF_BINS  = 1024;     /** Maximum number of adaptive histogram bins */
+}
+
+std::uint32_t getAdaptiveNumberOfBins(std::uint64_t numberOfValues)
+{
+    const auto numberOfBins = std::ceil(2.0 * std::cbrt(static_cast<double>(numberOfValues)));
+
+    return std::clamp(static_cast<std::uint32_t>(std::min(numberOfBins, static_cast<double>(MAXIMUM_NUMBER_OF_BINS))), 1u, MAXIMUM_NUMBER_OF_BINS);
+}
+
+std::size_t getNumberOfStatisticsChunks(std::size_t numberOfValues)
+{
+    return getNumberOfParallelRanges(numberOfValues, MINIMUM_CHUNK_SIZE);
+}
+
+}
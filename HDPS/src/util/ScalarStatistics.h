@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#pragma once
+
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace mv::util {
+
+/**
+ * Scalar statistics
+ *
+ * Range, mean and histogram of a series of scalars, as used for color map ranges and histograms.
+ * Non-finite scalars (NaN and infinity) are ignored.
+ */
+struct ScalarStatistics
+{
+    std::uint64_t               numberOfValues  = 0;        /** Number of finite scalars */
+    float                       minimum         = 0.0f;     /** Minimum finite scalar */
+    float                       maximum         = 0.0f;     /** Maximum finite scalar */
+    double                      mean            = 0.0;      /** Mean of the finite scalars */
+    std::vector<std::uint32_t>  histogram;                  /** Number of scalars per bin, the bins divide [minimum, maximum] uniformly (empty when not requested) */
+
+    /** Get whether there is at least one finite scalar */
+    bool isValid() const {
+        return numberOfValues > 0;
+    }
+};
+
+constexpr std::uint32_t NO_HISTOGRAM             = 0;                                         /** Do not compute a histogram */
+constexpr std::uint32_t ADAPTIVE_NUMBER_OF_BINS  = std::numeric_limits<std::uint32_t>::max();   /** Choose the number of histogram bins from the number of scalars */
+
+/**
+ * Get the number of histogram bins for \p numberOfValues scalars (Rice rule, at most 1024 bins)
+ * @param numberOfValues Number of scalars
+ * @return Number of histogram bins
+ */
+std::uint32_t getAdaptiveNumberOfBins(std::uint64_t numberOfValues);
+
+/**
+ * Get the number of chunks in which \p numberOfValues scalars are processed concurrently
+ * @param numberOfValues Number of scalars
+ * @return Number of chunks (at most one per hardware thread)
+ */
+std::size_t getNumberOfStatisticsChunks(std::size_t numberOfValues);
+
+/**
+ * Computes the statistics of \p numberOfValues scalars, which are \p stride elements apart (for instance a
+ * dimension of row-major point data). The range and mean are computed in one pass, the histogram (if requested)
+ * in a second pass, both concurrently over chunks of the scalars. The inner loops use independent accumulators
+ * per lane, so that the compiler vectorizes them for contiguous scalars.
+ * @param values Pointer to the first scalar (float or any other point data element type)
+ * @param numberOfValues Number of scalars
+ * @param stride Distance between consecutive scalars, in elements
+ * @param numberOfBins Number of histogram bins (NO_HISTOGRAM or ADAPTIVE_NUMBER_OF_BINS are allowed too)
+ * @return Scalar statistics
+ */
+template<typename ElementType>
+ScalarStatistics computeScalarStatistics(const ElementType* values, std::size_t numberOfValues, std::size_t stride = 1, std::uint32_t numberOfBins = NO_HISTOGRAM)
+{
+    constexpr std::size_t NUMBER_OF_LANES   = 8;        /** Number of independent accumulators */
+    constexpr std::size_t BLOCK_SIZE        = 4096;     /** Number of scalars summed in single precision before they are added in double precision */
+
+    /** Statistics of a chunk */
+    struct Partial
+    {
+        float           minimum         = std::numeric_limits<float>::max();
+        float           maximum         = std::numeric_limits<float>::lowest();
+        double          sum             = 0.0;
+        std::uint64_t   numberOfValues  = 0;
+    };
+
+    const auto numberOfChunks   = getNumberOfStatisticsChunks(numberOfValues);
+    const auto chunkSize        = numberOfChunks == 0 ? 0 : (numberOfValues + numberOfChunks - 1) / numberOfChunks;
+
+    std::vector<Partial> partials(numberOfChunks);
+
+    parallelForEach(numberOfChunks, [&](std::size_t chunkIndex) -> void {
+        const auto begin    = chunkIndex * chunkSize;
+        const auto end      = std::min(begin + chunkSize, numberOfValues);
+
+        float           minima[NUMBER_OF_LANES], maxima[NUMBER_OF_LANES];
+        std::uint32_t   counts[NUMBER_OF_LANES];
+
+        std::fill_n(minima, NUMBER_OF_LANES, std::numeric_limits<float>::max());
+        std::fill_n(maxima, NUMBER_OF_LANES, std::numeric_limits<float>::lowest());
+
+        auto& partial = partials[chunkIndex];
+
+        for (auto blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE) {
+            const auto blockEnd = std::min(blockBegin + BLOCK_SIZE, end);
+
+            float sums[NUMBER_OF_LANES] = {};
+
+            std::fill_n(counts, NUMBER_OF_LANES, 0u);
+
+            auto index = blockBegin;
+
+            for (; index + NUMBER_OF_LANES <= blockEnd; index += NUMBER_OF_LANES) {
+                for (std::size_t lane = 0; lane < NUMBER_OF_LANES; ++lane) {
+                    const auto value    = static_cast<float>(values[(index + lane) * stride]);
+                    const auto isFinite = value - value == 0.0f;
+
+                    minima[lane]    = isFinite && value < minima[lane] ? value : minima[lane];
+                    maxima[lane]    = isFinite && value > maxima[lane] ? value : maxima[lane];
+                    sums[lane]      += isFinite ? value : 0.0f;
+                    counts[lane]    += isFinite ? 1u : 0u;
+                }
+            }
+
+            for (; index < blockEnd; ++index) {
+                const auto value    = static_cast<float>(values[index * stride]);
+                const auto isFinite = value - value == 0.0f;
+
+                minima[0]   = isFinite && value < minima[0] ? value : minima[0];
+                maxima[0]   = isFinite && value > maxima[0] ? value : maxima[0];
+                sums[0]     += isFinite ? value : 0.0f;
+                counts[0]   += isFinite ? 1u : 0u;
+            }
+
+            for (std::size_t lane = 0; lane < NUMBER_OF_LANES; ++lane) {
+                partial.sum             += sums[lane];
+                partial.numberOfValues  += counts[lane];
+            }
+        }
+
+        for (std::size_t lane = 0; lane < NUMBER_OF_LANES; ++lane) {
+            partial.minimum = std::min(partial.minimum, minima[lane]);
+            partial.maximum = std::max(partial.maximum, maxima[lane]);
+        }
+    });
+
+    ScalarStatistics statistics;
+
+    Partial total;
+
+    for (const auto& partial : partials) {
+        total.minimum           = std::min(total.minimum, partial.minimum);
+        total.maximum           = std::max(total.maximum, partial.maximum);
+        total.sum               += partial.sum;
+        total.numberOfValues    += partial.numberOfValues;
+    }
+
+    if (total.numberOfValues == 0)
+        return statistics;
+
+    statistics.numberOfValues   = total.numberOfValues;
+    statistics.minimum          = total.minimum;
+    statistics.maximum          = total.maximum;
+    statistics.mean             = total.sum / static_cast<double>(total.numberOfValues);
+
+    if (numberOfBins == NO_HISTOGRAM)
+        return statistics;
+
+    if (numberOfBins == ADAPTIVE_NUMBER_OF_BINS)
+        numberOfBins = getAdaptiveNumberOfBins(statistics.numberOfValues);
+
+    // Count the scalars per bin for each chunk and add the chunk histograms afterwards
+    std::vector<std::vector<std::uint32_t>> histograms(numberOfChunks, std::vector<std::uint32_t>(numberOfBins, 0));
+
+    const auto range            = statistics.maximum - statistics.minimum;
+    const auto binsPerUnit      = range > 0.0f ? static_cast<float>(numberOfBins) / range : 0.0f;
+    const auto lastBinIndex     = static_cast<float>(numberOfBins - 1);
+    const auto minimum          = statistics.minimum;
+    const auto maximum          = statistics.maximum;
+
+    parallelForEach(numberOfChunks, [&](std::size_t chunkIndex) -> void {
+        const auto begin    = chunkIndex * chunkSize;
+        const auto end      = std::min(begin + chunkSize, numberOfValues);
+
+        auto& histogram = histograms[chunkIndex];
+
+        for (auto index = begin; index < end; ++index) {
+            const auto value = static_cast<float>(values[index * stride]);
+
+            // Skips non-finite scalars
+            if (!(value >= minimum && value <= maximum))
+                continue;
+
+            ++histogram[static_cast<std::uint32_t>(std::min((value - minimum) * binsPerUnit, lastBinIndex))];
+        }
+    });
+
+    statistics.histogram.assign(numberOfBins, 0);
+
+    for (const auto& histogram : histograms)
+        for (std::uint32_t binIndex = 0; binIndex < numberOfBins; ++binIndex)
+            statistics.histogram[binIndex] += histogram[binIndex];
+
+    return statistics;
+}
+
+}
@@ -0,0 +1,471 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#include "SelectionBitmap.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+namespace mv::util {
+
+namespace {
+
+/** Get the number of set bits in \p words */
+std::uint32_t countBits(const std::vector<std::uint64_t>& words)
+{
+    std::uint32_t count = 0;
+
+    for (const auto word : words)
+        count += static_cast<std::uint32_t>(std::bitset<64>(word).count());
+
+    return count;
+}
+
+/** Get whether bit \p value is set in \p words */
+bool testBit(const std::vector<std::uint64_t>& words, std::uint32_t value)
+{
+    return (words[value >> 6] & (std::uint64_t(1) << (value & 63))) != 0;
+}
+
+/** Sets the bits in the half-open range [\p begin, \p end) of \p words */
+void setBits(std::vector<std::uint64_t>& words, std::uint32_t begin, std::uint32_t end)
+{
+    auto value = begin;
+
+    for (; value < end && (value & 63) != 0; ++value)
+        words[value >> 6] |= std::uint64_t(1) << (value & 63);
+
+    for (; value + 64 <= end; value += 64)
+        words[value >> 6] = ~std::uint64_t(0);
+
+    for (; value < end; ++value)
+        words[value >> 6] |= std::uint64_t(1) << (value & 63);
+}
+
+}
+
+SelectionBitmap::SelectionBitmap(const std::vector<std::uint32_t>& indices)
+{
+    if (indices.empty())
+        return;
+
+    const auto maximumKey = *std::max_element(indices.begin(), indices.end()) >> 16;
+
+    // Count the indices per chunk first, so that the representation of each chunk is known up front
+    std::vector<std::uint32_t> counts(maximumKey + 1, 0);
+
+    for (const auto index : indices)
+        counts[index >> 16]++;
+
+    std::vector<std::uint32_t> chunkIndices(maximumKey + 1, 0);
+
+    for (std::uint32_t key = 0; key <= maximumKey; ++key) {
+        if (counts[key] == 0)
+            continue;
+
+        chunkIndices[key] = static_cast<std::uint32_t>(_chunks.size());
+
+        Chunk chunk;
+
+        chunk._key = static_cast<std::uint16_t>(key);
+
+        if (counts[key] > maximumArraySize)
+            chunk._words.resize(numberOfWordsPerBitset, 0);
+        else
+            chunk._values.reserve(counts[key]);
+
+        _chunks.push_back(std::move(chunk));
+    }
+
+    for (const auto index : indices) {
+        auto& chunk = _chunks[chunkIndices[index >> 16]];
+
+        const auto value = static_cast<std::uint16_t>(index & 0xFFFF);
+
+        if (chunk.isBitset())
+            chunk._words[value >> 6] |= std::uint64_t(1) << (value & 63);
+        else
+            chunk._values.push_back(value);
+    }
+
+    // Indices might be unsorted and contain duplicates
+    for (auto& chunk : _chunks) {
+        if (chunk.isBitset()) {
+            chunk._count = countBits(chunk._words);
+        }
+        else {
+            if (!std::is_sorted(chunk._values.begin(), chunk._values.end()))
+                std::sort(chunk._values.begin(), chunk._values.end());
+
+            chunk._values.erase(std::unique(chunk._values.begin(), chunk._values.end()), chunk._values.end());
+        }
+
+        chunk.optimize();
+    }
+}
+
+SelectionBitmap SelectionBitmap::fromRange(std::uint32_t begin, std::uint32_t end)
+{
+    SelectionBitmap selectionBitmap;
+
+    if (begin >= end)
+        return selectionBitmap;
+
+    const auto last = end - 1;
+
+    for (std::uint32_t key = begin >> 16; key <= (last >> 16); ++key) {
+        const auto chunkBegin   = (key == (begin >> 16)) ? (begin & 0xFFFF) : 0u;
+        const auto chunkEnd     = (key == (last >> 16)) ? (last & 0xFFFF) + 1 : 65536u;
+
+        Chunk chunk;
+
+        chunk._key = static_cast<std::uint16_t>(key);
+
+        if (chunkEnd - chunkBegin > maximumArraySize) {
+            chunk._words.resize(numberOfWordsPerBitset, 0);
+            chunk._count = chunkEnd - chunkBegin;
+
+            setBits(chunk._words, chunkBegin, chunkEnd);
+        }
+        else {
+            chunk._values.resize(chunkEnd - chunkBegin);
+
+            for (std::uint32_t value = chunkBegin; value < chunkEnd; ++value)
+                chunk._values[value - chunkBegin] = static_cast<std::uint16_t>(value);
+        }
+
+        selectionBitmap._chunks.push_back(std::move(chunk));
+    }
+
+    return selectionBitmap;
+}
+
+void SelectionBitmap::add(std::uint32_t index)
+{
+    const auto key      = static_cast<std::uint16_t>(index >> 16);
+    const auto value    = static_cast<std::uint16_t>(index & 0xFFFF);
+
+    auto chunkIt = std::lower_bound(_chunks.begin(), _chunks.end(), key, [](const Chunk& chunk, std::uint16_t key) {
+        return chunk._key < key;
+    });
+
+    if (chunkIt == _chunks.end() || chunkIt->_key != key) {
+        Chunk chunk;
+
+        chunk._key = key;
+        chunk._values.push_back(value);
+
+        _chunks.insert(chunkIt, std::move(chunk));
+        return;
+    }
+
+    if (chunkIt->isBitset()) {
+        if (!testBit(chunkIt->_words, value)) {
+            chunkIt->_words[value >> 6] |= std::uint64_t(1) << (value & 63);
+            chunkIt->_count++;
+        }
+    }
+    else {
+        auto valueIt = std::lower_bound(chunkIt->_values.begin(), chunkIt->_values.end(), value);
+
+        if (valueIt == chunkIt->_values.end() || *valueIt != value) {
+            chunkIt->_values.insert(valueIt, value);
+            chunkIt->optimize();
+        }
+    }
+}
+
+bool SelectionBitmap::contains(std::uint32_t index) const
+{
+    const auto chunk = findChunk(static_cast<std::uint16_t>(index >> 16));
+
+    if (chunk == nullptr)
+        return false;
+
+    const auto value = static_cast<std::uint16_t>(index & 0xFFFF);
+
+    if (chunk->isBitset())
+        return testBit(chunk->_words, value);
+
+    return std::binary_search(chunk->_values.begin(), chunk->_values.end(), value);
+}
+
+std::uint64_t SelectionBitmap::count() const
+{
+    std::uint64_t count = 0;
+
+    for (const auto& chunk : _chunks)
+        count += chunk.count();
+
+    return count;
+}
+
+bool SelectionBitmap::isEmpty() const
+{
+    return _chunks.empty();
+}
+
+void SelectionBitmap::clear()
+{
+    _chunks.clear();
+}
+
+std::vector<std::uint32_t> SelectionBitmap::toIndices() const
+{
+    std::vector<std::uint32_t> indices;
+
+    indices.reserve(count());
+
+    forEach([&indices](std::uint32_t index) {
+        indices.push_back(index);
+    });
+
+    return indices;
+}
+
+void SelectionBitmap::invert(std::uint32_t size)
+{
+    auto inverted = fromRange(0, size);
+
+    inverted -= *this;
+
+    *this = std::move(inverted);
+}
+
+SelectionBitmap& SelectionBitmap::operator |= (const SelectionBitmap& other)
+{
+    combine(other, Operation::Union);
+
+    return *this;
+}
+
+SelectionBitmap& SelectionBitmap::operator &= (const SelectionBitmap& other)
+{
+    combine(other, Operation::Intersection);
+
+    return *this;
+}
+
+SelectionBitmap& SelectionBitmap::operator -= (const SelectionBitmap& other)
+{
+    combine(other, Operation::Difference);
+
+    return *this;
+}
+
+SelectionBitmap& SelectionBitmap::operator ^= (const SelectionBitmap& other)
+{
+    combine(other, Operation::SymmetricDifference);
+
+    return *this;
+}
+
+bool SelectionBitmap::operator == (const SelectionBitmap& other) const
+{
+    // Chunks are always stored in their most compact representation, so equal sets have equal chunks
+    return std::equal(_chunks.begin(), _chunks.end(), other._chunks.begin(), other._chunks.end(), [](const Chunk& lhs, const Chunk& rhs) {
+        return lhs._key == rhs._key && lhs._values == rhs._values && lhs._words == rhs._words;
+    });
+}
+
+void SelectionBitmap::Chunk::toBitset()
+{
+    if (isBitset())
+        return;
+
+    _words.resize(numberOfWordsPerBitset, 0);
+
+    for (const auto value : _values)
+        _words[value >> 6] |= std::uint64_t(1) << (value & 63);
+
+    _count = static_cast<std::uint32_t>(_values.size());
+
+    _values.clear();
+    _values.shrink_to_fit();
+}
+
+void SelectionBitmap::Chunk::optimize()
+{
+    if (isBitset() && _count <= maximumArraySize) {
+        _values.clear();
+        _values.reserve(_count);
+
+        for (std::uint32_t wordIndex = 0; wordIndex < numberOfWordsPerBitset; ++wordIndex) {
+            auto word = _words[wordIndex];
+
+            while (word != 0) {
+                _values.push_back(static_cast<std::uint16_t>(wordIndex * 64 + countTrailingZeros(word)));
+                word &= word - 1;
+            }
+        }
+
+        _words.clear();
+        _words.shrink_to_fit();
+        _count = 0;
+    }
+    else if (!isBitset() && _values.size() > maximumArraySize) {
+        toBitset();
+    }
+}
+
+const SelectionBitmap::Chunk* SelectionBitmap::findChunk(std::uint16_t key) const
+{
+    auto chunkIt = std::lower_bound(_chunks.begin(), _chunks.end(), key, [](const Chunk& chunk, std::uint16_t key) {
+        return chunk._key < key;
+    });
+
+    if (chunkIt == _chunks.end() || chunkIt->_key != key)
+        return nullptr;
+
+    return &*chunkIt;
+}
+
+SelectionBitmap::Chunk SelectionBitmap::combineChunks(const Chunk& lhs, const Chunk& rhs, Operation operation)
+{
+    Chunk result;
+
+    result._key = lhs._key;
+
+    if (!lhs.isBitset() && !rhs.isBitset()) {
+        auto output = std::back_inserter(result._values);
+
+        switch (operation)
+        {
+            case Operation::Union:
+                std::set_union(lhs._values.begin(), lhs._values.end(), rhs._values.begin(), rhs._values.end(), output);
+                break;
+
+            case Operation::Intersection:
+                std::set_intersection(lhs._values.begin(), lhs._values.end(), rhs._values.begin(), rhs._values.end(), output);
+                break;
+
+            case Operation::Difference:
+                std::set_difference(lhs._values.begin(), lhs._values.end(), rhs._values.begin(), rhs._values.end(), output);
+                break;
+
+            case Operation::SymmetricDifference:
+                std::set_symmetric_difference(lhs._values.begin(), lhs._values.end(), rhs._values.begin(), rhs._values.end(), output);
+                break;
+        }
+
+        result.optimize();
+
+        return result;
+    }
+
+    // Filtering an array by a bitset is cheaper than converting the array to a bitset
+    if (!lhs.isBitset() && (operation == Operation::Intersection || operation == Operation::Difference)) {
+        const auto keep = operation == Operation::Intersection;
+
+        std::copy_if(lhs._values.begin(), lhs._values.end(), std::back_inserter(result._values), [&rhs, keep](std::uint16_t value) {
+            return testBit(rhs._words, value) == keep;
+        });
+
+        return result;
+    }
+
+    if (!rhs.isBitset() && operation == Operation::Intersection) {
+        std::copy_if(rhs._values.begin(), rhs._values.end(), std::back_inserter(result._values), [&lhs](std::uint16_t value) {
+            return testBit(lhs._words, value);
+        });
+
+        return result;
+    }
+
+    Chunk lhsBitset, rhsBitset;
+
+    if (!lhs.isBitset()) {
+        lhsBitset = lhs;
+        lhsBitset.toBitset();
+    }
+
+    if (!rhs.isBitset()) {
+        rhsBitset = rhs;
+        rhsBitset.toBitset();
+    }
+
+    const auto& lhsWords = lhs.isBitset() ? lhs._words : lhsBitset._words;
+    const auto& rhsWords = rhs.isBitset() ? rhs._words : rhsBitset._words;
+
+    result._words.resize(numberOfWordsPerBitset);
+
+    for (std::uint32_t wordIndex = 0; wordIndex < numberOfWordsPerBitset; ++wordIndex) {
+        switch (operation)
+        {
+            case Operation::Union:
+                result._words[wordIndex] = lhsWords[wordIndex] | rhsWords[wordIndex];
+                break;
+
+            case Operation::Intersection:
+                result._words[wordIndex] = lhsWords[wordIndex] & rhsWords[wordIndex];
+                break;
+
+            case Operation::Difference:
+                result._words[wordIndex] = lhsWords[wordIndex] & ~rhsWords[wordIndex];
+                break;
+
+            case Operation::SymmetricDifference:
+                result._words[wordIndex] = lhsWords[wordIndex] ^ rhsWords[wordIndex];
+                break;
+        }
+    }
+
+    result._count = countBits(result._words);
+    result.optimize();
+
+    return result;
+}
+
+void SelectionBitmap::combine(const SelectionBitmap& other, Operation operation)
+{
+    // The chunks of this selection bitmap are moved while combining
+    if (&other == this) {
+        const auto copy = other;
+
+        combine(copy, operation);
+        return;
+    }
+
+    // Chunks that only occur in this selection bitmap are kept, except by an intersection
+    const auto keepOwnChunks    = operation != Operation::Intersection;
+
+    // Chunks that only occur in the other selection bitmap are copied by a union and a symmetric difference
+    const auto copyOtherChunks  = operation == Operation::Union || operation == Operation::SymmetricDifference;
+
+    std::vector<Chunk> chunks;
+
+    chunks.reserve(_chunks.size() + (copyOtherChunks ? other._chunks.size() : 0));
+
+    auto lhsIt = _chunks.begin();
+    auto rhsIt = other._chunks.begin();
+
+    while (lhsIt != _chunks.end() || rhsIt != other._chunks.end()) {
+        if (rhsIt == other._chunks.end() || (lhsIt != _chunks.end() && lhsIt->_key < rhsIt->_key)) {
+            if (keepOwnChunks)
+                chunks.push_back(std::move(*lhsIt));
+
+            ++lhsIt;
+        }
+        else if (lhsIt == _chunks.end() || rhsIt->_key < lhsIt->_key) {
+            if (copyOtherChunks)
+                chunks.push_back(*rhsIt);
+
+            ++rhsIt;
+        }
+        else {
+            auto chunk = combineChunks(*lhsIt, *rhsIt, operation);
+
+            if (chunk.count() > 0)
+                chunks.push_back(std::move(chunk));
+
+            ++lhsIt;
+            ++rhsIt;
+        }
+    }
+
+    _chunks = std::move(chunks);
+}
+
+}
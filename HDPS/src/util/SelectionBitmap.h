@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later 
+// A corresponding LICENSE file is located in the root directory of this source tree 
+// Copyright (C) 2023 BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft) 
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace mv::util {
+
+/**
+ * Selection bitmap class
+ *
+ * Compressed set of (32-bit) point indices, for fast set operations on large selections.
+ *
+ * Follows the design of roaring bitmaps: the index range is partitioned into chunks of
+ * 65536 indices (keyed by the upper 16 bits of the index). Sparse chunks store the lower
+ * 16 bits of their indices in a sorted array, dense chunks store them as a bitset of 8 kB.
+ * So memory use is proportional to the number of selected indices rather than to the
+ * number of points, while a selection of all points costs only one bit per point.
+ */
+class SelectionBitmap
+{
+public: // Construction
+
+    /** Constructs an empty selection bitmap */
+    SelectionBitmap() = default;
+
+    /**
+     * Constructs a selection bitmap from \p indices (which do not need to be sorted or unique)
+     * @param indices Point indices
+     */
+    explicit SelectionBitmap(const std::vector<std::uint32_t>& indices);
+
+    /**
+     * Constructs a selection bitmap that contains all indices in the half-open range [\p begin, \p end)
+     * @param begin First index in the range
+     * @param end One beyond the last index in the range
+     */
+    static SelectionBitmap fromRange(std::uint32_t begin, std::uint32_t end);
+
+public: // Element access
+
+    /**
+     * Adds \p index to the selection
+     * @param index Point index
+     */
+    void add(std::uint32_t index);
+
+    /**
+     * Establishes whether \p index is in the selection
+     * @param index Point index
+     * @return Boolean determining whether the index is selected
+     */
+    bool contains(std::uint32_t index) const;
+
+    /** Get the number of selected indices */
+    std::uint64_t count() const;
+
+    /** Get whether the selection is empty */
+    bool isEmpty() const;
+
+    /** Removes all indices from the selection */
+    void clear();
+
+    /**
+     * Calls \p function for each selected index, in ascending order
+     * @param function Function that takes a std::uint32_t index
+     */
+    template<typename Function>
+    void forEach(Function function) const
+    {
+        for (const auto& chunk : _chunks) {
+            const auto offset = static_cast<std::uint32_t>(chunk._key) << 16;
+
+            if (chunk.isBitset()) {
+                for (std::uint32_t wordIndex = 0; wordIndex < numberOfWordsPerBitset; ++wordIndex) {
+                    auto word = chunk._words[wordIndex];
+
+                    while (word != 0) {
+                        function(offset + wordIndex * 64 + countTrailingZeros(word));
+                        word &= word - 1;
+                    }
+                }
+            }
+            else {
+                for (const auto value : chunk._values)
+                    function(offset + value);
+            }
+        }
+    }
+
+    /** Get the selected indices as sorted vector */
+    std::vector<std::uint32_t> toIndices() const;
+
+public: // Set operations
+
+    /**
+     * Inverts the selection within the range [0, \p size) (indices beyond the range are removed)
+     * @param size Number of points in the range
+     */
+    void invert(std::uint32_t size);
+
+    /** Union with \p other */
+    SelectionBitmap& operator |= (const SelectionBitmap& other);
+
+    /** Intersection with \p other */
+    SelectionBitmap& operator &= (const SelectionBitmap& other);
+
+    /** Difference: removes the indices of \p other from the selection */
+    SelectionBitmap& operator -= (const SelectionBitmap& other);
+
+    /** Symmetric difference: toggles the indices of \p other in the selection */
+    SelectionBitmap& operator ^= (const SelectionBitmap& other);
+
+    /** Equality operator */
+    bool operator == (const SelectionBitmap& other) const;
+
+    /** Inequality operator */
+    bool operator != (const SelectionBitmap& other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    /** Chunks with more indices than this are stored as bitset */
+    static constexpr std::uint32_t maximumArraySize = 4096;
+
+    /** Number of 64-bit words in the bitset of a dense chunk */
+    static constexpr std::uint32_t numberOfWordsPerBitset = 65536 / 64;
+
+    /** Indices that share the same upper 16 bits */
+    struct Chunk
+    {
+        /** Get whether the indices are stored as bitset (otherwise as sorted array) */
+        bool isBitset() const {
+            return !_words.empty();
+        }
+
+        /** Get the number of indices in the chunk */
+        std::uint32_t count() const {
+            return isBitset() ? _count : static_cast<std::uint32_t>(_values.size());
+        }
+
+        /** Converts the chunk to a bitset */
+        void toBitset();
+
+        /** Converts the chunk to the most compact representation, given its number of indices */
+        void optimize();
+
+        std::uint16_t                   _key = 0;       /** Upper 16 bits of the indices */
+        std::uint32_t                   _count = 0;     /** Number of indices (only maintained for bitsets) */
+        std::vector<std::uint16_t>      _values;        /** Sorted lower 16 bits of the indices (array chunk) */
+        std::vector<std::uint64_t>      _words;         /** Bitset of the lower 16 bits of the indices (bitset chunk) */
+    };
+
+    /** Get the number of trailing zero bits of (non-zero) \p word */
+    static std::uint32_t countTrailingZeros(std::uint64_t word) {
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanForward64(&index, word);
+        return index;
+#else
+        return static_cast<std::uint32_t>(__builtin_ctzll(word));
+#endif
+    }
+
+    /** Get the chunk with \p key (nullptr if there is none) */
+    const Chunk* findChunk(std::uint16_t key) const;
+
+    /** Set operations that combine two selection bitmaps */
+    enum class Operation
+    {
+        Union,
+        Intersection,
+        Difference,
+        SymmetricDifference
+    };
+
+    /** Combines chunks \p lhs and \p rhs (which have the same key) by \p operation */
+    static Chunk combineChunks(const Chunk& lhs, const Chunk& rhs, Operation operation);
+
+    /** Combines this selection bitmap with \p other by \p operation */
+    void combine(const SelectionBitmap& other, Operation operation);
+
+private:
+    std::vector<Chunk>  _chunks;    /** Non-empty chunks, sorted by key */
+};
+
+}
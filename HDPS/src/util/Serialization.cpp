@@ -4,9 +4,12 @@
 
 #include "Serialization.h"
 #include "Application.h"
+#include "RawDataCodec.h"
 
 #include <QUuid>
 
+#include <algorithm>
+#include <cstdint>
 #include <exception>
 
 #include <math.h>
@@ -15,7 +18,64 @@ namespace mv {
 
 namespace util {
 
-void saveRawDataToBinaryFile(const char* bytes, const std::uint64_t& numberOfBytes, const QString& filePath)
+namespace {
+
+/** Raw data is written and read in chunks of this size, directly from and to the buffer of the caller */
+constexpr std::uint64_t streamChunkSize = 64 * 1024 * 1024;
+
+/** Lookup tables for CRC-32 (reflected polynomial 0xEDB88320), for processing eight bytes at a time */
+struct ChecksumTables
+{
+    constexpr ChecksumTables() :
+        _tables()
+    {
+        for (std::uint32_t index = 0; index < 256; ++index) {
+            auto value = index;
+
+            for (int bit = 0; bit < 8; ++bit)
+                value = (value >> 1) ^ ((value & 1) ? 0xEDB88320u : 0u);
+
+            _tables[0][index] = value;
+        }
+
+        for (std::uint32_t index = 0; index < 256; ++index)
+            for (int tableIndex = 1; tableIndex < 8; ++tableIndex)
+                _tables[tableIndex][index] = (_tables[tableIndex - 1][index] >> 8) ^ _tables[0][_tables[tableIndex - 1][index] & 0xFF];
+    }
+
+    std::uint32_t _tables[8][256];
+};
+
+constexpr ChecksumTables checksumTables;
+
+}
+
+std::uint32_t computeChecksum(const char* bytes, const std::uint64_t& numberOfBytes, std::uint32_t checksum /*= 0*/)
+{
+    const auto& tables  = checksumTables._tables;
+    const auto data     = reinterpret_cast<const std::uint8_t*>(bytes);
+
+    auto crc = ~checksum;
+
+    std::uint64_t offset = 0;
+
+    for (; offset + 8 <= numberOfBytes; offset += 8) {
+        const auto* chunk = data + offset;
+
+        const std::uint32_t low     = crc ^ (static_cast<std::uint32_t>(chunk[0]) | (static_cast<std::uint32_t>(chunk[1]) << 8) | (static_cast<std::uint32_t>(chunk[2]) << 16) | (static_cast<std::uint32_t>(chunk[3]) << 24));
+        const std::uint32_t high    = static_cast<std::uint32_t>(chunk[4]) | (static_cast<std::uint32_t>(chunk[5]) << 8) | (static_cast<std::uint32_t>(chunk[6]) << 16) | (static_cast<std::uint32_t>(chunk[7]) << 24);
+
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+              tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+    }
+
+    for (; offset < numberOfBytes; ++offset)
+        crc = (crc >> 8) ^ tables[0][(crc ^ data[offset]) & 0xFF];
+
+    return ~crc;
+}
+
+void saveRawDataToBinaryFile(const char* bytes, const std::uint64_t& numberOfBytes, const QString& filePath, std::uint32_t* checksum /*= nullptr*/)
 {
     // Exit prematurely if the serialization process was aborted
     if (Application::isSerializationAborted())
@@ -28,22 +88,31 @@ void saveRawDataToBinaryFile(const char* bytes, const std::uint64_t& numberOfByt
     if (!QFileInfo(filePath).dir().exists())
         throw std::runtime_error(QString("Unable to save data in %1, the directory does not exist").arg(outputDirectory.dirName()).toLatin1());
 
-    // Raw bytes
-    QByteArray rawData(bytes, numberOfBytes);
-
-    // Copy the block to the raw data byte array
-    memcpy((void*)rawData.data(), bytes, numberOfBytes);
-
     // Create binary file
     QFile binaryFile(filePath);
 
-    // And save it do disk
-    binaryFile.open(QIODevice::WriteOnly);
-    binaryFile.write(rawData);
-    binaryFile.close();
+    if (!binaryFile.open(QIODevice::WriteOnly))
+        throw std::runtime_error(QString("Unable to save binary file, cannot open %1").arg(filePath).toLatin1());
+
+    if (checksum != nullptr)
+        *checksum = 0;
+
+    // Write directly from the input buffer, without intermediate copies
+    for (std::uint64_t offset = 0; offset < numberOfBytes; offset += streamChunkSize) {
+        if (Application::isSerializationAborted())
+            return;
+
+        const auto chunkSize = std::min(streamChunkSize, numberOfBytes - offset);
+
+        if (checksum != nullptr)
+            *checksum = computeChecksum(&bytes[offset], chunkSize, *checksum);
+
+        if (binaryFile.write(&bytes[offset], static_cast<qint64>(chunkSize)) != static_cast<qint64>(chunkSize))
+            throw std::runtime_error(QString("Unable to save binary file %1: %2").arg(filePath, binaryFile.errorString()).toLatin1());
+    }
 }
 
-void loadRawDataFromBinaryFile(const char* bytes, const std::uint64_t& numberOfBytes, const QString& filePath)
+void loadRawDataFromBinaryFile(const char* bytes, const std::uint64_t& numberOfBytes, const QString& filePath, const std::uint32_t* expectedChecksum /*= nullptr*/)
 {
     // Exit prematurely if the serialization process was aborted
     if (Application::isSerializationAborted())
@@ -60,23 +129,36 @@ void loadRawDataFromBinaryFile(const char* bytes, const std::uint64_t& numberOfB
     if (!binaryFile.open(QIODevice::ReadOnly))
         throw std::runtime_error("Unable to load binary file, cannot open file");
 
-    // Read the raw data from the file
-    QByteArray rawData = binaryFile.readAll();
-
-    // Determine number of bytes in file
-    const auto numberOfBytesInFile = rawData.size();
-
     // Except if the number of bytes in the file deviates from the number of requested bytes
-    if (numberOfBytesInFile != numberOfBytes)
+    if (static_cast<std::uint64_t>(binaryFile.size()) != numberOfBytes)
         throw std::runtime_error("Unable to load binary file, number of requested bytes is not the same as in the file");
 
-    // Copy the block to the raw data byte array
-    memcpy((void*)bytes, (void*)rawData.data(), numberOfBytes);
+    // The output buffer is owned by the caller and is written to directly
+    auto output = const_cast<char*>(bytes);
+
+    std::uint32_t checksum = 0;
+
+    for (std::uint64_t offset = 0; offset < numberOfBytes; offset += streamChunkSize) {
+        if (Application::isSerializationAborted())
+            return;
+
+        const auto chunkSize = std::min(streamChunkSize, numberOfBytes - offset);
+
+        if (binaryFile.read(&output[offset], static_cast<qint64>(chunkSize)) != static_cast<qint64>(chunkSize))
+            throw std::runtime_error(QString("Unable to load binary file %1: %2").arg(filePath, binaryFile.errorString()).toLatin1());
+
+        if (expectedChecksum != nullptr)
+            checksum = computeChecksum(&output[offset], chunkSize, checksum);
+    }
+
+    if (expectedChecksum != nullptr && checksum != *expectedChecksum)
+        throw std::runtime_error(QString("Unable to load binary file, the checksum of %1 does not match").arg(filePath).toLatin1());
 }
 
-QVariantMap rawDataToVariantMap(const char* bytes, const std::uint64_t& numberOfBytes, bool saveToDisk /*= false*/, std::uint64_t maxBlockSize /*= -1*/)
+QVariantMap rawDataToVariantMap(const char* bytes, const std::uint64_t& numberOfBytes, bool saveToDisk /*= false*/, std::uint64_t maxBlockSize /*= -1*/, bool checksum /*= false*/, std::uint32_t elementSize /*= 1*/)
 {
     Q_ASSERT(maxBlockSize != 0);
+    Q_ASSERT(elementSize != 0);
 
     if (maxBlockSize == -1)
         maxBlockSize = DEFAULT_MAX_BLOCK_SIZE;
@@ -94,6 +176,8 @@ QVariantMap rawDataToVariantMap(const char* bytes, const std::uint64_t& numberOf
 
     QVariantList blocks;
 
+    const auto rawDataCodec = Application::getSerializationRawDataCodec();
+
     while (offset < numberOfBytes)
     {
         QVariantMap block;
@@ -104,22 +188,54 @@ QVariantMap rawDataToVariantMap(const char* bytes, const std::uint64_t& numberOf
         block["Offset"] = QVariant::fromValue(offset);
         block["Size"]   = QVariant::fromValue(blockSize);
 
-        if (saveToDisk) {
+        if (rawDataCodec != RawDataCodec::None) {
+
+            // Encode the block, the checksum (if any) is computed over the decoded bytes
+            const auto encodedBytes = encodeRawData(rawDataCodec, &bytes[offset], blockSize, elementSize);
+
+            block["Codec"]          = getRawDataCodecName(rawDataCodec);
+            block["ElementSize"]    = QVariant::fromValue(elementSize);
+            block["EncodedSize"]    = QVariant::fromValue(static_cast<std::uint64_t>(encodedBytes.size()));
+
+            if (saveToDisk) {
+                const auto fileName = QUuid::createUuid().toString(QUuid::WithoutBraces) + ".bin";
+                const auto filePath = QDir::toNativeSeparators(Application::getSerializationTemporaryDirectory() + "/" + fileName);
+
+                saveRawDataToBinaryFile(encodedBytes.data(), encodedBytes.size(), filePath);
+
+                block["URI"] = fileName;
+            }
+            else {
+                block["Data"] = QString(QByteArray::fromRawData(encodedBytes.data(), static_cast<qsizetype>(encodedBytes.size())).toBase64());
+            }
+
+            if (checksum)
+                block["Checksum"] = QVariant::fromValue(computeChecksum(&bytes[offset], blockSize));
+        }
+        else if (saveToDisk) {
 
             // File name and path of the external binary file in the temporary directory
             const auto fileName = QUuid::createUuid().toString(QUuid::WithoutBraces) + ".bin";
             const auto filePath = QDir::toNativeSeparators(Application::getSerializationTemporaryDirectory() + "/" + fileName);
 
+            std::uint32_t blockChecksum = 0;
+
             // Save the raw data to binary file
-            saveRawDataToBinaryFile(&bytes[offset], blockSize, filePath);
+            saveRawDataToBinaryFile(&bytes[offset], blockSize, filePath, checksum ? &blockChecksum : nullptr);
 
             // Set the raw data URL
             block["URI"] = fileName;
+
+            if (checksum)
+                block["Checksum"] = QVariant::fromValue(blockChecksum);
         }
         else {
 
             // Create data block
             block["Data"] = QString(qCompress(QByteArray::fromRawData(&bytes[offset], blockSize)).toBase64());
+
+            if (checksum)
+                block["Checksum"] = QVariant::fromValue(computeChecksum(&bytes[offset], blockSize));
         }
 
         // Append block to the blocks
@@ -156,14 +272,56 @@ void populateDataBufferFromVariantMap (const QVariantMap& variantMap, const char
         const auto offset   = map["Offset"].value<uint64_t>();
         const auto size     = map["Size"].value<uint64_t>();
 
+        // Blocks that were saved without checksum are not verified
+        const auto hasChecksum      = map.contains("Checksum");
+        const auto expectedChecksum = map["Checksum"].value<std::uint32_t>();
+
+        if (map.contains("Codec")) {
+            variantMapMustContain(map, "ElementSize");
+            variantMapMustContain(map, "EncodedSize");
+
+            const auto rawDataCodec = getRawDataCodec(map["Codec"].toString());
+            const auto elementSize  = map["ElementSize"].value<std::uint32_t>();
+            const auto encodedSize  = map["EncodedSize"].value<std::uint64_t>();
+
+            QByteArray encodedBytes;
+
+            if (map.contains("URI")) {
+                encodedBytes.resize(static_cast<qsizetype>(encodedSize));
+
+                loadRawDataFromBinaryFile(encodedBytes.data(), encodedSize, QDir::toNativeSeparators(Application::getSerializationTemporaryDirectory() + "/" + map["URI"].toString()));
+            }
+            else {
+                variantMapMustContain(map, "Data");
+
+                encodedBytes = QByteArray::fromBase64(map["Data"].toString().toUtf8());
+            }
+
+            if (static_cast<std::uint64_t>(encodedBytes.size()) != encodedSize)
+                throw std::runtime_error("Unable to populate data buffer, the size of the encoded block is incorrect");
+
+            decodeRawData(rawDataCodec, encodedBytes.constData(), encodedSize, const_cast<char*>(&bytes[offset]), size, elementSize);
+
+            if (hasChecksum && computeChecksum(&bytes[offset], size) != expectedChecksum)
+                throw std::runtime_error("Unable to populate data buffer, the checksum of the block does not match");
+
+            continue;
+        }
+
         if (map.contains("URI")) {
-            loadRawDataFromBinaryFile(&bytes[offset], size, QDir::toNativeSeparators(Application::getSerializationTemporaryDirectory() + "/" + map["URI"].toString()));
+            loadRawDataFromBinaryFile(&bytes[offset], size, QDir::toNativeSeparators(Application::getSerializationTemporaryDirectory() + "/" + map["URI"].toString()), hasChecksum ? &expectedChecksum : nullptr);
         }
 
         if (map.contains("Data")) {
             const auto data         = map["Data"].toString();
             const auto blockData    = qUncompress(QByteArray::fromBase64(data.toUtf8()));
 
+            if (static_cast<std::uint64_t>(blockData.size()) != size)
+                throw std::runtime_error("Unable to populate data buffer, the size of the uncompressed block is incorrect");
+
+            if (hasChecksum && computeChecksum(blockData.data(), size) != expectedChecksum)
+                throw std::runtime_error("Unable to populate data buffer, the checksum of the block does not match");
+
             // Copy the block to the output bytes
             memcpy((void*)&bytes[offset], blockData.data(), size);
         }
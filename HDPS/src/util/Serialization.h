@@ -16,20 +16,32 @@ namespace mv {
 namespace util {
 
 /**
- * Save raw data to binary file on disk
+ * Compute the CRC-32 checksum (as used by zlib and PNG) of a buffer, which can be computed incrementally by passing
+ * the checksum of the preceding bytes as \p checksum
  * @param bytes Pointer to input buffer
  * @param numberOfBytes Number of input bytes
- * @param filePath Path of the file on disk
+ * @param checksum Checksum of the preceding bytes (zero when there are none)
+ * @return Checksum
  */
-void saveRawDataToBinaryFile(const char* bytes, const std::uint64_t& numberOfBytes, const QString& filePath);
+std::uint32_t computeChecksum(const char* bytes, const std::uint64_t& numberOfBytes, std::uint32_t checksum = 0);
 
 /**
- * Load raw data from binary file on disk
+ * Save raw data to binary file on disk, the data is streamed directly from the input buffer in chunks
  * @param bytes Pointer to input buffer
  * @param numberOfBytes Number of input bytes
  * @param filePath Path of the file on disk
+ * @param checksum Pointer to the resulting checksum of the data (not computed when nullptr)
+ */
+void saveRawDataToBinaryFile(const char* bytes, const std::uint64_t& numberOfBytes, const QString& filePath, std::uint32_t* checksum = nullptr);
+
+/**
+ * Load raw data from binary file on disk, the data is streamed directly into the output buffer in chunks
+ * @param bytes Pointer to output buffer
+ * @param numberOfBytes Number of output bytes
+ * @param filePath Path of the file on disk
+ * @param expectedChecksum Pointer to the checksum the data should have (not verified when nullptr)
  */
-void loadRawDataFromBinaryFile(const char* bytes, const std::uint64_t& numberOfBytes, const QString& filePath);
+void loadRawDataFromBinaryFile(const char* bytes, const std::uint64_t& numberOfBytes, const QString& filePath, const std::uint32_t* expectedChecksum = nullptr);
 
 /**
  * Convert raw data buffer to variant map (divide up in blocks when the total number of bytes exceeds maxBlockSize)
@@ -37,11 +49,13 @@ void loadRawDataFromBinaryFile(const char* bytes, const std::uint64_t& numberOfB
  * @param numberOfBytes Number of input bytes 
  * @param saveToDisk Whether to save the raw data to disk or inline in the variant
  * @param maxBlockSize Maximum size per block (DEFAULT_MAX_BLOCK_SIZE when maxBlockSize == -1)
+ * @param checksum Whether to store a checksum per block, which is verified when the data is populated
+ * @param elementSize Size of the data elements in bytes (used by the raw data codec, see Application::getSerializationRawDataCodec())
  */
-QVariantMap rawDataToVariantMap(const char* bytes, const std::uint64_t& numberOfBytes, bool saveToDisk = false, std::uint64_t maxBlockSize = -1);
+QVariantMap rawDataToVariantMap(const char* bytes, const std::uint64_t& numberOfBytes, bool saveToDisk = false, std::uint64_t maxBlockSize = -1, bool checksum = false, std::uint32_t elementSize = 1);
 
 /**
- * Convert variant map to raw data
+ * Convert variant map to raw data (decodes blocks that were encoded with a raw data codec and verifies the checksum of blocks that have one)
  * @param variantMap Variant map containing the data blocks
  * @param bytes Output buffer to which the data is copied
  */